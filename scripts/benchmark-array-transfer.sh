@@ -0,0 +1,46 @@
+#! /bin/bash
+
+# measure distribution of render object arrays from an OpenCOVER master
+# to slaves running on this host, with and without compression
+#
+# usage: benchmark-array-transfer.sh [slaves [megabytes [TCP|MULTICAST]]]
+
+numslaves="${1:-2}"
+megabytes="${2:-256}"
+syncmode="${3:-TCP}"
+
+case "$syncmode" in
+   TCP|MULTICAST) ;;
+   *) echo "sync mode has to be TCP or MULTICAST" 1>&2; exit 1 ;;
+esac
+
+config="$(mktemp "${TMPDIR:-/tmp}/config-array-transfer-XXXXXX.xml")" || exit 1
+trap 'rm -f "$config"' EXIT
+
+{
+   echo '<?xml version="1.0"?>'
+   echo '<COCONFIG version="1" >'
+   echo ' <GLOBAL>'
+   echo '  <COVER>'
+   echo '   <MultiPC>'
+   echo "    <SyncMode value=\"$syncmode\" />"
+   echo "    <NumSlaves value=\"$numslaves\" />"
+   echo '    <MasterInterface value="127.0.0.1" />'
+   echo '    <Multicast>'
+   echo '     <mcastAddr value="224.223.222.221" />'
+   echo '     <mcastIface value="127.0.0.1" />'
+   echo '     <lback value="on" />'
+   echo '    </Multicast>'
+   # slaves render offscreen as well, -O has to follow the -c arguments added by the master
+   for i in $(seq 0 $((numslaves - 1))); do
+      echo "    <Startup value=\"sh -c 'exec opencover &quot;\$@&quot; -O' opencover\" name=\"$i\" />"
+   done
+   echo '   </MultiPC>'
+   echo '  </COVER>'
+   echo ' </GLOBAL>'
+   echo ' <INCLUDE global="1" configname="general" >config.xml</INCLUDE>'
+   echo '</COCONFIG>'
+} > "$config"
+
+export COCONFIG="$config"
+opencover -O -T "$megabytes"
@@ -64,6 +64,7 @@
 #include <vrb/client/VRBClient.h>
 
 #include "coVRAnimationManager.h"
+#include "coVRBenchmark.h"
 #include "coVRCollaboration.h"
 #include "coVRFileManager.h"
 #include "coVRNavigationManager.h"
@@ -108,12 +109,18 @@ static void usage()
 {
     fprintf(stderr, "OpenCOVER\n");
     fprintf(stderr, "       (C) HLRS, University of Stuttgart (2004)\n\n");
-    fprintf(stderr, "usage: cover [-g sessionName] [-C vrbServer:port] [-v <viewpoints file>] [-s <collaborative config file>] [-h] <data file>\n\n");
+    fprintf(stderr, "usage: cover [-g sessionName] [-C vrbServer:port] [-v <viewpoints file>] [-s <collaborative config file>] [-B <camera path>|orbit [-N frames] [-R report] [-O]] [-P <camera path>] [-T <megabytes>] [-h] <data file>\n\n");
     fprintf(stderr, "       -h : print this message\n");
     fprintf(stderr, "       -v : automatically load the indicated viewpoint file\n");
     fprintf(stderr, "       -s : collaborative VR configuration file, used by web interface\n");
     fprintf(stderr, "       -C : vrb to connect to in form host:port\n");
     fprintf(stderr, "       -g : Collaborative Session to load\n");
+    fprintf(stderr, "       -B : benchmark: play camera path, write frame times to report and quit\n");
+    fprintf(stderr, "       -N : number of frames to benchmark\n");
+    fprintf(stderr, "       -R : benchmark report file (default: opencover-benchmark.csv)\n");
+    fprintf(stderr, "       -O : render offscreen into pbuffers\n");
+    fprintf(stderr, "       -P : record camera path to file\n");
+    fprintf(stderr, "       -T : benchmark distribution of arrays to cluster slaves, with and without compression\n");
 }
 
 //Signal handler
@@ -360,7 +367,7 @@ bool OpenCOVER::init()
 
     int c = 0;
     std::string collaborativeOptionsFile, viewpointsFile;
-    while ((c = getopt(coCommandLine::argc(), coCommandLine::argv(), "hdC:s:v:c:::g:")) != -1)
+    while ((c = getopt(coCommandLine::argc(), coCommandLine::argv(), "hdOC:s:v:c:::g:B:N:R:P:T:")) != -1)
     {
         switch (c)
         {
@@ -404,6 +411,24 @@ bool OpenCOVER::init()
 			m_startSession = optarg;
 		}
 		break;
+        case 'B':
+            coVRBenchmark::instance()->setPath(optarg);
+            break;
+        case 'N':
+            coVRBenchmark::instance()->setNumFrames(atoi(optarg));
+            break;
+        case 'R':
+            coVRBenchmark::instance()->setReport(optarg);
+            break;
+        case 'O':
+            coVRBenchmark::instance()->setOffscreen(true);
+            break;
+        case 'P':
+            coVRBenchmark::instance()->setRecordPath(optarg);
+            break;
+        case 'T':
+            coVRBenchmark::instance()->setTransferSize(atoi(optarg));
+            break;
         case 'h':
             usage();
             exit(EXIT_SUCCESS);
@@ -551,7 +576,7 @@ bool OpenCOVER::init()
         sprintf(envStr, "__GL_LOG_MAX_ANISO=%d", AnisotropicFiltering);
         putenv(envStr);
     }
-    if (coCoviseConfig::isOn("COVER.SyncToVBlank", false))
+    if (coCoviseConfig::isOn("COVER.SyncToVBlank", false) && !coVRBenchmark::instance()->enabled())
     {
         putenv((char *)"__GL_SYNC_TO_VBLANK=1");
         fprintf(stderr,"__GL_SYNC_TO_VBLANK=1\n");
@@ -560,6 +585,8 @@ bool OpenCOVER::init()
     {
         putenv((char *)"__GL_SYNC_TO_VBLANK=0");
         fprintf(stderr,"__GL_SYNC_TO_VBLANK=0\n");
+        if (coVRBenchmark::instance()->enabled())
+            putenv((char *)"vblank_mode=0"); // Mesa
 	}
     std::string syncDevice = coCoviseConfig::getEntry("device", "COVER.SyncToVBlank");
     if (!syncDevice.empty())
@@ -644,6 +671,16 @@ bool OpenCOVER::init()
 
     cover->setScale(coCoviseConfig::getFloat("COVER.DefaultScaleFactor", 1.f));
 
+    if (coVRBenchmark::instance()->offscreen())
+    {
+        // no window system required, just a GL context for pbuffers
+        for (auto &win: coVRConfig::instance()->windows)
+        {
+            win.pbuffer = true;
+            win.type.clear();
+        }
+    }
+
     bool haveWindows = VRWindow::instance()->config();
     haveWindows = coVRMSController::instance()->allReduceOr(haveWindows);
     if (!haveWindows)
@@ -854,6 +891,10 @@ bool OpenCOVER::init()
     coVRPluginList::instance()->init2();
     double init2End = cover->currentTime();
 
+    coVRBenchmark::instance()->init();
+    if (coVRBenchmark::instance()->enabled())
+        coVRConfig::instance()->m_continuousRendering = true;
+
     if (!coVRConfig::instance()->continuousRendering())
     {
         if (cover->debugLevel(2))
@@ -939,7 +980,9 @@ void OpenCOVER::loop()
         exitFlag = coVRMSController::instance()->syncBool(exitFlag);
         if (exitFlag)
             break;
+        coVRBenchmark::instance()->preFrame();
         frame();
+        coVRBenchmark::instance()->postFrame();
     }
 
     VRViewer::instance()->disableSync();
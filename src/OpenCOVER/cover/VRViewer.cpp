@@ -43,6 +43,7 @@
 #include "OpenCOVER.h"
 #include <OpenVRUI/osg/mathUtils.h>
 #include "coVRPluginList.h"
+#include "coVRPluginProfiler.h"
 #include "coVRPluginSupport.h"
 #include "coVRConfig.h"
 #include "coCullVisitor.h"
@@ -50,6 +51,7 @@
 #include "InitGLOperation.h"
 #include "input/input.h"
 #include "tridelity.h"
+#include "ui/Action.h"
 #include "ui/Button.h"
 #include "ui/SelectionList.h"
 #include "ui/Menu.h"
@@ -457,6 +459,7 @@ VRViewer::VRViewer()
     showStats->append("Viewer");
     showStats->append("Viewer+camera");
     showStats->append("Viewer+camera+nodes");
+    showStats->append("Plugins");
     cover->viewOptionsMenu->add(showStats);
     showStats->select(coVRConfig::instance()->drawStatistics);
     showStats->setCallback([this](int val){
@@ -465,6 +468,13 @@ VRViewer::VRViewer()
         //XXX setInstrumentationMode( coVRConfig::instance()->drawStatistics );
     });
 
+    auto saveProfile = new ui::Action("SavePluginProfile", this);
+    cover->viewOptionsMenu->add(saveProfile);
+    saveProfile->setText("Save plugin profile");
+    saveProfile->setCallback([](){
+        coVRPluginProfiler::instance()->save();
+    });
+
     statsDisplay = new coVRStatsDisplay();
 }
 
@@ -14,7 +14,8 @@
 
 #include <config/CoviseConfig.h>
 
-#include <osg/LineSegment>
+#include <osg/Geometry>
+#include <osg/KdTree>
 #include <osg/Matrix>
 #include <osg/Vec3>
 #include <osg/io_utils>
@@ -35,6 +36,12 @@
 #include <util/coWristWatch.h>
 #include <numeric>
 #include <limits>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
 
 using namespace osg;
 using namespace osgUtil;
@@ -121,8 +128,226 @@ void coIntersector::intersect(osgUtil::IntersectionVisitor &iv, osg::Drawable *d
 
 
 
+namespace
+{
+
+// changes whenever vertices or primitives of a geometry are modified
+struct GeometryStamp
+{
+    const osg::Array *vertices = nullptr;
+    unsigned modified = 0;
+    size_t numPrimitiveSets = 0;
+
+    GeometryStamp() {}
+    explicit GeometryStamp(const osg::Geometry &geom)
+        : vertices(geom.getVertexArray())
+        , numPrimitiveSets(geom.getNumPrimitiveSets())
+    {
+        if (vertices)
+            modified = vertices->getModifiedCount();
+        for (size_t i = 0; i < numPrimitiveSets; ++i)
+            modified += geom.getPrimitiveSet(i)->getModifiedCount();
+    }
+
+    bool operator==(const GeometryStamp &o) const
+    {
+        return vertices == o.vertices && modified == o.modified && numPrimitiveSets == o.numPrimitiveSets;
+    }
+};
+}
+
+// KdTrees are built from copies of the geometry by a worker thread and
+// attached on the main thread, if the geometry has not changed meanwhile
+struct coIntersection::KdTrees
+{
+    struct Job
+    {
+        osg::observer_ptr<osg::Geometry> geometry;
+        osg::ref_ptr<osg::Geometry> copy;
+        GeometryStamp stamp;
+        osg::ref_ptr<osg::KdTree> kdTree;
+    };
+
+    struct Entry
+    {
+        osg::observer_ptr<osg::Geometry> geometry;
+        GeometryStamp stamp;
+        bool pending = false;
+    };
+
+    class Collector: public osg::NodeVisitor
+    {
+    public:
+        Collector(KdTrees *trees)
+            : osg::NodeVisitor(osg::NodeVisitor::TRAVERSE_ALL_CHILDREN)
+            , trees(trees)
+        {
+        }
+
+        void apply(osg::Geometry &geom) override
+        {
+            trees->check(geom);
+        }
+
+    private:
+        KdTrees *trees;
+    };
+
+    bool enabled = true;
+    int minVertices = 1000;
+    int scanInterval = 30;
+    int frame = 0;
+
+    std::map<const osg::Geometry *, Entry> entries;
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::deque<std::shared_ptr<Job>> queue, done;
+    bool quit = false;
+    std::thread thread;
+
+    KdTrees()
+    {
+        enabled = coCoviseConfig::isOn("COVER.Intersection.KdTree", true);
+        minVertices = coCoviseConfig::getInt("minVertices", "COVER.Intersection.KdTree", minVertices);
+        scanInterval = std::max(1, coCoviseConfig::getInt("scanInterval", "COVER.Intersection.KdTree", scanInterval));
+    }
+
+    ~KdTrees()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            quit = true;
+        }
+        cond.notify_all();
+        if (thread.joinable())
+            thread.join();
+    }
+
+    void run()
+    {
+        osg::KdTree::BuildOptions options;
+        for (;;)
+        {
+            std::shared_ptr<Job> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cond.wait(lock, [this]() { return quit || !queue.empty(); });
+                if (quit)
+                    return;
+                job = queue.front();
+                queue.pop_front();
+            }
+
+            osg::ref_ptr<osg::KdTree> kdTree = new osg::KdTree;
+            if (kdTree->build(options, job->copy.get()))
+                job->kdTree = kdTree;
+            job->copy = nullptr;
+
+            std::lock_guard<std::mutex> lock(mutex);
+            done.push_back(job);
+        }
+    }
+
+    void submit(osg::Geometry &geom, Entry &entry)
+    {
+        auto job = std::make_shared<Job>();
+        job->geometry = &geom;
+        job->stamp = entry.stamp;
+        // geometry might be modified by the application while the tree is built
+        job->copy = new osg::Geometry(geom, osg::CopyOp::DEEP_COPY_ARRAYS | osg::CopyOp::DEEP_COPY_PRIMITIVES);
+        entry.pending = true;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!thread.joinable())
+            thread = std::thread([this]() { run(); });
+        queue.push_back(job);
+        cond.notify_one();
+    }
+
+    void check(osg::Geometry &geom)
+    {
+        if (geom.getDataVariance() == osg::Object::DYNAMIC)
+            return;
+        auto vertices = dynamic_cast<const osg::Vec3Array *>(geom.getVertexArray());
+        if (!vertices || vertices->size() < size_t(minVertices))
+            return;
+
+        auto it = entries.find(&geom);
+        if (it != entries.end() && !it->second.geometry.valid())
+        {
+            // address of a deleted geometry has been reused
+            entries.erase(it);
+            it = entries.end();
+        }
+        if (it == entries.end())
+        {
+            // leave trees built elsewhere, e.g. by the COVISE plugin, alone
+            if (geom.getShape())
+                return;
+            Entry &entry = entries[&geom];
+            entry.geometry = &geom;
+            entry.stamp = GeometryStamp(geom);
+            submit(geom, entry);
+        }
+    }
+
+    void update(osg::Node *root)
+    {
+        // attach finished trees
+        std::deque<std::shared_ptr<Job>> finished;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::swap(finished, done);
+        }
+        for (auto &job: finished)
+        {
+            osg::ref_ptr<osg::Geometry> geom;
+            if (!job->geometry.lock(geom))
+                continue;
+            auto it = entries.find(geom.get());
+            if (it == entries.end())
+                continue;
+            it->second.pending = false;
+            if (!job->kdTree || !(it->second.stamp == job->stamp) || !(GeometryStamp(*geom) == job->stamp))
+                continue;
+            job->kdTree->setVertices(static_cast<osg::Vec3Array *>(geom->getVertexArray()));
+            geom->setShape(job->kdTree.get());
+        }
+
+        // invalidate trees of modified geometry
+        for (auto it = entries.begin(); it != entries.end();)
+        {
+            osg::ref_ptr<osg::Geometry> geom;
+            if (!it->second.geometry.lock(geom))
+            {
+                it = entries.erase(it);
+                continue;
+            }
+            GeometryStamp stamp(*geom);
+            if (!(stamp == it->second.stamp))
+            {
+                if (dynamic_cast<osg::KdTree *>(geom->getShape()))
+                    geom->setShape(nullptr);
+                it->second.stamp = stamp;
+                if (!it->second.pending && !geom->getShape() && dynamic_cast<const osg::Vec3Array *>(geom->getVertexArray()))
+                    submit(*geom, it->second);
+            }
+            ++it;
+        }
+
+        // look for new geometry
+        if (root && frame++ % scanInterval == 0)
+        {
+            Collector collector(this);
+            root->accept(collector);
+        }
+    }
+};
+
 coIntersection::coIntersection()
     : elapsedTimes(1)
+    , kdTrees(new KdTrees)
 {
     assert(!intersector);
 
@@ -177,10 +402,42 @@ coIntersection *coIntersection::instance()
     return intersector;
 }
 
+void coIntersection::updateKdTrees()
+{
+    if (kdTrees->enabled)
+        kdTrees->update(cover->getObjectsRoot());
+}
+
+bool coIntersection::hintDistance(bool mouseHit, const osg::Vec3 &q0, const osg::Vec3 &q1, unsigned mask, float &dist)
+{
+    osg::ref_ptr<osg::Drawable> drawable;
+    if (!hintDrawable[mouseHit].lock(drawable))
+        return false;
+
+    bool found = false;
+    for (const auto &mat: drawable->getWorldMatrices(cover->getScene()))
+    {
+        osg::Matrix inv = osg::Matrix::inverse(mat);
+        osg::ref_ptr<coIntersector> intersector = newIntersector(q0 * inv, q1 * inv);
+        IntersectionVisitor visitor(intersector.get());
+        visitor.setTraversalMask(mask);
+        drawable->accept(visitor);
+        if (!intersector->containsIntersections())
+            continue;
+        float d = (intersector->getFirstIntersection().getLocalIntersectPoint() * mat - q0).length();
+        if (!found || d < dist)
+            dist = d;
+        found = true;
+    }
+    return found;
+}
+
 void coIntersection::intersect()
 {
     double beginTime = VRViewer::instance()->elapsedTime();
 
+    updateKdTrees();
+
     cover->intersectedNode = 0;
 
     // for debug only
@@ -262,21 +519,38 @@ void coIntersection::intersect(const osg::Matrix &handMat, bool mouseHit)
     std::cerr << "coIntersection::intersect info: ray from " << q0 << " to " << q1 << std::endl;
 #endif
 
-    ref_ptr<LineSegment> ray = new LineSegment();
-    ray->set(q0, q1);
+    unsigned mask = numIsectAllNodes > 0 ? Isect::Pick : Isect::Intersection;
 
-    if (q0 != q1)
+    // nothing farther away than the previous hit can be the nearest hit,
+    // so the ray ends just behind it unless the hit has gone
+    Vec3 end = q1;
+    float hintDist = 0.f;
+    bool shortened = false;
+    if (q0 != q1 && hintDistance(mouseHit, q0, q1, mask, hintDist))
     {
-        IntersectionVisitor visitor;
-        if (numIsectAllNodes > 0)
+        float len = (q1 - q0).length();
+        float dist = hintDist * 1.01f + 0.001f * len;
+        if (dist < len)
         {
-            visitor.setTraversalMask(Isect::Pick);
+            end = q0 + (q1 - q0) * (dist / len);
+            shortened = true;
         }
-        else
+    }
+    hintDrawable[mouseHit] = nullptr;
+
+    for (int pass = 0; pass < 2 && q0 != q1; ++pass)
+    {
+        if (pass > 0)
         {
-            visitor.setTraversalMask(Isect::Intersection);
+            if (!shortened || hintDrawable[mouseHit].valid())
+                break;
+            // previous hit is not visible anymore: search along the whole ray
+            end = q1;
         }
-        osg::ref_ptr<coIntersector> intersector = new coIntersector(ray->start(), ray->end());
+
+        IntersectionVisitor visitor;
+        visitor.setTraversalMask(mask);
+        osg::ref_ptr<coIntersector> intersector = new coIntersector(q0, end);
         for (auto h: handlers)
             intersector->addHandler(h);
         visitor.setIntersector(intersector.get());
@@ -363,6 +637,7 @@ void coIntersection::intersect(const osg::Matrix &handMat, bool mouseHit)
                     //    fprintf(stderr,"coIntersection::intersect hit node without name\n");
 
                     cover->intersectedNodePath = isect.nodePath;
+                    hintDrawable[mouseHit] = isect.drawable;
                     // walk up to the root and call all coActions
                     OSGVruiHit hit(isect, mouseHit);
                     if (cover->intersectedNode.get())
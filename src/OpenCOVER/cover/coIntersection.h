@@ -23,8 +23,11 @@
 
 #include <OpenVRUI/sginterface/vruiIntersection.h>
 #include <osg/Matrix>
+#include <osg/observer_ptr>
 #include <osgUtil/LineSegmentIntersector>
 
+#include <memory>
+
 namespace osgUtil {
 class IntersectionVisitor;
 }
@@ -94,6 +97,15 @@ protected:
 private:
     std::vector<std::vector<float> > elapsedTimes;
     std::vector<osg::ref_ptr<IntersectionHandler>> handlers;
+
+    // KdTrees for drawables of the scene, built in the background
+    struct KdTrees;
+    std::unique_ptr<KdTrees> kdTrees;
+    void updateKdTrees();
+
+    // drawable hit in previous frame by pointer and mouse, limits length of ray
+    osg::observer_ptr<osg::Drawable> hintDrawable[2];
+    bool hintDistance(bool mouseHit, const osg::Vec3 &q0, const osg::Vec3 &q1, unsigned mask, float &dist);
 };
 }
 #endif
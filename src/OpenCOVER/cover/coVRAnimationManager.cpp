@@ -5,6 +5,11 @@
 
  * License: LGPL 2+ */
 
+#include <algorithm>
+
+#include <osg/Geode>
+#include <osg/Geometry>
+#include <osg/NodeVisitor>
 #include <osg/Sequence>
 #include <osgGA/GUIEventAdapter>
 
@@ -21,6 +26,8 @@
 #include "coVRCollaboration.h"
 #include "coVRMSController.h"
 #include "OpenCOVER.h"
+#include "VRViewer.h"
+#include "coVRStatsDisplay.h"
 
 #include <grmsg/coGRAnimationOnMsg.h>
 #include <grmsg/coGRSetAnimationSpeedMsg.h>
@@ -35,6 +42,68 @@ using namespace covise;
 
 coVRAnimationManager *coVRAnimationManager::s_instance;
 
+struct coVRAnimationManager::Stream
+{
+    FrameLoader loader;
+    std::vector<osg::ref_ptr<osg::Group> > frames; // children of the sequence, receive the loaded frames
+    std::vector<size_t> bytes;
+    std::vector<bool> resident;
+    std::map<int, std::shared_ptr<FrameLoad> > loads; // frames queued or being loaded
+};
+
+struct coVRAnimationManager::FrameLoad
+{
+    FrameLoader loader;
+    int frame = -1;
+    osg::ref_ptr<osg::Node> node;
+    bool started = false;
+    bool done = false;
+};
+
+namespace
+{
+
+// sum up the size of vertex arrays and primitive sets
+class MemoryVisitor : public osg::NodeVisitor
+{
+public:
+    MemoryVisitor()
+        : osg::NodeVisitor(osg::NodeVisitor::TRAVERSE_ALL_CHILDREN)
+    {
+    }
+
+    void apply(osg::Geode &geode) override
+    {
+        for (unsigned int i = 0; i < geode.getNumDrawables(); ++i)
+        {
+            osg::Geometry *geo = geode.getDrawable(i)->asGeometry();
+            if (!geo)
+                continue;
+            add(geo->getVertexArray());
+            add(geo->getNormalArray());
+            add(geo->getColorArray());
+            add(geo->getSecondaryColorArray());
+            add(geo->getFogCoordArray());
+            for (unsigned int t = 0; t < geo->getNumTexCoordArrays(); ++t)
+                add(geo->getTexCoordArray(t));
+            for (unsigned int a = 0; a < geo->getNumVertexAttribArrays(); ++a)
+                add(geo->getVertexAttribArray(a));
+            for (unsigned int p = 0; p < geo->getNumPrimitiveSets(); ++p)
+                add(geo->getPrimitiveSet(p));
+        }
+    }
+
+    size_t bytes = 0;
+
+private:
+    void add(const osg::BufferData *data)
+    {
+        if (data)
+            bytes += data->getTotalDataSize();
+    }
+};
+}
+
 coVRAnimationManager::coVRAnimationManager()
     : ui::Owner("AnimationManager", cover->ui)
     , m_animSliderMin(-25.)
@@ -61,6 +130,15 @@ coVRAnimationManager::coVRAnimationManager()
 
 coVRAnimationManager::~coVRAnimationManager()
 {
+    {
+        std::lock_guard<std::mutex> lock(m_streamMutex);
+        m_quitStreamLoaders = true;
+        m_streamQueue.clear();
+    }
+    m_streamCond.notify_all();
+    for (auto &t: m_streamThreads)
+        t.join();
+
     s_instance = NULL;
 }
 
@@ -222,10 +300,7 @@ coVRAnimationManager::setRemoteAnimationFrame(int currentFrame)
     if (currentFrame >= 0 || currentFrame < m_numFrames)
     {
         m_currentAnimationFrame = currentFrame;
-        for (unsigned int i = 0; i < m_listOfSeq.size(); i++)
-        {
-            updateSequence(m_listOfSeq[i], currentFrame);
-        }
+        updateSequences(currentFrame);
         coVRPluginList::instance()->setTimestep(currentFrame);
         if (animFrameItem && m_numFrames != 0)
             animFrameItem->setValue(currentFrame);
@@ -280,30 +355,53 @@ coVRAnimationManager::requestAnimationFrame(int currentFrame)
     return change;
 }
 
-void
-coVRAnimationManager::updateSequence(Sequence &seq, int currentFrame)
+int
+coVRAnimationManager::sequenceChild(const Sequence &seq, int currentFrame)
 {
     int numChildren = seq.seq->getNumChildren();
     if (currentFrame < numChildren)
-    {
-        seq.seq->setValue(currentFrame);
-        return;
-    }
+        return currentFrame;
 
     switch(seq.fill)
     {
         case Nothing:
-            seq.seq->setValue(-1);
-            break;
+            return -1;
         case Last:
-            seq.seq->setValue(numChildren-1);
-            break;
+            return numChildren-1;
         case Cycle:
             if (numChildren>0)
-                seq.seq->setValue(currentFrame % numChildren);
-            else
-                seq.seq->setValue(-1);
-            break;
+                return currentFrame % numChildren;
+            return -1;
+    }
+    return -1;
+}
+
+void
+coVRAnimationManager::updateSequence(Sequence &seq, int currentFrame)
+{
+    seq.seq->setValue(sequenceChild(seq, currentFrame));
+}
+
+void
+coVRAnimationManager::updateSequences(int currentFrame)
+{
+    size_t hits = m_prefetchHits, misses = m_prefetchMisses;
+    for (unsigned int i = 0; i < m_listOfSeq.size(); i++)
+    {
+        if (m_listOfSeq[i].stream)
+            makeResident(m_listOfSeq[i], sequenceChild(m_listOfSeq[i], currentFrame));
+        updateSequence(m_listOfSeq[i], currentFrame);
+    }
+
+    hits = m_prefetchHits - hits;
+    misses = m_prefetchMisses - misses;
+    if (hits + misses == 0)
+        return;
+    auto stats = VRViewer::instance()->getViewerStats();
+    if (stats && stats->collectStats("frame_rate"))
+    {
+        int fn = VRViewer::instance()->getFrameStamp()->getFrameNumber();
+        stats->setAttribute(fn, "Streaming prefetch hits", 100. * hits / (hits + misses));
     }
 }
 
@@ -318,10 +416,7 @@ coVRAnimationManager::setAnimationFrame(int currentFrame)
     if (m_currentAnimationFrame != currentFrame)
     {
         m_currentAnimationFrame = currentFrame;
-        for (unsigned int i = 0; i < m_listOfSeq.size(); i++)
-        {
-            updateSequence(m_listOfSeq[i], currentFrame);
-        }
+        updateSequences(currentFrame);
         coVRPluginList::instance()->setTimestep(currentFrame);
         if (animFrameItem && m_numFrames != 0)
             animFrameItem->setValue(m_timestepBase + m_timestepScale * currentFrame);
@@ -473,6 +568,18 @@ coVRAnimationManager::enableAnimation(bool state)
 bool
 coVRAnimationManager::update()
 {
+    if (!m_streamThreads.empty())
+    {
+        updateStreaming();
+
+        auto stats = VRViewer::instance()->getViewerStats();
+        if (stats && stats->collectStats("frame_rate"))
+        {
+            int fn = VRViewer::instance()->getFrameStamp()->getFrameNumber();
+            stats->setAttribute(fn, "Streaming resident bytes", m_streamBytes);
+        }
+    }
+
     // Set selected animation frame:
     return updateAnimationFrame();
 
@@ -548,6 +655,8 @@ coVRAnimationManager::removeSequence(osg::Sequence *seq)
     {
         if (m_listOfSeq[i].seq == seq)
         {
+            if (m_listOfSeq[i].stream)
+                releaseStream(*m_listOfSeq[i].stream);
             removeTimestepProvider(seq);
             for (unsigned int n = i; n < m_listOfSeq.size() - 1; n++)
                 m_listOfSeq[n] = m_listOfSeq[n + 1];
@@ -587,6 +696,310 @@ coVRAnimationManager::addSequence(osg::Sequence *seq, coVRAnimationManager::Fill
     }
 }
 
+void
+coVRAnimationManager::addStreamingSequence(osg::Sequence *seq, int numFrames, const FrameLoader &loader, FillMode mode)
+{
+    if (m_streamThreads.empty())
+    {
+        m_streamAhead = std::max(0, coCoviseConfig::getInt("ahead", "COVER.Animation.Streaming", 4));
+        m_streamBehind = std::max(0, coCoviseConfig::getInt("behind", "COVER.Animation.Streaming", 1));
+        int numThreads = std::max(1, coCoviseConfig::getInt("loaderThreads", "COVER.Animation.Streaming", 1));
+        for (int i = 0; i < numThreads; ++i)
+            m_streamThreads.emplace_back(&coVRAnimationManager::runStreamLoader, this);
+        if (VRViewer::instance()->statsDisplay)
+            VRViewer::instance()->statsDisplay->enableStreamingStats(true);
+    }
+
+    for (auto &s: m_listOfSeq)
+    {
+        if (s.seq == seq && s.stream)
+        {
+            releaseStream(*s.stream);
+            s.stream.reset();
+        }
+    }
+
+    auto stream = std::make_shared<Stream>();
+    stream->loader = loader;
+    stream->bytes.resize(numFrames, 0);
+    stream->resident.resize(numFrames, false);
+    seq->removeChildren(0, seq->getNumChildren());
+    for (int i = 0; i < numFrames; ++i)
+    {
+        osg::ref_ptr<osg::Group> frame = new osg::Group;
+        frame->setName(seq->getName() + "_" + std::to_string(i));
+        stream->frames.push_back(frame);
+        seq->addChild(frame.get());
+    }
+
+    addSequence(seq, mode);
+    for (auto &s: m_listOfSeq)
+    {
+        if (s.seq == seq)
+        {
+            s.stream = stream;
+            makeResident(s, sequenceChild(s, m_currentAnimationFrame));
+        }
+    }
+}
+
+size_t coVRAnimationManager::getStreamingMemory() const
+{
+    return m_streamBytes;
+}
+
+float coVRAnimationManager::getPrefetchHitRate() const
+{
+    size_t total = m_prefetchHits + m_prefetchMisses;
+    if (total == 0)
+        return 1.f;
+    return float(m_prefetchHits) / total;
+}
+
+// next frame in playback direction dir as in getNextFrame, without changing the animation state
+int coVRAnimationManager::stepFrame(int frame, int &dir) const
+{
+    int start = m_startFrame, stop = std::max(m_startFrame, m_stopFrame);
+    int next = frame + dir * m_aniSkip;
+    if (animPingPongItem->getValue())
+    {
+        if (next > stop || next < start)
+        {
+            dir = -dir;
+            next = frame + dir * m_aniSkip;
+        }
+        return std::max(start, std::min(stop, next));
+    }
+
+    int len = stop - start + 1;
+    return ((next - start) % len + len) % len + start;
+}
+
+// children of seq to keep resident, most urgent first
+std::vector<int> coVRAnimationManager::streamingWindow(const Sequence &seq) const
+{
+    std::vector<int> children;
+    if (m_currentAnimationFrame < 0)
+        return children;
+
+    auto add = [&seq, &children](int frame) {
+        int child = sequenceChild(seq, frame);
+        if (child >= 0 && child < (int)seq.stream->frames.size()
+            && std::find(children.begin(), children.end(), child) == children.end())
+            children.push_back(child);
+    };
+
+    add(m_currentAnimationFrame);
+
+    int dir = m_aniDirection;
+    if (animSpeedItem->getValue() < 0.)
+        dir = -dir;
+    int frame = m_currentAnimationFrame, d = dir;
+    for (int i = 0; i < m_streamAhead; ++i)
+    {
+        frame = stepFrame(frame, d);
+        add(frame);
+    }
+    frame = m_currentAnimationFrame;
+    d = -dir;
+    for (int i = 0; i < m_streamBehind; ++i)
+    {
+        frame = stepFrame(frame, d);
+        add(frame);
+    }
+
+    return children;
+}
+
+// load child of seq on the main thread unless it has been prefetched
+bool coVRAnimationManager::makeResident(Sequence &seq, int child)
+{
+    Stream &stream = *seq.stream;
+    if (child < 0 || child >= (int)stream.frames.size())
+        return true;
+
+    if (stream.resident[child])
+    {
+        ++m_prefetchHits;
+        return true;
+    }
+    ++m_prefetchMisses;
+
+    osg::ref_ptr<osg::Node> node;
+    auto it = stream.loads.find(child);
+    if (it == stream.loads.end())
+    {
+        node = stream.loader(child);
+    }
+    else
+    {
+        auto load = it->second;
+        stream.loads.erase(it);
+        std::unique_lock<std::mutex> lock(m_streamMutex);
+        if (load->started)
+        {
+            m_streamCond.wait(lock, [load]() { return load->done; });
+            node = load->node;
+        }
+        else
+        {
+            m_streamQueue.erase(std::find(m_streamQueue.begin(), m_streamQueue.end(), load));
+            lock.unlock();
+            node = stream.loader(child);
+        }
+    }
+    if (cover->debugLevel(3))
+        std::cerr << "coVRAnimationManager: frame " << child << " of " << seq.seq->getName() << " was not prefetched" << std::endl;
+
+    attachFrame(stream, child, node.get());
+    return false;
+}
+
+void coVRAnimationManager::attachFrame(Stream &stream, int child, osg::Node *node)
+{
+    // also when loading failed, so that it is not retried in every frame
+    stream.resident[child] = true;
+    if (!node)
+    {
+        std::cerr << "coVRAnimationManager: could not load frame " << child << std::endl;
+        return;
+    }
+
+    MemoryVisitor mv;
+    node->accept(mv);
+    stream.bytes[child] = mv.bytes;
+    m_streamBytes += mv.bytes;
+    stream.frames[child]->addChild(node);
+}
+
+void coVRAnimationManager::evictFrame(Stream &stream, int child)
+{
+    stream.frames[child]->removeChildren(0, stream.frames[child]->getNumChildren());
+    m_streamBytes -= stream.bytes[child];
+    stream.bytes[child] = 0;
+    stream.resident[child] = false;
+}
+
+void coVRAnimationManager::releaseStream(Stream &stream)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_streamMutex);
+        for (auto &l: stream.loads)
+        {
+            auto it = std::find(m_streamQueue.begin(), m_streamQueue.end(), l.second);
+            if (it != m_streamQueue.end())
+                m_streamQueue.erase(it);
+        }
+    }
+    // running loads finish, but their result is dropped
+    stream.loads.clear();
+
+    for (size_t child = 0; child < stream.frames.size(); ++child)
+    {
+        if (stream.resident[child])
+            evictFrame(stream, (int)child);
+    }
+}
+
+void coVRAnimationManager::updateStreaming()
+{
+    for (auto &seq: m_listOfSeq)
+    {
+        if (!seq.stream)
+            continue;
+        Stream &stream = *seq.stream;
+
+        std::vector<int> window = streamingWindow(seq);
+        std::vector<bool> wanted(stream.frames.size(), false);
+        for (int child: window)
+            wanted[child] = true;
+
+        // take back queued loads, so that they can be queued again in the order of the window
+        std::vector<std::shared_ptr<FrameLoad> > finished;
+        {
+            std::lock_guard<std::mutex> lock(m_streamMutex);
+            for (auto it = stream.loads.begin(); it != stream.loads.end();)
+            {
+                auto load = it->second;
+                if (load->done)
+                {
+                    finished.push_back(load);
+                    it = stream.loads.erase(it);
+                    continue;
+                }
+                if (!load->started)
+                {
+                    m_streamQueue.erase(std::find(m_streamQueue.begin(), m_streamQueue.end(), load));
+                    if (!wanted[it->first])
+                    {
+                        it = stream.loads.erase(it);
+                        continue;
+                    }
+                }
+                ++it;
+            }
+        }
+
+        for (auto &load: finished)
+        {
+            if (wanted[load->frame] && !stream.resident[load->frame])
+                attachFrame(stream, load->frame, load->node.get());
+        }
+
+        int current = sequenceChild(seq, m_currentAnimationFrame);
+        for (size_t child = 0; child < stream.frames.size(); ++child)
+        {
+            if (stream.resident[child] && !wanted[child] && (int)child != current)
+                evictFrame(stream, (int)child);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_streamMutex);
+            for (int child: window)
+            {
+                if (stream.resident[child])
+                    continue;
+                auto &load = stream.loads[child];
+                if (!load)
+                {
+                    load = std::make_shared<FrameLoad>();
+                    load->loader = stream.loader;
+                    load->frame = child;
+                }
+                if (!load->started)
+                    m_streamQueue.push_back(load);
+            }
+        }
+        m_streamCond.notify_all();
+    }
+}
+
+void coVRAnimationManager::runStreamLoader()
+{
+    for (;;)
+    {
+        std::shared_ptr<FrameLoad> load;
+        {
+            std::unique_lock<std::mutex> lock(m_streamMutex);
+            m_streamCond.wait(lock, [this]() { return m_quitStreamLoaders || !m_streamQueue.empty(); });
+            if (m_quitStreamLoaders)
+                return;
+            load = m_streamQueue.front();
+            m_streamQueue.pop_front();
+            load->started = true;
+        }
+
+        osg::ref_ptr<osg::Node> node = load->loader(load->frame);
+
+        {
+            std::lock_guard<std::mutex> lock(m_streamMutex);
+            load->node = node;
+            load->done = true;
+        }
+        m_streamCond.notify_all();
+    }
+}
+
 void coVRAnimationManager::setStartFrame(int frame)
 {
     m_startFrame = frame;
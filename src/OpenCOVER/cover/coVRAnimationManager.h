@@ -35,7 +35,13 @@ class Slider;
 #include "ui/CovconfigLink.h"
 
 #include <util/coExport.h>
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <osg/Sequence>
 
@@ -61,12 +67,19 @@ public:
         Cycle, //< previous elements are repeated periodically
     };
 
+    //! creates the subgraph for one frame of a streamed sequence,
+    //! called from loader threads as well as from the main thread
+    typedef std::function<osg::ref_ptr<osg::Node>(int frame)> FrameLoader;
+
+    struct Stream; //< frame loader and resident frames of a streamed sequence
+
     struct Sequence
     {
         Sequence(osg::Sequence *seq, FillMode mode=Nothing): seq(seq), fill(mode) {}
 
         osg::ref_ptr<osg::Sequence> seq;
         FillMode fill = Nothing;
+        std::shared_ptr<Stream> stream;
     };
 
     void setNumTimesteps(int);
@@ -75,6 +88,14 @@ public:
     void addSequence(osg::Sequence *seq, FillMode mode=Nothing);
     void removeSequence(osg::Sequence *seq);
 
+    //! animate numFrames frames created by loader: seq receives an empty group per frame,
+    //! only frames close to the current frame are loaded into them, distant frames are released
+    void addStreamingSequence(osg::Sequence *seq, int numFrames, const FrameLoader &loader, FillMode mode=Nothing);
+    //! approximate size of the geometry of all resident streamed frames
+    size_t getStreamingMemory() const;
+    //! fraction of streamed frames that were resident when they were shown
+    float getPrefetchHitRate() const;
+
     const std::vector<Sequence> &getSequences() const;
 
     int getAnimationFrame() const
@@ -128,6 +149,27 @@ private:
     void setAnimationFrame(int currentFrame);
 
     void updateSequence(Sequence &seq, int currentFrame);
+    void updateSequences(int currentFrame);
+    static int sequenceChild(const Sequence &seq, int currentFrame);
+
+    // streamed sequences
+    struct FrameLoad;
+    int m_streamAhead = 0, m_streamBehind = 0; // frames kept resident around the current frame
+    bool m_quitStreamLoaders = false;
+    std::vector<std::thread> m_streamThreads;
+    std::mutex m_streamMutex;
+    std::condition_variable m_streamCond;
+    std::deque<std::shared_ptr<FrameLoad> > m_streamQueue; // not started yet
+    size_t m_streamBytes = 0;
+    size_t m_prefetchHits = 0, m_prefetchMisses = 0;
+    int stepFrame(int frame, int &dir) const;
+    std::vector<int> streamingWindow(const Sequence &seq) const;
+    bool makeResident(Sequence &seq, int child);
+    void attachFrame(Stream &stream, int child, osg::Node *node);
+    void evictFrame(Stream &stream, int child);
+    void releaseStream(Stream &stream);
+    void updateStreaming();
+    void runStreamLoader();
     std::vector<Sequence> m_listOfSeq;
     float m_animSliderMin, m_animSliderMax;
     float m_timeState;
@@ -0,0 +1,214 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#include "coVRArrayTransfer.h"
+
+#include "coVRMSController.h"
+#include "coVRPluginSupport.h"
+#include <config/CoviseConfig.h>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#include <algorithm>
+#include <iostream>
+#include <string.h>
+
+using namespace opencover;
+using covise::coCoviseConfig;
+
+namespace
+{
+
+struct Settings
+{
+    int chunkSize;
+    int compress;
+    int level;
+};
+
+// configuration of the master, read when the first object is distributed
+const Settings &settings()
+{
+    static Settings s;
+    static bool initialized = false;
+    if (!initialized)
+    {
+        initialized = true;
+        // a chunk has to fit into a single multicast message
+        int maxLength = coCoviseConfig::getInt("COVER.MultiPC.Multicast.maxLength", 1000000);
+        s.chunkSize = coCoviseConfig::getInt("chunkSize", "COVER.Plugin.COVISE.ArrayTransfer", maxLength);
+        s.chunkSize = std::max(4096, std::min(s.chunkSize, maxLength));
+        s.compress = coCoviseConfig::isOn("compress", "COVER.Plugin.COVISE.ArrayTransfer", false);
+        s.level = coCoviseConfig::getInt("level", "COVER.Plugin.COVISE.ArrayTransfer", 1);
+#ifndef HAVE_ZLIB
+        if (s.compress)
+            std::cerr << "coVRArrayTransfer: compression not available" << std::endl;
+        s.compress = 0;
+#endif
+        coVRMSController::instance()->syncData(&s, sizeof(s));
+    }
+    return s;
+}
+
+// arrays are placed at offsets suitable for any element type
+size_t aligned(size_t bytes)
+{
+    return (bytes + 15) & ~size_t(15);
+}
+
+std::vector<char> packed;
+}
+
+coVRArrayTransfer::coVRArrayTransfer()
+    : m_compress(-1)
+    , m_bytes(0)
+    , m_wireBytes(0)
+    , m_seconds(0.)
+{
+}
+
+void coVRArrayTransfer::setCompression(bool compress)
+{
+    m_compress = compress;
+#ifndef HAVE_ZLIB
+    m_compress = 0;
+#endif
+}
+
+bool coVRArrayTransfer::compress() const
+{
+    return m_compress >= 0 ? m_compress != 0 : settings().compress != 0;
+}
+
+size_t coVRArrayTransfer::bytes() const
+{
+    return m_bytes;
+}
+
+size_t coVRArrayTransfer::bytesOnWire() const
+{
+    return m_wireBytes;
+}
+
+double coVRArrayTransfer::seconds() const
+{
+    return m_seconds;
+}
+
+char *coVRArrayTransfer::transfer()
+{
+    if (!coVRMSController::instance()->isCluster() || m_arrays.empty())
+    {
+        m_arrays.clear();
+        return NULL;
+    }
+
+    double startTime = cover->currentTime();
+    m_wireBytes = 0;
+
+    size_t total = 0;
+    for (size_t i = 0; i < m_arrays.size(); ++i)
+        total += aligned(m_arrays[i].bytes);
+
+    char *buf = NULL;
+    if (coVRMSController::instance()->isMaster())
+    {
+        for (size_t i = 0; i < m_arrays.size(); ++i)
+            send(m_arrays[i].data, m_arrays[i].bytes);
+    }
+    else
+    {
+        // empty arrays get a valid pointer as well
+        buf = new char[std::max(total, size_t(1))];
+        size_t offset = 0;
+        for (size_t i = 0; i < m_arrays.size(); ++i)
+        {
+            Array &a = m_arrays[i];
+            receive(buf + offset, a.bytes);
+            a.assign(a.ref, buf + offset);
+            offset += aligned(a.bytes);
+        }
+    }
+
+    m_bytes = total;
+    m_seconds = cover->currentTime() - startTime;
+    if (cover->debugLevel(4))
+        fprintf(stderr, "coVRArrayTransfer: %d arrays, %ld bytes, %ld bytes on the wire, %.3f s\n",
+                (int)m_arrays.size(), (long)total, (long)m_wireBytes, m_seconds);
+
+    m_arrays.clear();
+    return buf;
+}
+
+void coVRArrayTransfer::send(const char *data, size_t bytes)
+{
+    const Settings &s = settings();
+    coVRMSController *ms = coVRMSController::instance();
+    for (size_t offset = 0; offset < bytes; offset += s.chunkSize)
+    {
+        int n = (int)std::min(bytes - offset, size_t(s.chunkSize));
+        char *chunk = const_cast<char *>(data + offset);
+        if (compress())
+        {
+            // length of compressed chunk, 0 if it is sent as is
+            int len = 0;
+#ifdef HAVE_ZLIB
+            uLongf packedLen = compressBound(n);
+            packed.resize(packedLen);
+            if (compress2((Bytef *)&packed[0], &packedLen, (const Bytef *)chunk, n, s.level) == Z_OK
+                && packedLen < uLongf(n))
+                len = (int)packedLen;
+#endif
+            ms->syncData(&len, sizeof(len));
+            if (len > 0)
+            {
+                ms->syncData(&packed[0], len);
+                m_wireBytes += len;
+                continue;
+            }
+        }
+        ms->syncData(chunk, n);
+        m_wireBytes += n;
+    }
+}
+
+void coVRArrayTransfer::receive(char *data, size_t bytes)
+{
+    const Settings &s = settings();
+    coVRMSController *ms = coVRMSController::instance();
+    for (size_t offset = 0; offset < bytes; offset += s.chunkSize)
+    {
+        int n = (int)std::min(bytes - offset, size_t(s.chunkSize));
+        char *chunk = data + offset;
+        if (compress())
+        {
+            int len = 0;
+            ms->syncData(&len, sizeof(len));
+            if (len > 0)
+            {
+                packed.resize(len);
+                ms->syncData(&packed[0], len);
+                m_wireBytes += len;
+#ifdef HAVE_ZLIB
+                uLongf chunkLen = n;
+                if (uncompress((Bytef *)chunk, &chunkLen, (const Bytef *)&packed[0], len) != Z_OK
+                    || chunkLen != uLongf(n))
+#endif
+                {
+                    std::cerr << "coVRArrayTransfer: could not decompress chunk of " << n << " bytes" << std::endl;
+                    memset(chunk, 0, n);
+                }
+                continue;
+            }
+        }
+        // no intermediate copy: read directly into place
+        ms->syncData(chunk, n);
+        m_wireBytes += n;
+    }
+}
@@ -0,0 +1,86 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+/*! \file
+ \brief  distribute the arrays of a render object from master to slaves
+
+ Arrays are sent after the object description, split into chunks
+ no larger than a multicast message and optionally compressed. Chunks
+ go through coVRMSController::syncData, so they use multicast or an
+ MPI broadcast if the cluster is set up for it. Slaves receive all
+ arrays of an object into one buffer and point the arrays into it.
+
+ Settings are read from COVER.Plugin.COVISE.ArrayTransfer on the master.
+ */
+
+#ifndef CO_VR_ARRAY_TRANSFER_H
+#define CO_VR_ARRAY_TRANSFER_H
+
+#include <util/coExport.h>
+
+#include <stddef.h>
+#include <vector>
+
+namespace opencover
+{
+
+class COVEREXPORT coVRArrayTransfer
+{
+public:
+    coVRArrayTransfer();
+
+    /// override configured compression, has to be called with the same value on all nodes
+    void setCompression(bool compress);
+
+    /// master: queue array of n elements for sending,
+    /// slave: let array point to the received data after transfer()
+    template <typename T>
+    void add(T *&array, size_t n)
+    {
+        Array a;
+        a.ref = &array;
+        a.data = reinterpret_cast<const char *>(array);
+        a.bytes = n * sizeof(T);
+        a.assign = &assign<T>;
+        m_arrays.push_back(a);
+    }
+
+    /// send or receive all queued arrays, on slaves the returned buffer
+    /// holds the arrays and has to be deleted with delete[]
+    char *transfer();
+
+    /// statistics of the last transfer: size of the arrays, bytes sent or received, seconds taken
+    size_t bytes() const;
+    size_t bytesOnWire() const;
+    double seconds() const;
+
+private:
+    struct Array
+    {
+        void *ref;
+        const char *data;
+        size_t bytes;
+        void (*assign)(void *ref, char *data);
+    };
+
+    template <typename T>
+    static void assign(void *ref, char *data)
+    {
+        *static_cast<T **>(ref) = reinterpret_cast<T *>(data);
+    }
+
+    bool compress() const;
+    void send(const char *data, size_t bytes);
+    void receive(char *data, size_t bytes);
+
+    std::vector<Array> m_arrays;
+    int m_compress; ///< -1: as configured
+    size_t m_bytes, m_wireBytes;
+    double m_seconds;
+};
+}
+#endif
@@ -0,0 +1,448 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#include "coVRBenchmark.h"
+#include "coVRArrayTransfer.h"
+#include "coVRPluginSupport.h"
+#include "coVRPluginProfiler.h"
+#include "coVRFileManager.h"
+#include "coVRMSController.h"
+#include "OpenCOVER.h"
+#include "VRViewer.h"
+
+#include <config/CoviseConfig.h>
+#include <osg/ClipNode>
+#include <osg/MatrixTransform>
+#include <osg/Stats>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace opencover;
+using covise::coCoviseConfig;
+
+namespace
+{
+
+// frames to wait until statistics of draw threads are complete
+const int StatsLag = 2;
+
+double getAttribute(osg::Stats *stats, int frameNumber, const std::string &name)
+{
+    double value = 0.;
+    if (stats)
+        stats->getAttribute(frameNumber, name, value);
+    return value;
+}
+
+double percentile(std::vector<double> values, double p)
+{
+    if (values.empty())
+        return 0.;
+    size_t idx = std::min(values.size() - 1, size_t(p * values.size()));
+    std::nth_element(values.begin(), values.begin() + idx, values.end());
+    return values[idx];
+}
+}
+
+coVRBenchmark *coVRBenchmark::instance()
+{
+    static coVRBenchmark *singleton = new coVRBenchmark;
+    return singleton;
+}
+
+coVRBenchmark::coVRBenchmark()
+{
+    m_reportFile = "opencover-benchmark.csv";
+}
+
+coVRBenchmark::~coVRBenchmark()
+{
+    if (m_record)
+        fclose(m_record);
+}
+
+void coVRBenchmark::setPath(const std::string &path)
+{
+    m_pathFile = path;
+}
+
+void coVRBenchmark::setNumFrames(int frames)
+{
+    m_numFrames = std::max(0, frames);
+}
+
+void coVRBenchmark::setReport(const std::string &report)
+{
+    m_reportFile = report;
+}
+
+void coVRBenchmark::setOffscreen(bool offscreen)
+{
+    m_offscreen = offscreen;
+}
+
+void coVRBenchmark::setRecordPath(const std::string &path)
+{
+    m_recordFile = path;
+}
+
+void coVRBenchmark::setTransferSize(int megabytes)
+{
+    m_transferSize = std::max(0, megabytes);
+}
+
+bool coVRBenchmark::enabled() const
+{
+    return !m_pathFile.empty();
+}
+
+bool coVRBenchmark::offscreen() const
+{
+    return m_offscreen;
+}
+
+bool coVRBenchmark::readPath()
+{
+    // scale and matrix for every frame
+    std::vector<double> values;
+    if (coVRMSController::instance()->isMaster())
+    {
+        std::ifstream in(m_pathFile);
+        if (!in)
+        {
+            std::cerr << "coVRBenchmark: cannot read camera path " << m_pathFile << std::endl;
+        }
+        std::string line;
+        int lineNum = 0;
+        while (std::getline(in, line))
+        {
+            ++lineNum;
+            if (line.empty() || line[0] == '#')
+                continue;
+            std::istringstream str(line);
+            std::vector<double> v;
+            double d;
+            while (str >> d)
+                v.push_back(d);
+            if (v.size() == 16)
+                v.insert(v.begin(), 0.);
+            if (v.size() != 17)
+            {
+                std::cerr << "coVRBenchmark: " << m_pathFile << ":" << lineNum << ": expected 16 or 17 numbers" << std::endl;
+                continue;
+            }
+            values.insert(values.end(), v.begin(), v.end());
+        }
+    }
+
+    int n = (int)values.size();
+    coVRMSController::instance()->syncData(&n, sizeof(n));
+    values.resize(n);
+    if (n > 0)
+        coVRMSController::instance()->syncData(&values[0], n * sizeof(double));
+
+    for (size_t i = 0; i + 17 <= values.size(); i += 17)
+    {
+        m_scale.push_back(values[i]);
+        m_path.emplace_back(&values[i + 1]);
+    }
+    return !m_path.empty();
+}
+
+void coVRBenchmark::benchmarkTransfer(bool compress)
+{
+    coVRMSController *ms = coVRMSController::instance();
+
+    // coordinates of a regular grid, a smooth scalar field and connectivity, like a typical render object
+    size_t n = size_t(m_transferSize) * 1024 * 1024 / (5 * sizeof(float));
+    std::vector<float> x, y, z, s;
+    std::vector<int> conn;
+    if (ms->isMaster())
+    {
+        size_t dim = std::max(size_t(1), size_t(std::cbrt(double(n))));
+        x.resize(n);
+        y.resize(n);
+        z.resize(n);
+        s.resize(n);
+        conn.resize(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            x[i] = float(i % dim);
+            y[i] = float(i / dim % dim);
+            z[i] = float(i / dim / dim);
+            s[i] = std::sin(0.1f * x[i]) * std::cos(0.1f * y[i]) + 0.01f * z[i];
+            conn[i] = int(i);
+        }
+    }
+    float *px = x.empty() ? nullptr : &x[0];
+    float *py = y.empty() ? nullptr : &y[0];
+    float *pz = z.empty() ? nullptr : &z[0];
+    float *ps = s.empty() ? nullptr : &s[0];
+    int *pconn = conn.empty() ? nullptr : &conn[0];
+
+    coVRArrayTransfer transfer;
+    transfer.setCompression(compress);
+    transfer.add(px, n);
+    transfer.add(py, n);
+    transfer.add(pz, n);
+    transfer.add(ps, n);
+    transfer.add(pconn, n);
+
+    // start together and stop when the last slave has received everything
+    ms->allReduceOr(true);
+    double start = cover->currentTime();
+    char *buf = transfer.transfer();
+    ms->allReduceOr(true);
+    double seconds = cover->currentTime() - start;
+    delete[] buf;
+
+    if (ms->isMaster())
+    {
+        double mb = transfer.bytes() / (1024. * 1024.);
+        double wire = transfer.bytesOnWire() / (1024. * 1024.);
+        fprintf(stderr, "coVRBenchmark: transfer %s: %.1f MB, %.1f MB on the wire (%.1f%%), %.3f s, %.1f MB/s\n",
+                compress ? "compressed" : "uncompressed", mb, wire, transfer.bytes() > 0 ? 100. * wire / mb : 0.,
+                seconds, seconds > 0. ? mb / seconds : 0.);
+    }
+}
+
+void coVRBenchmark::init()
+{
+    if (!m_recordFile.empty() && coVRMSController::instance()->isMaster())
+    {
+        m_record = fopen(m_recordFile.c_str(), "w");
+        if (m_record)
+            fprintf(m_record, "# scale, then matrix of scene transformation, one line per frame\n");
+        else
+            std::cerr << "coVRBenchmark: cannot record camera path to " << m_recordFile << std::endl;
+    }
+
+    coVRMSController::instance()->syncData(&m_transferSize, sizeof(m_transferSize));
+    if (m_transferSize > 0)
+    {
+        if (coVRMSController::instance()->isCluster())
+        {
+            if (coVRMSController::instance()->isMaster())
+                std::cerr << "coVRBenchmark: sending " << m_transferSize << " MB to "
+                          << coVRMSController::instance()->getNumSlaves() << " slaves, sync mode "
+                          << coCoviseConfig::getEntry("COVER.MultiPC.SyncMode") << std::endl;
+            benchmarkTransfer(false);
+            benchmarkTransfer(true);
+        }
+        else
+        {
+            std::cerr << "coVRBenchmark: transfer benchmark requires a cluster" << std::endl;
+        }
+        if (!enabled())
+            OpenCOVER::instance()->setExitFlag(true);
+    }
+
+    if (!enabled())
+        return;
+
+    m_warmup = std::max(0, coCoviseConfig::getInt("warmup", "COVER.Benchmark", 10));
+
+    m_orbit = m_pathFile == "orbit";
+    if (!m_orbit && !readPath())
+    {
+        std::cerr << "coVRBenchmark: no camera path, quitting" << std::endl;
+        m_state = Done;
+        OpenCOVER::instance()->setExitFlag(true);
+        return;
+    }
+    if (m_numFrames == 0)
+        m_numFrames = m_orbit ? 360 : (int)m_path.size();
+
+    coVRPluginProfiler::instance()->enable(true);
+
+    osgViewer::ViewerBase::Cameras cameras;
+    VRViewer::instance()->getCameras(cameras);
+    for (auto camera: cameras)
+    {
+        if (camera->getStats())
+        {
+            camera->getStats()->collectStats("rendering", true);
+            camera->getStats()->collectStats("gpu", true);
+        }
+    }
+    if (osg::Stats *stats = VRViewer::instance()->getViewerStats())
+    {
+        for (auto s: {"frame_rate", "update", "plugin", "opencover"})
+            stats->collectStats(s, true);
+    }
+
+    m_state = Loading;
+    if (cover->debugLevel(1))
+        std::cerr << "coVRBenchmark: measuring " << m_numFrames << " frames along "
+                  << (m_orbit ? std::string("orbit") : m_pathFile) << std::endl;
+}
+
+void coVRBenchmark::preFrame()
+{
+    if (m_state != WarmingUp && m_state != Measuring)
+        return;
+
+    // warm-up frames already show the first view
+    int frame = m_state == Measuring ? m_frame : 0;
+    if (m_orbit)
+    {
+        double angle = 2. * M_PI * frame / m_numFrames;
+        cover->setXformMat(m_start * osg::Matrix::translate(-m_center) * osg::Matrix::rotate(angle, osg::Vec3(0, 0, 1))
+                           * osg::Matrix::translate(m_center));
+    }
+    else
+    {
+        size_t idx = frame % m_path.size();
+        if (m_scale[idx] > 0.)
+            cover->setScale(m_scale[idx]);
+        cover->setXformMat(m_path[idx]);
+    }
+    m_frameStart = osg::Timer::instance()->tick();
+}
+
+bool coVRBenchmark::postFrame()
+{
+    if (m_record)
+    {
+        const osg::Matrix &m = cover->getXformMat();
+        fprintf(m_record, "%g", cover->getScale());
+        for (int i = 0; i < 16; ++i)
+            fprintf(m_record, " %.10g", m.ptr()[i]);
+        fprintf(m_record, "\n");
+    }
+
+    switch (m_state)
+    {
+    case Idle:
+    case Done:
+        return m_state == Done;
+
+    case Loading:
+    {
+        bool loaded = coVRFileManager::instance()->numPendingLoads() == 0;
+        if (!coVRMSController::instance()->syncBool(loaded))
+            return false;
+        if (m_orbit)
+        {
+            // rotate around center of scene
+            m_start = cover->getXformMat();
+            m_center = cover->getObjectsRoot()->getBound().center() * cover->getObjectsScale()->getMatrix() * m_start;
+            coVRMSController::instance()->syncData(m_start.ptr(), 16 * sizeof(double));
+            coVRMSController::instance()->syncData(m_center.ptr(), sizeof(m_center));
+        }
+        m_state = WarmingUp;
+        m_frame = 0;
+        return false;
+    }
+
+    case WarmingUp:
+        if (++m_frame < m_warmup)
+            return false;
+        coVRPluginProfiler::instance()->reset();
+        m_state = Measuring;
+        m_frame = 0;
+        return false;
+
+    case Measuring:
+    {
+        // viewer statistics are assigned to frame numbers, read them when the frame has been drawn
+        m_frameNumbers.push_back(VRViewer::instance()->getFrameStamp()->getFrameNumber());
+        m_samples.emplace_back();
+        m_samples.back().frame = osg::Timer::instance()->delta_m(m_frameStart, osg::Timer::instance()->tick());
+        if (m_samples.size() > StatsLag)
+            collect(m_frameNumbers[m_samples.size() - StatsLag - 1], m_samples[m_samples.size() - StatsLag - 1]);
+        if (++m_frame < m_numFrames)
+            return false;
+        m_state = Draining;
+        m_frame = 0;
+        return false;
+    }
+
+    case Draining:
+        if (++m_frame < StatsLag)
+            return false;
+        for (size_t i = m_samples.size() > StatsLag ? m_samples.size() - StatsLag : 0; i < m_samples.size(); ++i)
+            collect(m_frameNumbers[i], m_samples[i]);
+        if (coVRMSController::instance()->isMaster())
+            writeReport();
+        m_state = Done;
+        OpenCOVER::instance()->setExitFlag(true);
+        return true;
+    }
+
+    return false;
+}
+
+void coVRBenchmark::collect(int frameNumber, Sample &sample) const
+{
+    // application phase is accounted to the frame number before the viewer advances it
+    osg::Stats *stats = VRViewer::instance()->getViewerStats();
+    sample.update = getAttribute(stats, frameNumber - 1, "opencover time taken") * 1000.;
+    sample.plugin = getAttribute(stats, frameNumber - 1, "Plugin time taken") * 1000.;
+    sample.rendering = getAttribute(stats, frameNumber, "Rendering traversals time taken") * 1000.;
+
+    osgViewer::ViewerBase::Cameras cameras;
+    VRViewer::instance()->getCameras(cameras);
+    for (auto camera: cameras)
+    {
+        sample.cull += getAttribute(camera->getStats(), frameNumber, "Cull traversal time taken") * 1000.;
+        sample.draw += getAttribute(camera->getStats(), frameNumber, "Draw traversal time taken") * 1000.;
+        sample.gpu += getAttribute(camera->getStats(), frameNumber, "GPU draw time taken") * 1000.;
+    }
+}
+
+void coVRBenchmark::writeReport() const
+{
+    std::ofstream csv(m_reportFile);
+    if (!csv)
+    {
+        std::cerr << "coVRBenchmark: cannot write " << m_reportFile << std::endl;
+    }
+    else
+    {
+        csv << "frame,frame_ms,update_ms,plugin_ms,rendering_ms,cull_ms,draw_ms,gpu_ms" << std::endl;
+        for (size_t i = 0; i < m_samples.size(); ++i)
+        {
+            const Sample &s = m_samples[i];
+            csv << i << "," << s.frame << "," << s.update << "," << s.plugin << "," << s.rendering << "," << s.cull
+                << "," << s.draw << "," << s.gpu << std::endl;
+        }
+    }
+
+    std::string pluginReport = m_reportFile;
+    auto dot = pluginReport.rfind('.');
+    if (dot == std::string::npos || pluginReport.find('/', dot) != std::string::npos)
+        dot = pluginReport.length();
+    pluginReport.insert(dot, "-plugins");
+    coVRPluginProfiler::instance()->writeCsv(pluginReport);
+
+    auto print = [this](const char *name, double Sample::*member) {
+        std::vector<double> v;
+        double sum = 0.;
+        for (const auto &s: m_samples)
+        {
+            v.push_back(s.*member);
+            sum += s.*member;
+        }
+        fprintf(stderr, "  %-10s %9.3f %9.3f %9.3f %9.3f\n", name, v.empty() ? 0. : sum / v.size(), percentile(v, 0.5),
+                percentile(v, 0.95), v.empty() ? 0. : *std::max_element(v.begin(), v.end()));
+    };
+    fprintf(stderr, "coVRBenchmark: %d frames, times in ms, report in %s and %s\n", (int)m_samples.size(),
+            m_reportFile.c_str(), pluginReport.c_str());
+    fprintf(stderr, "  %-10s %9s %9s %9s %9s\n", "", "average", "median", "95%", "max");
+    print("frame", &Sample::frame);
+    print("update", &Sample::update);
+    print("plugins", &Sample::plugin);
+    print("rendering", &Sample::rendering);
+    print("cull", &Sample::cull);
+    print("draw", &Sample::draw);
+    print("gpu", &Sample::gpu);
+}
@@ -0,0 +1,112 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#ifndef COVR_BENCHMARK_H
+#define COVR_BENCHMARK_H
+
+/*! \file
+ \brief  reproducible measurement of frame times
+
+ In benchmark mode, OpenCOVER plays a camera path for a fixed number of
+ frames after the scene has been loaded, writes the times of every frame
+ and the time spent in plugins to report files and quits.
+
+ A camera path has one line per frame with the 16 elements of the
+ transformation of the scene (cover->getXformMat()), optionally preceded by
+ the scale factor. Lines starting with # are ignored. Such paths are
+ written when OpenCOVER is started with a file for recording the path.
+ The path "orbit" rotates the scene once around its center instead.
+
+ In a cluster, the distribution of arrays from the master to the slaves
+ can be measured as well: synthetic arrays of a given size are sent with
+ and without compression, bytes on the wire and time are reported.
+ */
+
+#include <util/coExport.h>
+#include <osg/Matrix>
+#include <osg/Timer>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace opencover
+{
+
+class COVEREXPORT coVRBenchmark
+{
+public:
+    static coVRBenchmark *instance();
+
+    //! play camera path from file or "orbit"
+    void setPath(const std::string &path);
+    //! number of frames to measure, the length of the path if 0
+    void setNumFrames(int frames);
+    //! file receiving frame times, plugin times go to a file with -plugins appended to its base name
+    void setReport(const std::string &report);
+    //! render into pbuffers instead of windows
+    void setOffscreen(bool offscreen);
+    //! record the camera path of an interactive session
+    void setRecordPath(const std::string &path);
+    //! measure distribution of arrays of this size in MB to cluster slaves
+    void setTransferSize(int megabytes);
+
+    bool enabled() const;
+    bool offscreen() const;
+
+    //! load path, has to be called on all cluster nodes after startup
+    void init();
+    //! set camera for the coming frame
+    void preFrame();
+    //! collect statistics of the frame that has been rendered, returns true when done
+    bool postFrame();
+
+private:
+    coVRBenchmark();
+    ~coVRBenchmark();
+
+    struct Sample
+    {
+        double frame = 0., update = 0., plugin = 0., rendering = 0., cull = 0., draw = 0., gpu = 0.;
+    };
+
+    bool readPath();
+    void benchmarkTransfer(bool compress);
+    void collect(int frameNumber, Sample &sample) const;
+    void writeReport() const;
+
+    std::string m_pathFile, m_reportFile, m_recordFile;
+    bool m_offscreen = false;
+    int m_numFrames = 0;
+    int m_transferSize = 0;
+    int m_warmup = 10;
+
+    std::vector<float> m_scale;
+    std::vector<osg::Matrix> m_path;
+    bool m_orbit = false;
+    osg::Matrix m_start;
+    osg::Vec3 m_center;
+
+    enum State
+    {
+        Idle,
+        Loading,
+        WarmingUp,
+        Measuring,
+        Draining,
+        Done
+    };
+    State m_state = Idle;
+    int m_frame = 0; // in current state
+    osg::Timer_t m_frameStart = 0;
+    std::vector<int> m_frameNumbers; // frame stamps of measured frames
+    std::vector<Sample> m_samples;
+
+    FILE *m_record = nullptr;
+};
+}
+#endif
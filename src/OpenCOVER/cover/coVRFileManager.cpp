@@ -8,6 +8,7 @@
 #include "coVRFileManager.h"
 #include "coHud.h"
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
 #include <cstring>
@@ -33,6 +34,7 @@
 #include "ui/Button.h"
 #include "ui/FileBrowser.h"
 #include "ui/Group.h"
+#include "ui/Label.h"
 #include "ui/Menu.h"
 #include "ui/Owner.h"
 #include <config/CoviseConfig.h>
@@ -330,6 +332,7 @@ struct LoadedFile: public osg::Observer
     coVRIOReader *reader = nullptr;
     coTUIFileBrowserButton *filebrowser = nullptr;
     int loadCount = 0;
+    bool async = false; // let OSG read the file in the background
 
     int numInstances() const
     {
@@ -529,6 +532,16 @@ osg::Node *LoadedFile::load()
             reader->load(filenameToLoad, fakeParent);
         }
     }
+    else if (async)
+    {
+        std::string tmpFileName = adjustedFileName;
+        if (fb)
+        {
+            tmpFileName = fb->getFilename(adjustedFileName);
+        }
+        // placeholder, receives the subgraph in coVRFileManager::attachLoads
+        node = coVRFileManager::instance()->submitLoad(tmpFileName);
+    }
     else
     {
         //fprintf(stderr, "coVRFileManager::loadFile(name=%s)   else\n", fileName);
@@ -827,6 +840,7 @@ osg::Node *coVRFileManager::loadFile(const char *fileName, coTUIFileBrowserButto
     if (covise_key)
         fe->key = covise_key;
     fe->filebrowser = fb;
+    fe->async = m_loadAsync && isRoot;
     if (!OpenCOVER::instance()->visPlugin() && !m_settings && fe->url.valid() && fe->url.isLocal())
     {
         std::cerr << "Sidecar file for " << fe->url.str() << std::endl;
@@ -930,7 +944,9 @@ osg::Node *coVRFileManager::loadFile(const char *fileName, coTUIFileBrowserButto
     {
         //VRViewer::instance()->forceCompile();
   
-		if (node)
+        if (node && fe->async && !handler && !reader)
+            OpenCOVER::instance()->hud->setText2("loading in background");
+        else if (node)
             OpenCOVER::instance()->hud->setText2("done loading");
         else
             OpenCOVER::instance()->hud->setText2("failed to load");
@@ -945,6 +961,163 @@ osg::Node *coVRFileManager::loadFile(const char *fileName, coTUIFileBrowserButto
     return node;
 }
 
+osg::Node *coVRFileManager::loadFileAsync(const char *fileName, osg::Group *parent, const char *covise_key)
+{
+    // placeholders are only filled from update()
+    m_loadAsync = m_loadGroup != nullptr;
+    auto node = loadFile(fileName, nullptr, parent, covise_key);
+    m_loadAsync = false;
+    return node;
+}
+
+struct coVRFileManager::AsyncLoad
+{
+    std::string fileName;
+    osg::ref_ptr<osgDB::ReaderWriter::Options> options;
+    osg::ref_ptr<osg::Group> placeholder;
+    osg::ref_ptr<osg::Node> node;
+    bool done = false;
+};
+
+osg::Group *coVRFileManager::submitLoad(const std::string &fileName)
+{
+    if (m_loaderThreads.empty())
+    {
+        int numThreads = std::max(1, coCoviseConfig::getInt("loaderThreads", "COVER.File", 2));
+        for (int i = 0; i < numThreads; ++i)
+            m_loaderThreads.emplace_back(&coVRFileManager::runLoader, this);
+    }
+
+    auto load = std::make_shared<AsyncLoad>();
+    load->fileName = fileName;
+    load->options = options;
+    load->placeholder = new osg::Group;
+    load->placeholder->setName(fileName);
+    m_loads.push_back(load);
+    ++m_loadsSubmitted;
+    {
+        std::lock_guard<std::mutex> lock(m_loadMutex);
+        m_loadQueue.push_back(load);
+    }
+    m_loadCond.notify_one();
+
+    updateLoadStatus();
+    return load->placeholder.get();
+}
+
+void coVRFileManager::runLoader()
+{
+    for (;;)
+    {
+        std::shared_ptr<AsyncLoad> load;
+        {
+            std::unique_lock<std::mutex> lock(m_loadMutex);
+            m_loadCond.wait(lock, [this]() { return m_quitLoaders || !m_loadQueue.empty(); });
+            if (m_quitLoaders)
+                return;
+            load = m_loadQueue.front();
+            m_loadQueue.pop_front();
+        }
+
+        osg::ref_ptr<osg::Node> node = osgDB::readNodeFile(load->fileName, load->options.get());
+        if (node)
+            node->setNodeMask(node->getNodeMask() & (~Isect::Intersection));
+
+        std::lock_guard<std::mutex> lock(m_loadMutex);
+        load->node = node;
+        load->done = true;
+    }
+}
+
+void coVRFileManager::attachLoads()
+{
+    if (m_loads.empty())
+        return;
+
+    auto ms = coVRMSController::instance();
+    while (!m_loads.empty())
+    {
+        auto load = m_loads.front();
+        bool done = false;
+        {
+            std::lock_guard<std::mutex> lock(m_loadMutex);
+            done = load->done;
+        }
+        // attach in the same frame on all cluster nodes
+        if (ms->isCluster())
+            done = ms->syncBool(ms->reduceAnd(done));
+        if (!done)
+            break;
+
+        m_loads.pop_front();
+        ++m_loadsCompleted;
+        if (!load->node)
+        {
+            std::cerr << "WARNING: Could not load file " << load->fileName << std::endl;
+            continue;
+        }
+        // not referenced from anywhere else if the file was unloaded meanwhile
+        if (load->placeholder->referenceCount() <= 1)
+            continue;
+        if (load->node->getName().empty())
+            load->node->setName(load->placeholder->getName());
+        load->placeholder->addChild(load->node.get());
+        VRRegisterSceneGraph::instance()->registerNode(load->node.get(), load->placeholder->getName());
+        if (cover->debugLevel(3))
+            std::cerr << "coVRFileManager::attachLoads info: attached " << load->fileName << std::endl;
+    }
+
+    if (m_loads.empty())
+    {
+        OpenCOVER::instance()->hud->setText2("done loading");
+        OpenCOVER::instance()->hud->redraw();
+    }
+    updateLoadStatus();
+}
+
+void coVRFileManager::cancelLoads()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_loadMutex);
+        m_loadQueue.clear();
+    }
+    // loads already running complete, but their result is dropped
+    m_loads.clear();
+    updateLoadStatus();
+
+    OpenCOVER::instance()->hud->setText2("loading canceled");
+    OpenCOVER::instance()->hud->redraw();
+}
+
+int coVRFileManager::numPendingLoads() const
+{
+    return int(m_loads.size());
+}
+
+float coVRFileManager::loadProgress() const
+{
+    if (m_loadsSubmitted == 0)
+        return 1.f;
+    return float(m_loadsCompleted) / float(m_loadsSubmitted);
+}
+
+void coVRFileManager::updateLoadStatus()
+{
+    if (m_loads.empty())
+    {
+        m_loadsSubmitted = m_loadsCompleted = 0;
+        if (m_loadGroup)
+            m_loadGroup->setVisible(false);
+        return;
+    }
+
+    if (!m_loadGroup)
+        return;
+    m_loadGroup->setVisible(true);
+    m_loadLabel->setText("Loading " + getFileName(m_loads.front()->fileName) + " ("
+                         + std::to_string(m_loadsCompleted + 1) + " of " + std::to_string(m_loadsSubmitted) + ")");
+}
+
 osg::Node *coVRFileManager::replaceFile(const char *fileName, coTUIFileBrowserButton *fb, osg::Group *parent, const char *covise_key)
 {
     return loadFile(fileName, fb, parent, covise_key);
@@ -1189,8 +1362,12 @@ coVRFileManager::coVRFileManager()
         if(cover->fileMenu)
         {
           cover->fileMenu->add(fileOpen);
-          fileOpen->setCallback([this](const std::string &file){
-                  loadFile(file.c_str());
+          bool async = coCoviseConfig::isOn("async", "COVER.File", false);
+          fileOpen->setCallback([this, async](const std::string &file){
+                  if (async)
+                      loadFileAsync(file.c_str());
+                  else
+                      loadFile(file.c_str());
           });
           m_sharedFiles.setUpdateFunction([this](void) {loadPartnerFiles(); });
           m_fileGroup = new ui::Group("LoadedFiles", m_owner.get());
@@ -1204,6 +1381,17 @@ coVRFileManager::coVRFileManager()
                   reloadFile();
           });
 
+          m_loadGroup = new ui::Group("BackgroundLoading", m_owner.get());
+          m_loadGroup->setText("Loading");
+          cover->fileMenu->add(m_loadGroup);
+          m_loadLabel = new ui::Label(m_loadGroup, "LoadStatus");
+          m_cancelLoads = new ui::Action(m_loadGroup, "CancelLoading");
+          m_cancelLoads->setText("Cancel loading");
+          m_cancelLoads->setCallback([this](){
+                  cancelLoads();
+          });
+          m_loadGroup->setVisible(false);
+
           auto fileSave = new ui::FileBrowser("SaveFile", m_owner.get(), true);
           fileSave->setText("Save");
           fileSave->setFilter(getWriteFilterList());
@@ -1281,6 +1469,15 @@ coVRFileManager::~coVRFileManager()
 
     cover->getUpdateManager()->remove(this);
 
+    {
+        std::lock_guard<std::mutex> lock(m_loadMutex);
+        m_quitLoaders = true;
+        m_loadQueue.clear();
+    }
+    m_loadCond.notify_all();
+    for (auto &t: m_loaderThreads)
+        t.join();
+
     s_instance = NULL;
 }
 
@@ -1885,6 +2082,8 @@ std::string coVRFileManager::getViewPointFile()
 
 bool coVRFileManager::update()
 {
+    attachLoads();
+
     for (ReadOperations::iterator op = this->readOperations.begin(); op != this->readOperations.end(); ++op)
     {
         std::string reader = op->first;
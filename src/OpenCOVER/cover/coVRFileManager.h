@@ -21,14 +21,18 @@
  */
 
 #include <util/coExport.h>
+#include <condition_variable>
+#include <deque>
 #include <list>
 #include <limits.h>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <osg/ref_ptr>
 #include <osg/Texture2D>
 #include <osgDB/ReadFile>
 #include <string>
+#include <thread>
 #include <vector>
 #include <vrb/client/SharedState.h>
 #include <OpenVRUI/coUpdateManager.h>
@@ -58,6 +62,8 @@ namespace ui
 class Owner;
 class Group;
 class FileBrowser;
+class Label;
+class Action;
 }
 
 class coTUIFileBrowserButton;
@@ -147,6 +153,19 @@ public:
     // load a OSG or VRML97 or other (via plugin) file
     osg::Node *loadFile(const char *file, coTUIFileBrowserButton *fb = NULL, osg::Group *parent = NULL, const char *covise_key = "");
 
+    // load a file, files read by OSG are loaded in the background:
+    // returns a placeholder which receives the subgraph when loading has completed
+    osg::Node *loadFileAsync(const char *file, osg::Group *parent = NULL, const char *covise_key = "");
+
+    // number of files which are still being loaded in the background
+    int numPendingLoads() const;
+
+    // fraction of the files loaded in the background since loading started which have been completed
+    float loadProgress() const;
+
+    // stop loading files in the background, placeholders remain empty
+    void cancelLoads();
+
     // replace the last loaded Performer or VRML97 file
     osg::Node *replaceFile(const char *file, coTUIFileBrowserButton *fb = NULL, osg::Group *parent = NULL, const char *covise_key = "");
 
@@ -270,6 +289,24 @@ private:
     typedef std::map<std::string, std::list<IOReadOperation> > ReadOperations;
     ReadOperations readOperations;
 
+    // file read by OSG in the background
+    struct AsyncLoad;
+    bool m_loadAsync = false; // load files in the background from within loadFileAsync
+    bool m_quitLoaders = false;
+    std::vector<std::thread> m_loaderThreads;
+    std::mutex m_loadMutex;
+    std::condition_variable m_loadCond;
+    std::deque<std::shared_ptr<AsyncLoad> > m_loadQueue; // not started yet
+    std::deque<std::shared_ptr<AsyncLoad> > m_loads; // not attached yet, in submission order
+    int m_loadsSubmitted = 0, m_loadsCompleted = 0;
+    ui::Group *m_loadGroup = nullptr;
+    ui::Label *m_loadLabel = nullptr;
+    ui::Action *m_cancelLoads = nullptr;
+    osg::Group *submitLoad(const std::string &fileName);
+    void runLoader();
+    void attachLoads();
+    void updateLoadStatus();
+
     coVRFileManager();
     LoadedFile *m_lastFile = nullptr;
     LoadedFile *m_loadingFile = nullptr;
@@ -12,6 +12,7 @@
 #include "coVRPluginList.h"
 #include "coVRPluginSupport.h"
 #include "coVRPlugin.h"
+#include "coVRPluginProfiler.h"
 #include "coVRSelectionManager.h"
 #include "RenderObject.h"
 #include "coVRMSController.h"
@@ -52,6 +53,18 @@ typedef opencover::coVRPlugin *(coVRPluginInitFunc)();
         }                                                                                                  \
     }
 
+// do something for all plugins, measure time per plugin if profiling
+#define DOALL_PROFILED(phase, something)                                                                   \
+    {                                                                                                      \
+        coVRPluginProfiler *profiler = coVRPluginProfiler::instance();                                     \
+        if (!profiler->enabled())                                                                          \
+            DOALL(something)                                                                               \
+        else                                                                                               \
+            DOALL(osg::Timer_t begin = osg::Timer::instance()->tick();                                     \
+                  something;                                                                               \
+                  profiler->record(plugin, phase, begin, osg::Timer::instance()->tick()))                  \
+    }
+
 coVRPlugin *coVRPluginList::loadPlugin(const char *name, bool showErrors)
 {
     if (cover->debugLevel(3))
@@ -445,7 +458,9 @@ bool coVRPluginList::update() const
 #ifdef DOTIMING
     MARK0("COVER calling update for all plugins");
 #endif
-    DOALL(ret |= plugin->update());
+    if (coVRPluginProfiler::instance()->enabled())
+        coVRPluginProfiler::instance()->frame();
+    DOALL_PROFILED(coVRPluginProfiler::Update, ret |= plugin->update());
 #ifdef DOTIMING
     MARK0("done");
 #endif
@@ -459,7 +474,7 @@ void coVRPluginList::preFrame()
 #endif
     unloadQueued();
 
-    DOALL(plugin->preFrame());
+    DOALL_PROFILED(coVRPluginProfiler::PreFrame, plugin->preFrame());
 #ifdef DOTIMING
     MARK0("done");
 #endif
@@ -507,7 +522,7 @@ void coVRPluginList::postFrame() const
     MARK0("COVER calling postFrame for all plugins");
 #endif
 
-    DOALL(plugin->postFrame());
+    DOALL_PROFILED(coVRPluginProfiler::PostFrame, plugin->postFrame());
 #ifdef DOTIMING
     MARK0("done");
 #endif
@@ -515,7 +530,7 @@ void coVRPluginList::postFrame() const
 
 void coVRPluginList::preDraw(osg::RenderInfo &renderInfo) const
 {
-    DOALL(plugin->preDraw(renderInfo));
+    DOALL_PROFILED(coVRPluginProfiler::PreDraw, plugin->preDraw(renderInfo));
 }
 
 void coVRPluginList::preSwapBuffers(int windowNumber) const
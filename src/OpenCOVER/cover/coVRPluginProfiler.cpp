@@ -0,0 +1,227 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#include "coVRPluginProfiler.h"
+#include "coVRPlugin.h"
+
+#include <config/CoviseConfig.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+using namespace opencover;
+using covise::coCoviseConfig;
+
+coVRPluginProfiler *coVRPluginProfiler::instance()
+{
+    static coVRPluginProfiler *singleton = new coVRPluginProfiler;
+    return singleton;
+}
+
+coVRPluginProfiler::coVRPluginProfiler()
+    : m_mainThread(std::this_thread::get_id())
+    , m_start(osg::Timer::instance()->tick())
+{
+    m_configured = coCoviseConfig::isOn("COVER.PluginProfiler", false);
+    m_numFrames = std::max(1, coCoviseConfig::getInt("frames", "COVER.PluginProfiler", 300));
+    m_maxEvents = std::max(0, coCoviseConfig::getInt("traceEvents", "COVER.PluginProfiler", 100000));
+    m_csvFile = coCoviseConfig::getEntry("csv", "COVER.PluginProfiler", "opencover-plugins.csv");
+    m_traceFile = coCoviseConfig::getEntry("trace", "COVER.PluginProfiler", "opencover-plugins.json");
+    m_enabled = m_configured;
+}
+
+const char *coVRPluginProfiler::phaseName(Phase phase)
+{
+    switch (phase)
+    {
+    case Update:
+        return "update";
+    case PreFrame:
+        return "preFrame";
+    case PostFrame:
+        return "postFrame";
+    case PreDraw:
+        return "preDraw";
+    case NumPhases:
+        break;
+    }
+    return "unknown";
+}
+
+void coVRPluginProfiler::enable(bool state)
+{
+    m_enabled = state || m_configured;
+}
+
+int coVRPluginProfiler::index(const coVRPlugin *plugin)
+{
+    auto it = m_index.find(plugin->getName());
+    if (it != m_index.end())
+        return it->second;
+
+    int idx = (int)m_plugins.size();
+    m_index[plugin->getName()] = idx;
+    m_plugins.emplace_back();
+    m_plugins.back().name = plugin->getName();
+    for (int p = 0; p < NumPhases; ++p)
+        m_plugins.back().phase[p].frames.resize(m_numFrames, 0.f);
+    return idx;
+}
+
+void coVRPluginProfiler::record(const coVRPlugin *plugin, Phase phase, osg::Timer_t begin, osg::Timer_t end)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    int idx = index(plugin);
+    m_plugins[idx].phase[phase].current += (float)osg::Timer::instance()->delta_m(begin, end);
+
+    if (m_maxEvents == 0)
+        return;
+    if (m_events.size() < m_maxEvents)
+        m_events.emplace_back();
+    Event &ev = m_events[m_numEvents % m_maxEvents];
+    ev.plugin = idx;
+    ev.phase = phase;
+    ev.begin = begin;
+    ev.end = end;
+    ev.mainThread = std::this_thread::get_id() == m_mainThread;
+    ++m_numEvents;
+}
+
+void coVRPluginProfiler::frame()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    size_t slot = m_frame % m_numFrames;
+    for (auto &plugin: m_plugins)
+    {
+        for (int p = 0; p < NumPhases; ++p)
+        {
+            History &h = plugin.phase[p];
+            h.frames[slot] = h.current;
+            h.maxEver = std::max(h.maxEver, (double)h.current);
+            h.current = 0.f;
+        }
+    }
+    ++m_frame;
+}
+
+void coVRPluginProfiler::reset()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_plugins.clear();
+    m_index.clear();
+    m_events.clear();
+    m_numEvents = 0;
+    m_frame = 0;
+    m_start = osg::Timer::instance()->tick();
+}
+
+std::vector<coVRPluginProfiler::Summary> coVRPluginProfiler::summary() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::vector<Summary> result;
+    size_t n = std::min(m_frame, m_numFrames);
+    if (n == 0)
+        return result;
+
+    for (const auto &plugin: m_plugins)
+    {
+        Summary s;
+        s.plugin = plugin.name;
+        s.total = 0.;
+        s.histogram.resize(NumBins, 0);
+        std::vector<float> sum(n, 0.f);
+        for (int p = 0; p < NumPhases; ++p)
+        {
+            const History &h = plugin.phase[p];
+            double total = 0., max = 0.;
+            for (size_t i = 0; i < n; ++i)
+            {
+                total += h.frames[i];
+                max = std::max(max, (double)h.frames[i]);
+                sum[i] += h.frames[i];
+            }
+            s.average[p] = total / n;
+            s.max[p] = max;
+            s.total += s.average[p];
+        }
+        for (size_t i = 0; i < n; ++i)
+        {
+            int bin = 0;
+            for (double bound = MinBin * 0.001; bin < NumBins - 1 && sum[i] >= bound; bound *= 2.)
+                ++bin;
+            ++s.histogram[bin];
+        }
+        result.push_back(s);
+    }
+
+    std::sort(result.begin(), result.end(), [](const Summary &a, const Summary &b) { return a.total > b.total; });
+    return result;
+}
+
+bool coVRPluginProfiler::writeCsv(const std::string &filename) const
+{
+    std::ofstream csv(filename);
+    if (!csv)
+    {
+        std::cerr << "coVRPluginProfiler: cannot write " << filename << std::endl;
+        return false;
+    }
+
+    auto plugins = summary();
+    csv << "plugin,phase,average_ms,max_ms";
+    for (int b = 0; b < NumBins - 1; ++b)
+        csv << ",<" << MinBin * (1 << b) << "us";
+    csv << ",more" << std::endl;
+    for (const auto &s: plugins)
+    {
+        for (int p = 0; p < NumPhases; ++p)
+            csv << s.plugin << "," << phaseName(Phase(p)) << "," << s.average[p] << "," << s.max[p] << std::endl;
+        csv << s.plugin << ",total," << s.total << ",";
+        for (int b = 0; b < NumBins; ++b)
+            csv << "," << s.histogram[b];
+        csv << std::endl;
+    }
+    return true;
+}
+
+bool coVRPluginProfiler::writeTrace(const std::string &filename) const
+{
+    std::ofstream trace(filename);
+    if (!trace)
+    {
+        std::cerr << "coVRPluginProfiler: cannot write " << filename << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    osg::Timer *timer = osg::Timer::instance();
+    size_t first = m_numEvents > m_events.size() ? m_numEvents - m_events.size() : 0;
+    trace << "[" << std::endl;
+    for (size_t i = first; i < m_numEvents; ++i)
+    {
+        const Event &ev = m_events[i % m_events.size()];
+        trace << "{\"name\":\"" << m_plugins[ev.plugin].name << "\",\"cat\":\"" << phaseName(ev.phase)
+              << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << (ev.mainThread ? 1 : 2)
+              << ",\"ts\":" << timer->delta_u(m_start, ev.begin) << ",\"dur\":" << timer->delta_u(ev.begin, ev.end) << "}";
+        if (i + 1 < m_numEvents)
+            trace << ",";
+        trace << std::endl;
+    }
+    trace << "]" << std::endl;
+    return true;
+}
+
+void coVRPluginProfiler::save() const
+{
+    if (writeCsv(m_csvFile) && writeTrace(m_traceFile))
+        std::cerr << "coVRPluginProfiler: saved to " << m_csvFile << " and " << m_traceFile << std::endl;
+}
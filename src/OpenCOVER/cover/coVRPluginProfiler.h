@@ -0,0 +1,130 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#ifndef COVR_PLUGIN_PROFILER_H
+#define COVR_PLUGIN_PROFILER_H
+
+/*! \file
+ \brief  time spent by plugins in the phases of a frame
+
+ coVRPluginList measures every plugin call of update, preFrame,
+ postFrame and preDraw while profiling is enabled. The profiler keeps the
+ time per frame for a configurable number of recent frames, from which
+ averages, maxima and histograms are derived, and the individual calls for
+ writing a Chrome trace (chrome://tracing, Perfetto).
+ */
+
+#include <util/coExport.h>
+#include <osg/Timer>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace opencover
+{
+class coVRPlugin;
+
+class COVEREXPORT coVRPluginProfiler
+{
+public:
+    enum Phase
+    {
+        Update,
+        PreFrame,
+        PostFrame,
+        PreDraw,
+        NumPhases // keep last
+    };
+
+    //! upper bounds of histogram bins are MinBin*2^i microseconds, the last bin is unbounded
+    enum
+    {
+        MinBin = 8,
+        NumBins = 18
+    };
+
+    struct Summary
+    {
+        std::string plugin;
+        double average[NumPhases]; // ms per frame
+        double max[NumPhases]; // ms, maximum within history
+        double total; // ms per frame, all phases
+        std::vector<int> histogram; // frames per bin, all phases
+    };
+
+    static coVRPluginProfiler *instance();
+    static const char *phaseName(Phase phase);
+
+    //! cheap enough to be checked for every call
+    bool enabled() const
+    {
+        return m_enabled;
+    }
+    //! profiling is always on if configured, otherwise only while statistics are shown
+    void enable(bool state);
+
+    //! account time between begin and end to plugin, may be called from draw threads
+    void record(const coVRPlugin *plugin, Phase phase, osg::Timer_t begin, osg::Timer_t end);
+    //! start a new frame in the history
+    void frame();
+    //! forget everything recorded so far
+    void reset();
+
+    //! per plugin statistics over history, most expensive first
+    std::vector<Summary> summary() const;
+
+    //! write statistics and histograms as comma separated values
+    bool writeCsv(const std::string &filename) const;
+    //! write recorded calls in Chrome trace event format
+    bool writeTrace(const std::string &filename) const;
+    //! write CSV and trace to the configured files
+    void save() const;
+
+private:
+    coVRPluginProfiler();
+
+    struct Event
+    {
+        int plugin;
+        Phase phase;
+        osg::Timer_t begin, end;
+        bool mainThread;
+    };
+
+    struct History
+    {
+        std::vector<float> frames; // ms per frame, ring buffer
+        float current = 0.f; // ms in frame which is being recorded
+        double maxEver = 0.;
+    };
+
+    struct Plugin
+    {
+        std::string name;
+        History phase[NumPhases];
+    };
+
+    int index(const coVRPlugin *plugin);
+
+    bool m_configured = false;
+    bool m_enabled = false;
+    mutable std::mutex m_mutex;
+    std::thread::id m_mainThread;
+    osg::Timer_t m_start;
+    size_t m_numFrames; // length of history
+    size_t m_frame = 0; // frames recorded
+    std::vector<Plugin> m_plugins;
+    std::map<std::string, int> m_index;
+    std::vector<Event> m_events; // ring buffer
+    size_t m_maxEvents, m_numEvents = 0;
+    std::string m_csvFile, m_traceFile;
+};
+}
+#endif
@@ -15,6 +15,7 @@
 #include "coVRPluginList.h"
 #include "coVRPlugin.h"
 #include "coVRMSController.h"
+#include "coVRFileManager.h"
 
 #include <OpenConfig/file.h>
 #include <OpenVRUI/coUpdateManager.h>
@@ -647,6 +648,27 @@ int coVRPluginSupport::removePlugin(const char *name)
     return 0;
 }
 
+osg::Node *coVRPluginSupport::loadFileAsync(const char *file, osg::Group *parent)
+{
+    START("coVRPluginSupport::loadFileAsync");
+    return coVRFileManager::instance()->loadFileAsync(file, parent);
+}
+
+int coVRPluginSupport::getNumPendingLoads() const
+{
+    return coVRFileManager::instance()->numPendingLoads();
+}
+
+float coVRPluginSupport::getLoadProgress() const
+{
+    return coVRFileManager::instance()->loadProgress();
+}
+
+void coVRPluginSupport::cancelLoads()
+{
+    coVRFileManager::instance()->cancelLoads();
+}
+
 const osg::Matrix &coVRPluginSupport::getInvBaseMat() const
 {
     START("coVRPluginSupport::getInvBaseMat");
@@ -358,6 +358,20 @@ public:
     //! remove a plugin by name
     int removePlugin(const char *name);
 
+    //! load a file, files read by OSG are loaded in the background
+    /*! returns a placeholder which receives the loaded subgraph
+       * at the beginning of a later frame */
+    osg::Node *loadFileAsync(const char *file, osg::Group *parent = NULL);
+
+    //! number of files which are still being loaded in the background
+    int getNumPendingLoads() const;
+
+    //! fraction of background loads which have completed, between 0 and 1
+    float getLoadProgress() const;
+
+    //! stop loading files in the background
+    void cancelLoads();
+
     //! informs other plugins that this plugin extended the scene graph
     void addedNode(osg::Node *node, coVRPlugin *myPlugin);
 
@@ -21,6 +21,7 @@
 #include <sstream>
 #include <iomanip>
 #include <limits>
+#include <algorithm>
 #include <cstdio>
 
 #include <osg/io_utils>
@@ -35,6 +36,7 @@
 #include <osg/Geometry>
 #include "coVRStatsDisplay.h"
 #include "coVRFileManager.h"
+#include "coVRPluginProfiler.h"
 #include <config/CoviseConfig.h>
 #include <osg/Version>
 
@@ -251,6 +253,8 @@ void coVRStatsDisplay::showStats(int whichStats, osgViewer::ViewerBase *viewer)
 
     viewer->getViewerStats()->collectStats("scene", false);
 
+    coVRPluginProfiler::instance()->enable(_statsType == PLUGIN_STATS);
+
     _camera->setNodeMask(0x0);
     _switch->setAllChildrenOff();
     switch (_statsType)
@@ -259,6 +263,15 @@ void coVRStatsDisplay::showStats(int whichStats, osgViewer::ViewerBase *viewer)
     {
         break;
     }
+    case (PLUGIN_STATS):
+    {
+        viewer->getViewerStats()->collectStats("frame_rate", true);
+
+        _camera->setNodeMask(0xffffffff);
+        _switch->setValue(_frameRateChildNum, true);
+        _switch->setValue(_pluginChildNum, true);
+        break;
+    }
     case (VIEWER_SCENE_STATS):
     {
         _camera->setNodeMask(0xffffffff);
@@ -345,6 +358,11 @@ void coVRStatsDisplay::showStats(int whichStats, osgViewer::ViewerBase *viewer)
             _switch->setValue(_rhrSkippedChildNum, true);
             _switch->setValue(_threadingModelChildNum, true);
         }
+        if (_streamingStats)
+        {
+            _switch->setValue(_streamingMemChildNum, true);
+            _switch->setValue(_streamingHitsChildNum, true);
+        }
     }
     default:
         break;
@@ -362,6 +380,11 @@ void coVRStatsDisplay::enableRhrStats(bool enable)
     _rhrStats = enable;
 }
 
+void coVRStatsDisplay::enableStreamingStats(bool enable)
+{
+    _streamingStats = enable;
+}
+
 void coVRStatsDisplay::enableFinishStats(bool enable)
 {
     _finishStats = enable;
@@ -704,6 +727,92 @@ struct ViewSceneStatsTextDrawCallback : public virtual osg::Drawable::DrawCallba
     int _viewNumber;
 };
 
+// plugin profile, shared by the columns of the plugin page
+struct PluginProfile : public osg::Referenced
+{
+    PluginProfile()
+        : _tickLastUpdated(0)
+    {
+    }
+
+    const std::vector<coVRPluginProfiler::Summary> &get()
+    {
+        osg::Timer_t tick = osg::Timer::instance()->tick();
+        if (osg::Timer::instance()->delta_m(_tickLastUpdated, tick) > 500) // update every 500ms
+        {
+            _tickLastUpdated = tick;
+            _summary = coVRPluginProfiler::instance()->summary();
+        }
+        return _summary;
+    }
+
+    std::vector<coVRPluginProfiler::Summary> _summary;
+    osg::Timer_t _tickLastUpdated;
+};
+
+struct PluginStatsTextDrawCallback : public virtual osg::Drawable::DrawCallback
+{
+    enum
+    {
+        Name = -2,
+        Histogram = -1
+    };
+
+    PluginStatsTextDrawCallback(PluginProfile *profile, int column, int maxPlugins)
+        : _profile(profile)
+        , _column(column)
+        , _maxPlugins(maxPlugins)
+    {
+    }
+
+    /** do customized draw code.*/
+    virtual void drawImplementation(osg::RenderInfo &renderInfo, const osg::Drawable *drawable) const
+    {
+        osgText::Text *text = (osgText::Text *)drawable;
+
+        const auto &summary = _profile->get();
+        std::ostringstream str;
+        str.setf(std::ios::fixed);
+        str.precision(2);
+        if (_column == Name)
+            str << "Plugin";
+        else if (_column == Histogram)
+            str << "Histogram (8us..1s)";
+        else
+            str << coVRPluginProfiler::phaseName(coVRPluginProfiler::Phase(_column)) << " avg/max ms";
+        str << std::endl;
+
+        for (int i = 0; i < (int)summary.size() && i < _maxPlugins; ++i)
+        {
+            const auto &s = summary[i];
+            if (_column == Name)
+            {
+                str << s.plugin;
+            }
+            else if (_column == Histogram)
+            {
+                // one character per bin, density relative to the fullest bin
+                static const char levels[] = " .:-=+*#";
+                int max = *std::max_element(s.histogram.begin(), s.histogram.end());
+                for (int count: s.histogram)
+                    str << levels[max > 0 ? (count * (int)(sizeof(levels) - 2) + max - 1) / max : 0];
+            }
+            else
+            {
+                str << s.average[_column] << " / " << s.max[_column];
+            }
+            str << std::endl;
+        }
+
+        text->setText(str.str(), osgText::String::ENCODING_UTF8);
+        text->drawImplementation(renderInfo);
+    }
+
+    osg::ref_ptr<PluginProfile> _profile;
+    int _column;
+    int _maxPlugins;
+};
+
 struct BlockDrawCallback : public virtual osg::Drawable::DrawCallback
 {
     BlockDrawCallback(coVRStatsDisplay *statsHandler, float xPos, osg::Stats *viewerStats, osg::Stats *stats, const std::string &beginName, const std::string &endName, int frameDelta, int numFrames)
@@ -1855,6 +1964,72 @@ void coVRStatsDisplay::setUpScene(osgViewer::ViewerBase *viewer)
         pos.x() += space;
     }
 
+    // memory of streamed animation frames
+    {
+        osg::Geode *geode = new osg::Geode();
+        _streamingMemChildNum = _switch->getNumChildren();
+        _switch->addChild(geode, false);
+
+        osg::ref_ptr<osgText::Text> label = new osgText::Text;
+        geode->addDrawable(label.get());
+
+        label->setColor(colorFR);
+        label->setFont(font);
+        label->setCharacterSize(characterSize);
+        label->setPosition(pos);
+        label->setText("Timesteps MB:X", osgText::String::ENCODING_UTF8);
+        pos.x() = label->getBound().xMax();
+        label->setText("Timesteps MB: ", osgText::String::ENCODING_UTF8);
+
+        osg::ref_ptr<osgText::Text> value = new osgText::Text;
+        geode->addDrawable(value.get());
+
+        value->setColor(colorFR);
+        value->setFont(font);
+        value->setCharacterSize(characterSize);
+        value->setPosition(pos);
+        value->setText("7777.77", osgText::String::ENCODING_UTF8);
+
+        auto cb = new AveragedValueTextDrawCallback(viewer->getViewerStats(), "Streaming resident bytes", AccumNewest, 1./1024/1024);
+        value->setDrawCallback(cb);
+
+        pos.x() = value->getBound().xMax();
+        pos.x() += space;
+    }
+
+    // timesteps that had been prefetched when they were shown
+    {
+        osg::Geode *geode = new osg::Geode();
+        _streamingHitsChildNum = _switch->getNumChildren();
+        _switch->addChild(geode, false);
+
+        osg::ref_ptr<osgText::Text> label = new osgText::Text;
+        geode->addDrawable(label.get());
+
+        label->setColor(colorFR);
+        label->setFont(font);
+        label->setCharacterSize(characterSize);
+        label->setPosition(pos);
+        label->setText("Prefetched %:X", osgText::String::ENCODING_UTF8);
+        pos.x() = label->getBound().xMax();
+        label->setText("Prefetched %: ", osgText::String::ENCODING_UTF8);
+
+        osg::ref_ptr<osgText::Text> value = new osgText::Text;
+        geode->addDrawable(value.get());
+
+        value->setColor(colorFR);
+        value->setFont(font);
+        value->setCharacterSize(characterSize);
+        value->setPosition(pos);
+        value->setText("100.00", osgText::String::ENCODING_UTF8);
+
+        auto cb = new AveragedValueTextDrawCallback(viewer->getViewerStats(), "Streaming prefetch hits", AccumAverage, 1.);
+        value->setDrawCallback(cb);
+
+        pos.x() = value->getBound().xMax();
+        pos.x() += space;
+    }
+
     // next line
     pos.y() -= characterSize * 1.5f;
 
@@ -1863,6 +2038,7 @@ void coVRStatsDisplay::setUpScene(osgViewer::ViewerBase *viewer)
     osg::Vec4 dynamicTextColor(1.0, 1.0, 1.0f, 1.0);
     float backgroundMargin = 5;
     float backgroundSpacing = 3;
+    osg::Vec3 pluginPos = pos;
 
 #define ADDBLOCK(viewerStats, stats, text, prefix, color) \
     { \
@@ -2338,6 +2514,47 @@ void coVRStatsDisplay::setUpScene(osgViewer::ViewerBase *viewer)
             viewCounter++;
         }
     }
+
+    // Per plugin time spent in frame phases
+    {
+        pos = pluginPos;
+        pos.y() -= characterSize + backgroundMargin;
+
+        osg::Geode *geode = new osg::Geode();
+        geode->setCullingActive(false);
+        _pluginChildNum = _switch->getNumChildren();
+        _switch->addChild(geode, false);
+
+        int maxPlugins = covise::coCoviseConfig::getInt("maxPlugins", "COVER.Stats", 30);
+        osg::ref_ptr<PluginProfile> profile = new PluginProfile;
+        std::vector<std::pair<int, float> > columns;
+        columns.emplace_back(PluginStatsTextDrawCallback::Name, 10 * characterSize);
+        for (int p = 0; p < coVRPluginProfiler::NumPhases; ++p)
+            columns.emplace_back(p, 8 * characterSize);
+        columns.emplace_back(PluginStatsTextDrawCallback::Histogram, 10 * characterSize);
+
+        float width = 0.f;
+        for (const auto &c: columns)
+            width += c.second + backgroundSpacing;
+        geode->addDrawable(createBackgroundRectangle(pos + osg::Vec3(-backgroundMargin, characterSize + backgroundMargin, 0),
+                                                     width + 2 * backgroundMargin,
+                                                     (maxPlugins + 1) * characterSize + 2 * backgroundMargin,
+                                                     backgroundColor));
+
+        for (const auto &c: columns)
+        {
+            osgText::Text *text = new osgText::Text;
+            geode->addDrawable(text);
+
+            text->setColor(c.first == PluginStatsTextDrawCallback::Name ? staticTextColor : dynamicTextColor);
+            text->setFont(font);
+            text->setCharacterSize(characterSize);
+            text->setPosition(pos);
+            text->setDrawCallback(new PluginStatsTextDrawCallback(profile.get(), c.first, maxPlugins));
+
+            pos.x() += c.second + backgroundSpacing;
+        }
+    }
 }
 
 osg::Node *coVRStatsDisplay::createCameraTimeStats(const std::string &font, osg::Vec3 &pos, float startBlocks, bool acquireGPUStats, float characterSize, osg::Stats *viewerStats, osg::Camera *camera)
@@ -34,7 +34,8 @@ public:
         VIEWER_STATS = 2,
         CAMERA_SCENE_STATS = 3,
         VIEWER_SCENE_STATS = 4,
-        LAST = 5
+        PLUGIN_STATS = 5,
+        LAST = 6
     };
 
     double getBlockMultiplier() const
@@ -57,6 +58,7 @@ public:
 
     void enableGpuStats(bool enable, const std::string &devname = std::string());
     void enableRhrStats(bool enable);
+    void enableStreamingStats(bool enable);
     void enableFinishStats(bool enable);
     void enableSyncStats(bool enable);
 
@@ -95,6 +97,7 @@ protected:
     bool _gpuStats = false;
     std::string _gpuName;
     bool _rhrStats = false;
+    bool _streamingStats = false;
     unsigned int _frameRateChildNum;
     unsigned int _gpuMemChildNum;
     unsigned int _gpuPCIeChildNum;
@@ -105,10 +108,13 @@ protected:
     unsigned int _rhrBandwidthChildNum;
     unsigned int _rhrDelayChildNum;
     unsigned int _rhrSkippedChildNum;
+    unsigned int _streamingMemChildNum = 0;
+    unsigned int _streamingHitsChildNum = 0;
     unsigned int _viewerChildNum;
     unsigned int _gpuChildNum;
     unsigned int _cameraSceneChildNum;
     unsigned int _viewerSceneChildNum;
+    unsigned int _pluginChildNum = 0;
     unsigned int _numBlocks;
     double _blockMultiplier;
 
@@ -197,12 +197,15 @@ static void updateScenegraph()
 
 bool CovisePlugin::update()
 {
-    bool ret = RotatorList::instance()->num() > 0 || SliderList::instance()->num() > 0;
+    bool ret = RotatorList::instance()->num() > 0 || SliderList::instance()->num() > 0
+               || ObjectManager::instance()->geometryPending();
     return VRCoviseConnection::covconn->update() || ret;
 }
 
 void CovisePlugin::preFrame()
 {
+    ObjectManager::instance()->attachGeometry();
+    ObjectManager::instance()->releaseObjects();
     updateScenegraph();
 }
 
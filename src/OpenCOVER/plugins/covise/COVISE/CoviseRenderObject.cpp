@@ -33,6 +33,7 @@
 #include <do/coDoGeometry.h>
 
 #include "coVRDistributionManager.h"
+#include <cover/coVRArrayTransfer.h>
 #include <cover/coVRPluginSupport.h>
 
 using namespace opencover;
@@ -93,6 +94,7 @@ CoviseRenderObject::CoviseRenderObject(const coDistributedObject *co, const std:
         colorMapObject[c] = NULL;
     geometryFlag = 0;
     pc = NULL;
+    arrayData = NULL;
     coviseObject = co;
     cluster = coVRMSController::instance()->isCluster();
 
@@ -101,13 +103,15 @@ CoviseRenderObject::CoviseRenderObject(const coDistributedObject *co, const std:
         this->assignedTo = coVRDistributionManager::instance().assign(co);
     }
 
+    // arrays are sent separately after the description of the object
+    coVRArrayTransfer arrays;
+
 #define ADDCHAN(c) \
-    tb.addBinary((char *)farr[c], size*sizeof(float)); \
+    arrays.add(farr[c], size); \
     addFloat(min_[c]); \
     addFloat(max_[c]);
 #define COPYCHAN(c) \
-    farr[c] = new float[size]; \
-    memcpy(farr[c], tb.getBinary(size * sizeof(float)), size * sizeof(float)); \
+    arrays.add(farr[c], size); \
     copyFloat(min_[c]); \
     copyFloat(max_[c]);
 
@@ -205,11 +209,11 @@ CoviseRenderObject::CoviseRenderObject(const coDistributedObject *co, const std:
                     addInt(sizeu);
                     addInt(sizev);
                     addInt(size);
-                    tb.addBinary((char *)farr[0], size * sizeof(float));
-                    tb.addBinary((char *)farr[1], size * sizeof(float));
-                    tb.addBinary((char *)farr[2], size * sizeof(float));
-                    tb.addBinary((char *)iarr[0], sizev * sizeof(int));
-                    tb.addBinary((char *)iarr[1], sizeu * sizeof(int));
+                    arrays.add(farr[0], size);
+                    arrays.add(farr[1], size);
+                    arrays.add(farr[2], size);
+                    arrays.add(iarr[0], sizev);
+                    arrays.add(iarr[1], sizeu);
                 }
             }
             else if (strcmp(type, "TRIANG") == 0)
@@ -224,11 +228,11 @@ CoviseRenderObject::CoviseRenderObject(const coDistributedObject *co, const std:
                     addInt(sizeu);
                     addInt(sizev);
                     addInt(size);
-                    tb.addBinary((char *)farr[0], size * sizeof(float));
-                    tb.addBinary((char *)farr[1], size * sizeof(float));
-                    tb.addBinary((char *)farr[2], size * sizeof(float));
-                    tb.addBinary((char *)iarr[0], sizev * sizeof(int));
-                    tb.addBinary((char *)iarr[1], sizeu * sizeof(int));
+                    arrays.add(farr[0], size);
+                    arrays.add(farr[1], size);
+                    arrays.add(farr[2], size);
+                    arrays.add(iarr[0], sizev);
+                    arrays.add(iarr[1], sizeu);
                 }
             }
             else if (strcmp(type, "UNIGRD") == 0)
@@ -260,12 +264,12 @@ CoviseRenderObject::CoviseRenderObject(const coDistributedObject *co, const std:
                     addInt(sizeu);
                     addInt(sizev);
                     addInt(sizew);
-                    tb.addBinary((char *)farr[0], sizew * sizeof(float));
-                    tb.addBinary((char *)farr[1], sizew * sizeof(float));
-                    tb.addBinary((char *)farr[2], sizew * sizeof(float));
-                    tb.addBinary((char *)iarr[0], sizev * sizeof(int));
-                    tb.addBinary((char *)iarr[1], sizeu * sizeof(int));
-                    tb.addBinary((char *)iarr[2], sizeu * sizeof(int));
+                    arrays.add(farr[0], sizew);
+                    arrays.add(farr[1], sizew);
+                    arrays.add(farr[2], sizew);
+                    arrays.add(iarr[0], sizev);
+                    arrays.add(iarr[1], sizeu);
+                    arrays.add(iarr[2], sizeu);
                 }
             }
             else if (strcmp(type, "RCTGRD") == 0)
@@ -278,9 +282,9 @@ CoviseRenderObject::CoviseRenderObject(const coDistributedObject *co, const std:
                     addInt(sizeu);
                     addInt(sizev);
                     addInt(sizew);
-                    tb.addBinary((char *)farr[0], sizeu * sizeof(float));
-                    tb.addBinary((char *)farr[1], sizev * sizeof(float));
-                    tb.addBinary((char *)farr[2], sizew * sizeof(float));
+                    arrays.add(farr[0], sizeu);
+                    arrays.add(farr[1], sizev);
+                    arrays.add(farr[2], sizew);
                 }
             }
             else if (strcmp(type, "STRGRD") == 0)
@@ -293,9 +297,9 @@ CoviseRenderObject::CoviseRenderObject(const coDistributedObject *co, const std:
                     addInt(sizeu);
                     addInt(sizev);
                     addInt(sizew);
-                    tb.addBinary((char *)farr[0], sizeu * sizev * sizew * sizeof(float));
-                    tb.addBinary((char *)farr[1], sizeu * sizev * sizew * sizeof(float));
-                    tb.addBinary((char *)farr[2], sizeu * sizev * sizew * sizeof(float));
+                    arrays.add(farr[0], sizeu * sizev * sizew);
+                    arrays.add(farr[1], sizeu * sizev * sizew);
+                    arrays.add(farr[2], sizeu * sizev * sizew);
                 }
             }
             else if (strcmp(type, "POINTS") == 0)
@@ -306,9 +310,9 @@ CoviseRenderObject::CoviseRenderObject(const coDistributedObject *co, const std:
                 if (cluster)
                 {
                     addInt(size);
-                    tb.addBinary((char *)farr[0], size * sizeof(float));
-                    tb.addBinary((char *)farr[1], size * sizeof(float));
-                    tb.addBinary((char *)farr[2], size * sizeof(float));
+                    arrays.add(farr[0], size);
+                    arrays.add(farr[1], size);
+                    arrays.add(farr[2], size);
                 }
             }
             else if (strcmp(type, "SPHERE") == 0)
@@ -337,10 +341,10 @@ CoviseRenderObject::CoviseRenderObject(const coDistributedObject *co, const std:
                 {
                     addInt(size);
                     addInt(geometryFlag);
-                    tb.addBinary((char *)farr[0], size * sizeof(float));
-                    tb.addBinary((char *)farr[1], size * sizeof(float));
-                    tb.addBinary((char *)farr[2], size * sizeof(float));
-                    tb.addBinary((char *)farr[3], size * sizeof(float));
+                    arrays.add(farr[0], size);
+                    arrays.add(farr[1], size);
+                    arrays.add(farr[2], size);
+                    arrays.add(farr[3], size);
                 }
             }
             else if (strcmp(type, "LINES") == 0)
@@ -355,11 +359,11 @@ CoviseRenderObject::CoviseRenderObject(const coDistributedObject *co, const std:
                     addInt(sizeu);
                     addInt(sizev);
                     addInt(size);
-                    tb.addBinary((char *)farr[0], size * sizeof(float));
-                    tb.addBinary((char *)farr[1], size * sizeof(float));
-                    tb.addBinary((char *)farr[2], size * sizeof(float));
-                    tb.addBinary((char *)iarr[0], sizev * sizeof(int));
-                    tb.addBinary((char *)iarr[1], sizeu * sizeof(int));
+                    arrays.add(farr[0], size);
+                    arrays.add(farr[1], size);
+                    arrays.add(farr[2], size);
+                    arrays.add(iarr[0], sizev);
+                    arrays.add(iarr[1], sizeu);
                 }
             }
             else if (strcmp(type, "QUADS") == 0)
@@ -372,10 +376,10 @@ CoviseRenderObject::CoviseRenderObject(const coDistributedObject *co, const std:
                 {
                     addInt(sizev);
                     addInt(size);
-                    tb.addBinary((char *)farr[0], size * sizeof(float));
-                    tb.addBinary((char *)farr[1], size * sizeof(float));
-                    tb.addBinary((char *)farr[2], size * sizeof(float));
-                    tb.addBinary((char *)iarr[0], sizev * sizeof(int));
+                    arrays.add(farr[0], size);
+                    arrays.add(farr[1], size);
+                    arrays.add(farr[2], size);
+                    arrays.add(iarr[0], sizev);
                 }
             }
             else if (strcmp(type, "TRITRI") == 0)
@@ -388,10 +392,10 @@ CoviseRenderObject::CoviseRenderObject(const coDistributedObject *co, const std:
                 {
                     addInt(sizev);
                     addInt(size);
-                    tb.addBinary((char *)farr[0], size * sizeof(float));
-                    tb.addBinary((char *)farr[1], size * sizeof(float));
-                    tb.addBinary((char *)farr[2], size * sizeof(float));
-                    tb.addBinary((char *)iarr[0], sizev * sizeof(int));
+                    arrays.add(farr[0], size);
+                    arrays.add(farr[1], size);
+                    arrays.add(farr[2], size);
+                    arrays.add(iarr[0], sizev);
                 }
             }
             else if (strcmp(type, "USTSTD") == 0)
@@ -455,9 +459,9 @@ CoviseRenderObject::CoviseRenderObject(const coDistributedObject *co, const std:
                     addInt(sizev);
                     addInt(sizew);
                     addInt(numTC);
-                    tb.addBinary((char *)texture, sizeu * sizev * sizew);
-                    tb.addBinary((char *)textureCoords[0], numTC * sizeof(float));
-                    tb.addBinary((char *)textureCoords[1], numTC * sizeof(float));
+                    arrays.add(texture, sizeu * sizev * sizew);
+                    arrays.add(textureCoords[0], numTC);
+                    arrays.add(textureCoords[1], numTC);
                 }
             }
             else if (strcmp(type, "RGBADT") == 0 || strcmp(type, "colors") == 0)
@@ -468,7 +472,7 @@ CoviseRenderObject::CoviseRenderObject(const coDistributedObject *co, const std:
                 if (cluster)
                 {
                     addInt(size);
-                    tb.addBinary((char *)pc, size * sizeof(int));
+                    arrays.add(pc, size);
                 }
             }
             else if (strcmp(type, "BYTEDT") == 0)
@@ -489,7 +493,7 @@ CoviseRenderObject::CoviseRenderObject(const coDistributedObject *co, const std:
                 if (cluster)
                 {
                     addInt(size);
-                    tb.addBinary((const char *)barr[0], size);
+                    arrays.add(barr[0], size);
                     addFloat(min_[0]);
                     addFloat(max_[0]);
                 }
@@ -537,7 +541,7 @@ CoviseRenderObject::CoviseRenderObject(const coDistributedObject *co, const std:
                     addInt(size);
                     addFloat(min_[0]);
                     addFloat(max_[0]);
-                    tb.addBinary((char *)farr[0], 5 * size * sizeof(float));
+                    arrays.add(farr[0], 5 * size);
                 }
             }
             else
@@ -615,32 +619,22 @@ CoviseRenderObject::CoviseRenderObject(const coDistributedObject *co, const std:
             copyInt(sizeu);
             copyInt(sizev);
             copyInt(size);
-            farr[0] = new float[size];
-            farr[1] = new float[size];
-            farr[2] = new float[size];
-            iarr[0] = new int[sizev];
-            iarr[1] = new int[sizeu];
-            memcpy(farr[0], tb.getBinary(size * sizeof(float)), size * sizeof(float));
-            memcpy(farr[1], tb.getBinary(size * sizeof(float)), size * sizeof(float));
-            memcpy(farr[2], tb.getBinary(size * sizeof(float)), size * sizeof(float));
-            memcpy(iarr[0], tb.getBinary(sizev * sizeof(int)), sizev * sizeof(int));
-            memcpy(iarr[1], tb.getBinary(sizeu * sizeof(int)), sizeu * sizeof(int));
+            arrays.add(farr[0], size);
+            arrays.add(farr[1], size);
+            arrays.add(farr[2], size);
+            arrays.add(iarr[0], sizev);
+            arrays.add(iarr[1], sizeu);
         }
         else if (strcmp(type, "TRIANG") == 0)
         {
             copyInt(sizeu);
             copyInt(sizev);
             copyInt(size);
-            farr[0] = new float[size];
-            farr[1] = new float[size];
-            farr[2] = new float[size];
-            iarr[0] = new int[sizev];
-            iarr[1] = new int[sizeu];
-            memcpy(farr[0], tb.getBinary(size * sizeof(float)), size * sizeof(float));
-            memcpy(farr[1], tb.getBinary(size * sizeof(float)), size * sizeof(float));
-            memcpy(farr[2], tb.getBinary(size * sizeof(float)), size * sizeof(float));
-            memcpy(iarr[0], tb.getBinary(sizev * sizeof(int)), sizev * sizeof(int));
-            memcpy(iarr[1], tb.getBinary(sizeu * sizeof(int)), sizeu * sizeof(int));
+            arrays.add(farr[0], size);
+            arrays.add(farr[1], size);
+            arrays.add(farr[2], size);
+            arrays.add(iarr[0], sizev);
+            arrays.add(iarr[1], sizeu);
         }
         else if (strcmp(type, "UNIGRD") == 0)
         {
@@ -659,107 +653,75 @@ CoviseRenderObject::CoviseRenderObject(const coDistributedObject *co, const std:
             copyInt(sizeu);
             copyInt(sizev);
             copyInt(sizew);
-            farr[0] = new float[sizew];
-            farr[1] = new float[sizew];
-            farr[2] = new float[sizew];
-            iarr[0] = new int[sizev];
-            iarr[1] = new int[sizeu];
-            iarr[2] = new int[sizeu];
-            memcpy(farr[0], tb.getBinary(sizew * sizeof(float)), sizew * sizeof(float));
-            memcpy(farr[1], tb.getBinary(sizew * sizeof(float)), sizew * sizeof(float));
-            memcpy(farr[2], tb.getBinary(sizew * sizeof(float)), sizew * sizeof(float));
-            memcpy(iarr[0], tb.getBinary(sizev * sizeof(int)), sizev * sizeof(int));
-            memcpy(iarr[1], tb.getBinary(sizeu * sizeof(int)), sizeu * sizeof(int));
-            memcpy(iarr[2], tb.getBinary(sizeu * sizeof(int)), sizeu * sizeof(int));
+            arrays.add(farr[0], sizew);
+            arrays.add(farr[1], sizew);
+            arrays.add(farr[2], sizew);
+            arrays.add(iarr[0], sizev);
+            arrays.add(iarr[1], sizeu);
+            arrays.add(iarr[2], sizeu);
         }
         else if (strcmp(type, "RCTGRD") == 0)
         {
             copyInt(sizeu);
             copyInt(sizev);
             copyInt(sizew);
-            farr[0] = new float[sizeu];
-            farr[1] = new float[sizev];
-            farr[2] = new float[sizew];
-            memcpy(farr[0], tb.getBinary(sizeu * sizeof(float)), sizeu * sizeof(float));
-            memcpy(farr[1], tb.getBinary(sizev * sizeof(float)), sizev * sizeof(float));
-            memcpy(farr[2], tb.getBinary(sizew * sizeof(float)), sizew * sizeof(float));
+            arrays.add(farr[0], sizeu);
+            arrays.add(farr[1], sizev);
+            arrays.add(farr[2], sizew);
         }
         else if (strcmp(type, "STRGRD") == 0)
         {
             copyInt(sizeu);
             copyInt(sizev);
             copyInt(sizew);
-            farr[0] = new float[sizeu * sizev * sizew];
-            farr[1] = new float[sizeu * sizev * sizew];
-            farr[2] = new float[sizeu * sizev * sizew];
-            memcpy(farr[0], tb.getBinary(sizeu * sizev * sizew * sizeof(float)), sizeu * sizev * sizew * sizeof(float));
-            memcpy(farr[1], tb.getBinary(sizeu * sizev * sizew * sizeof(float)), sizeu * sizev * sizew * sizeof(float));
-            memcpy(farr[2], tb.getBinary(sizeu * sizev * sizew * sizeof(float)), sizeu * sizev * sizew * sizeof(float));
+            arrays.add(farr[0], sizeu * sizev * sizew);
+            arrays.add(farr[1], sizeu * sizev * sizew);
+            arrays.add(farr[2], sizeu * sizev * sizew);
         }
         else if (strcmp(type, "POINTS") == 0)
         {
             copyInt(size);
-            farr[0] = new float[size];
-            farr[1] = new float[size];
-            farr[2] = new float[size];
-            memcpy(farr[0], tb.getBinary(size * sizeof(float)), size * sizeof(float));
-            memcpy(farr[1], tb.getBinary(size * sizeof(float)), size * sizeof(float));
-            memcpy(farr[2], tb.getBinary(size * sizeof(float)), size * sizeof(float));
+            arrays.add(farr[0], size);
+            arrays.add(farr[1], size);
+            arrays.add(farr[2], size);
         }
         else if (strcmp(type, "SPHERE") == 0)
         {
             copyInt(size);
             copyInt(geometryFlag);
-            farr[0] = new float[size];
-            farr[1] = new float[size];
-            farr[2] = new float[size];
-            farr[3] = new float[size];
-            memcpy(farr[0], tb.getBinary(size * sizeof(float)), size * sizeof(float));
-            memcpy(farr[1], tb.getBinary(size * sizeof(float)), size * sizeof(float));
-            memcpy(farr[2], tb.getBinary(size * sizeof(float)), size * sizeof(float));
-            memcpy(farr[3], tb.getBinary(size * sizeof(float)), size * sizeof(float));
+            arrays.add(farr[0], size);
+            arrays.add(farr[1], size);
+            arrays.add(farr[2], size);
+            arrays.add(farr[3], size);
         }
         else if (strcmp(type, "LINES") == 0)
         {
             copyInt(sizeu);
             copyInt(sizev);
             copyInt(size);
-            farr[0] = new float[size];
-            farr[1] = new float[size];
-            farr[2] = new float[size];
-            iarr[0] = new int[sizev];
-            iarr[1] = new int[sizeu];
-            memcpy(farr[0], tb.getBinary(size * sizeof(float)), size * sizeof(float));
-            memcpy(farr[1], tb.getBinary(size * sizeof(float)), size * sizeof(float));
-            memcpy(farr[2], tb.getBinary(size * sizeof(float)), size * sizeof(float));
-            memcpy(iarr[0], tb.getBinary(sizev * sizeof(int)), sizev * sizeof(int));
-            memcpy(iarr[1], tb.getBinary(sizeu * sizeof(int)), sizeu * sizeof(int));
+            arrays.add(farr[0], size);
+            arrays.add(farr[1], size);
+            arrays.add(farr[2], size);
+            arrays.add(iarr[0], sizev);
+            arrays.add(iarr[1], sizeu);
         }
         else if (strcmp(type, "QUADS") == 0)
         {
             copyInt(sizev);
             copyInt(size);
-            farr[0] = new float[size];
-            farr[1] = new float[size];
-            farr[2] = new float[size];
-            iarr[0] = new int[sizev];
-            memcpy(farr[0], tb.getBinary(size * sizeof(float)), size * sizeof(float));
-            memcpy(farr[1], tb.getBinary(size * sizeof(float)), size * sizeof(float));
-            memcpy(farr[2], tb.getBinary(size * sizeof(float)), size * sizeof(float));
-            memcpy(iarr[0], tb.getBinary(sizev * sizeof(int)), sizev * sizeof(int));
+            arrays.add(farr[0], size);
+            arrays.add(farr[1], size);
+            arrays.add(farr[2], size);
+            arrays.add(iarr[0], sizev);
         }
         else if (strcmp(type, "TRITRI") == 0)
         {
             copyInt(sizev);
             copyInt(size);
-            farr[0] = new float[size];
-            farr[1] = new float[size];
-            farr[2] = new float[size];
-            iarr[0] = new int[sizev];
-            memcpy(farr[0], tb.getBinary(size * sizeof(float)), size * sizeof(float));
-            memcpy(farr[1], tb.getBinary(size * sizeof(float)), size * sizeof(float));
-            memcpy(farr[2], tb.getBinary(size * sizeof(float)), size * sizeof(float));
-            memcpy(iarr[0], tb.getBinary(sizev * sizeof(int)), sizev * sizeof(int));
+            arrays.add(farr[0], size);
+            arrays.add(farr[1], size);
+            arrays.add(farr[2], size);
+            arrays.add(iarr[0], sizev);
         }
         else if (strcmp(type, "USTSTD") == 0)
         {
@@ -780,25 +742,20 @@ CoviseRenderObject::CoviseRenderObject(const coDistributedObject *co, const std:
             copyInt(sizev);
             copyInt(sizew);
             copyInt(numTC);
-            texture = new unsigned char[sizeu * sizev * sizew];
             textureCoords = new float *[2];
-            textureCoords[0] = new float[numTC];
-            textureCoords[1] = new float[numTC];
-            memcpy(texture, tb.getBinary(sizeu * sizev * sizew), sizeu * sizev * sizew);
-            memcpy(textureCoords[0], tb.getBinary(numTC * sizeof(float)), numTC * sizeof(float));
-            memcpy(textureCoords[1], tb.getBinary(numTC * sizeof(float)), numTC * sizeof(float));
+            arrays.add(texture, sizeu * sizev * sizew);
+            arrays.add(textureCoords[0], numTC);
+            arrays.add(textureCoords[1], numTC);
         }
         else if (strcmp(type, "RGBADT") == 0 || strcmp(type, "colors") == 0)
         {
             copyInt(size);
-            pc = new int[size];
-            memcpy(pc, tb.getBinary(size * sizeof(int)), size * sizeof(int));
+            arrays.add(pc, size);
         }
         else if (strcmp(type, "BYTEDT") == 0)
         {
             copyInt(size);
-            barr[0] = new unsigned char[size];
-            memcpy(barr[0], tb.getBinary(size), size);
+            arrays.add(barr[0], size);
             copyFloat(min_[0]);
             copyFloat(max_[0]);
         }
@@ -812,10 +769,11 @@ CoviseRenderObject::CoviseRenderObject(const coDistributedObject *co, const std:
             copyInt(size);
             copyFloat(min_[0]);
             copyFloat(max_[0]);
-            farr[0] = new float[5 * size];
-            memcpy(farr[0], tb.getBinary(5 * size * sizeof(float)), 5 * size * sizeof(float));
+            arrays.add(farr[0], 5 * size);
         }
     }
+
+    arrayData = arrays.transfer();
 }
 
 CoviseRenderObject::CoviseRenderObject(const coDistributedObject *const *cos, const std::vector<int> &assignedTo)
@@ -843,6 +801,7 @@ CoviseRenderObject::CoviseRenderObject(const coDistributedObject *const *cos, co
     , vertexAttributeObject(NULL)
     , geometryFlag(0)
     , pc(NULL)
+    , arrayData(NULL)
     , coviseObject(NULL)    // TODO
     , cluster(coVRMSController::instance()->isCluster())
 {
@@ -869,6 +828,7 @@ CoviseRenderObject::CoviseRenderObject(const coDistributedObject *const *cos, co
         colorMapObject[c] = NULL;
     }
 
+    coVRArrayTransfer arrays;
     for (int c = 0; c < Field::NumChannels; ++c)
     {
         const coDistributedObject *co = cos[c];
@@ -923,7 +883,7 @@ CoviseRenderObject::CoviseRenderObject(const coDistributedObject *const *cos, co
                     if (cluster)
                     {
                         addInt(size);
-                        tb.addBinary((const char *)barr[c], size);
+                        arrays.add(barr[c], size);
                     }
                 }
                 else if (strcmp(type, "USTSDT") == 0)
@@ -934,7 +894,7 @@ CoviseRenderObject::CoviseRenderObject(const coDistributedObject *const *cos, co
                     if (cluster)
                     {
                         addInt(size);
-                        tb.addBinary((char *)farr[c], size * sizeof(float));
+                        arrays.add(farr[c], size);
                     }
                 }
             }
@@ -1001,14 +961,12 @@ CoviseRenderObject::CoviseRenderObject(const coDistributedObject *const *cos, co
             if (strcmp(type, "BYTEDT") == 0)
             {
                 copyInt(size);
-                barr[c] = new unsigned char[size];
-                memcpy(barr[c], tb.getBinary(size), size);
+                arrays.add(barr[c], size);
             }
             else if (strcmp(type, "USTSDT") == 0)
             {
                 copyInt(size);
-                farr[c] = new float[size];
-                memcpy(farr[c], tb.getBinary(size * sizeof(float)), size * sizeof(float));
+                arrays.add(farr[c], size);
             }
 
             copyFloat(min_[c]);
@@ -1035,6 +993,8 @@ CoviseRenderObject::CoviseRenderObject(const coDistributedObject *const *cos, co
             delete[] attributes;
         }
     }
+
+    arrayData = arrays.transfer();
 }
 
 CoviseRenderObject::~CoviseRenderObject()
@@ -1050,12 +1010,6 @@ CoviseRenderObject::~CoviseRenderObject()
     if (!coVRMSController::instance()->isMaster())
     {
         int i;
-        delete[] texture;
-        if (textureCoords)
-        {
-            delete[] textureCoords[0];
-            delete[] textureCoords[1];
-        }
         delete[] textureCoords;
         for (i = 0; i < numAttributes; i++)
         {
@@ -1064,12 +1018,7 @@ CoviseRenderObject::~CoviseRenderObject()
         }
         delete[] attrNames;
         delete[] attributes;
-        for (int c = 0; c < Field::NumChannels; ++c)
-        {
-            delete[] barr[c];
-            delete[] iarr[c];
-            delete[] farr[c];
-        }
+        delete[] arrayData;
         delete coviseObject;
         delete COVdobj;
         delete COVnormals;
@@ -225,6 +225,7 @@ public:
     unsigned char *barr[Field::NumChannels];
     int *iarr[Field::NumChannels];
     float *farr[Field::NumChannels];
+    char *arrayData; // storage of received arrays on slaves
     int geometryFlag;
     float min_[Field::NumChannels];
     float max_[Field::NumChannels];
@@ -0,0 +1,216 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#include "VRCoviseGeometryWorkers.h"
+#include <CovisePluginUtil/VRCoviseGeometryManager.h>
+#include <cover/coVRPluginSupport.h>
+
+#include <stdio.h>
+
+using namespace opencover;
+
+GeometryJob::GeometryJob()
+    : type(Polygons)
+    , no_prim(0)
+    , no_vert(0)
+    , no_points(0)
+    , no_c(0)
+    , colorbinding(0)
+    , colorpacking(0)
+    , no_n(0)
+    , normalbinding(0)
+    , transparency(0.f)
+    , vertexOrder(0)
+    , material(NULL)
+    , texW(0)
+    , texH(0)
+    , pixS(0)
+    , no_t(0)
+    , wrapMode(osg::Texture::CLAMP_TO_EDGE)
+    , minfm(osg::Texture::NEAREST)
+    , magfm(osg::Texture::NEAREST)
+    , no_va(0)
+    , attr(new Attributes)
+    , cullBackfaces(false)
+    , done(false)
+{
+}
+
+template <typename T>
+static void freeVector(std::vector<T> &v)
+{
+    std::vector<T>().swap(v);
+}
+
+void GeometryJob::release()
+{
+    freeVector(x);
+    freeVector(y);
+    freeVector(z);
+    freeVector(vl);
+    freeVector(ll);
+    freeVector(r);
+    freeVector(g);
+    freeVector(b);
+    freeVector(pc);
+    freeVector(image);
+    attr = NULL;
+}
+
+GeometryWorkers::GeometryWorkers(int numThreads)
+    : m_quit(false)
+{
+    // has to exist before it is used from the workers
+    GeometryManager::instance();
+
+    for (int i = 0; i < numThreads; ++i)
+        m_threads.push_back(std::thread(&GeometryWorkers::run, this));
+}
+
+GeometryWorkers::~GeometryWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+        m_queue.clear();
+    }
+    m_wake.notify_all();
+    for (size_t i = 0; i < m_threads.size(); ++i)
+        m_threads[i].join();
+
+    for (size_t i = 0; i < m_jobs.size(); ++i)
+        delete m_jobs[i];
+}
+
+osg::Group *GeometryWorkers::submit(GeometryJob *job)
+{
+    job->group = new osg::Group;
+    job->group->setName(job->name);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back(job);
+        m_queue.push_back(job);
+    }
+    m_wake.notify_one();
+    return job->group.get();
+}
+
+int GeometryWorkers::attach(int maxObjects, int maxVertices)
+{
+    std::vector<GeometryJob *> finished;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        int vertices = 0;
+        size_t keep = 0;
+        for (size_t i = 0; i < m_jobs.size(); ++i)
+        {
+            GeometryJob *job = m_jobs[i];
+            // always attach at least one node per frame
+            bool full = !finished.empty()
+                        && ((int)finished.size() >= maxObjects || vertices + job->no_points > maxVertices);
+            if (job->done && !full)
+            {
+                vertices += job->no_points;
+                finished.push_back(job);
+            }
+            else
+            {
+                m_jobs[keep++] = job;
+            }
+        }
+        m_jobs.resize(keep);
+    }
+
+    int attached = 0;
+    for (size_t i = 0; i < finished.size(); ++i)
+    {
+        GeometryJob *job = finished[i];
+        // the group is not referenced from the scene graph anymore if the object was deleted meanwhile
+        if (job->node.valid() && job->group->referenceCount() > 1)
+        {
+            job->group->addChild(job->node.get());
+            ++attached;
+        }
+        delete job;
+    }
+
+    if (attached > 0 && cover->debugLevel(3))
+        fprintf(stderr, "GeometryWorkers::attach: %d nodes, %d pending\n", attached, (int)m_jobs.size());
+
+    return attached;
+}
+
+bool GeometryWorkers::pending()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return !m_jobs.empty();
+}
+
+void GeometryWorkers::run()
+{
+    for (;;)
+    {
+        GeometryJob *job = NULL;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            while (!m_quit && m_queue.empty())
+                m_wake.wait(lock);
+            if (m_quit)
+                return;
+            job = m_queue.front();
+            m_queue.pop_front();
+        }
+
+        build(job);
+        job->release();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        job->done = true;
+    }
+}
+
+void GeometryWorkers::build(GeometryJob *job)
+{
+    GeometryManager *gm = GeometryManager::instance();
+    typedef GeometryJob J;
+    switch (job->type)
+    {
+    case GeometryJob::Polygons:
+        job->node = gm->addPolygon(job->name.c_str(), job->no_prim, job->no_vert, job->no_points,
+                                   J::ptr(job->x), J::ptr(job->y), J::ptr(job->z), J::ptr(job->vl), J::ptr(job->ll),
+                                   job->no_c, job->colorbinding, job->colorpacking,
+                                   J::ptr(job->r), J::ptr(job->g), J::ptr(job->b), J::ptr(job->pc),
+                                   job->no_n, job->normalbinding, J::ptr(job->attr->nx), J::ptr(job->attr->ny), J::ptr(job->attr->nz),
+                                   job->transparency, job->vertexOrder, job->material,
+                                   job->texW, job->texH, job->pixS, J::ptr(job->image),
+                                   job->no_t, J::ptr(job->attr->tx), J::ptr(job->attr->ty), job->wrapMode, job->minfm, job->magfm,
+                                   job->no_va, J::ptr(job->attr->vax), J::ptr(job->attr->vay), J::ptr(job->attr->vaz), job->cullBackfaces, job->attr.get());
+        break;
+    case GeometryJob::TriangleStrips:
+        job->node = gm->addTriangleStrip(job->name.c_str(), job->no_prim, job->no_vert, job->no_points,
+                                         J::ptr(job->x), J::ptr(job->y), J::ptr(job->z), J::ptr(job->vl), J::ptr(job->ll),
+                                         job->no_c, job->colorbinding, job->colorpacking,
+                                         J::ptr(job->r), J::ptr(job->g), J::ptr(job->b), J::ptr(job->pc),
+                                         job->no_n, job->normalbinding, J::ptr(job->attr->nx), J::ptr(job->attr->ny), J::ptr(job->attr->nz),
+                                         job->transparency, job->vertexOrder, job->material,
+                                         job->texW, job->texH, job->pixS, J::ptr(job->image),
+                                         job->no_t, J::ptr(job->attr->tx), J::ptr(job->attr->ty), job->wrapMode, job->minfm, job->magfm,
+                                         job->no_va, J::ptr(job->attr->vax), J::ptr(job->attr->vay), J::ptr(job->attr->vaz), job->cullBackfaces);
+        break;
+    case GeometryJob::Triangles:
+        job->node = gm->addTriangles(job->name.c_str(), job->no_vert, job->no_points,
+                                     J::ptr(job->x), J::ptr(job->y), J::ptr(job->z), J::ptr(job->vl),
+                                     job->no_c, job->colorbinding, job->colorpacking,
+                                     J::ptr(job->r), J::ptr(job->g), J::ptr(job->b), J::ptr(job->pc),
+                                     job->no_n, job->normalbinding, J::ptr(job->attr->nx), J::ptr(job->attr->ny), J::ptr(job->attr->nz),
+                                     job->transparency, job->vertexOrder, job->material,
+                                     job->texW, job->texH, job->pixS, J::ptr(job->image),
+                                     job->no_t, J::ptr(job->attr->tx), J::ptr(job->attr->ty), job->wrapMode, job->minfm, job->magfm,
+                                     job->no_va, J::ptr(job->attr->vax), J::ptr(job->attr->vay), J::ptr(job->attr->vaz), job->cullBackfaces);
+        break;
+    }
+}
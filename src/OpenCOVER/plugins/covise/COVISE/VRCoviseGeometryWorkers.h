@@ -0,0 +1,123 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+/*! \file
+ \brief  convert COVISE surface geometry to OSG in background threads
+
+ Jobs own copies of all arrays they need, so that the COVISE objects
+ may be deleted while a job is still pending. Per vertex attributes
+ are not copied again into the geometry, but referenced from the job.
+ Finished nodes are attached to the group created at submission time
+ from the render thread, only a limited number of them per frame.
+ */
+
+#ifndef VR_COVISE_GEOMETRY_WORKERS_H
+#define VR_COVISE_GEOMETRY_WORKERS_H
+
+#include <osg/Group>
+#include <osg/ref_ptr>
+#include <osg/Texture>
+
+#include <util/coMaterial.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace opencover
+{
+
+struct GeometryJob
+{
+    enum Type
+    {
+        Polygons,
+        TriangleStrips,
+        Triangles
+    };
+
+    // per vertex attributes, may be referenced by the created geometry
+    struct Attributes : public osg::Referenced
+    {
+        std::vector<float> nx, ny, nz;
+        std::vector<float> tx, ty;
+        std::vector<float> vax, vay, vaz;
+    };
+
+    GeometryJob();
+    /// free the input which is not needed after the node has been built
+    void release();
+
+    template <typename T>
+    static void copy(std::vector<T> &dest, const T *src, int n)
+    {
+        if (src && n > 0)
+            dest.assign(src, src + n);
+    }
+    template <typename T>
+    static T *ptr(std::vector<T> &v)
+    {
+        return v.empty() ? NULL : &v[0];
+    }
+
+    Type type;
+    std::string name;
+    int no_prim; // polygons or strips
+    int no_vert, no_points;
+    std::vector<float> x, y, z;
+    std::vector<int> vl, ll;
+    int no_c, colorbinding, colorpacking;
+    std::vector<float> r, g, b;
+    std::vector<int> pc;
+    int no_n, normalbinding;
+    float transparency;
+    int vertexOrder;
+    covise::coMaterial *material;
+    int texW, texH, pixS;
+    std::vector<unsigned char> image;
+    int no_t;
+    osg::Texture::WrapMode wrapMode;
+    osg::Texture::FilterMode minfm, magfm;
+    int no_va;
+    osg::ref_ptr<Attributes> attr;
+    bool cullBackfaces;
+
+    osg::ref_ptr<osg::Group> group; // receives the finished node
+    osg::ref_ptr<osg::Node> node;
+    bool done;
+};
+
+class GeometryWorkers
+{
+public:
+    GeometryWorkers(int numThreads);
+    ~GeometryWorkers();
+
+    /// takes ownership of job, returns the group the geometry will be attached to
+    osg::Group *submit(GeometryJob *job);
+    /// attach finished geometry, at most maxObjects nodes and about maxVertices coordinates,
+    /// returns the number of attached nodes
+    int attach(int maxObjects, int maxVertices);
+    /// there is geometry which has not been attached yet
+    bool pending();
+
+private:
+    void run();
+    static void build(GeometryJob *job);
+
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::deque<GeometryJob *> m_queue; // not started yet
+    std::vector<GeometryJob *> m_jobs; // not attached yet, in submission order
+    bool m_quit;
+};
+}
+#endif
@@ -31,6 +31,8 @@
 
 #include <cover/input/VRKeys.h>
 #include "VRCoviseObjectManager.h"
+#include "VRCoviseGeometryWorkers.h"
+#include "VRCoviseSpatialGrouping.h"
 #include <CovisePluginUtil/VRCoviseGeometryManager.h>
 #include <cover/coVRNavigationManager.h>
 #include <cover/coVRFileManager.h>
@@ -126,6 +128,27 @@ void ColorMap::setMinMax(float min, float max)
 }
 
 
+// owns render objects, OSG arrays refer to their data through it
+class RenderObjectRef : public osg::Referenced
+{
+public:
+    void add(CoviseRenderObject *ro)
+    {
+        if (ro)
+            m_objects.push_back(ro);
+    }
+
+protected:
+    ~RenderObjectRef()
+    {
+        for (size_t i = 0; i < m_objects.size(); ++i)
+            delete m_objects[i];
+    }
+
+private:
+    std::vector<CoviseRenderObject *> m_objects;
+};
+
 static ObjectManager *singleton = NULL;
 
 //================================================================
@@ -154,10 +177,24 @@ ObjectManager::ObjectManager(coVRPlugin *plugin): materialList(NULL), coviseSG(n
 
     anzset = 0;
     depthPeeling = coCoviseConfig::isOn("COVER.DepthPeeling", false);
+
+    // cluster nodes would attach geometry in different frames
+    if (coCoviseConfig::isOn("COVER.Plugin.COVISE.AsyncGeometry", false) && !coVRMSController::instance()->isCluster())
+    {
+        int threads = coCoviseConfig::getInt("threads", "COVER.Plugin.COVISE.AsyncGeometry", 2);
+        m_attachObjects = coCoviseConfig::getInt("maxObjects", "COVER.Plugin.COVISE.AsyncGeometry", m_attachObjects);
+        m_attachVertices = coCoviseConfig::getInt("maxVertices", "COVER.Plugin.COVISE.AsyncGeometry", m_attachVertices);
+        if (threads > 0)
+            m_geometryWorkers = new GeometryWorkers(threads);
+    }
+
+    m_spatialGrouping = new SpatialGrouping;
 }
 
 ObjectManager::~ObjectManager()
 {
+    delete m_geometryWorkers;
+    delete m_spatialGrouping;
     delete coviseSG;
     if (cover->debugLevel(2))
         fprintf(stderr, "delete ObjectManager\n");
@@ -394,6 +431,29 @@ ObjectManager::update(void)
     }
 }
 
+void ObjectManager::attachGeometry()
+{
+    if (m_geometryWorkers)
+        m_geometryWorkers->attach(m_attachObjects, m_attachVertices);
+
+    // bounds of sets are known once all their elements have been attached
+    if (!m_groupingPending.empty() && !geometryPending())
+    {
+        for (size_t i = 0; i < m_groupingPending.size(); ++i)
+        {
+            osg::ref_ptr<osg::Group> group;
+            if (m_groupingPending[i].first.lock(group))
+                m_spatialGrouping->apply(group.get(), m_groupingPending[i].second);
+        }
+        m_groupingPending.clear();
+    }
+}
+
+bool ObjectManager::geometryPending() const
+{
+    return m_geometryWorkers && m_geometryWorkers->pending();
+}
+
 //----------------------------------------------------------------
 //
 //----------------------------------------------------------------
@@ -413,7 +473,9 @@ void ObjectManager::addObject(const char *object, const coDistributedObject *dat
 
     if (ro != NULL)
     {
-        m_roMap[object] = ro;
+        RenderObjectRef *ref = new RenderObjectRef;
+        ref->add(ro);
+        m_roMap[object] = ref;
         //fprintf(stderr, "++++++ObjectManager(%s)::addObject %s  data_obj=%s renderObj=%s\n", getenv("HOST"), object,data_obj->getName(), ro->getName() );
 
         std::string gtype = ro->getType();
@@ -427,7 +489,7 @@ void ObjectManager::addObject(const char *object, const coDistributedObject *dat
         else
         {
             // also send container object 'ro' for plugin usage
-            if (osg::Node *n = addGeometry(object, NULL, ro, NULL, NULL, NULL, NULL, ro, NULL))
+            if (osg::Node *n = addGeometry(object, NULL, ro, NULL, NULL, NULL, NULL, ro, NULL, ref))
             {
                 coviseSG->addNode(n, (osg::Group *)NULL, ro);
             }
@@ -501,6 +563,35 @@ void ObjectManager::coviseError(const char *error)
     coVRPluginList::instance()->coviseError(error);
 }
 
+//----------------------------------------------------------------
+// geometry can be created in the background, if everything done
+// with the new node after its creation works on an empty group as well
+//----------------------------------------------------------------
+bool ObjectManager::canDefer(const char *gtype, CoviseRenderObject *geometry, CoviseRenderObject *texture,
+                             CoviseRenderObject *container, int colorpacking, bool rotator) const
+{
+    if (!m_geometryWorkers || rotator || colorpacking == Pack::Float)
+        return false;
+
+    if (strcmp(gtype, "POLYGN") != 0 && strcmp(gtype, "TRIANG") != 0
+        && strcmp(gtype, "TRITRI") != 0 && strcmp(gtype, "QUADS") != 0)
+        return false;
+
+    // these need access to the geode itself
+    static const char *attribs[] = { "SHADER", "POLYGON_OFFSET", "SLIDER0", "VECTOR0", "TUI0", "MENU_TEXTURE", NULL };
+    for (int i = 0; attribs[i]; ++i)
+    {
+        if (geometry->getAttribute(attribs[i]))
+            return false;
+    }
+    if (texture && texture->getAttribute("SHADER"))
+        return false;
+    if (container && container->getAttribute("SHADER"))
+        return false;
+
+    return true;
+}
+
 //----------------------------------------------------------------
 //
 //----------------------------------------------------------------
@@ -534,6 +625,10 @@ void ObjectManager::deleteObject(const char *name, bool groupobject)
             }
         }
     }
+    // geometry may refer to the arrays of the render objects, keep both until no draw thread uses them
+    Release release;
+    release.frame = m_frame;
+    release.node = coviseSG->findNode(name);
     removeGeometry(name, groupobject);
 #ifdef PHANTOM_TRACKER
     if (feedbackList)
@@ -542,10 +637,21 @@ void ObjectManager::deleteObject(const char *name, bool groupobject)
     RenderObjectMap::iterator it = m_roMap.find(name);
     if (it != m_roMap.end())
     {
-        RenderObject *ro = it->second;
+        release.objects = it->second;
         m_roMap.erase(it);
-        delete ro;
     }
+    if (release.node.valid() || release.objects.valid())
+        m_releaseQueue.push_back(release);
+}
+
+void ObjectManager::releaseObjects()
+{
+    // with DrawThreadPerContext, a frame is drawn while the next one is culled and the one after that updated
+    const unsigned int DrawLag = 3;
+
+    ++m_frame;
+    while (!m_releaseQueue.empty() && m_frame - m_releaseQueue.front().frame >= DrawLag)
+        m_releaseQueue.pop_front();
 }
 
 //----------------------------------------------------------------
@@ -683,8 +789,15 @@ void ObjectManager::addColorMap(const char *object, CoviseRenderObject *cmap)
     std::cerr << "colormap for species " << species << ": range " << cm.min << " - " << cm.max << ", #steps: " << cmap->getNumColors() << std::endl;
 }
 
+// nodes of such objects are looked up by name and must not be merged with others
+static bool hasFeedback(const CoviseRenderObject *ro)
+{
+    return ro && (ro->getAttribute("FEEDBACK") || ro->getAttribute("INTERACTOR") || ro->getAttribute("MENU_TEXTURE"));
+}
+
 osg::Node *ObjectManager::addGeometry(const char *object, osg::Group *root, CoviseRenderObject *geometry,
-                                      CoviseRenderObject *normals, CoviseRenderObject *colors, CoviseRenderObject *texture, CoviseRenderObject *vertexAttribute, CoviseRenderObject *container, const char *lod)
+                                      CoviseRenderObject *normals, CoviseRenderObject *colors, CoviseRenderObject *texture, CoviseRenderObject *vertexAttribute, CoviseRenderObject *container, const char *lod,
+                                      osg::Referenced *dataOwner)
 {
     CoviseRenderObject *const *dobjsg = NULL; // Geometry Set elements
     CoviseRenderObject *const *dobjsc = NULL; // Color Set elements
@@ -1085,7 +1198,7 @@ osg::Node *ObjectManager::addGeometry(const char *object, osg::Group *root, Covi
         CoviseRenderObject *dobjv = geometry->getVertexAttribute();
         gtype = dobjg->getType();
         // use correct name for container object (necessary for COVER-GUI comunication)
-        return addGeometry(object, root, dobjg, dobjn, dobjc, dobjt, dobjv, container, lod);
+        return addGeometry(object, root, dobjg, dobjn, dobjc, dobjt, dobjv, container, lod, dataOwner);
     }
     else if (strcmp(gtype, "SETELE") == 0)
     {
@@ -1233,6 +1346,7 @@ osg::Node *ObjectManager::addGeometry(const char *object, osg::Group *root, Covi
             }
         }
         anzset++;
+        bool mergeElements = !inter && !hasFeedback(geometry);
         for (int i = 0; i < no_elems; i++)
         {
             strcpy(buf, dobjsg[i]->getName());
@@ -1240,13 +1354,28 @@ osg::Node *ObjectManager::addGeometry(const char *object, osg::Group *root, Covi
             elemnames[curset][i] = new char[strlen(objName) + 1];
             strcpy(elemnames[curset][i], objName);
 
+            // the elements are deleted as soon as no geometry refers to them
+            osg::ref_ptr<RenderObjectRef> elemRef = new RenderObjectRef;
+            if (dobjsg)
+                elemRef->add(dobjsg[i]);
+            if (dobjsn && i < no_n)
+                elemRef->add(dobjsn[i]);
+            if (dobjsc && i < no_c)
+                elemRef->add(dobjsc[i]);
+            if (dobjst && i < no_t)
+                elemRef->add(dobjst[i]);
+            if (dobjsva && i < no_va)
+                elemRef->add(dobjsva[i]);
+
             //std::cerr << "ObjectManager::addGeometry info: calling addGeometry for " << objName << " (" << i << ")" << std::endl;
             osg::Node *node = addGeometry(objName, groupNode, dobjsg[i],
                                           no_n > 0 ? dobjsn[i] : NULL,
                                           no_c > 0 ? dobjsc[i] : NULL,
                                           no_t > 0 ? dobjst[i] : NULL,
                                           no_va > 0 ? dobjsva[i] : NULL,
-                                          container, lod);
+                                          container, lod, elemRef.get());
+            if (hasFeedback(dobjsg[i]))
+                mergeElements = false;
             if (groupNode && node)
             {
                 groupNode->addChild(node);
@@ -1255,17 +1384,6 @@ osg::Node *ObjectManager::addGeometry(const char *object, osg::Group *root, Covi
             {
                 std::cerr << "ignoring Set element " << objName << ": no " << (node ? "" : "group ") << "node" << std::endl;
             }
-
-            if (dobjsg)
-                delete dobjsg[i];
-            if (dobjsn && i < no_n)
-                delete dobjsn[i];
-            if (dobjsc && i < no_c)
-                delete dobjsc[i];
-            if (dobjst && i < no_t)
-                delete dobjst[i];
-            if (dobjsva && i < no_va)
-                delete dobjsva[i];
         }
 
         const char *polyOffset = geometry->getAttribute("POLYGON_OFFSET");
@@ -1312,6 +1430,14 @@ osg::Node *ObjectManager::addGeometry(const char *object, osg::Group *root, Covi
             //std::cerr << "setting interactor user data on Group " << groupNode->getName() << std::endl;
             groupNode->setUserData(new InteractorReference(inter));
         }
+        // MULTIROT refers to elements by index
+        if (groupNode && m_spatialGrouping->enabled() && !attr)
+        {
+            if (geometryPending())
+                m_groupingPending.push_back(std::make_pair(groupNode, mergeElements));
+            else
+                m_spatialGrouping->apply(groupNode, mergeElements);
+        }
         if (groupNode)
         {
             if (osg::Sequence * pSequence = dynamic_cast<osg::Sequence*>(groupNode)) // timesteps
@@ -1597,7 +1723,65 @@ osg::Node *ObjectManager::addGeometry(const char *object, osg::Group *root, Covi
 
         bool skipGeometryCreation = false;
 
-        if (!skipGeometryCreation)
+        if (!skipGeometryCreation && canDefer(gtype, geometry, texture, container, colorpacking, cur_rotator != NULL))
+        {
+            // arrays are copied, as the objects may be gone before the job is run
+            GeometryJob *job = new GeometryJob;
+            job->name = object;
+            job->no_vert = no_vert;
+            job->no_points = no_points;
+            if (strcmp(gtype, "POLYGN") == 0)
+            {
+                job->type = GeometryJob::Polygons;
+                job->no_prim = no_poly;
+            }
+            else if (strcmp(gtype, "TRIANG") == 0)
+            {
+                job->type = GeometryJob::TriangleStrips;
+                job->no_prim = no_strip;
+            }
+            else
+            {
+                job->type = GeometryJob::Triangles;
+            }
+            GeometryJob::copy(job->x, x_c, no_points);
+            GeometryJob::copy(job->y, y_c, no_points);
+            GeometryJob::copy(job->z, z_c, no_points);
+            GeometryJob::copy(job->vl, v_l, no_vert);
+            GeometryJob::copy(job->ll, l_l, job->no_prim);
+            job->no_c = no_c;
+            job->colorbinding = colorbinding;
+            job->colorpacking = colorpacking;
+            GeometryJob::copy(job->r, rc, no_c);
+            GeometryJob::copy(job->g, gc, no_c);
+            GeometryJob::copy(job->b, bc, no_c);
+            GeometryJob::copy(job->pc, pc, no_c);
+            job->no_n = no_n;
+            job->normalbinding = normalbinding;
+            GeometryJob::copy(job->attr->nx, xn, no_n);
+            GeometryJob::copy(job->attr->ny, yn, no_n);
+            GeometryJob::copy(job->attr->nz, zn, no_n);
+            job->transparency = transparency;
+            job->vertexOrder = vertexOrder;
+            job->material = material;
+            job->texW = texW;
+            job->texH = texH;
+            job->pixS = pixS;
+            GeometryJob::copy(job->image, texImage, texW * texH * pixS);
+            job->no_t = no_t;
+            GeometryJob::copy(job->attr->tx, t_c[0], no_t);
+            GeometryJob::copy(job->attr->ty, t_c[1], no_t);
+            job->wrapMode = wrapMode;
+            job->minfm = minfm;
+            job->magfm = magfm;
+            job->no_va = no_va;
+            GeometryJob::copy(job->attr->vax, xva, no_va);
+            GeometryJob::copy(job->attr->vay, yva, no_va);
+            GeometryJob::copy(job->attr->vaz, zva, no_va);
+            job->cullBackfaces = cullBackfaces;
+            newNode = m_geometryWorkers->submit(job);
+        }
+        else if (!skipGeometryCreation)
         {
             if (strcmp(gtype, "UNIGRD") == 0)
             {
@@ -1623,7 +1807,8 @@ osg::Node *ObjectManager::addGeometry(const char *object, osg::Group *root, Covi
                                                                   no_n, normalbinding, xn, yn, zn, transparency,
                                                                   vertexOrder, material,
                                                                   texW, texH, pixS, texImage,
-                                                                  no_t, t_c[0], t_c[1], wrapMode, minfm, magfm, no_va, xva, yva, zva, cullBackfaces);
+                                                                  no_t, t_c[0], t_c[1], wrapMode, minfm, magfm, no_va, xva, yva, zva, cullBackfaces,
+                                                                  dataOwner);
             else if (strcmp(gtype, "TRIANG") == 0)
                 newNode = GeometryManager::instance()->addTriangleStrip(object, no_strip, no_vert,
                                                                         no_points, x_c, y_c, z_c,
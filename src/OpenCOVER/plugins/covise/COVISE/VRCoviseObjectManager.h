@@ -26,9 +26,14 @@
 
 #include <osg/Matrix>
 #include <osg/ColorMask>
+#include <osg/ref_ptr>
+#include <osg/Referenced>
+#include <osg/observer_ptr>
 
 #include <util/coMaterial.h>
+#include <deque>
 #include <map>
+#include <vector>
 
 #define MAXSETS 8000
 
@@ -51,6 +56,8 @@ class CoviseRenderObject;
 namespace opencover
 {
 class RenderObject;
+class GeometryWorkers;
+class SpatialGrouping;
 class coTUIUITab;
 class coVRShader;
 class coInteractor;
@@ -108,9 +115,13 @@ private:
     //		     coDistributedObject *normals,
     //	     coDistributedObject *colors);
     osg::Node *addGeometry(const char *object, osg::Group *root, CoviseRenderObject *geometry,
-                           CoviseRenderObject *normals, CoviseRenderObject *colors, CoviseRenderObject *texture, CoviseRenderObject *vertexAttribute, CoviseRenderObject *container, const char *lod);
+                           CoviseRenderObject *normals, CoviseRenderObject *colors, CoviseRenderObject *texture, CoviseRenderObject *vertexAttribute, CoviseRenderObject *container, const char *lod,
+                           osg::Referenced *dataOwner);
     void removeGeometry(const char *name, bool);
 
+    bool canDefer(const char *gtype, CoviseRenderObject *geometry, CoviseRenderObject *texture,
+                  CoviseRenderObject *container, int colorpacking, bool rotator) const;
+
     opencover::coInteractor *handleInteractors(CoviseRenderObject *container,
                            CoviseRenderObject *geo, CoviseRenderObject *norm, CoviseRenderObject *col, CoviseRenderObject *tex) const;
 
@@ -121,10 +132,32 @@ private:
     ColorMaps colormaps;
     const ColorMap &getColorMap(const std::string &species);
 
-    typedef std::map<std::string, CoviseRenderObject *> RenderObjectMap;
+    // render objects are deleted when no geometry refers to their arrays anymore
+    typedef std::map<std::string, osg::ref_ptr<osg::Referenced> > RenderObjectMap;
     RenderObjectMap m_roMap;
     coVRPlugin *m_plugin = nullptr;
 
+    // draw threads may still render removed nodes for a few frames,
+    // their render objects are released once these frames are done
+    struct Release
+    {
+        unsigned int frame; ///< frame counter when the object was deleted
+        osg::ref_ptr<osg::Node> node;
+        osg::ref_ptr<osg::Referenced> objects;
+    };
+    std::deque<Release> m_releaseQueue;
+    unsigned int m_frame = 0;
+
+    // background creation of surface geometry
+    GeometryWorkers *m_geometryWorkers = nullptr;
+    int m_attachObjects = 8; ///< max. number of nodes attached per frame
+    int m_attachVertices = 1000000; ///< max. number of coordinates attached per frame
+
+    // spatial hierarchy for sets with many elements
+    SpatialGrouping *m_spatialGrouping = nullptr;
+    /// sets waiting for background geometry, and whether their elements may be merged
+    std::vector<std::pair<osg::observer_ptr<osg::Group>, bool> > m_groupingPending;
+
 public:
     static ObjectManager *instance();
 
@@ -135,6 +168,11 @@ public:
     void coviseError(const char *error);
 
     void update(void);
+    /// attach geometry finished in the background to the scene graph
+    void attachGeometry();
+    /// release deleted objects which cannot be in use by draw threads anymore, call once per frame
+    void releaseObjects();
+    bool geometryPending() const;
 };
 }
 #endif
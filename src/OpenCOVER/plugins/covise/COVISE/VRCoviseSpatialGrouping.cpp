@@ -0,0 +1,271 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#include "VRCoviseSpatialGrouping.h"
+#include <CovisePluginUtil/VRCoviseArray.h>
+#include <cover/coVRPluginSupport.h>
+#include <config/CoviseConfig.h>
+
+#include <osg/Geode>
+#include <osg/Geometry>
+#include <osg/Version>
+#include <osgUtil/Optimizer>
+
+#include <algorithm>
+#include <typeinfo>
+#include <stdio.h>
+
+using namespace opencover;
+using covise::coCoviseConfig;
+
+namespace
+{
+
+// maximum number of vertices of a geometry created by merging
+const unsigned int MaxMergedVertices = 65536;
+
+bool isPlain(const osg::Node *node)
+{
+    return !node->getUserData() && !node->getUpdateCallback() && !node->getEventCallback() && !node->getCullCallback();
+}
+
+// geode which may be merged with others, unwrapping the group created for deferred geometry
+osg::Geode *mergeableGeode(osg::Node *node, int maxVertices)
+{
+    if (typeid(*node) == typeid(osg::Group) && isPlain(node) && !node->getStateSet()
+        && node->asGroup()->getNumChildren() == 1)
+        node = node->asGroup()->getChild(0);
+    if (typeid(*node) != typeid(osg::Geode) || !isPlain(node) || node->getNumParents() != 1)
+        return NULL;
+
+    osg::Geode *geode = node->asGeode();
+    int vertices = 0;
+    for (unsigned int i = 0; i < geode->getNumDrawables(); ++i)
+    {
+        osg::Geometry *geom = geode->getDrawable(i)->asGeometry();
+        if (!geom || !isPlain(geom) || geom->getNumParents() != 1 || geom->getStateSet())
+            return NULL;
+        const osg::Vec3Array *vertexArray = dynamic_cast<const osg::Vec3Array *>(geom->getVertexArray());
+        if (!vertexArray)
+            return NULL;
+        vertices += vertexArray->size();
+    }
+    if (vertices >= maxVertices || geode->getNumDrawables() == 0)
+        return NULL;
+    return geode;
+}
+
+bool sameState(const osg::Geode *a, const osg::Geode *b)
+{
+    if (a->getNodeMask() != b->getNodeMask())
+        return false;
+    const osg::StateSet *sa = a->getStateSet(), *sb = b->getStateSet();
+    if (!sa || !sb)
+        return sa == sb;
+    return sa == sb || sa->compare(*sb, true) == 0;
+}
+
+// arrays referencing COVISE objects cannot be appended to, so they are copied
+osg::Array *plainArray(osg::Array *array)
+{
+    CoviseArray *ca = dynamic_cast<CoviseArray *>(array);
+    if (!ca)
+        return array;
+
+    unsigned int n = ca->getNumElements();
+    const float *data = static_cast<const float *>(ca->getDataPointer());
+    osg::Array *copy = NULL;
+    switch (ca->getDataSize())
+    {
+    case 1:
+        copy = new osg::FloatArray(n, data);
+        break;
+    case 2:
+        copy = new osg::Vec2Array(n, reinterpret_cast<const osg::Vec2 *>(data));
+        break;
+    case 3:
+        copy = new osg::Vec3Array(n, reinterpret_cast<const osg::Vec3 *>(data));
+        break;
+    default:
+        return array;
+    }
+    copy->setBinding(ca->getBinding());
+    copy->setNormalize(ca->getNormalize());
+    return copy;
+}
+
+void makePlain(osg::Geometry *geom)
+{
+    if (geom->getNormalArray())
+        geom->setNormalArray(plainArray(geom->getNormalArray()));
+    if (geom->getColorArray())
+        geom->setColorArray(plainArray(geom->getColorArray()));
+    for (unsigned int i = 0; i < geom->getNumTexCoordArrays(); ++i)
+        if (geom->getTexCoordArray(i))
+            geom->setTexCoordArray(i, plainArray(geom->getTexCoordArray(i)));
+    for (unsigned int i = 0; i < geom->getNumVertexAttribArrays(); ++i)
+        if (geom->getVertexAttribArray(i))
+            geom->setVertexAttribArray(i, plainArray(geom->getVertexAttribArray(i)));
+    // the KdTree of the element does not fit the merged geometry
+    geom->setShape(NULL);
+}
+
+struct CenterLess
+{
+    int axis;
+    bool operator()(const osg::ref_ptr<osg::Node> &a, const osg::ref_ptr<osg::Node> &b) const
+    {
+        return a->getBound().center()[axis] < b->getBound().center()[axis];
+    }
+};
+}
+
+SpatialGrouping::SpatialGrouping()
+    : m_merge(false)
+    , m_numGroups(0)
+    , m_numMerged(0)
+{
+    m_enabled = coCoviseConfig::isOn("COVER.Plugin.COVISE.SpatialGrouping", false);
+    m_minChildren = coCoviseConfig::getInt("minChildren", "COVER.Plugin.COVISE.SpatialGrouping", 64);
+    m_leafSize = std::max(2, coCoviseConfig::getInt("leafSize", "COVER.Plugin.COVISE.SpatialGrouping", 8));
+    m_mergeVertices = coCoviseConfig::getInt("mergeVertices", "COVER.Plugin.COVISE.SpatialGrouping", 1000);
+}
+
+bool SpatialGrouping::enabled() const
+{
+    return m_enabled;
+}
+
+bool SpatialGrouping::apply(osg::Group *group, bool mergeElements)
+{
+    if (!m_enabled || !group || typeid(*group) != typeid(osg::Group))
+        return false;
+    if ((int)group->getNumChildren() < std::max(m_minChildren, m_leafSize + 1))
+        return false;
+
+    // children without bounds, e.g. empty elements, stay where they are
+    NodeList nodes, keep;
+    for (unsigned int i = 0; i < group->getNumChildren(); ++i)
+    {
+        osg::Node *child = group->getChild(i);
+        if (child->getBound().valid())
+            nodes.push_back(child);
+        else
+            keep.push_back(child);
+    }
+    if ((int)nodes.size() <= m_leafSize)
+        return false;
+
+    m_numGroups = m_numMerged = 0;
+    m_merge = mergeElements && m_mergeVertices > 0;
+    osg::ref_ptr<osg::Group> root = build(group->getName(), nodes, 0, nodes.size());
+
+    group->removeChildren(0, group->getNumChildren());
+    for (size_t i = 0; i < root->getNumChildren(); ++i)
+        group->addChild(root->getChild(i));
+    for (size_t i = 0; i < keep.size(); ++i)
+        group->addChild(keep[i].get());
+
+    if (cover->debugLevel(2))
+        fprintf(stderr, "SpatialGrouping: %s: %d elements in %d groups, %d elements merged\n",
+                group->getName().c_str(), (int)nodes.size(), m_numGroups, m_numMerged);
+    return true;
+}
+
+osg::Group *SpatialGrouping::build(const std::string &name, NodeList &nodes, size_t begin, size_t end)
+{
+    osg::Group *group = new osg::Group;
+    group->setName(name + "_bvh");
+    ++m_numGroups;
+
+    if (end - begin <= size_t(m_leafSize))
+    {
+        for (size_t i = begin; i < end; ++i)
+            group->addChild(nodes[i].get());
+        if (m_merge)
+            merge(group);
+        return group;
+    }
+
+    // split at median along longest extent of element centers
+    osg::BoundingBox bb;
+    for (size_t i = begin; i < end; ++i)
+        bb.expandBy(nodes[i]->getBound().center());
+    CenterLess less;
+    less.axis = 0;
+    for (int a = 1; a < 3; ++a)
+    {
+        if (bb._max[a] - bb._min[a] > bb._max[less.axis] - bb._min[less.axis])
+            less.axis = a;
+    }
+    size_t mid = begin + (end - begin) / 2;
+    std::nth_element(nodes.begin() + begin, nodes.begin() + mid, nodes.begin() + end, less);
+
+    group->addChild(build(name, nodes, begin, mid));
+    group->addChild(build(name, nodes, mid, end));
+    return group;
+}
+
+void SpatialGrouping::merge(osg::Group *leaf)
+{
+    // buckets of children with equal state
+    std::vector<std::vector<unsigned int> > buckets;
+    std::vector<osg::Geode *> geodes(leaf->getNumChildren());
+    for (unsigned int i = 0; i < leaf->getNumChildren(); ++i)
+    {
+        geodes[i] = mergeableGeode(leaf->getChild(i), m_mergeVertices);
+        if (!geodes[i])
+            continue;
+        size_t b = 0;
+        while (b < buckets.size() && !sameState(geodes[buckets[b][0]], geodes[i]))
+            ++b;
+        if (b == buckets.size())
+            buckets.push_back(std::vector<unsigned int>());
+        buckets[b].push_back(i);
+    }
+
+    NodeList remove;
+    for (size_t b = 0; b < buckets.size(); ++b)
+    {
+        if (buckets[b].size() < 2)
+            continue;
+
+        osg::Geode *first = geodes[buckets[b][0]];
+        osg::ref_ptr<osg::Geode> merged = new osg::Geode;
+        merged->setName(leaf->getName() + "_merged");
+        merged->setNodeMask(first->getNodeMask());
+        merged->setStateSet(first->getStateSet());
+        for (size_t i = 0; i < buckets[b].size(); ++i)
+        {
+            unsigned int c = buckets[b][i];
+            osg::Geode *geode = geodes[c];
+            std::vector<osg::ref_ptr<osg::Drawable> > drawables;
+            for (unsigned int d = 0; d < geode->getNumDrawables(); ++d)
+                drawables.push_back(geode->getDrawable(d));
+            geode->removeDrawables(0, geode->getNumDrawables());
+            for (size_t d = 0; d < drawables.size(); ++d)
+            {
+                makePlain(drawables[d]->asGeometry());
+                merged->addDrawable(drawables[d].get());
+            }
+            remove.push_back(leaf->getChild(c));
+        }
+        m_numMerged += buckets[b].size();
+
+        osgUtil::Optimizer::MergeGeometryVisitor mgv;
+        mgv.setTargetMaximumNumberOfVertices(MaxMergedVertices);
+#if (OSG_VERSION_LESS_THAN(3, 5, 0))
+        mgv.mergeGeode(*merged);
+#else
+        mgv.mergeGroup(*merged);
+#endif
+        leaf->addChild(merged.get());
+    }
+
+    for (size_t i = 0; i < remove.size(); ++i)
+        leaf->removeChild(remove[i].get());
+}
@@ -0,0 +1,58 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+/*! \file
+ \brief  reorganize the elements of a COVISE set into a spatial hierarchy
+
+ Sets with many elements, e.g. the blocks of a multi-block result, are
+ created as one group with a child per element. As the culler cannot
+ reject such elements in bulk, the children are sorted into a bounding
+ volume hierarchy of groups. Within a leaf of the hierarchy, elements
+ with few vertices and equal state may be merged into a single geometry.
+ This loses the names of their nodes, so it is only done for sets whose
+ elements are not needed for feedback, interactors or menus.
+ Timestep sequences are left alone, as their children are frames.
+ */
+
+#ifndef VR_COVISE_SPATIAL_GROUPING_H
+#define VR_COVISE_SPATIAL_GROUPING_H
+
+#include <osg/Group>
+#include <osg/ref_ptr>
+
+#include <string>
+#include <vector>
+
+namespace opencover
+{
+
+class SpatialGrouping
+{
+public:
+    SpatialGrouping();
+
+    /// grouping is configured
+    bool enabled() const;
+    /// reorganize the children of group, returns false if group was left unchanged
+    bool apply(osg::Group *group, bool mergeElements);
+
+private:
+    typedef std::vector<osg::ref_ptr<osg::Node> > NodeList;
+
+    osg::Group *build(const std::string &name, NodeList &nodes, size_t begin, size_t end);
+    void merge(osg::Group *leaf);
+
+    bool m_enabled;
+    int m_minChildren; ///< smaller sets are not reorganized
+    int m_leafSize; ///< max. children of leaf groups
+    int m_mergeVertices; ///< elements with fewer vertices are merged
+    bool m_merge; ///< merging allowed for current set
+
+    int m_numGroups, m_numMerged;
+};
+}
+#endif
@@ -0,0 +1,178 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#include "VRCoviseArray.h"
+
+#include <osg/Vec2>
+#include <osg/Vec3>
+
+#include <math.h>
+#include <vector>
+
+using namespace opencover;
+
+CoviseArray::CoviseArray()
+    : osg::Array(osg::Array::ArrayType, 1, GL_FLOAT)
+    , m_numElements(0)
+    , m_numComponents(1)
+    , m_normalize(false)
+{
+    m_comp[0] = m_comp[1] = m_comp[2] = NULL;
+}
+
+CoviseArray::CoviseArray(osg::Referenced *owner, unsigned int numElements, int numComponents,
+                         const float *c0, const float *c1, const float *c2, bool normalize)
+    : osg::Array(osg::Array::ArrayType, numComponents, GL_FLOAT)
+    , m_owner(owner)
+    , m_numElements(numElements)
+    , m_numComponents(numComponents)
+    , m_normalize(normalize && numComponents > 1)
+{
+    m_comp[0] = c0;
+    m_comp[1] = c1;
+    m_comp[2] = c2;
+}
+
+CoviseArray::CoviseArray(const CoviseArray &array, const osg::CopyOp &copyop)
+    : osg::Array(array, copyop)
+    , m_owner(array.m_owner)
+    , m_numElements(array.m_numElements)
+    , m_numComponents(array.m_numComponents)
+    , m_normalize(array.m_normalize)
+{
+    for (int c = 0; c < 3; ++c)
+        m_comp[c] = array.m_comp[c];
+}
+
+CoviseArray::~CoviseArray()
+{
+}
+
+void CoviseArray::accept(osg::ArrayVisitor &av)
+{
+    av.apply(*this);
+}
+
+void CoviseArray::accept(osg::ConstArrayVisitor &av) const
+{
+    av.apply(*this);
+}
+
+void CoviseArray::accept(unsigned int index, osg::ValueVisitor &vv)
+{
+    // data is read-only, the visitor only gets a copy
+    const float *v = interleave(index, 1);
+    switch (m_numComponents)
+    {
+    case 1:
+    {
+        GLfloat f = v[0];
+        vv.apply(f);
+        break;
+    }
+    case 2:
+    {
+        osg::Vec2 vec(v[0], v[1]);
+        vv.apply(vec);
+        break;
+    }
+    case 3:
+    {
+        osg::Vec3 vec(v[0], v[1], v[2]);
+        vv.apply(vec);
+        break;
+    }
+    }
+}
+
+void CoviseArray::accept(unsigned int index, osg::ConstValueVisitor &vv) const
+{
+    const float *v = interleave(index, 1);
+    switch (m_numComponents)
+    {
+    case 1:
+        vv.apply(v[0]);
+        break;
+    case 2:
+        vv.apply(osg::Vec2(v[0], v[1]));
+        break;
+    case 3:
+        vv.apply(osg::Vec3(v[0], v[1], v[2]));
+        break;
+    }
+}
+
+int CoviseArray::compare(unsigned int lhs, unsigned int rhs) const
+{
+    for (int c = 0; c < m_numComponents; ++c)
+    {
+        if (m_comp[c][lhs] < m_comp[c][rhs])
+            return -1;
+        if (m_comp[c][rhs] < m_comp[c][lhs])
+            return 1;
+    }
+    return 0;
+}
+
+unsigned int CoviseArray::getElementSize() const
+{
+    return m_numComponents * sizeof(float);
+}
+
+const GLvoid *CoviseArray::getDataPointer() const
+{
+    return interleave(0, m_numElements);
+}
+
+#if OSG_VERSION_GREATER_OR_EQUAL(3, 4, 0)
+const GLvoid *CoviseArray::getDataPointer(unsigned int index) const
+{
+    return interleave(index, m_numElements - index);
+}
+#endif
+
+unsigned int CoviseArray::getTotalDataSize() const
+{
+    return m_numElements * getElementSize();
+}
+
+unsigned int CoviseArray::getNumElements() const
+{
+    return m_numElements;
+}
+
+const float *CoviseArray::interleave(unsigned int first, unsigned int count) const
+{
+    if (m_numElements == 0 || !m_comp[0])
+        return NULL;
+
+    // scalar data can be handed out as is
+    if (m_numComponents == 1)
+        return m_comp[0] + first;
+
+    // one buffer per thread: buffer objects are filled from the
+    // pointer before the next array is asked for its data
+    static thread_local std::vector<float> buf;
+    buf.resize(count * m_numComponents);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        float *v = &buf[i * m_numComponents];
+        float len2 = 0.f;
+        for (int c = 0; c < m_numComponents; ++c)
+        {
+            v[c] = m_comp[c][first + i];
+            len2 += v[c] * v[c];
+        }
+        if (m_normalize && len2 > 0.f)
+        {
+            float s = 1.f / sqrtf(len2);
+            for (int c = 0; c < m_numComponents; ++c)
+                v[c] *= s;
+        }
+    }
+    return buf.empty() ? NULL : &buf[0];
+}
@@ -0,0 +1,73 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+/*! \file
+ \brief OSG array referencing the component arrays of a COVISE object
+
+ The data is not copied: the array points to the separate x, y, z
+ arrays of the object and holds a reference to an owner keeping them
+ valid. Components are interleaved only when OSG asks for a data
+ pointer, i.e. when a buffer object is filled, so geometry using
+ such arrays has to be drawn with vertex buffer objects.
+
+ As OSG treats this as an array of unknown type, it must not be
+ used for vertices, which are accessed element-wise for bounds and
+ intersections.
+ */
+
+#ifndef VR_COVISE_ARRAY_H
+#define VR_COVISE_ARRAY_H
+
+#include <osg/Array>
+#include <osg/ref_ptr>
+#include <osg/Version>
+
+namespace opencover
+{
+
+class CoviseArray : public osg::Array
+{
+public:
+    CoviseArray();
+    /// numComponents arrays of numElements floats, vectors are normalized on upload if normalize is set
+    CoviseArray(osg::Referenced *owner, unsigned int numElements, int numComponents,
+                const float *c0, const float *c1 = NULL, const float *c2 = NULL, bool normalize = false);
+    CoviseArray(const CoviseArray &array, const osg::CopyOp &copyop = osg::CopyOp::SHALLOW_COPY);
+
+    META_Object(opencover, CoviseArray);
+
+    virtual void accept(osg::ArrayVisitor &av);
+    virtual void accept(osg::ConstArrayVisitor &av) const;
+    virtual void accept(unsigned int index, osg::ValueVisitor &vv);
+    virtual void accept(unsigned int index, osg::ConstValueVisitor &vv) const;
+    virtual int compare(unsigned int lhs, unsigned int rhs) const;
+
+    virtual unsigned int getElementSize() const;
+    virtual const GLvoid *getDataPointer() const;
+    virtual unsigned int getTotalDataSize() const;
+    virtual unsigned int getNumElements() const;
+#if OSG_VERSION_GREATER_OR_EQUAL(3, 4, 0)
+    virtual const GLvoid *getDataPointer(unsigned int index) const;
+    virtual void reserveArray(unsigned int) {}
+    virtual void resizeArray(unsigned int) {}
+#endif
+
+protected:
+    virtual ~CoviseArray();
+
+private:
+    // interleaved data, valid until the next call from the same thread
+    const float *interleave(unsigned int first, unsigned int count) const;
+
+    osg::ref_ptr<osg::Referenced> m_owner;
+    unsigned int m_numElements;
+    int m_numComponents;
+    const float *m_comp[3];
+    bool m_normalize;
+};
+}
+#endif
@@ -51,8 +51,10 @@
 #include <osg/ColorMask>
 #include <osg/PolygonOffset>
 #include <osgUtil/SmoothingVisitor>
+#include <osgUtil/MeshOptimizers>
 #include <cover/coVRFileManager.h>
 #include "VRCoviseGeometryManager.h"
+#include "VRCoviseArray.h"
 #include <cover/coVRLighting.h>
 #include <cover/VRSceneGraph.h>
 #include <cover/coVRMSController.h>
@@ -112,10 +114,29 @@ GeometryManager::GeometryManager()
 
     d_kdtreeBuilder = new osg::KdTreeBuilder;
 
+    meshOptimization = coCoviseConfig::isOn("COVER.Plugin.COVISE.MeshOptimization", false);
+    std::string strips = coCoviseConfig::getEntry("strips", "COVER.Plugin.COVISE.MeshOptimization", "triangles");
+    if (strips == "join")
+        stripMode = JoinStrips;
+    else if (strips == "keep")
+        stripMode = KeepStrips;
+    else
+        stripMode = StripsToTriangles;
+    meshTriangles = meshMissesBefore = meshMissesAfter = 0;
+
     float r = coCoviseConfig::getFloat("r", "COVER.CoviseGeometryDefaultColor", 1.0f);
     float g = coCoviseConfig::getFloat("g", "COVER.CoviseGeometryDefaultColor", 1.0f);
     float b = coCoviseConfig::getFloat("b", "COVER.CoviseGeometryDefaultColor", 1.0f);
     coviseGeometryDefaultColor = osg::Vec4(r, g, b, 1.0f);
+
+    mainThread = std::this_thread::get_id();
+    globalDefaultMaterial = new osg::Material;
+    globalDefaultMaterial->setColorMode(osg::Material::AMBIENT_AND_DIFFUSE);
+    globalDefaultMaterial->setAmbient(osg::Material::FRONT_AND_BACK, osg::Vec4(0.2f, 0.2f, 0.2f, 1.0));
+    globalDefaultMaterial->setDiffuse(osg::Material::FRONT_AND_BACK, osg::Vec4(1.0f, 1.0f, 1.0f, 1.0));
+    globalDefaultMaterial->setSpecular(osg::Material::FRONT_AND_BACK, osg::Vec4(0.4f, 0.4f, 0.4f, 1.0));
+    globalDefaultMaterial->setEmission(osg::Material::FRONT_AND_BACK, osg::Vec4(0.0f, 0.0f, 0.0f, 1.0));
+    globalDefaultMaterial->setShininess(osg::Material::FRONT_AND_BACK, 16.0f);
 }
 GeometryManager::~GeometryManager()
 {
@@ -701,17 +722,6 @@ GeometryManager::addSGrid(const char *object,
 
 void GeometryManager::setDefaultMaterial(osg::StateSet *geoState, bool transparent, coMaterial *material, bool isLightingOn)
 {
-    if (globalDefaultMaterial.get() == NULL)
-    {
-        globalDefaultMaterial = new osg::Material;
-        globalDefaultMaterial->setColorMode(osg::Material::AMBIENT_AND_DIFFUSE);
-        globalDefaultMaterial->setAmbient(osg::Material::FRONT_AND_BACK, osg::Vec4(0.2f, 0.2f, 0.2f, 1.0));
-        globalDefaultMaterial->setDiffuse(osg::Material::FRONT_AND_BACK, osg::Vec4(1.0f, 1.0f, 1.0f, 1.0));
-        globalDefaultMaterial->setSpecular(osg::Material::FRONT_AND_BACK, osg::Vec4(0.4f, 0.4f, 0.4f, 1.0));
-        globalDefaultMaterial->setEmission(osg::Material::FRONT_AND_BACK, osg::Vec4(0.0f, 0.0f, 0.0f, 1.0));
-        globalDefaultMaterial->setShininess(osg::Material::FRONT_AND_BACK, 16.0f);
-    }
-
     if (material)
     {
         osg::Material *mymtl = new osg::Material;
@@ -724,10 +734,16 @@ void GeometryManager::setDefaultMaterial(osg::StateSet *geoState, bool transpare
         geoState->setAttributeAndModes(mymtl, osg::StateAttribute::ON);
         transparent = transparent || (material->transparency > 0.0f && material->transparency < 1.0);
     }
-    else
+    else if (std::this_thread::get_id() == mainThread)
     {
         geoState->setAttributeAndModes(globalDefaultMaterial.get(), osg::StateAttribute::ON);
     }
+    else
+    {
+        // the parent list of a shared attribute must not be modified concurrently
+        // with the render thread, so geometry built in the background gets its own copy
+        geoState->setAttributeAndModes(new osg::Material(*globalDefaultMaterial), osg::StateAttribute::ON);
+    }
 
     if (transparent)
     {
@@ -770,7 +786,7 @@ GeometryManager::addPolygon(const char *object_name,
                             float &transparency, int, coMaterial *material, int texWidth, int texHeight, int pixelSize, unsigned char *image,
                             int no_of_texCoords, float *tx, float *ty, osg::Texture::WrapMode wm, osg::Texture::FilterMode minfm, osg::Texture::FilterMode magfm,
                             int no_of_vertexAttributes,
-                            float *vax, float *vay, float *vaz, bool cullBackfaces)
+                            float *vax, float *vay, float *vaz, bool cullBackfaces, osg::Referenced *dataOwner)
 {
     if ((no_of_polygons == 0) || (no_of_coords == 0) || (no_of_vertices == 0))
     {
@@ -801,10 +817,19 @@ GeometryManager::addPolygon(const char *object_name,
         indexed = false;
     }
 
+    // per vertex attributes can refer to the COVISE arrays instead of copies
+    bool shared = indexed && dataOwner;
+
     osg::Geode *geode = new osg::Geode();
     geode->setName(object_name);
     osg::Geometry *geom = new osg::Geometry();
     cover->setRenderStrategy(geom);
+    if (shared)
+    {
+        // CoviseArray data is only interleaved for filling buffer objects
+        geom->setUseDisplayList(false);
+        geom->setUseVertexBufferObjects(true);
+    }
 
     // set up geometry
     osg::Vec3Array *vert = new osg::Vec3Array;
@@ -873,6 +898,12 @@ GeometryManager::addPolygon(const char *object_name,
             switch (colorbinding)
             {
             case Bind::PerVertex:
+                if (shared)
+                {
+                    geom->setVertexAttribArray(attribIdx, new CoviseArray(dataOwner, no_of_coords, 1, r));
+                    geom->setVertexAttribBinding(attribIdx, osg::Geometry::BIND_PER_VERTEX);
+                    break;
+                }
                 geom->setVertexAttribBinding(attribIdx, osg::Geometry::BIND_PER_VERTEX);
                 if (indexed)
                 {
@@ -999,6 +1030,13 @@ GeometryManager::addPolygon(const char *object_name,
         {
             //fprintf(stderr,"COVER INFO: colorbinding per vertex\n");
 
+            if (shared)
+            {
+                geom->setNormalArray(new CoviseArray(dataOwner, no_of_coords, 3, nx, ny, nz, true));
+                geom->setNormalBinding(osg::Geometry::BIND_PER_VERTEX);
+                break;
+            }
+
             osg::Vec3Array *normalArray = new osg::Vec3Array();
 
             if (indexed)
@@ -1070,7 +1108,11 @@ GeometryManager::addPolygon(const char *object_name,
         }
     }
 
-    if (no_of_texCoords)
+    if (no_of_texCoords && shared && no_of_texCoords == no_of_coords)
+    {
+        geom->setTexCoordArray(0, new CoviseArray(dataOwner, no_of_coords, 2, tx, ty));
+    }
+    else if (no_of_texCoords)
     {
         osg::Vec2Array *tcArray = new osg::Vec2Array();
 
@@ -1102,7 +1144,11 @@ GeometryManager::addPolygon(const char *object_name,
 
     osg::StateSet *geoState = geode->getOrCreateStateSet();
 
-    if (no_of_vertexAttributes > 0)
+    if (no_of_vertexAttributes > 0 && shared && no_of_vertexAttributes == no_of_coords)
+    {
+        geom->setVertexAttribArray(6, new CoviseArray(dataOwner, no_of_coords, 3, vax, vay, vaz));
+    }
+    else if (no_of_vertexAttributes > 0)
     {
         osg::Vec3Array *vertArray = new osg::Vec3Array;
         if (indexed)
@@ -1164,11 +1210,18 @@ GeometryManager::addPolygon(const char *object_name,
         osgUtil::SmoothingVisitor::smooth(*geom, CreaseAngle);
     }
 
-    for (auto &ps: geom->getPrimitiveSetList())
+    if (meshOptimization)
     {
-        if (auto de = dynamic_cast<osg::DrawElementsUInt *>(ps.get()))
+        optimizeMesh(object_name, geom);
+    }
+    else
+    {
+        for (auto &ps: geom->getPrimitiveSetList())
         {
-            tipsify(&(*de)[0], de->size());
+            if (auto de = dynamic_cast<osg::DrawElementsUInt *>(ps.get()))
+            {
+                tipsify(&(*de)[0], de->size());
+            }
         }
     }
 
@@ -1417,6 +1470,9 @@ GeometryManager::addTriangles(const char *object_name,
         osgUtil::SmoothingVisitor::smooth(*geom, CreaseAngle);
     }
 
+    if (meshOptimization)
+        optimizeMesh(object_name, geom);
+
 #if (OSG_VERSION_GREATER_OR_EQUAL(3, 4, 0))
     d_kdtreeBuilder->apply(*geom);
 #endif
@@ -1667,6 +1723,9 @@ GeometryManager::addQuads(const char *object_name,
         osgUtil::SmoothingVisitor::smooth(*geom, CreaseAngle);
     }
 
+    if (meshOptimization)
+        optimizeMesh(object_name, geom);
+
 #if (OSG_VERSION_GREATER_OR_EQUAL(3, 4, 0))
     d_kdtreeBuilder->apply(*geom);
 #endif
@@ -1676,6 +1735,99 @@ GeometryManager::addQuads(const char *object_name,
     return ((osg::Node *)geode);
 }
 
+void GeometryManager::optimizeMesh(const char *object_name, osg::Geometry *geom)
+{
+    bool strips = false;
+    for (auto &ps: geom->getPrimitiveSetList())
+    {
+        if (ps->getMode() == osg::PrimitiveSet::TRIANGLE_STRIP)
+            strips = true;
+    }
+    if (strips && stripMode == KeepStrips)
+        return;
+
+    osgUtil::VertexCacheMissVisitor before;
+    before.doGeometry(*geom);
+
+    // arrays referencing COVISE objects cannot be reordered, only the index list
+    bool shared = dynamic_cast<CoviseArray *>(geom->getNormalArray()) || dynamic_cast<CoviseArray *>(geom->getColorArray());
+    for (unsigned int i = 0; i < geom->getNumTexCoordArrays(); ++i)
+        shared |= dynamic_cast<CoviseArray *>(geom->getTexCoordArray(i)) != NULL;
+    for (unsigned int i = 0; i < geom->getNumVertexAttribArrays(); ++i)
+        shared |= dynamic_cast<CoviseArray *>(geom->getVertexAttribArray(i)) != NULL;
+
+    if (strips && stripMode == JoinStrips)
+    {
+        // a single draw call instead of one per strip, primitive restart indices
+        // would not be understood by triangle functors used for intersections
+        osg::Geometry::PrimitiveSetList list;
+        for (auto &ps: geom->getPrimitiveSetList())
+        {
+            auto dal = dynamic_cast<osg::DrawArrayLengths *>(ps.get());
+            if (!dal || dal->getMode() != osg::PrimitiveSet::TRIANGLE_STRIP)
+            {
+                list.push_back(ps);
+                continue;
+            }
+            osg::DrawElementsUInt *de = new osg::DrawElementsUInt(osg::PrimitiveSet::TRIANGLE_STRIP);
+            GLuint first = dal->getFirst();
+            for (GLuint len: *dal)
+            {
+                if (len < 3)
+                {
+                    first += len;
+                    continue;
+                }
+                if (!de->empty())
+                {
+                    de->push_back(de->back());
+                    de->push_back(first);
+                    // keep orientation of next strip
+                    if (de->size() % 2 == 1)
+                        de->push_back(first);
+                }
+                for (GLuint v = first; v < first + len; ++v)
+                    de->push_back(v);
+                first += len;
+            }
+            list.push_back(de);
+        }
+        geom->setPrimitiveSetList(list);
+    }
+    else if (!shared)
+    {
+        // merge equal vertices and convert all primitives to indexed triangles
+        osgUtil::IndexMeshVisitor imv;
+        imv.makeMesh(*geom);
+    }
+
+    for (auto &ps: geom->getPrimitiveSetList())
+    {
+        auto de = dynamic_cast<osg::DrawElementsUInt *>(ps.get());
+        if (de && de->getMode() == osg::PrimitiveSet::TRIANGLES && !de->empty())
+            tipsify(&(*de)[0], de->size());
+    }
+    if (!shared)
+    {
+        // store vertices in the order they are first used
+        osgUtil::VertexAccessOrderVisitor vaov;
+        vaov.optimizeOrder(*geom);
+    }
+
+    osgUtil::VertexCacheMissVisitor after;
+    after.doGeometry(*geom);
+
+    std::lock_guard<std::mutex> lock(meshStatsMutex);
+    // joined strips contain additional degenerate triangles
+    meshTriangles += before.triangles;
+    meshMissesBefore += before.misses;
+    meshMissesAfter += after.misses;
+    if (cover->debugLevel(2) && before.triangles > 0)
+        fprintf(stderr, "GeometryManager: %s: %u triangles, ACMR %.3f -> %.3f, all objects %.3f -> %.3f\n",
+                object_name, before.triangles, (float)before.misses / before.triangles, (float)after.misses / before.triangles,
+                (float)meshMissesBefore / meshTriangles, (float)meshMissesAfter / meshTriangles);
+}
+
 void
 GeometryManager::setTexture(const unsigned char *image, int pixelSize, int texWidth, int texHeight, osg::StateSet *geoState, osg::Texture::WrapMode wm, osg::Texture::FilterMode minfm, osg::Texture::FilterMode magfm)
 {
@@ -2020,6 +2172,9 @@ osg::Node *GeometryManager::addTriangleStrip(const char *object_name,
         osgUtil::SmoothingVisitor::smooth(*geom, CreaseAngle);
     }
 
+    if (meshOptimization)
+        optimizeMesh(object_name, geom);
+
 #if (OSG_VERSION_GREATER_OR_EQUAL(3, 4, 0))
     d_kdtreeBuilder->apply(*geom);
 #endif
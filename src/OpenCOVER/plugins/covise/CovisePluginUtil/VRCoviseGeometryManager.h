@@ -29,6 +29,9 @@ using covise::coMaterial;
 #include <osg/ref_ptr>
 #include <osg/KdTree>
 
+#include <mutex>
+#include <thread>
+
 namespace osg
 {
 class DrawElementsUShort;
@@ -51,6 +54,7 @@ private:
     int sequential;
 
     osg::ref_ptr<osg::Material> globalDefaultMaterial;
+    std::thread::id mainThread; // geometry may also be created from other threads
 
     void setDefaultMaterial(osg::StateSet *geoState, bool transparent, coMaterial *material = NULL, bool isLightingOn = true);
 
@@ -58,6 +62,19 @@ private:
 
     osg::Vec4 coviseGeometryDefaultColor;
 
+    // reordering of surface geometry for vertex cache and vertex fetch locality
+    enum StripMode
+    {
+        KeepStrips, ///< draw strips as they come
+        StripsToTriangles, ///< convert to indexed triangles and optimize them
+        JoinStrips ///< one indexed strip, strips connected by degenerate triangles
+    };
+    bool meshOptimization;
+    StripMode stripMode;
+    std::mutex meshStatsMutex;
+    size_t meshTriangles, meshMissesBefore, meshMissesAfter; // simulated vertex cache misses
+    void optimizeMesh(const char *object_name, osg::Geometry *geom);
+
 public:
     static GeometryManager *instance();
     GeometryManager();
@@ -88,6 +105,9 @@ public:
                         int normalbinding,
                         float *nx, float *ny, float *nz, float &transparency);
 
+    /// if dataOwner is given, per vertex attributes of indexed geometry refer to the
+    /// arrays passed in instead of copies, the arrays have to live as long as dataOwner,
+    /// vertex coordinates are always copied
     osg::Node *addPolygon(const char *object_name,
                           int no_of_polygons, int no_of_vertices, int no_of_coords,
                           float *x_c, float *y_c, float *z_c,
@@ -100,7 +120,8 @@ public:
                           coMaterial *, int texWidth, int texHeight, int pixelSize, unsigned char *image,
                           int no_of_texCoords, float *tx, float *ty, osg::Texture::WrapMode wm, osg::Texture::FilterMode minfm, osg::Texture::FilterMode magfm,
                           int no_of_vertexAttributes,
-                          float *vax, float *vay, float *vaz, bool cullBackfaces);
+                          float *vax, float *vay, float *vaz, bool cullBackfaces,
+                          osg::Referenced *dataOwner = NULL);
 
     osg::Node *addTriangles(const char *object_name,
                             int no_of_vertices, int no_of_coords,
@@ -0,0 +1,101 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#include <cover/coVRPluginSupport.h>
+#include <cover/coInteractor.h>
+#include <cover/RenderObject.h>
+
+#include "RWCovisePlugin.h"
+
+#include <algorithm>
+
+RWCovisePlugin::RWCovisePlugin()
+: coVRPlugin(COVER_PLUGIN_NAME)
+{
+}
+
+RWCovisePlugin::~RWCovisePlugin()
+{
+    for (size_t i = 0; i < m_windows.size(); ++i)
+        m_windows[i].interactor->decRefCount();
+}
+
+void RWCovisePlugin::newInteractor(const RenderObject *ro, coInteractor *inter)
+{
+    if (strcmp(inter->getPluginName(), "RWCovise") != 0)
+        return;
+
+    Window win;
+    win.interactor = inter;
+    win.objName = ro->getName();
+    win.numSteps = inter->getNumUser() > 0 ? atoi(inter->getString(0)) : 0;
+    win.first = 0;
+    win.size = 1;
+    win.prefetch = 0;
+    win.requested = false;
+    inter->getIntScalarParam("window_start", win.first);
+    inter->getIntScalarParam("resident_window", win.size);
+    inter->getIntScalarParam("prefetch", win.prefetch);
+    inter->incRefCount();
+
+    // a new window of the same module replaces the old one
+    for (size_t i = 0; i < m_windows.size(); ++i)
+    {
+        if (m_windows[i].interactor->isSameModule(inter))
+        {
+            m_windows[i].interactor->decRefCount();
+            m_windows[i] = win;
+            return;
+        }
+    }
+    m_windows.push_back(win);
+
+    if (cover->debugLevel(3))
+        std::cerr << "RWCovisePlugin::newInteractor: " << win.objName << ": " << win.numSteps
+                  << " steps, window " << win.first << "+" << win.size << std::endl;
+}
+
+void RWCovisePlugin::removeObject(const char *objName, bool replace)
+{
+    if (replace)
+        return;
+
+    for (size_t i = 0; i < m_windows.size(); ++i)
+    {
+        if (m_windows[i].objName == objName)
+        {
+            m_windows[i].interactor->decRefCount();
+            m_windows.erase(m_windows.begin() + i);
+            return;
+        }
+    }
+}
+
+void RWCovisePlugin::setTimestep(int t)
+{
+    for (size_t i = 0; i < m_windows.size(); ++i)
+    {
+        Window &win = m_windows[i];
+        if (win.requested || win.numSteps <= 0 || win.size >= win.numSteps)
+            continue;
+
+        // position of the step within the (cyclic) window
+        int step = t % win.numSteps;
+        int offset = (step - win.first % win.numSteps + win.numSteps) % win.numSteps;
+        int ahead = std::min(std::max(win.prefetch, 0), win.size - 1);
+        if (offset < win.size - ahead)
+            continue;
+
+        // the new window starts at the current step, so that it
+        // is read while the remaining steps are still displayed
+        win.interactor->setScalarParam("window_start", step);
+        win.interactor->executeModule();
+        win.requested = true;
+    }
+}
+
+COVERPLUGIN(RWCovisePlugin)
@@ -0,0 +1,52 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#ifndef RWCOVISE_PLUGIN_H
+#define RWCOVISE_PLUGIN_H
+
+//**************************************************************************
+//
+// * Description    : Moves the resident timestep window of RWCovise
+//                    modules reading lazily along with the animation
+//
+// **************************************************************************
+
+#include <cover/coVRPlugin.h>
+#include <string>
+#include <vector>
+
+using namespace opencover;
+
+class RWCovisePlugin : public coVRPlugin
+{
+public:
+    RWCovisePlugin();
+    ~RWCovisePlugin();
+
+    // this will be called if a COVISE object has to be removed
+    void removeObject(const char *objName, bool replace);
+
+    // this will be called when a COVISE object with a feedback object arrives
+    void newInteractor(const RenderObject *ro, coInteractor *inter);
+
+    // request the next window before the animation leaves the current one
+    void setTimestep(int t);
+
+private:
+    struct Window
+    {
+        coInteractor *interactor;
+        std::string objName;
+        int numSteps;
+        int first;
+        int size;
+        int prefetch;
+        bool requested;
+    };
+    std::vector<Window> m_windows;
+};
+#endif
@@ -19,6 +19,7 @@
 \**************************************************************************/
 
 #include "DeleteUnusedPoints.h"
+#include "coSpatialHashMerge.h"
 #include <do/coDoPolygons.h>
 #include <do/coDoLines.h>
 #include <do/coDoUnstructuredGrid.h>
@@ -27,7 +28,7 @@ using namespace covise;
 
 namespace covise
 {
-coDistributedObject *checkUSG(coDistributedObject *DistrObj, const coObjInfo &outInfo)
+coDistributedObject *checkUSG(coDistributedObject *DistrObj, const coObjInfo &outInfo, bool useHash)
 {
     coDistributedObject *NewDistrObj = NULL;
     // temp
@@ -124,12 +125,19 @@ coDistributedObject *checkUSG(coDistributedObject *DistrObj, const coObjInfo &ou
         }
     }
     // what we do next depends on the chosen algorithm
-
-    boundingBox(&xcoord, &ycoord, &zcoord, coordInBox, numCoordInBox,
-                &bbx1, &bby1, &bbz1, &bbx2, &bby2, &bbz2);
-    computeCell(xcoord, ycoord, zcoord,
-                coordInBox, numCoordInBox, bbx1, bby1, bbz1,
-                bbx2, bby2, bbz2, maxCoord, replBy, numCoordToRemove);
+    if (useHash)
+    {
+        numCoordToRemove += coSpatialHashMerge::merge(replBy, xcoord, ycoord, zcoord,
+                                                      coordInBox, numCoordInBox, 0.0f);
+    }
+    else
+    {
+        boundingBox(&xcoord, &ycoord, &zcoord, coordInBox, numCoordInBox,
+                    &bbx1, &bby1, &bbz1, &bbx2, &bby2, &bbz2);
+        computeCell(xcoord, ycoord, zcoord,
+                    coordInBox, numCoordInBox, bbx1, bby1, bbz1,
+                    bbx2, bby2, bbz2, maxCoord, replBy, numCoordToRemove);
+    }
 
     // partially clean up
     delete[] coordInBox;
@@ -35,7 +35,8 @@ int numFiltered;
 
 // functions
 // this is the main function which must be used, if you want to fix USG
-ALGEXPORT coDistributedObject *checkUSG(coDistributedObject *DistrObj, const coObjInfo &outInfo);
+// useHash: find doubled points with coSpatialHashMerge, otherwise with the octant recursion
+ALGEXPORT coDistributedObject *checkUSG(coDistributedObject *DistrObj, const coObjInfo &outInfo, bool useHash = true);
 
 // these are helping funktions for checkUSG
 coDistributedObject *filterCoordinates(coDistributedObject *obj_in, const coObjInfo &outInfo,
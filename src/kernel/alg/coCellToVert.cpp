@@ -20,6 +20,10 @@
 #include <do/coDoPolygons.h>
 #include <do/coDoUnstructuredGrid.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace covise
 {
 inline double sqr(float x)
@@ -32,6 +36,13 @@ using namespace covise;
 
 #define NODES_IN_ELEM(i) (((i) == num_elem - 1) ? num_conn - elem_list[(i)] : elem_list[(i) + 1] - elem_list[(i)])
 
+coCellToVert::coCellToVert()
+    : adjacencyConn_(NULL)
+    , adjacencyNumConn_(0)
+    , adjacencyNumPoint_(0)
+{
+}
+
 ////// workin' routines
 bool
 coCellToVert::interpolate(bool unstructured, int num_elem, int num_conn, int num_point,
@@ -97,95 +108,101 @@ coCellToVert::interpolate(bool unstructured, int num_elem, int num_conn, int num
     return true;
 }
 
+void
+coCellToVert::buildVertexCells(int num_elem, int num_conn, int num_point,
+                               const int *elem_list, const int *conn_list)
+{
+    if (!gridName_.empty() && gridName_ == adjacencyGrid_
+        && adjacencyConn_ == conn_list && adjacencyNumConn_ == num_conn
+        && adjacencyNumPoint_ == num_point)
+    {
+        return;
+    }
+
+    int i, j, n;
+    vertexCellIndex_.assign(num_point + 1, 0);
+    for (i = 0; i < num_elem; i++)
+    {
+        n = NODES_IN_ELEM(i);
+        for (j = 0; j < n; j++)
+            vertexCellIndex_[conn_list[elem_list[i] + j] + 1]++;
+    }
+    for (i = 0; i < num_point; i++)
+        vertexCellIndex_[i + 1] += vertexCellIndex_[i];
+
+    // cells are entered in ascending order, so summing them up per vertex
+    // happens in the same order as in the former scatter loop
+    vertexCells_.resize(vertexCellIndex_[num_point]);
+    std::vector<int> fill(vertexCellIndex_.begin(), vertexCellIndex_.end() - 1);
+    for (i = 0; i < num_elem; i++)
+    {
+        n = NODES_IN_ELEM(i);
+        for (j = 0; j < n; j++)
+            vertexCells_[fill[conn_list[elem_list[i] + j]]++] = i;
+    }
+
+    adjacencyGrid_ = gridName_;
+    adjacencyConn_ = conn_list;
+    adjacencyNumConn_ = num_conn;
+    adjacencyNumPoint_ = num_point;
+}
+
 bool
 coCellToVert::simpleAlgo(int num_elem, int num_conn, int num_point,
                          const int *elem_list, const int *conn_list,
                          int numComp, int dataSize, const float *in_data_0, const float *in_data_1, const float *in_data_2,
                          float *out_data_0, float *out_data_1, float *out_data_2)
 {
-    int i, j, n, vertex;
     enum
     {
         SCALAR = 1,
         VECTOR = 3
     };
 
-    float *weight_num;
-    weight_num = new float[num_point];
-
-    if (!weight_num)
-        return false;
+    buildVertexCells(num_elem, num_conn, num_point, elem_list, conn_list);
+    const int *index = &vertexCellIndex_[0];
+    const int *cells = vertexCells_.empty() ? NULL : &vertexCells_[0];
 
-    // reset everything to 0, != 0 to prevent div/0 errors
-    for (vertex = 0; vertex < num_point; vertex++)
-        weight_num[vertex] = 1.0e-30f;
-
-    if (numComp == SCALAR)
-        for (vertex = 0; vertex < num_point; vertex++)
-            out_data_0[vertex] = 0.0;
-    else
+    // every vertex gathers the values of its adjacent cells,
+    // so vertices are independent of each other
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int vertex = 0; vertex < num_point; vertex++)
     {
-        for (vertex = 0; vertex < num_point; vertex++)
-            out_data_0[vertex] = 0.0;
-        for (vertex = 0; vertex < num_point; vertex++)
-            out_data_1[vertex] = 0.0;
-        for (vertex = 0; vertex < num_point; vertex++)
-            out_data_2[vertex] = 0.0;
-    }
-
-    if (numComp == SCALAR)
-        for (i = 0; i < num_elem; i++)
-        {
-            n = NODES_IN_ELEM(i);
-            for (j = 0; j < n; j++)
-            {
-                vertex = conn_list[elem_list[i] + j];
-                weight_num[vertex] += 1.0;
-                if (i < dataSize)
-                    out_data_0[vertex] += in_data_0[i];
-            }
-        }
-    else
-        for (i = 0; i < num_elem; i++)
+        // != 0 to prevent div/0 errors
+        float weight_num = 1.0e-30f;
+        float sum_0 = 0.0, sum_1 = 0.0, sum_2 = 0.0;
+        for (int k = index[vertex]; k < index[vertex + 1]; k++)
         {
-            n = NODES_IN_ELEM(i);
-            for (j = 0; j < n; j++)
+            int cell = cells[k];
+            weight_num += 1.0;
+            if (cell < dataSize)
             {
-                vertex = conn_list[elem_list[i] + j];
-                weight_num[vertex] += 1.0;
-                if (i < dataSize)
+                sum_0 += in_data_0[cell];
+                if (numComp != SCALAR)
                 {
-                    out_data_0[vertex] += in_data_0[i];
-                    out_data_1[vertex] += in_data_1[i];
-                    out_data_2[vertex] += in_data_2[i];
+                    sum_1 += in_data_1[cell];
+                    sum_2 += in_data_2[cell];
                 }
             }
         }
 
-    // divide value sum by 'weight' (# adjacent cells)
-
-    if (numComp == SCALAR)
-    {
-        for (vertex = 0; vertex < num_point; vertex++)
-            if (weight_num[vertex] >= 1.0)
-                out_data_0[vertex] /= weight_num[vertex];
-    }
-    else
-    {
-        for (vertex = 0; vertex < num_point; vertex++)
+        // divide value sum by 'weight' (# adjacent cells)
+        if (weight_num >= 1.0)
         {
-            if (weight_num[vertex] >= 1.0)
-            {
-                out_data_0[vertex] /= weight_num[vertex];
-                out_data_1[vertex] /= weight_num[vertex];
-                out_data_2[vertex] /= weight_num[vertex];
-            }
+            sum_0 /= weight_num;
+            sum_1 /= weight_num;
+            sum_2 /= weight_num;
+        }
+        out_data_0[vertex] = sum_0;
+        if (numComp != SCALAR)
+        {
+            out_data_1[vertex] = sum_1;
+            out_data_2[vertex] = sum_2;
         }
     }
 
-    // clean up
-    delete[] weight_num;
-
     return true;
 }
 
@@ -201,56 +218,35 @@ coCellToVert::weightedAlgo(int num_elem, int num_conn, int num_point,
 
     // now go through all elements and calculate their center
 
-    int *ePtr = (int *)elem_list;
-    int *tPtr = (int *)type_list;
-
-    int el_type;
-    int elem, num_vert_elem;
-    int vert, vertex, *vertex_id;
-
-    float *xc, *yc, *zc;
-
-    float *cell_center_0 = new float[num_elem];
-    float *cell_center_1 = new float[num_elem];
-    float *cell_center_2 = new float[num_elem];
+    std::vector<float> cell_center_0(num_elem);
+    std::vector<float> cell_center_1(num_elem);
+    std::vector<float> cell_center_2(num_elem);
 
     //static const int num_vertices_per_element[] = {0,2,3,4,4,5,6,8};
 
-    for (elem = 0; elem < num_elem; elem++)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int elem = 0; elem < num_elem; elem++)
     {
-        el_type = *tPtr++; // get this elements type (then go on to the next one)
-        //num_vert_elem = num_vertices_per_element[el_type];
-        if (elem == num_elem - 1)
-        {
-            num_vert_elem = num_conn - elem_list[elem];
-        }
-        else
-        {
-            num_vert_elem = elem_list[elem + 1] - elem_list[elem];
-        }
-
+        int el_type = type_list[elem]; // get this elements type
         // # of vertices in current element
-        vertex_id = (int *)conn_list + (*ePtr++); // get ptr to the first vertex-id of current element
-        // then go on to the next one
-
-        // place where to store the calculated center-coordinates in
-        xc = &cell_center_0[elem];
-        yc = &cell_center_1[elem];
-        zc = &cell_center_2[elem];
+        int num_vert_elem = NODES_IN_ELEM(elem);
+        const int *vertex_id = conn_list + elem_list[elem]; // ptr to the first vertex-id of current element
 
-        // reset
-        (*xc) = (*yc) = (*zc) = 0.0;
+        // the calculated center-coordinates
+        float xc = 0.0, yc = 0.0, zc = 0.0;
 
         //FIXME doesn't make sense for Polyhedrons
         // the center can be calculated now
         if (el_type == TYPE_POLYHEDRON)
         {
             int num_averaged = 0;
-            int facestart = conn_list[elem_list[elem]];
+            int facestart = vertex_id[0];
             bool face_done = true;
-            for (vert = 0; vert < num_vert_elem; vert++)
+            for (int vert = 0; vert < num_vert_elem; vert++)
             {
-                int cur_vert = conn_list[elem_list[elem] + vert];
+                int cur_vert = vertex_id[vert];
                 if (face_done)
                 {
                     facestart = cur_vert;
@@ -261,64 +257,59 @@ coCellToVert::weightedAlgo(int num_elem, int num_conn, int num_point,
                     face_done = true;
                     continue;
                 }
-                (*xc) += xcoord[cur_vert];
-                (*yc) += ycoord[cur_vert];
-                (*zc) += zcoord[cur_vert];
+                xc += xcoord[cur_vert];
+                yc += ycoord[cur_vert];
+                zc += zcoord[cur_vert];
                 ++num_averaged;
             }
-            (*xc) /= num_averaged;
-            (*yc) /= num_averaged;
-            (*zc) /= num_averaged;
+            xc /= num_averaged;
+            yc /= num_averaged;
+            zc /= num_averaged;
         }
         else
         {
-            for (vert = 0; vert < num_vert_elem; vert++)
+            for (int vert = 0; vert < num_vert_elem; vert++)
             {
-                (*xc) += xcoord[*vertex_id];
-                (*yc) += ycoord[*vertex_id];
-                (*zc) += zcoord[*vertex_id];
-                vertex_id++;
+                xc += xcoord[vertex_id[vert]];
+                yc += ycoord[vertex_id[vert]];
+                zc += zcoord[vertex_id[vert]];
             }
-            (*xc) /= num_vert_elem;
-            (*yc) /= num_vert_elem;
-            (*zc) /= num_vert_elem;
+            xc /= num_vert_elem;
+            yc /= num_vert_elem;
+            zc /= num_vert_elem;
         }
+        cell_center_0[elem] = xc;
+        cell_center_1[elem] = yc;
+        cell_center_2[elem] = zc;
     }
 
-    int actIndex = 0;
-    int ni, cp;
-
-    int *niPtr = (int *)neighbour_idx + 1;
-    int *cellPtr = (int *)neighbour_cells;
-
-    double weight_sum, weight;
-    double value_sum_0, value_sum_1, value_sum_2;
-    float vx, vy, vz, ccx, ccy, ccz;
-
-    for (vertex = 0; vertex < num_point; vertex++)
+    // every vertex gathers from its neighbour cells, so vertices are independent
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int vertex = 0; vertex < num_point; vertex++)
     {
-        weight_sum = 0.0;
-        value_sum_0 = 0.0;
-        value_sum_1 = 0.0;
-        value_sum_2 = 0.0;
+        double weight_sum = 0.0;
+        double value_sum_0 = 0.0;
+        double value_sum_1 = 0.0;
+        double value_sum_2 = 0.0;
 
-        vx = xcoord[vertex];
-        vy = ycoord[vertex];
-        vz = zcoord[vertex];
+        float vx = xcoord[vertex];
+        float vy = ycoord[vertex];
+        float vz = zcoord[vertex];
 
-        ni = *niPtr;
-
-        while (actIndex < ni) // loop over neighbour cells
+        // loop over neighbour cells
+        for (int actIndex = neighbour_idx[vertex]; actIndex < neighbour_idx[vertex + 1]; actIndex++)
         {
-            cp = *cellPtr;
-            ccx = cell_center_0[cp];
-            ccy = cell_center_1[cp];
-            ccz = cell_center_2[cp];
+            int cp = neighbour_cells[actIndex];
+            float ccx = cell_center_0[cp];
+            float ccy = cell_center_1[cp];
+            float ccz = cell_center_2[cp];
 
             // cells with 0 volume are not weigthed
             //XXX: was soll das?
             //weight = (weight==0.0) ? 0 : (1.0/weight);
-            weight = sqr(vx - ccx) + sqr(vy - ccy) + sqr(vz - ccz);
+            double weight = sqr(vx - ccx) + sqr(vy - ccy) + sqr(vz - ccz);
             weight_sum += weight;
 
             if (cp < dataSize)
@@ -332,12 +323,8 @@ coCellToVert::weightedAlgo(int num_elem, int num_conn, int num_point,
                     value_sum_2 += weight * in_data_2[cp];
                 }
             }
-
-            actIndex++;
-            cellPtr++;
         }
 
-        niPtr++;
         if (weight_sum == 0)
             weight_sum = 1.0;
 
@@ -404,6 +391,7 @@ coCellToVert::interpolate(const coDistributedObject *geo_in,
     {
         return NULL;
     }
+    gridName_ = geo_in->getName();
 
     int *neighbour_cells = NULL;
     int *neighbour_idx = NULL;
@@ -437,9 +425,11 @@ coCellToVert::interpolate(const coDistributedObject *geo_in,
         return NULL;
 
     bool unstructured = (dynamic_cast<const coDoUnstructuredGrid *>(geo_in) != NULL);
-    return interpolate(unstructured, num_elem, num_conn, num_point,
-                       elem_list, conn_list, type_list, neighbour_cells, neighbour_idx, xcoord, ycoord, zcoord,
-                       numComp, dataSize, in_data_0, in_data_1, in_data_2, objName, algo_option);
+    coDistributedObject *data_return = interpolate(unstructured, num_elem, num_conn, num_point,
+                                                   elem_list, conn_list, type_list, neighbour_cells, neighbour_idx, xcoord, ycoord, zcoord,
+                                                   numComp, dataSize, in_data_0, in_data_1, in_data_2, objName, algo_option);
+    gridName_.clear();
+    return data_return;
 }
 
 coDistributedObject *
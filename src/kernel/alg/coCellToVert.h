@@ -18,6 +18,8 @@
 // ++**********************************************************************/
 
 #include <covise/covise.h>
+#include <vector>
+#include <string>
 
 namespace covise
 {
@@ -57,7 +59,30 @@ private:
                     int numComp, int dataSize, const float *in_data_0, const float *in_data_1, const float *in_data_2,
                     float *out_data_0, float *out_data_1, float *out_data_2);
 
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    //
+    //   vertex to cell adjacency in CSR format for simpleAlgo: a vertex referenced several times
+    //   by one element is listed as often as it is referenced
+    //
+    //   the adjacency is kept as long as the grid (identified by gridName_) does not change,
+    //   so keep the coCellToVert object alive for interpolating several data sets on one grid
+    //
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    void buildVertexCells(int num_elem, int num_conn, int num_point,
+                          const int *elem_list, const int *conn_list);
+
+    std::string gridName_; // name of the grid currently interpolated on, empty if unknown
+    std::string adjacencyGrid_; // name of the grid vertexCells_ was built for
+    const int *adjacencyConn_;
+    int adjacencyNumConn_;
+    int adjacencyNumPoint_;
+    std::vector<int> vertexCells_;
+    std::vector<int> vertexCellIndex_;
+
 public:
+    coCellToVert();
+
     typedef enum
     {
         SQR_WEIGHT = 1,
@@ -23,6 +23,17 @@
 #include <do/coDoData.h>
 #include <do/coDoPixelImage.h>
 
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CO_COLORS_SSE2
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #define FAIL 0
 #define SUCCESS 1
 
@@ -86,6 +97,101 @@ AttributeList::copyFrom(const AttributeList &source)
 // Data values of more than  NoDataColorPercent*FLT_MAX are non-data values
 static const float NoDataColorPercent = 0.01f;
 
+coColorLut::coColorLut(const float (*map)[5], int numSteps, float min, float max,
+                       unsigned int noDataColor)
+    : lut_(numSteps)
+    , min_(min)
+    , delta_(numSteps / (max - min)) // cmap steps
+    , maxIdx_((float)(numSteps - 1))
+    , noDataColor_(noDataColor)
+{
+    for (int i = 0; i < numSteps; i++)
+    {
+        unsigned int r = (unsigned char)(int)(map[i][0] * 255);
+        unsigned int g = (unsigned char)(int)(map[i][1] * 255);
+        unsigned int b = (unsigned char)(int)(map[i][2] * 255);
+        unsigned int a = (unsigned char)(int)(map[i][3] * 255);
+        lut_[i] = (r << 24) | (g << 16) | (b << 8) | a;
+    }
+}
+
+unsigned int coColorLut::getColor(float value) const
+{
+    if (value >= NoDataColorPercent * FLT_MAX)
+        return noDataColor_;
+
+    // clamping before the conversion also maps NaN to the first entry
+    float f = (value - min_) * delta_;
+    if (!(f > 0.0f))
+        f = 0.0f;
+    if (f > maxIdx_)
+        f = maxIdx_;
+    return lut_[(int)f];
+}
+
+void coColorLut::mapChunk(const float *data, int num, unsigned int *packed) const
+{
+    int i = 0;
+#ifdef CO_COLORS_SSE2
+    const __m128 min = _mm_set1_ps(min_);
+    const __m128 delta = _mm_set1_ps(delta_);
+    const __m128 maxIdx = _mm_set1_ps(maxIdx_);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 noDataLimit = _mm_set1_ps(NoDataColorPercent * FLT_MAX);
+    const __m128i noDataColor = _mm_set1_epi32((int)noDataColor_);
+    const unsigned int *lut = &lut_[0];
+    for (; i + 4 <= num; i += 4)
+    {
+        __m128 v = _mm_loadu_ps(data + i);
+        __m128 f = _mm_mul_ps(_mm_sub_ps(v, min), delta);
+        // _mm_max_ps returns its 2nd operand for NaN
+        f = _mm_min_ps(_mm_max_ps(f, zero), maxIdx);
+        int idx[4];
+        _mm_storeu_si128((__m128i *)idx, _mm_cvttps_epi32(f));
+        __m128i color = _mm_set_epi32((int)lut[idx[3]], (int)lut[idx[2]], (int)lut[idx[1]], (int)lut[idx[0]]);
+        __m128i noData = _mm_castps_si128(_mm_cmpge_ps(v, noDataLimit));
+        color = _mm_or_si128(_mm_andnot_si128(noData, color), _mm_and_si128(noData, noDataColor));
+        _mm_storeu_si128((__m128i *)(packed + i), color);
+    }
+#endif
+    for (; i < num; i++)
+        packed[i] = getColor(data[i]);
+}
+
+void coColorLut::map(const float *data, int num, unsigned int *packed,
+                     const float *alpha, int repeat) const
+{
+    if (lut_.empty() || num <= 0)
+        return;
+
+    int numChunks = (num + CHUNK_SIZE - 1) / CHUNK_SIZE;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if (numChunks > 4)
+#endif
+    for (int c = 0; c < numChunks; c++)
+    {
+        int begin = c * CHUNK_SIZE;
+        int n = std::min((int)CHUNK_SIZE, num - begin);
+        unsigned int buffer[CHUNK_SIZE];
+        unsigned int *out = (repeat == 1) ? packed + begin : buffer;
+        mapChunk(data + begin, n, out);
+        if (alpha)
+        {
+            for (int i = 0; i < n; i++)
+            {
+                if (!(data[begin + i] >= NoDataColorPercent * FLT_MAX))
+                    out[i] = (out[i] & 0xffffff00) | (unsigned char)(int)(alpha[begin + i] * 255);
+            }
+        }
+        if (repeat != 1)
+        {
+            for (int i = 0; i < n; i++)
+                for (int replicate = 0; replicate < repeat; ++replicate)
+                    packed[(size_t)repeat * (begin + i) + replicate] = out[i];
+        }
+    }
+}
+
 coColor::coColor(int num_el, float *data_, const coDoColormap *colorMapIn)
     : numElem(num_el)
     , data(data_)
@@ -128,36 +234,11 @@ coColor::coColor(int num_el, float *data_, const coDoColormap *colorMapIn)
 
 coDistributedObject *coColor::createColors(const coObjInfo &info)
 {
-
-    float delta = steps_ / (max_ - min_); // cmap steps
-    int max_Idx = steps_ - 1;
-    int i;
-
     coDoRGBA *res = new coDoRGBA(info, numElem);
     int *dPtr;
     res->getAddress(&dPtr);
-    unsigned int *packed = (unsigned int *)dPtr;
-    unsigned char r, g, b, a;
-    for (i = 0; i < numElem; i++)
-    {
-        if (data[i] >= NoDataColorPercent * FLT_MAX)
-        {
-            packed[i] = d_noDataColor;
-        }
-        else
-        {
-            int idx = (int)((data[i] - min_) * delta);
-            if (idx < 0)
-                idx = 0;
-            if (idx > max_Idx)
-                idx = max_Idx;
-            r = (unsigned char)(actMap_[idx][0] * 255);
-            g = (unsigned char)(actMap_[idx][1] * 255);
-            b = (unsigned char)(actMap_[idx][2] * 255);
-            a = (unsigned char)(actMap_[idx][3] * 255);
-            packed[i] = (r << 24) | (g << 16) | (b << 8) | a;
-        }
-    }
+    coColorLut lut(actMap_, steps_, min_, max_, (unsigned int)d_noDataColor);
+    lut.map(data, numElem, (unsigned int *)dPtr);
 
     res->copyAllAttributes(NULL);
 
@@ -570,8 +651,6 @@ coDistributedObject *coColors::createColors(recObj &base, const coObjInfo &info,
     else
     {
         float *data = base.data; // where my data starts
-        float delta = steps_ / (max_ - min_); // cmap steps
-        int max_Idx = steps_ - 1;
 
         // packed RGBA data
         if (outStyle == RGBA)
@@ -579,39 +658,8 @@ coDistributedObject *coColors::createColors(recObj &base, const coObjInfo &info,
             coDoRGBA *res = new coDoRGBA(info, base.numElem * repeat);
             int *dPtr;
             res->getAddress(&dPtr);
-            unsigned int *packed = (unsigned int *)dPtr;
-            unsigned char r, g, b, a;
-            for (i = 0; i < base.numElem; i++)
-            {
-                int base = repeat * i;
-                if (data[i] >= NoDataColorPercent * FLT_MAX)
-                {
-                    // packed[i] = d_noDataColor;
-                    int replicate;
-                    for (replicate = 0; replicate < repeat; ++replicate)
-                    {
-                        packed[base + replicate] = d_noDataColor;
-                    }
-                }
-                else
-                {
-                    int idx = (int)((data[i] - min_) * delta);
-                    if (idx < 0)
-                        idx = 0;
-                    if (idx > max_Idx)
-                        idx = max_Idx;
-                    r = (unsigned char)(actMap_[idx][0] * 255);
-                    g = (unsigned char)(actMap_[idx][1] * 255);
-                    b = (unsigned char)(actMap_[idx][2] * 255);
-                    a = (unsigned char)(actMap_[idx][3] * 255);
-                    packed[base] = (r << 24) | (g << 16) | (b << 8) | a;
-                    int replicate;
-                    for (replicate = 1; replicate < repeat; ++replicate)
-                    {
-                        packed[base + replicate] = packed[base];
-                    }
-                }
-            }
+            coColorLut lut(actMap_, steps_, min_, max_, (unsigned int)d_noDataColor);
+            lut.map(data, base.numElem, (unsigned int *)dPtr, NULL, repeat);
             if (base.obj)
             {
                 res->copyAllAttributes(base.obj);
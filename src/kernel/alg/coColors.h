@@ -28,6 +28,7 @@
 #include <do/coDoIntArr.h>
 
 #include <utility>
+#include <vector>
 #include <cfloat>
 
 namespace covise
@@ -45,6 +46,35 @@ private:
     std::vector<std::pair<std::string, std::string> > m_attrList;
 };
 
+// Lookup table of packed RGBA colors for mapping scalar values with a fixed
+// range: the colormap is converted once, then every value costs one index
+// computation (4 at a time with SSE2) and one table read. Large arrays are
+// processed in parallel with OpenMP.
+class ALGEXPORT coColorLut
+{
+public:
+    coColorLut(const float (*map)[5], int numSteps, float min, float max,
+               unsigned int noDataColor = 0x00000000);
+
+    // map num values to packed RGBA, each color written repeat times;
+    // if alpha is given, it replaces the alpha of the colormap
+    void map(const float *data, int num, unsigned int *packed,
+             const float *alpha = NULL, int repeat = 1) const;
+
+    unsigned int getColor(float value) const;
+
+private:
+    enum
+    {
+        CHUNK_SIZE = 4096
+    };
+    void mapChunk(const float *data, int num, unsigned int *packed) const;
+
+    std::vector<unsigned int> lut_;
+    float min_, delta_, maxIdx_;
+    unsigned int noDataColor_;
+};
+
 class ALGEXPORT coColor
 {
 public:
@@ -6,6 +6,7 @@
  * License: LGPL 2+ */
 
 #include "coFixUsg.h"
+#include "coSpatialHashMerge.h"
 #include <do/coDoUnstructuredGrid.h>
 #include <do/coDoPolygons.h>
 #include <do/coDoData.h>
@@ -17,13 +18,15 @@ coFixUsg::coFixUsg()
     max_vertices_ = 50;
     delta_ = 0.;
     opt_mem_ = false;
+    algorithm_ = BOUNDING_BOX;
 };
 
-coFixUsg::coFixUsg(int max_vertices, float delta, bool opt_mem)
+coFixUsg::coFixUsg(int max_vertices, float delta, bool opt_mem, int algorithm)
 {
     max_vertices_ = max_vertices;
     delta_ = delta;
     opt_mem_ = opt_mem;
+    algorithm_ = algorithm;
 };
 
 int
@@ -83,15 +86,22 @@ coFixUsg::fixUsg(int num_elem, int num_conn, int num_coord,
         }
     }
     // what we do next depends on the chosen algorithm
-
-    float bbx1, bby1, bbz1;
-    float bbx2, bby2, bbz2;
-
-    boundingBox(&xcoord, &ycoord, &zcoord, coordInBox, numCoordInBox,
-                &bbx1, &bby1, &bbz1, &bbx2, &bby2, &bbz2);
-    computeCell(replBy, xcoord, ycoord, zcoord,
-                coordInBox, numCoordInBox, bbx1, bby1, bbz1,
-                bbx2, bby2, bbz2, opt_mem_, delta_ * delta_, max_vertices_);
+    if (algorithm_ == SPATIAL_HASH)
+    {
+        coSpatialHashMerge::merge(replBy, xcoord, ycoord, zcoord,
+                                  coordInBox, numCoordInBox, delta_);
+    }
+    else
+    {
+        float bbx1, bby1, bbz1;
+        float bbx2, bby2, bbz2;
+
+        boundingBox(&xcoord, &ycoord, &zcoord, coordInBox, numCoordInBox,
+                    &bbx1, &bby1, &bbz1, &bbx2, &bby2, &bbz2);
+        computeCell(replBy, xcoord, ycoord, zcoord,
+                    coordInBox, numCoordInBox, bbx1, bby1, bbz1,
+                    bbx2, bby2, bbz2, opt_mem_, delta_ * delta_, max_vertices_);
+    }
 
     // partially clean up
     delete[] coordInBox;
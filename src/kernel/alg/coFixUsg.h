@@ -36,6 +36,7 @@ private:
     int max_vertices_;
     float delta_;
     bool opt_mem_;
+    int algorithm_;
 
     bool isEqual(float x1, float y1, float z1,
                  float x2, float y2, float z2, float dist);
@@ -72,8 +73,15 @@ private:
     void computeWorkingLists(int num_coord, int *replyBy, int **src2fil, int **fil2src, int &num_target);
 
 public:
+    // algorithm used to find coincident points
+    enum
+    {
+        BOUNDING_BOX = 0, // recursive octant subdivision
+        SPATIAL_HASH = 1 // sorted hash grid, see coSpatialHashMerge
+    };
+
     coFixUsg();
-    coFixUsg(int max_vertices, float delta, bool opt_mem = false);
+    coFixUsg(int max_vertices, float delta, bool opt_mem = false, int algorithm = BOUNDING_BOX);
 
     enum
     {
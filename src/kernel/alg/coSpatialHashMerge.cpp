@@ -0,0 +1,228 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#include "coSpatialHashMerge.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace covise;
+
+namespace
+{
+
+struct Entry
+{
+    unsigned long long key;
+    int index;
+    bool operator<(const Entry &other) const
+    {
+        return key < other.key || (key == other.key && index < other.index);
+    }
+};
+
+// sort chunks in parallel, then merge them pairwise
+void parallelSort(std::vector<Entry> &entries)
+{
+#ifdef _OPENMP
+    int numChunks = omp_get_max_threads();
+    if (numChunks > 1 && entries.size() > 100000)
+    {
+        std::vector<size_t> bound(numChunks + 1);
+        for (int c = 0; c <= numChunks; ++c)
+            bound[c] = entries.size() * c / numChunks;
+#pragma omp parallel for
+        for (int c = 0; c < numChunks; ++c)
+            std::sort(entries.begin() + bound[c], entries.begin() + bound[c + 1]);
+        for (int width = 1; width < numChunks; width *= 2)
+        {
+#pragma omp parallel for
+            for (int c = 0; c < numChunks; c += 2 * width)
+            {
+                int mid = std::min(c + width, numChunks);
+                int end = std::min(c + 2 * width, numChunks);
+                if (mid < end)
+                    std::inplace_merge(entries.begin() + bound[c], entries.begin() + bound[mid],
+                                       entries.begin() + bound[end]);
+            }
+        }
+        return;
+    }
+#endif
+    std::sort(entries.begin(), entries.end());
+}
+
+unsigned long long mix(unsigned long long h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+unsigned long long floatBits(float f)
+{
+    if (f == 0.0f) // -0 == +0
+        f = 0.0f;
+    unsigned int bits;
+    memcpy(&bits, &f, sizeof(bits));
+    return bits;
+}
+
+const int CELL_BITS = 21;
+const long long MAX_CELL = (1 << CELL_BITS) - 1;
+
+inline unsigned long long cellKey(long long ix, long long iy, long long iz)
+{
+    return ((unsigned long long)ix << (2 * CELL_BITS)) | ((unsigned long long)iy << CELL_BITS) | (unsigned long long)iz;
+}
+}
+
+int coSpatialHashMerge::merge(int *replBy, const float *xcoord, const float *ycoord, const float *zcoord,
+                              const int *coordInBox, int numCoordInBox, float delta)
+{
+    if (numCoordInBox < 2)
+        return 0;
+
+    std::vector<Entry> entries(numCoordInBox);
+    int numReplaced = 0;
+
+    if (delta <= 0.0f)
+    {
+        // exact match: all coincident vertices share the same key
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int i = 0; i < numCoordInBox; ++i)
+        {
+            int v = coordInBox[i];
+            entries[i].key = mix(floatBits(xcoord[v]) ^ mix(floatBits(ycoord[v]) ^ mix(floatBits(zcoord[v]))));
+            entries[i].index = v;
+        }
+        parallelSort(entries);
+
+        // within a run of equal keys, replace every vertex by the first
+        // (i.e. smallest) one with the same coordinates
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 4096) reduction(+ : numReplaced)
+#endif
+        for (int i = 0; i < numCoordInBox; ++i)
+        {
+            if (i > 0 && entries[i - 1].key == entries[i].key)
+                continue;
+            int end = i + 1;
+            while (end < numCoordInBox && entries[end].key == entries[i].key)
+                ++end;
+            for (int j = i + 1; j < end; ++j)
+            {
+                int w = entries[j].index;
+                for (int k = i; k < j; ++k)
+                {
+                    int v = entries[k].index;
+                    if (xcoord[v] == xcoord[w] && ycoord[v] == ycoord[w] && zcoord[v] == zcoord[w])
+                    {
+                        replBy[w] = v;
+                        ++numReplaced;
+                        break;
+                    }
+                }
+            }
+        }
+        return numReplaced;
+    }
+
+    // tolerance: grid cells of edge length >= delta, so that all
+    // vertices within delta are found in the 27 surrounding cells
+    float min[3], max[3];
+    int v0 = coordInBox[0];
+    min[0] = max[0] = xcoord[v0];
+    min[1] = max[1] = ycoord[v0];
+    min[2] = max[2] = zcoord[v0];
+    for (int i = 1; i < numCoordInBox; ++i)
+    {
+        int v = coordInBox[i];
+        min[0] = std::min(min[0], xcoord[v]);
+        max[0] = std::max(max[0], xcoord[v]);
+        min[1] = std::min(min[1], ycoord[v]);
+        max[1] = std::max(max[1], ycoord[v]);
+        min[2] = std::min(min[2], zcoord[v]);
+        max[2] = std::max(max[2], zcoord[v]);
+    }
+    double cellSize = delta;
+    for (int k = 0; k < 3; ++k)
+        cellSize = std::max(cellSize, (double)(max[k] - min[k]) / MAX_CELL);
+    double invCellSize = 1.0 / cellSize;
+    float maxDistanceSqr = delta * delta;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int i = 0; i < numCoordInBox; ++i)
+    {
+        int v = coordInBox[i];
+        long long ix = std::min((long long)((xcoord[v] - min[0]) * invCellSize), MAX_CELL);
+        long long iy = std::min((long long)((ycoord[v] - min[1]) * invCellSize), MAX_CELL);
+        long long iz = std::min((long long)((zcoord[v] - min[2]) * invCellSize), MAX_CELL);
+        entries[i].key = cellKey(ix, iy, iz);
+        entries[i].index = v;
+    }
+    parallelSort(entries);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 4096) reduction(+ : numReplaced)
+#endif
+    for (int i = 0; i < numCoordInBox; ++i)
+    {
+        int w = entries[i].index;
+        long long ix = (long long)(entries[i].key >> (2 * CELL_BITS));
+        long long iy = (long long)((entries[i].key >> CELL_BITS) & MAX_CELL);
+        long long iz = (long long)(entries[i].key & MAX_CELL);
+        int best = -1;
+        for (long long nx = std::max(ix - 1, 0LL); nx <= std::min(ix + 1, MAX_CELL); ++nx)
+        {
+            for (long long ny = std::max(iy - 1, 0LL); ny <= std::min(iy + 1, MAX_CELL); ++ny)
+            {
+                for (long long nz = std::max(iz - 1, 0LL); nz <= std::min(iz + 1, MAX_CELL); ++nz)
+                {
+                    Entry first;
+                    first.key = cellKey(nx, ny, nz);
+                    first.index = -1;
+                    std::vector<Entry>::const_iterator it = std::lower_bound(entries.begin(), entries.end(), first);
+                    // entries of one cell are sorted by index, only smaller ones are candidates
+                    for (; it != entries.end() && it->key == first.key && it->index < w; ++it)
+                    {
+                        int v = it->index;
+                        if (best >= 0 && v >= best)
+                            break;
+                        float dx = xcoord[v] - xcoord[w];
+                        float dy = ycoord[v] - ycoord[w];
+                        float dz = zcoord[v] - zcoord[w];
+                        if (dx * dx + dy * dy + dz * dz <= maxDistanceSqr)
+                        {
+                            best = v;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+        if (best >= 0)
+        {
+            replBy[w] = best;
+            ++numReplaced;
+        }
+    }
+    return numReplaced;
+}
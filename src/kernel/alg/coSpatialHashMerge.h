@@ -0,0 +1,45 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#ifndef CO_SPATIAL_HASH_MERGE_H
+#define CO_SPATIAL_HASH_MERGE_H
+
+// +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++ Description: Find coincident vertices with a hash grid              ++
+// ++                 ( alternative to the octant recursion of coFixUsg ) ++
+// ++                                                                     ++
+// ++ Vertices are sorted by the key of the grid cell they fall into.     ++
+// ++ With delta == 0 the key hashes the exact coordinates, otherwise the ++
+// ++ cells have edge length >= delta and the 27 neighbouring cells are   ++
+// ++ searched. Does not degrade on clustered data and runs in parallel.  ++
+// ++**********************************************************************/
+
+#include <util/coExport.h>
+
+namespace covise
+{
+
+class ALGEXPORT coSpatialHashMerge
+{
+public:
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    //
+    //  Find the vertices among coordInBox which coincide with a vertex of smaller index
+    //        @param  replBy: replBy[v] is set to the smallest index of a vertex within distance
+    //                        delta, entries of other vertices are not touched
+    //        @param  coordInBox: list of the vertices to be checked
+    //        @param  numCoordInBox: length of coordInBox
+    //        @param  delta: max. distance between two vertices, 0 for exact match
+    //
+    //        @return : number of vertices marked for replacement
+    //
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    static int merge(int *replBy, const float *xcoord, const float *ycoord, const float *zcoord,
+                     const int *coordInBox, int numCoordInBox, float delta);
+};
+}
+#endif
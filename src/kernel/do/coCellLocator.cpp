@@ -0,0 +1,262 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#include "coCellLocator.h"
+
+#include <algorithm>
+#include <cfloat>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define CO_CELL_LOCATOR_SSE
+#endif
+
+using namespace covise;
+
+namespace
+{
+
+struct CentroidLess
+{
+    const float *centroids;
+    int axis;
+    bool operator()(int a, int b) const
+    {
+        return centroids[3 * a + axis] < centroids[3 * b + axis];
+    }
+};
+
+// spread the lower 10 bits of v so that there are two zero bits between each
+inline unsigned int expandBits(unsigned int v)
+{
+    v = (v * 0x00010001u) & 0xFF0000FFu;
+    v = (v * 0x00000101u) & 0x0F00F00Fu;
+    v = (v * 0x00000011u) & 0xC30C30C3u;
+    v = (v * 0x00000005u) & 0x49249249u;
+    return v;
+}
+
+inline unsigned int quantize(float v, float min, float scale)
+{
+    float q = (v - min) * scale;
+    if (q < 0.0f)
+        q = 0.0f;
+    if (q > 1023.0f)
+        q = 1023.0f;
+    return (unsigned int)q;
+}
+}
+
+coCellLocator::coCellLocator(int nelem, int nconn, const int *el, const int *conn,
+                             const float *x_c, const float *y_c, const float *z_c)
+    : nelem_(nelem)
+{
+    bbox_[0] = bbox_[1] = bbox_[2] = FLT_MAX;
+    bbox_[3] = bbox_[4] = bbox_[5] = -FLT_MAX;
+    if (nelem <= 0)
+        return;
+
+    cellBBoxes_.resize(6 * nelem);
+    std::vector<float> centroids(3 * nelem);
+    cells_.resize(nelem);
+    for (int i = 0; i < nelem; ++i)
+    {
+        cells_[i] = i;
+        float *cb = &cellBBoxes_[6 * i];
+        cb[0] = cb[1] = cb[2] = FLT_MAX;
+        cb[3] = cb[4] = cb[5] = -FLT_MAX;
+        int end = (i < nelem - 1) ? el[i + 1] : nconn;
+        for (int j = el[i]; j < end; ++j)
+        {
+            int v = conn[j];
+            cb[0] = std::min(cb[0], x_c[v]);
+            cb[1] = std::min(cb[1], y_c[v]);
+            cb[2] = std::min(cb[2], z_c[v]);
+            cb[3] = std::max(cb[3], x_c[v]);
+            cb[4] = std::max(cb[4], y_c[v]);
+            cb[5] = std::max(cb[5], z_c[v]);
+        }
+        for (int k = 0; k < 3; ++k)
+        {
+            centroids[3 * i + k] = 0.5f * (cb[k] + cb[k + 3]);
+            bbox_[k] = std::min(bbox_[k], cb[k]);
+            bbox_[k + 3] = std::max(bbox_[k + 3], cb[k + 3]);
+        }
+    }
+
+    nodes_.reserve(2 * nelem / LEAF_SIZE + 1);
+    build(0, nelem, centroids);
+}
+
+coCellLocator::~coCellLocator()
+{
+}
+
+void coCellLocator::boundsOf(int begin, int end, float *box) const
+{
+    box[0] = box[1] = box[2] = FLT_MAX;
+    box[3] = box[4] = box[5] = -FLT_MAX;
+    for (int i = begin; i < end; ++i)
+    {
+        const float *cb = &cellBBoxes_[6 * cells_[i]];
+        for (int k = 0; k < 3; ++k)
+        {
+            box[k] = std::min(box[k], cb[k]);
+            box[k + 3] = std::max(box[k + 3], cb[k + 3]);
+        }
+    }
+}
+
+// median split along the axis with the largest centroid extent
+int coCellLocator::splitRange(int begin, int end, std::vector<float> &centroids)
+{
+    float cmin[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+    float cmax[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    for (int i = begin; i < end; ++i)
+    {
+        const float *c = &centroids[3 * cells_[i]];
+        for (int k = 0; k < 3; ++k)
+        {
+            cmin[k] = std::min(cmin[k], c[k]);
+            cmax[k] = std::max(cmax[k], c[k]);
+        }
+    }
+    CentroidLess less;
+    less.centroids = &centroids[0];
+    less.axis = 0;
+    for (int k = 1; k < 3; ++k)
+    {
+        if (cmax[k] - cmin[k] > cmax[less.axis] - cmin[less.axis])
+            less.axis = k;
+    }
+    int mid = begin + (end - begin) / 2;
+    std::nth_element(cells_.begin() + begin, cells_.begin() + mid, cells_.begin() + end, less);
+    return mid;
+}
+
+int coCellLocator::build(int begin, int end, std::vector<float> &centroids)
+{
+    int index = (int)nodes_.size();
+    nodes_.push_back(Node());
+
+    // split into (up to) 4 ranges for the children of this node
+    int ranges[5];
+    int numRanges = 0;
+    int mid = splitRange(begin, end, centroids);
+    ranges[numRanges++] = begin;
+    if (mid - begin > LEAF_SIZE)
+        ranges[numRanges++] = splitRange(begin, mid, centroids);
+    ranges[numRanges++] = mid;
+    if (end - mid > LEAF_SIZE)
+        ranges[numRanges++] = splitRange(mid, end, centroids);
+    ranges[numRanges] = end;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        float box[6] = { FLT_MAX, FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX };
+        int child = 0, count = 0;
+        if (i < numRanges)
+        {
+            int b = ranges[i], e = ranges[i + 1];
+            boundsOf(b, e, box);
+            if (e - b > LEAF_SIZE)
+            {
+                child = build(b, e, centroids);
+                count = -1;
+            }
+            else
+            {
+                child = b;
+                count = e - b;
+            }
+        }
+        Node &node = nodes_[index];
+        for (int k = 0; k < 3; ++k)
+        {
+            node.bmin[k][i] = box[k];
+            node.bmax[k][i] = box[k + 3];
+        }
+        node.child[i] = child;
+        node.count[i] = count;
+    }
+    return index;
+}
+
+int coCellLocator::hitMask(const Node &node, const float *point, float tolerance) const
+{
+#ifdef CO_CELL_LOCATOR_SSE
+    __m128 hit = _mm_cmpeq_ps(_mm_setzero_ps(), _mm_setzero_ps()); // all bits set
+    for (int k = 0; k < 3; ++k)
+    {
+        __m128 lo = _mm_set1_ps(point[k] + tolerance);
+        __m128 hi = _mm_set1_ps(point[k] - tolerance);
+        hit = _mm_and_ps(hit, _mm_cmple_ps(_mm_loadu_ps(node.bmin[k]), lo));
+        hit = _mm_and_ps(hit, _mm_cmpge_ps(_mm_loadu_ps(node.bmax[k]), hi));
+    }
+    return _mm_movemask_ps(hit);
+#else
+    int mask = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        if (node.bmin[0][i] <= point[0] + tolerance && node.bmax[0][i] >= point[0] - tolerance
+            && node.bmin[1][i] <= point[1] + tolerance && node.bmax[1][i] >= point[1] - tolerance
+            && node.bmin[2][i] <= point[2] + tolerance && node.bmax[2][i] >= point[2] - tolerance)
+            mask |= 1 << i;
+    }
+    return mask;
+#endif
+}
+
+bool coCellLocator::isInBBox(int cell, const float *point, float tolerance) const
+{
+    if (cell < 0 || cell >= nelem_)
+        return false;
+    const float *cb = &cellBBoxes_[6 * cell];
+    if (point[0] < cb[0] - tolerance || point[0] > cb[3] + tolerance)
+        return false;
+    if (point[1] < cb[1] - tolerance || point[1] > cb[4] + tolerance)
+        return false;
+    if (point[2] < cb[2] - tolerance || point[2] > cb[5] + tolerance)
+        return false;
+    return true;
+}
+
+void coCellLocator::mortonOrder(int n, const float *x, const float *y, const float *z,
+                                std::vector<int> &order)
+{
+    order.resize(n);
+    if (n <= 0)
+        return;
+
+    float min[3] = { x[0], y[0], z[0] };
+    float max[3] = { x[0], y[0], z[0] };
+    for (int i = 1; i < n; ++i)
+    {
+        min[0] = std::min(min[0], x[i]);
+        min[1] = std::min(min[1], y[i]);
+        min[2] = std::min(min[2], z[i]);
+        max[0] = std::max(max[0], x[i]);
+        max[1] = std::max(max[1], y[i]);
+        max[2] = std::max(max[2], z[i]);
+    }
+    float scale[3];
+    for (int k = 0; k < 3; ++k)
+        scale[k] = (max[k] > min[k]) ? 1023.0f / (max[k] - min[k]) : 0.0f;
+
+    // morton code in the upper, point index in the lower 32 bits
+    std::vector<unsigned long long> keys(n);
+    for (int i = 0; i < n; ++i)
+    {
+        unsigned int code = (expandBits(quantize(x[i], min[0], scale[0])) << 2)
+                            | (expandBits(quantize(y[i], min[1], scale[1])) << 1)
+                            | expandBits(quantize(z[i], min[2], scale[2]));
+        keys[i] = ((unsigned long long)code << 32) | (unsigned int)i;
+    }
+    std::sort(keys.begin(), keys.end());
+    for (int i = 0; i < n; ++i)
+        order[i] = (int)(keys[i] & 0xFFFFFFFFu);
+}
@@ -0,0 +1,136 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#ifndef CO_CELL_LOCATOR_H
+#define CO_CELL_LOCATOR_H
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//  CLASS coCellLocator
+//
+//  Bounding volume hierarchy over the cell bounding boxes of an
+//  unstructured grid. Every node stores the boxes of its 4 children
+//  in SoA layout, so that a point is tested against all of them with
+//  one SIMD comparison. Unlike coDoOctTree the hierarchy lives in
+//  process memory only and is meant for bulk point location.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include <util/coExport.h>
+#include <vector>
+
+namespace covise
+{
+
+class DOEXPORT coCellLocator
+{
+public:
+    enum
+    {
+        LEAF_SIZE = 4 // maximum number of cells in a leaf
+    };
+
+    /** Constructor
+       * @param nelem number of cells
+       * @param nconn length of the connectivity list
+       * @param el array with "pointers" to the connectivity list for each element
+       * @param conn connectivity list
+       * @param x_c X coordinates of the grid points
+       * @param y_c Y coordinates of the grid points
+       * @param z_c Z coordinates of the grid points
+       */
+    coCellLocator(int nelem, int nconn, const int *el, const int *conn,
+                  const float *x_c, const float *y_c, const float *z_c);
+    virtual ~coCellLocator();
+
+    /** visit: call test(cell) for every cell whose bounding box,
+       * enlarged by tolerance, contains point, until test returns true
+       * @return the accepted cell or -1
+       */
+    template <class Test>
+    int visit(const float *point, float tolerance, Test &test) const;
+
+    /// returns true if the bounding box of cell contains point
+    bool isInBBox(int cell, const float *point, float tolerance) const;
+
+    /// bounding box of all cells: xmin, ymin, zmin, xmax, ymax, zmax
+    const float *getBBox() const
+    {
+        return bbox_;
+    }
+
+    int getNumNodes() const
+    {
+        return (int)nodes_.size();
+    }
+
+    /** mortonOrder: sort point indices along a Z-order curve, so that
+       * points which are close in space are processed one after another
+       * @param n number of points
+       * @param x X coordinates
+       * @param y Y coordinates
+       * @param z Z coordinates
+       * @param order output: permutation of 0..n-1
+       */
+    static void mortonOrder(int n, const float *x, const float *y, const float *z,
+                            std::vector<int> &order);
+
+private:
+    struct Node
+    {
+        float bmin[3][4];
+        float bmax[3][4];
+        int child[4]; // node index, or first position in cells_ for leaves
+        int count[4]; // -1 for inner nodes, number of cells for leaves
+    };
+
+    int build(int begin, int end, std::vector<float> &centroids);
+    void boundsOf(int begin, int end, float *box) const;
+    int splitRange(int begin, int end, std::vector<float> &centroids);
+    int hitMask(const Node &node, const float *point, float tolerance) const;
+
+    std::vector<Node> nodes_;
+    std::vector<int> cells_; // cell labels, permuted by the build
+    std::vector<float> cellBBoxes_; // 6 floats per cell
+    float bbox_[6];
+    int nelem_;
+};
+
+template <class Test>
+int coCellLocator::visit(const float *point, float tolerance, Test &test) const
+{
+    if (nodes_.empty())
+        return -1;
+
+    // depth of the hierarchy is not bounded for degenerate cell distributions
+    std::vector<int> stack;
+    stack.reserve(64);
+    stack.push_back(0);
+    while (!stack.empty())
+    {
+        const Node &node = nodes_[stack.back()];
+        stack.pop_back();
+        int mask = hitMask(node, point, tolerance);
+        for (int i = 0; i < 4; ++i)
+        {
+            if (!(mask & (1 << i)))
+                continue;
+            if (node.count[i] < 0)
+            {
+                stack.push_back(node.child[i]);
+                continue;
+            }
+            const int *c = &cells_[node.child[i]];
+            for (int j = 0; j < node.count[i]; ++j)
+            {
+                if (isInBBox(c[j], point, tolerance) && test(c[j]))
+                    return c[j];
+            }
+        }
+    }
+    return -1;
+}
+}
+#endif
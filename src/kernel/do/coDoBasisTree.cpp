@@ -9,6 +9,11 @@
 #include <util/coVector.h>
 #include <vector>
 #include <cmath>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace covise;
 
 coDoBasisTree::coDoBasisTree(const coObjInfo &info, const char *label1, const char *label2,
@@ -138,11 +143,38 @@ coDoBasisTree::MakeOctTree(int *el,
     grid_bbox_[3] = -FLT_MAX;
     grid_bbox_[4] = -FLT_MAX;
     grid_bbox_[5] = -FLT_MAX;
-    for (i = 0, cell_bbox_ = cell_bboxes; i < nelem; ++i, cell_bbox_ += 6)
+    // for each element calculate its BBox...
+    // ...and modify the grid BBox if necessary
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
     {
-        // for each element calculate its BBox...
-        // ...and modify the grid BBox if necessary
-        BBoxForElement(i);
+        float thread_bbox[6] = { FLT_MAX, FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX };
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+        for (i = 0; i < nelem; ++i)
+        {
+            float *cb = cell_bboxes + 6 * i;
+            CellBBox(i, cb);
+            for (int k = 0; k < 3; ++k)
+            {
+                if (thread_bbox[k] > cb[k])
+                    thread_bbox[k] = cb[k];
+                if (thread_bbox[k + 3] < cb[k + 3])
+                    thread_bbox[k + 3] = cb[k + 3];
+            }
+        }
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+        for (int k = 0; k < 3; ++k)
+        {
+            if (grid_bbox_[k] > thread_bbox[k])
+                grid_bbox_[k] = thread_bbox[k];
+            if (grid_bbox_[k + 3] < thread_bbox[k + 3])
+                grid_bbox_[k + 3] = thread_bbox[k + 3];
+        }
     }
     // check grid_bbox_ to prevent division by 0
     float dimX = grid_bbox_[3] - grid_bbox_[0];
@@ -208,20 +240,21 @@ coDoBasisTree::MakeOctTree(int *el,
     ShareCellsBetweenLeaves();
 }
 
-// assume cell_bbox_ points to the correct place for the i-th element
+// compute the bbox of the i-th element into cb,
+// does not touch any member and may be called concurrently
 void
-coDoBasisTree::BBoxForElement(int i)
+coDoBasisTree::CellBBox(int i, float *cb) const
 {
     // load cell bbox with first vertex coordinates
     int first_vertex = el_[i]; //cell list
     int point = conn_[first_vertex]; //vertices array
     int numvert;
-    cell_bbox_[0] = x_c_[point];
-    cell_bbox_[1] = y_c_[point];
-    cell_bbox_[2] = z_c_[point];
-    cell_bbox_[3] = x_c_[point];
-    cell_bbox_[4] = y_c_[point];
-    cell_bbox_[5] = z_c_[point];
+    cb[0] = x_c_[point];
+    cb[1] = y_c_[point];
+    cb[2] = z_c_[point];
+    cb[3] = x_c_[point];
+    cb[4] = y_c_[point];
+    cb[5] = z_c_[point];
     // find out number of vertices for this element
     if (i < nelem - 1)
     {
@@ -235,19 +268,26 @@ coDoBasisTree::BBoxForElement(int i)
     for (i = 1; i < numvert; ++i)
     {
         point = conn_[first_vertex + i];
-        if (cell_bbox_[0] > x_c_[point])
-            cell_bbox_[0] = x_c_[point];
-        if (cell_bbox_[1] > y_c_[point])
-            cell_bbox_[1] = y_c_[point];
-        if (cell_bbox_[2] > z_c_[point])
-            cell_bbox_[2] = z_c_[point];
-        if (cell_bbox_[3] < x_c_[point])
-            cell_bbox_[3] = x_c_[point];
-        if (cell_bbox_[4] < y_c_[point])
-            cell_bbox_[4] = y_c_[point];
-        if (cell_bbox_[5] < z_c_[point])
-            cell_bbox_[5] = z_c_[point];
+        if (cb[0] > x_c_[point])
+            cb[0] = x_c_[point];
+        if (cb[1] > y_c_[point])
+            cb[1] = y_c_[point];
+        if (cb[2] > z_c_[point])
+            cb[2] = z_c_[point];
+        if (cb[3] < x_c_[point])
+            cb[3] = x_c_[point];
+        if (cb[4] < y_c_[point])
+            cb[4] = y_c_[point];
+        if (cb[5] < z_c_[point])
+            cb[5] = z_c_[point];
     }
+}
+
+// assume cell_bbox_ points to the correct place for the i-th element
+void
+coDoBasisTree::BBoxForElement(int i)
+{
+    CellBBox(i, cell_bbox_);
     // do not let the bounding box be too thin!!!
     // correct grid bbox
     if (grid_bbox_[0] > cell_bbox_[0])
@@ -268,123 +308,159 @@ coDoBasisTree::BBoxForElement(int i)
 void
 coDoBasisTree::ShareCellsBetweenLeaves()
 {
-    int position;
     int no_p_leaves = fX_ * fY_ * fZ_;
     populations_ = new std::vector<int>[no_p_leaves];
-    // we want to reserve space for these infinite arrays...
-    int ini_room_per_tree = nelem / (no_p_leaves * 4) + 1;
-    int octtreeInd;
-    for (octtreeInd = 0; octtreeInd < no_p_leaves; ++octtreeInd)
-    {
-        populations_[octtreeInd].reserve(ini_room_per_tree);
-    }
-    int cell;
     float i_x_grid_l = 1.0f / (grid_bbox_[3] - grid_bbox_[0]);
     float i_y_grid_l = 1.0f / (grid_bbox_[4] - grid_bbox_[1]);
     float i_z_grid_l = 1.0f / (grid_bbox_[5] - grid_bbox_[2]);
-    for (cell = 0; cell < nelem; ++cell)
+
+    // every thread takes a contiguous range of cells and first counts
+    // how many of them go to each oct-tree; with these counts the
+    // populations are filled in the same order as in a serial run
+    int max_threads = 1;
+#ifdef _OPENMP
+    max_threads = omp_get_max_threads();
+#endif
+    std::vector<int> counts((size_t)max_threads * no_p_leaves, 0);
+#ifdef _OPENMP
+#pragma omp parallel num_threads(max_threads)
+#endif
     {
-        int key[6];
-        int base = 6 * cell;
-        // code with factor_? bits per coordinate
-        // suppress floor
-        key[0] = (int)((cell_bbox_[base + 0] - grid_bbox_[0]) * i_x_grid_l * fX_);
-        if (key[0] >= fX_)
-            key[0] = fX_ - 1;
-        if (key[0] < 0)
-            key[0] = 0;
-
-        key[1] = (int)((cell_bbox_[base + 1] - grid_bbox_[1]) * i_y_grid_l * fY_);
-        if (key[1] >= fY_)
-            key[1] = fY_ - 1;
-        if (key[1] < 0)
-            key[1] = 0;
-
-        key[2] = (int)((cell_bbox_[base + 2] - grid_bbox_[2]) * i_z_grid_l * fZ_);
-        if (key[2] >= fZ_)
-            key[2] = fZ_ - 1;
-        if (key[2] < 0)
-            key[2] = 0;
-
-        key[3] = (int)((cell_bbox_[base + 3] - grid_bbox_[0]) * i_x_grid_l * fX_);
-        if (key[3] >= fX_)
-            key[3] = fX_ - 1;
-        if (key[3] < 0)
-            key[3] = 0;
-
-        key[4] = (int)((cell_bbox_[base + 4] - grid_bbox_[1]) * i_y_grid_l * fY_);
-        if (key[4] >= fY_)
-            key[4] = fY_ - 1;
-        if (key[4] < 0)
-            key[4] = 0;
-
-        key[5] = (int)((cell_bbox_[base + 5] - grid_bbox_[2]) * i_z_grid_l * fZ_);
-        if (key[5] >= fZ_)
-            key[5] = fZ_ - 1;
-        if (key[5] < 0)
-            key[5] = 0;
-
-        if (key[0] == key[3] && key[1] == key[4] && key[2] == key[5])
+        int num_threads = 1;
+        int thread = 0;
+#ifdef _OPENMP
+        num_threads = omp_get_num_threads();
+        thread = omp_get_thread_num();
+#endif
+        int begin = (int)((long long)nelem * thread / num_threads);
+        int end = (int)((long long)nelem * (thread + 1) / num_threads);
+        int *my_counts = &counts[(size_t)thread * no_p_leaves];
+        for (int pass = 0; pass < 2; ++pass)
         {
-            position = Position(key);
-            populations_[position].push_back(cell);
-        }
-        else
-        {
-            int sweep_key[3];
-            sweep_key[0] = key[0];
-            sweep_key[1] = key[1];
-            sweep_key[2] = key[2];
-            for (sweep_key[0] = key[0]; sweep_key[0] <= key[3]; ++sweep_key[0])
+            for (int cell = begin; cell < end; ++cell)
             {
-                for (sweep_key[1] = key[1]; sweep_key[1] <= key[4]; ++sweep_key[1])
+                int key[6];
+                int base = 6 * cell;
+                // code with factor_? bits per coordinate
+                // suppress floor
+                key[0] = (int)((cell_bbox_[base + 0] - grid_bbox_[0]) * i_x_grid_l * fX_);
+                key[1] = (int)((cell_bbox_[base + 1] - grid_bbox_[1]) * i_y_grid_l * fY_);
+                key[2] = (int)((cell_bbox_[base + 2] - grid_bbox_[2]) * i_z_grid_l * fZ_);
+                key[3] = (int)((cell_bbox_[base + 3] - grid_bbox_[0]) * i_x_grid_l * fX_);
+                key[4] = (int)((cell_bbox_[base + 4] - grid_bbox_[1]) * i_y_grid_l * fY_);
+                key[5] = (int)((cell_bbox_[base + 5] - grid_bbox_[2]) * i_z_grid_l * fZ_);
+                int f[3] = { fX_, fY_, fZ_ };
+                for (int k = 0; k < 6; ++k)
+                {
+                    if (key[k] >= f[k % 3])
+                        key[k] = f[k % 3] - 1;
+                    if (key[k] < 0)
+                        key[k] = 0;
+                }
+
+                int sweep_key[3];
+                for (sweep_key[0] = key[0]; sweep_key[0] <= key[3]; ++sweep_key[0])
                 {
-                    for (sweep_key[2] = key[2]; sweep_key[2] <= key[5]; ++sweep_key[2])
+                    for (sweep_key[1] = key[1]; sweep_key[1] <= key[4]; ++sweep_key[1])
                     {
-                        position = Position(sweep_key);
-                        populations_[position].push_back(cell);
+                        for (sweep_key[2] = key[2]; sweep_key[2] <= key[5]; ++sweep_key[2])
+                        {
+                            int position = Position(sweep_key);
+                            if (pass == 0)
+                                ++my_counts[position];
+                            else
+                                populations_[position][my_counts[position]++] = cell;
+                        }
+                    }
+                }
+            }
+            if (pass == 0)
+            {
+#ifdef _OPENMP
+#pragma omp barrier
+#pragma omp single
+#endif
+                {
+                    // turn the counts into start positions of each thread
+                    for (int position = 0; position < no_p_leaves; ++position)
+                    {
+                        int total = 0;
+                        for (int t = 0; t < num_threads; ++t)
+                        {
+                            int &count = counts[(size_t)t * no_p_leaves + position];
+                            int tmp = count;
+                            count = total;
+                            total += tmp;
+                        }
+                        populations_[position].resize(total);
                     }
                 }
             }
         }
     }
-    // OK, now create the octtrees; let the trees grow
-    int key[3];
-    int &i = key[0];
-    int &j = key[1];
-    int &k = key[2];
 
-    int macro_leaf;
-    float bbox[6];
-    cellList_.reserve(nelem);
-    cellList_.push_back(0); // one dummy element for cellList_
-    // make room for the fZ_*fY_*fX_ oct-tree entry points
-    macCellList_.reserve(no_p_leaves);
-    for (k = 0; k < fZ_; ++k)
+    // OK, now create the octtrees; let the trees grow.
+    // Every tree is built independently into its own lists...
+    std::vector<std::vector<int> > macFrags(no_p_leaves);
+    std::vector<std::vector<int> > cellFrags(no_p_leaves);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int macro_leaf = 0; macro_leaf < no_p_leaves; ++macro_leaf)
     {
-        for (j = 0; j < fY_; ++j)
-        {
-            for (i = 0; i < fX_; ++i)
-            {
-                macCellList_.push_back(0);
-            }
-        }
+        int key[3];
+        key[0] = macro_leaf % fX_;
+        key[1] = (macro_leaf / fX_) % fY_;
+        key[2] = macro_leaf / (fX_ * fY_);
+        float bbox[6];
+        IniBBox(bbox, key);
+        macFrags[macro_leaf].push_back(0); // entry point of this tree
+        cellFrags[macro_leaf].push_back(0); // dummy element as in cellList_
+        SplitOctTree(bbox, populations_[macro_leaf], 0, 0,
+                     macFrags[macro_leaf], cellFrags[macro_leaf]);
+        std::vector<int>().swap(populations_[macro_leaf]);
     }
-    for (k = 0; k < fZ_; ++k)
+    delete[] populations_;
+    populations_ = NULL;
+
+    // ...which are then concatenated in the order of a serial build,
+    // so that the layout is the same as if the trees were grown one by one
+    std::vector<int> macBase(no_p_leaves);
+    std::vector<int> cellBase(no_p_leaves);
+    int macSize = no_p_leaves;
+    int cellSize = 1;
+    for (int macro_leaf = 0; macro_leaf < no_p_leaves; ++macro_leaf)
     {
-        for (j = 0; j < fY_; ++j)
+        macBase[macro_leaf] = macSize;
+        cellBase[macro_leaf] = cellSize;
+        macSize += (int)macFrags[macro_leaf].size() - 1;
+        cellSize += (int)cellFrags[macro_leaf].size() - 1;
+    }
+    macCellList_.assign(macSize, 0);
+    cellList_.assign(cellSize, 0);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int macro_leaf = 0; macro_leaf < no_p_leaves; ++macro_leaf)
+    {
+        const std::vector<int> &mac = macFrags[macro_leaf];
+        for (size_t n = 0; n < mac.size(); ++n)
         {
-            for (i = 0; i < fX_; ++i)
-            {
-                macro_leaf = Position(key);
-                IniBBox(bbox, key);
-                // macCellList_.push_back(0);
-                SplitOctTree(bbox, populations_[macro_leaf], 0, macro_leaf);
-            }
+            int entry = mac[n];
+            if (entry > 0) // offset of the sons
+                entry += macBase[macro_leaf] - 1;
+            else if (entry < 0) // negative position in cellList_
+                entry -= cellBase[macro_leaf] - 1;
+            macCellList_[n == 0 ? macro_leaf : macBase[macro_leaf] + n - 1] = entry;
+        }
+        const std::vector<int> &cells = cellFrags[macro_leaf];
+        if (cells.size() > 1)
+        {
+            memcpy(&cellList_[cellBase[macro_leaf]], &cells[1], (cells.size() - 1) * sizeof(int));
         }
+        std::vector<int>().swap(macFrags[macro_leaf]);
+        std::vector<int>().swap(cellFrags[macro_leaf]);
     }
-    delete[] populations_;
-    populations_ = NULL;
 }
 
 // creates bbox for the root of an oct-tree given its key
@@ -406,6 +482,18 @@ coDoBasisTree::SplitOctTree(const float *bbox,
                             std::vector<int> &population,
                             int level,
                             int offset)
+{
+    SplitOctTree(bbox, population, level, offset, macCellList_, cellList_);
+}
+
+// divide oct-tree, appending to the given lists
+void
+coDoBasisTree::SplitOctTree(const float *bbox,
+                            std::vector<int> &population,
+                            int level,
+                            int offset,
+                            std::vector<int> &macList,
+                            std::vector<int> &cList)
 {
     // no more divisions if the population is small enough or if
     // the maximum supported level has been achieved or if all cells are too big
@@ -414,20 +502,20 @@ coDoBasisTree::SplitOctTree(const float *bbox,
         || level == max_no_levels_
         || CellsAreTooBig(bbox, population))
     {
-        // negative of the absolute position in cellList_
+        // negative of the absolute position in cList
         if (population.size() > 0)
         {
-            macCellList_[offset] = -((int)cellList_.size());
+            macList[offset] = -((int)cList.size());
             // dump population
-            cellList_.push_back((int)population.size());
+            cList.push_back((int)population.size());
             for (cell = 0; cell < population.size(); ++cell)
             {
-                cellList_.push_back(population[cell]);
+                cList.push_back(population[cell]);
             }
         }
         else
         {
-            macCellList_[offset] = 0;
+            macList[offset] = 0;
         }
         population.clear();
         return;
@@ -523,13 +611,13 @@ coDoBasisTree::SplitOctTree(const float *bbox,
     if (level >= crit_level_ && max_popu >= population.size())
     {
         // population.size()<NORMAL_SIZE/10){
-        // negative of the absolute position in cellList_
-        macCellList_[offset] = -((int)cellList_.size());
+        // negative of the absolute position in cList
+        macList[offset] = -((int)cList.size());
         // dump population
-        cellList_.push_back((int)population.size());
+        cList.push_back((int)population.size());
         for (cell = 0; cell < population.size(); ++cell)
         {
-            cellList_.push_back(population[cell]);
+            cList.push_back(population[cell]);
         }
         population.clear();
         return;
@@ -539,19 +627,20 @@ coDoBasisTree::SplitOctTree(const float *bbox,
     // we may then release the memory of population.
     population.clear();
 
-    // write in macCellList_ the new offset.
-    macCellList_[offset] = (int)macCellList_.size();
+    // write in macList the new offset.
+    macList[offset] = (int)macList.size();
     // make room for the 8 sons
     for (son = 0; son < 8; ++son)
     {
-        macCellList_.push_back(0);
+        macList.push_back(0);
     }
     // and divide
     for (son = 0; son < 8; ++son)
     {
         float bbox_son[6];
         fillBBoxSon(bbox_son, bbox, son);
-        SplitOctTree(bbox_son, popu_sons[son], level + 1, macCellList_[offset] + son);
+        SplitOctTree(bbox_son, popu_sons[son], level + 1, macList[offset] + son,
+                     macList, cList);
     }
 }
 
@@ -644,6 +733,52 @@ coDoBasisTree::CellsAreTooBig(const float *bbox, std::vector<int> &population)
     return 0;
 }
 
+void
+coDoBasisTree::getStatistics(int *numTrees, int *numNodes, int *numLeaves, int *maxDepth,
+                             int *maxPopulation, float *meanPopulation) const
+{
+    *numTrees = fXShm * fYShm * fZShm;
+    *numNodes = 0;
+    *numLeaves = 0;
+    *maxDepth = 0;
+    *maxPopulation = 0;
+    *meanPopulation = 0.0f;
+    if ((int)macroCellList.get_length() < *numTrees)
+        return;
+
+    long long totalPopulation = 0;
+    std::vector<std::pair<int, int> > stack; // position, level
+    for (int tree = 0; tree < *numTrees; ++tree)
+    {
+        stack.push_back(std::make_pair(tree, 0));
+        while (!stack.empty())
+        {
+            int position = stack.back().first;
+            int level = stack.back().second;
+            stack.pop_back();
+            ++*numNodes;
+            int entry = macroCellList[position];
+            if (entry > 0)
+            {
+                for (int son = 0; son < 8; ++son)
+                    stack.push_back(std::make_pair(entry + son, level + 1));
+            }
+            else if (entry < 0)
+            {
+                int population = cellList[-entry];
+                ++*numLeaves;
+                totalPopulation += population;
+                if (*maxPopulation < population)
+                    *maxPopulation = population;
+                if (*maxDepth < level)
+                    *maxDepth = level;
+            }
+        }
+    }
+    if (*numLeaves > 0)
+        *meanPopulation = (float)totalPopulation / *numLeaves;
+}
+
 // determine initial oct-tree
 int
 coDoBasisTree::Position(int *key) const
@@ -135,6 +135,17 @@ public:
     };
     void getChunks(vector<const int *> &chunks, const functionObject *test);
 
+    /** getStatistics: summary of the tree layout in shared memory
+       * @param numTrees number of oct-trees in the forest
+       * @param numNodes number of macrocells (roots, inner nodes and leaves)
+       * @param numLeaves number of non-empty leaves
+       * @param maxDepth depth of the deepest leaf
+       * @param maxPopulation largest number of cells in a leaf
+       * @param meanPopulation average number of cells in a non-empty leaf
+       */
+    void getStatistics(int *numTrees, int *numNodes, int *numLeaves, int *maxDepth,
+                       int *maxPopulation, float *meanPopulation) const;
+
     int getNumCellLists();
     int getNumMacroCellLists();
     int getNumCellBBoxes();
@@ -147,6 +158,7 @@ protected:
     int rebuildFromShm();
 
     void BBoxForElement(int i);
+    void CellBBox(int i, float *cb) const;
 
     // once the tree is made up to some level, we share the cell
     // population and recursively split the cells
@@ -162,6 +174,13 @@ protected:
                       std::vector<int> &population_,
                       int level,
                       int offset);
+    // same, but appends to macList/cList instead of the member lists
+    void SplitOctTree(const float *bbox,
+                      std::vector<int> &population_,
+                      int level,
+                      int offset,
+                      std::vector<int> &macList,
+                      std::vector<int> &cList);
     int CellsAreTooBig(const float *bbox,
                        std::vector<int> &population);
     // Recreate Shared Memory objects here
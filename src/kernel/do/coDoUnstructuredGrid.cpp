@@ -7,8 +7,13 @@
 
 #include "coDoUnstructuredGrid.h"
 #include "coDoOctTree.h"
+#include "coCellLocator.h"
 #include "covise_gridmethods.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 // in this list the TYPE_... definitions in covise_unstrgrd.h can be
 // used to return the number of vertices for this kind of element
 namespace covise
@@ -101,6 +106,7 @@ int coDoUnstructuredGrid::getObjInfo(int no, coDoInfo **il) const
 
 coDoUnstructuredGrid::~coDoUnstructuredGrid()
 {
+    delete cell_locator;
     // DO NOT delete these arrays here!!!
     //delete [] lnl;
     //delete [] lnli;
@@ -115,6 +121,7 @@ coDoUnstructuredGrid::~coDoUnstructuredGrid()
 coDoUnstructuredGrid::coDoUnstructuredGrid(const coObjInfo &info, coShmArray *arr)
     : coDoGrid(info)
     , oct_tree(NULL)
+    , cell_locator(NULL)
     , lnl(NULL)
     , lnli(NULL)
 {
@@ -132,6 +139,7 @@ coDoUnstructuredGrid::coDoUnstructuredGrid(const coObjInfo &info,
                                            float *zc)
     : coDoGrid(info)
     , oct_tree(NULL)
+    , cell_locator(NULL)
     , hastypes(0)
     , hasneighbors(0)
     , lnl(NULL)
@@ -207,6 +215,7 @@ coDoUnstructuredGrid::coDoUnstructuredGrid(const coObjInfo &info,
                                            float *zc, int *tl)
     : coDoGrid(info)
     , oct_tree(NULL)
+    , cell_locator(NULL)
     , lnl(NULL)
     , lnli(NULL)
 {
@@ -281,6 +290,7 @@ coDoUnstructuredGrid::coDoUnstructuredGrid(const coObjInfo &info,
                                            int nelem, int nconn, int ncoord, int ht)
     : coDoGrid(info)
     , oct_tree(NULL)
+    , cell_locator(NULL)
     , lnl(NULL)
     , lnli(NULL)
 {
@@ -1864,6 +1874,106 @@ const coDoOctTree *coDoUnstructuredGrid::GetOctTree(const coDistributedObject *r
     return (coDoOctTree *)(oct_tree);
 }
 
+const coCellLocator *coDoUnstructuredGrid::getCellLocator() const
+{
+    std::call_once(cell_locator_once, [this]() {
+        int *e_l, *c_l;
+        float *x_l, *y_l, *z_l;
+        getAddresses(&e_l, &c_l, &x_l, &y_l, &z_l);
+        cell_locator = new coCellLocator(numelem, numconn, e_l, c_l, x_l, y_l, z_l);
+    });
+    return cell_locator;
+}
+
+int coDoUnstructuredGrid::locateCell(const float *point, int hint, float tolerance) const
+{
+    const coCellLocator *locator = getCellLocator();
+
+    if (hint >= 0 && hint < numelem)
+    {
+        if (locator->isInBBox(hint, point, tolerance)
+            && testACell(NULL, point, hint, 0, 0, tolerance, NULL) == 0)
+            return hint;
+
+        // walk: try the cells sharing a vertex with the hint
+        if (lnl)
+        {
+            int *e_l, *c_l;
+            float *x_l, *y_l, *z_l;
+            getAddresses(&e_l, &c_l, &x_l, &y_l, &z_l);
+            int end = (hint < numelem - 1) ? e_l[hint + 1] : numconn;
+            for (int i = e_l[hint]; i < end; ++i)
+            {
+                int vertex = c_l[i];
+                for (int j = lnli[vertex]; j < lnli[vertex + 1]; ++j)
+                {
+                    int cell = lnl[j];
+                    if (cell != hint && locator->isInBBox(cell, point, tolerance)
+                        && testACell(NULL, point, cell, 0, 0, tolerance, NULL) == 0)
+                        return cell;
+                }
+            }
+        }
+    }
+
+    struct CellTest
+    {
+        const coDoUnstructuredGrid *grid;
+        const float *point;
+        float tolerance;
+        bool operator()(int cell) const
+        {
+            return grid->testACell(NULL, point, cell, 0, 0, tolerance, NULL) == 0;
+        }
+    };
+    CellTest test = { this, point, tolerance };
+    return locator->visit(point, tolerance, test);
+}
+
+int coDoUnstructuredGrid::getCells(int n, const float *x, const float *y, const float *z,
+                                   int *cells, float tolerance) const
+{
+    if (n <= 0)
+        return 0;
+
+    // build shared structures before going parallel
+    getCellLocator();
+    if (!lnl && hasTypeList())
+        computeNeighborList();
+
+    std::vector<int> order;
+    coCellLocator::mortonOrder(n, x, y, z, order);
+
+    int found = 0;
+#ifdef _OPENMP
+#pragma omp parallel reduction(+ : found)
+#endif
+    {
+        int numThreads = 1, thread = 0;
+#ifdef _OPENMP
+        numThreads = omp_get_num_threads();
+        thread = omp_get_thread_num();
+#endif
+        // each thread processes a contiguous part of the Morton order
+        int begin = (int)((long long)n * thread / numThreads);
+        int end = (int)((long long)n * (thread + 1) / numThreads);
+        int previous = -1;
+        for (int i = begin; i < end; ++i)
+        {
+            int p = order[i];
+            float point[3] = { x[p], y[p], z[p] };
+            int hint = (cells[p] >= 0) ? cells[p] : previous;
+            cells[p] = locateCell(point, hint, tolerance);
+            if (cells[p] >= 0)
+            {
+                previous = cells[p];
+                ++found;
+            }
+        }
+    }
+    return found;
+}
+
 void
 coDoUnstructuredGrid::compressConnectivity()
 {
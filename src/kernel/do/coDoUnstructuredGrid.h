@@ -25,6 +25,7 @@ enum ELEM_TYPE
 
 #ifndef CELL_TYPES_ONLY
 #include "coDoGrid.h"
+#include <mutex>
 
 /***********************************************************************\
  **                                                                     **
@@ -56,6 +57,7 @@ namespace covise
 DOEXPORT extern int UnstructuredGrid_Num_Nodes[20];
 
 class coDoOctTree;
+class coCellLocator;
 
 class DOEXPORT coDoUnstructuredGrid : public coDoGrid
 {
@@ -80,6 +82,8 @@ private:
     coIntShmArray neighborlist; // neighborlist list (length numneighbor)
     coIntShmArray neighborindex; // neighborindex list (length numcoord)
     mutable const coDistributedObject *oct_tree;
+    mutable coCellLocator *cell_locator;
+    mutable std::once_flag cell_locator_once; // the locator may be requested by several threads
 
     int testACell(float *v_interp, const float *point,
                   int cell, int no_arrays, int array_dim,
@@ -110,6 +114,7 @@ public:
     coDoUnstructuredGrid(const coObjInfo &info)
         : coDoGrid(info)
         , oct_tree(NULL)
+        , cell_locator(NULL)
         , lnl(0)
         , lnli(0)
     {
@@ -260,6 +265,23 @@ public:
     const coDoOctTree *GetOctTree(const coDistributedObject *reuseOctTree,
                                   const char *OctTreeSurname) const;
 
+    // BVH over the cell bounding boxes for bulk cell location,
+    // created on first use and owned by this object
+    const coCellLocator *getCellLocator() const;
+
+    // locate a single point with the cell locator:
+    // hint is tested first, then the cells sharing a vertex with hint
+    // returns the cell containing point or -1
+    int locateCell(const float *point, int hint, float tolerance) const;
+
+    // locate n points at once: points are processed in Morton order,
+    // every hit is used as start for the next point
+    // cells: on input an optional hint per point (or -1),
+    //        on output the containing cell or -1
+    // returns the number of points found in the grid
+    int getCells(int n, const float *x, const float *y, const float *z,
+                 int *cells, float tolerance) const;
+
     // checks all hexahedron elements if their connectivity
     // leads to PRISMs, QUADs or TETRAHEDRONs and fix them
     void compressConnectivity();
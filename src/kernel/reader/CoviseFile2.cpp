@@ -0,0 +1,591 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#include "CoviseFile2.h"
+
+#include <util/unixcompat.h>
+#include <fcntl.h>
+#include <zlib.h>
+
+#ifdef _WIN32
+#include <io.h>
+
+#define lseek64 _lseeki64
+#else
+#ifndef O_BINARY
+#define O_BINARY 0
+#endif
+#endif
+
+using namespace covise;
+
+namespace
+{
+
+const char headerMagic[8] = { 'C', 'O', 'V', 'I', 'S', 'E', '2', '\n' };
+const char trailerMagic[8] = { 'C', 'O', 'V', 'I', 'N', 'D', 'E', 'X' };
+const uint32_t byteOrderMark = 0x01020304;
+const uint32_t formatVersion = 2;
+const int headerSize = 64;
+const int trailerSize = 24;
+
+void swapBytes(void *data, int elemSize, int64_t num)
+{
+    char *p = (char *)data;
+    for (int64_t i = 0; i < num; ++i, p += elemSize)
+    {
+        for (int b = 0; b < elemSize / 2; ++b)
+        {
+            char c = p[b];
+            p[b] = p[elemSize - 1 - b];
+            p[elemSize - 1 - b] = c;
+        }
+    }
+}
+
+// byte i of element n goes to plane i: equal high order bytes of
+// neighbouring values end up next to each other and deflate much better
+void shuffle(const char *in, char *out, int elemSize, int64_t num)
+{
+    for (int64_t n = 0; n < num; ++n)
+        for (int b = 0; b < elemSize; ++b)
+            out[b * num + n] = in[n * elemSize + b];
+}
+
+void unshuffle(const char *in, char *out, int elemSize, int64_t num)
+{
+    for (int b = 0; b < elemSize; ++b)
+        for (int64_t n = 0; n < num; ++n)
+            out[n * elemSize + b] = in[b * num + n];
+}
+
+class IndexWriter
+{
+public:
+    IndexWriter(std::vector<char> &buf)
+        : buf_(buf)
+    {
+    }
+    void put(const void *data, size_t size)
+    {
+        buf_.insert(buf_.end(), (const char *)data, (const char *)data + size);
+    }
+    void putInt(int32_t val)
+    {
+        put(&val, sizeof(val));
+    }
+    void putInt64(int64_t val)
+    {
+        put(&val, sizeof(val));
+    }
+    void putFloat(float val)
+    {
+        put(&val, sizeof(val));
+    }
+    void putString(const std::string &str)
+    {
+        putInt((int32_t)str.size());
+        put(str.data(), str.size());
+    }
+
+private:
+    std::vector<char> &buf_;
+};
+
+class IndexReader
+{
+public:
+    IndexReader(const std::vector<char> &buf, bool swapped)
+        : pos_(buf.empty() ? NULL : &buf[0])
+        , end_(pos_ + buf.size())
+        , swapped_(swapped)
+        , ok_(true)
+    {
+    }
+    bool ok() const
+    {
+        return ok_;
+    }
+    void get(void *data, size_t size, int elemSize)
+    {
+        if (!ok_ || (size_t)(end_ - pos_) < size)
+        {
+            ok_ = false;
+            memset(data, 0, size);
+            return;
+        }
+        memcpy(data, pos_, size);
+        pos_ += size;
+        if (swapped_ && elemSize > 1)
+            swapBytes(data, elemSize, size / elemSize);
+    }
+    int32_t getInt()
+    {
+        int32_t val;
+        get(&val, sizeof(val), sizeof(val));
+        return val;
+    }
+    int64_t getInt64()
+    {
+        int64_t val;
+        get(&val, sizeof(val), sizeof(val));
+        return val;
+    }
+    float getFloat()
+    {
+        float val;
+        get(&val, sizeof(val), sizeof(val));
+        return val;
+    }
+    // number of following entries, each at least minSize bytes long
+    int getCount(size_t minSize)
+    {
+        int32_t num = getInt();
+        if (num < 0 || (size_t)(end_ - pos_) < num * minSize)
+        {
+            ok_ = false;
+            return 0;
+        }
+        return num;
+    }
+    std::string getString()
+    {
+        int len = getCount(1);
+        std::string str(pos_, len);
+        pos_ += len;
+        return str;
+    }
+
+private:
+    const char *pos_;
+    const char *end_;
+    bool swapped_;
+    bool ok_;
+};
+}
+
+CoviseFile2::CoviseFile2()
+    : fd_(-1)
+    , writing_(false)
+    , swapped_(false)
+    , level_(0)
+    , pos_(0)
+    , root_(-1)
+{
+}
+
+CoviseFile2::~CoviseFile2()
+{
+    close();
+}
+
+bool CoviseFile2::isV2File(const char *filename)
+{
+    int fd = ::open(filename, O_RDONLY | O_BINARY);
+    if (fd < 0)
+        return false;
+    char magic[sizeof(headerMagic)];
+    bool isV2 = ::read(fd, magic, sizeof(magic)) == sizeof(magic)
+                && memcmp(magic, headerMagic, sizeof(magic)) == 0;
+    ::close(fd);
+    return isV2;
+}
+
+void CoviseFile2::setError(const char *what)
+{
+    error_ = what;
+    if (errno != 0)
+    {
+        error_ += ": ";
+        error_ += strerror(errno);
+    }
+}
+
+bool CoviseFile2::create(const char *filename, int compressionLevel)
+{
+    close();
+    errno = 0;
+    fd_ = ::open(filename, O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0644);
+    if (fd_ < 0)
+    {
+        setError("cannot create file");
+        return false;
+    }
+    writing_ = true;
+    level_ = compressionLevel;
+    pos_ = 0;
+    root_ = -1;
+    objects_.clear();
+
+    char header[headerSize];
+    memset(header, 0, sizeof(header));
+    memcpy(header, headerMagic, sizeof(headerMagic));
+    memcpy(header + 8, &byteOrderMark, sizeof(byteOrderMark));
+    memcpy(header + 12, &formatVersion, sizeof(formatVersion));
+    return write(header, sizeof(header));
+}
+
+bool CoviseFile2::write(const void *data, int64_t size)
+{
+    const char *p = (const char *)data;
+    while (size > 0)
+    {
+        int n = ::write(fd_, p, (unsigned)std::min(size, (int64_t)ChunkSize));
+        if (n <= 0)
+        {
+            if (n < 0 && errno == EINTR)
+                continue;
+            setError("write failed");
+            return false;
+        }
+        p += n;
+        pos_ += n;
+        size -= n;
+    }
+    return true;
+}
+
+bool CoviseFile2::addArray(Object &obj, const void *data, int elemSize, int64_t numElem)
+{
+    static const char zeros[Alignment] = { 0 };
+    if (pos_ % Alignment != 0 && !write(zeros, Alignment - pos_ % Alignment))
+        return false;
+
+    Array arr;
+    arr.offset = pos_;
+    arr.rawSize = numElem * elemSize;
+    arr.elemSize = elemSize;
+    arr.codec = (level_ > 0 && arr.rawSize >= 4096) ? CODEC_SHUFFLE_DEFLATE : CODEC_NONE;
+
+    if (arr.codec == CODEC_NONE)
+    {
+        if (!write(data, arr.rawSize))
+            return false;
+        obj.arrays.push_back(arr);
+        return true;
+    }
+
+    const int64_t chunkElems = ChunkSize / elemSize;
+    std::vector<char> shuffled;
+    for (int64_t first = 0; first < numElem; first += chunkElems)
+    {
+        int64_t num = std::min(chunkElems, numElem - first);
+        const char *raw = (const char *)data + first * elemSize;
+        uLong rawLen = (uLong)(num * elemSize);
+        if (elemSize > 1)
+        {
+            shuffled.resize(rawLen);
+            shuffle(raw, &shuffled[0], elemSize, num);
+            raw = &shuffled[0];
+        }
+        uLongf packedLen = compressBound(rawLen);
+        buffer_.resize(packedLen);
+        if (compress2((Bytef *)&buffer_[0], &packedLen, (const Bytef *)raw, rawLen, level_) == Z_OK
+            && packedLen < rawLen)
+        {
+            if (!write(&buffer_[0], packedLen))
+                return false;
+            arr.chunkSizes.push_back(packedLen);
+        }
+        else
+        {
+            // incompressible: keep the chunk as it is
+            if (!write((const char *)data + first * elemSize, rawLen))
+                return false;
+            arr.chunkSizes.push_back(rawLen);
+        }
+    }
+    obj.arrays.push_back(arr);
+    return true;
+}
+
+int CoviseFile2::addObject(const Object &obj)
+{
+    objects_.push_back(obj);
+    root_ = (int)objects_.size() - 1;
+    return root_;
+}
+
+bool CoviseFile2::finish()
+{
+    if (fd_ < 0 || !writing_)
+        return false;
+
+    std::vector<char> index;
+    IndexWriter out(index);
+    out.putInt((int32_t)objects_.size());
+    out.putInt(root_);
+    for (size_t i = 0; i < objects_.size(); ++i)
+    {
+        const Object &obj = objects_[i];
+        out.putString(obj.type);
+        out.putString(obj.name);
+        out.putInt((int32_t)obj.sizes.size());
+        for (size_t j = 0; j < obj.sizes.size(); ++j)
+            out.putInt64(obj.sizes[j]);
+        out.putInt((int32_t)obj.values.size());
+        for (size_t j = 0; j < obj.values.size(); ++j)
+            out.putFloat(obj.values[j]);
+        out.putInt((int32_t)obj.attribNames.size());
+        for (size_t j = 0; j < obj.attribNames.size(); ++j)
+        {
+            out.putString(obj.attribNames[j]);
+            out.putString(obj.attribValues[j]);
+        }
+        out.putInt((int32_t)obj.arrays.size());
+        for (size_t j = 0; j < obj.arrays.size(); ++j)
+        {
+            const Array &arr = obj.arrays[j];
+            out.putInt64(arr.offset);
+            out.putInt64(arr.rawSize);
+            out.putInt(arr.elemSize);
+            out.putInt(arr.codec);
+            out.putInt((int32_t)arr.chunkSizes.size());
+            for (size_t c = 0; c < arr.chunkSizes.size(); ++c)
+                out.putInt64(arr.chunkSizes[c]);
+        }
+        out.putInt((int32_t)obj.children.size());
+        for (size_t j = 0; j < obj.children.size(); ++j)
+            out.putInt(obj.children[j]);
+    }
+
+    int64_t trailer[2] = { pos_, (int64_t)index.size() };
+    bool ok = write(&index[0], index.size())
+              && write(trailer, sizeof(trailer))
+              && write(trailerMagic, sizeof(trailerMagic));
+    if (::close(fd_) != 0 && ok)
+    {
+        setError("close failed");
+        ok = false;
+    }
+    fd_ = -1;
+    writing_ = false;
+    return ok;
+}
+
+bool CoviseFile2::open(const char *filename)
+{
+    close();
+    errno = 0;
+    fd_ = ::open(filename, O_RDONLY | O_BINARY);
+    if (fd_ < 0)
+    {
+        setError("cannot open file");
+        return false;
+    }
+
+    char header[headerSize];
+    if (!readAt(0, header, sizeof(header)))
+        return false;
+    errno = 0;
+    uint32_t bom, version;
+    memcpy(&bom, header + 8, sizeof(bom));
+    memcpy(&version, header + 12, sizeof(version));
+    if (memcmp(header, headerMagic, sizeof(headerMagic)) != 0)
+    {
+        setError("not a COVISE file of format version 2");
+        return false;
+    }
+    swapped_ = bom != byteOrderMark;
+    if (swapped_)
+        swapBytes(&version, sizeof(version), 1);
+    if (version != formatVersion)
+    {
+        setError("unsupported format version");
+        return false;
+    }
+
+    int64_t fileSize = lseek64(fd_, 0, SEEK_END);
+    char trailer[trailerSize];
+    if (fileSize < headerSize + trailerSize || !readAt(fileSize - trailerSize, trailer, sizeof(trailer)))
+    {
+        errno = 0;
+        setError("file is truncated");
+        return false;
+    }
+    int64_t indexPos[2];
+    memcpy(indexPos, trailer, sizeof(indexPos));
+    if (swapped_)
+        swapBytes(indexPos, sizeof(int64_t), 2);
+    errno = 0;
+    if (memcmp(trailer + 16, trailerMagic, sizeof(trailerMagic)) != 0
+        || indexPos[0] < headerSize || indexPos[1] < 0
+        || indexPos[0] + indexPos[1] > fileSize - trailerSize)
+    {
+        setError("file is truncated or index is corrupt");
+        return false;
+    }
+
+    std::vector<char> index(indexPos[1]);
+    if (!readAt(indexPos[0], index.empty() ? NULL : &index[0], index.size()))
+        return false;
+    return parseIndex(index);
+}
+
+bool CoviseFile2::parseIndex(const std::vector<char> &index)
+{
+    IndexReader in(index, swapped_);
+    int num = in.getCount(4);
+    root_ = in.getInt();
+    objects_.resize(num);
+    for (int i = 0; i < num && in.ok(); ++i)
+    {
+        Object &obj = objects_[i];
+        obj.type = in.getString();
+        obj.name = in.getString();
+        obj.sizes.resize(in.getCount(8));
+        for (size_t j = 0; j < obj.sizes.size(); ++j)
+            obj.sizes[j] = in.getInt64();
+        obj.values.resize(in.getCount(4));
+        for (size_t j = 0; j < obj.values.size(); ++j)
+            obj.values[j] = in.getFloat();
+        int numAttr = in.getCount(8);
+        obj.attribNames.resize(numAttr);
+        obj.attribValues.resize(numAttr);
+        for (int j = 0; j < numAttr; ++j)
+        {
+            obj.attribNames[j] = in.getString();
+            obj.attribValues[j] = in.getString();
+        }
+        obj.arrays.resize(in.getCount(28));
+        for (size_t j = 0; j < obj.arrays.size(); ++j)
+        {
+            Array &arr = obj.arrays[j];
+            arr.offset = in.getInt64();
+            arr.rawSize = in.getInt64();
+            arr.elemSize = in.getInt();
+            arr.codec = in.getInt();
+            arr.chunkSizes.resize(in.getCount(8));
+            for (size_t c = 0; c < arr.chunkSizes.size(); ++c)
+                arr.chunkSizes[c] = in.getInt64();
+        }
+        obj.children.resize(in.getCount(4));
+        for (size_t j = 0; j < obj.children.size(); ++j)
+        {
+            obj.children[j] = in.getInt();
+            // children are always written before their parent
+            if (obj.children[j] < 0 || obj.children[j] >= i)
+                obj.children[j] = -1;
+        }
+    }
+    errno = 0;
+    if (!in.ok() || root_ < 0 || root_ >= num)
+    {
+        objects_.clear();
+        setError("index is corrupt");
+        return false;
+    }
+    return true;
+}
+
+bool CoviseFile2::readAt(int64_t offset, void *data, int64_t size)
+{
+    errno = 0;
+    if (lseek64(fd_, offset, SEEK_SET) != offset)
+    {
+        setError("seek failed");
+        return false;
+    }
+    char *p = (char *)data;
+    while (size > 0)
+    {
+        int n = ::read(fd_, p, (unsigned)std::min(size, (int64_t)ChunkSize));
+        if (n <= 0)
+        {
+            if (n < 0 && errno == EINTR)
+                continue;
+            setError("read failed");
+            return false;
+        }
+        p += n;
+        size -= n;
+    }
+    return true;
+}
+
+bool CoviseFile2::readArray(const Array &arr, void *data, int64_t size)
+{
+    errno = 0;
+    if (arr.rawSize != size || arr.elemSize <= 0 || arr.rawSize % arr.elemSize != 0)
+    {
+        setError("array size does not match object");
+        return false;
+    }
+
+    if (arr.codec == CODEC_NONE)
+    {
+        if (!readAt(arr.offset, data, size))
+            return false;
+    }
+    else if (arr.codec == CODEC_SHUFFLE_DEFLATE)
+    {
+        const int64_t chunkBytes = (ChunkSize / arr.elemSize) * arr.elemSize;
+        std::vector<char> shuffled;
+        int64_t offset = arr.offset;
+        int64_t done = 0;
+        for (size_t c = 0; c < arr.chunkSizes.size() && done < size; ++c)
+        {
+            int64_t rawLen = std::min(chunkBytes, size - done);
+            char *dest = (char *)data + done;
+            int64_t stored = arr.chunkSizes[c];
+            if (stored == rawLen)
+            {
+                if (!readAt(offset, dest, rawLen))
+                    return false;
+            }
+            else
+            {
+                buffer_.resize(stored);
+                if (!readAt(offset, &buffer_[0], stored))
+                    return false;
+                char *out = dest;
+                if (arr.elemSize > 1)
+                {
+                    shuffled.resize(rawLen);
+                    out = &shuffled[0];
+                }
+                uLongf outLen = (uLongf)rawLen;
+                if (uncompress((Bytef *)out, &outLen, (const Bytef *)&buffer_[0], (uLong)stored) != Z_OK
+                    || (int64_t)outLen != rawLen)
+                {
+                    errno = 0;
+                    setError("array data is corrupt");
+                    return false;
+                }
+                if (arr.elemSize > 1)
+                    unshuffle(out, dest, arr.elemSize, rawLen / arr.elemSize);
+            }
+            offset += stored;
+            done += rawLen;
+        }
+        if (done != size)
+        {
+            setError("array data is truncated");
+            return false;
+        }
+    }
+    else
+    {
+        setError("unknown compression of array");
+        return false;
+    }
+
+    if (swapped_ && arr.elemSize > 1)
+        swapBytes(data, arr.elemSize, size / arr.elemSize);
+    return true;
+}
+
+void CoviseFile2::close()
+{
+    if (fd_ >= 0)
+        ::close(fd_);
+    fd_ = -1;
+    writing_ = false;
+    swapped_ = false;
+    objects_.clear();
+    root_ = -1;
+}
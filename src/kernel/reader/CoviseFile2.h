@@ -0,0 +1,138 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#ifndef COVISE_FILE2_H
+#define COVISE_FILE2_H
+
+#include <util/coviseCompat.h>
+#include <string>
+#include <vector>
+
+namespace covise
+{
+
+/**
+ * Container of the indexed .covise file format (version 2)
+ *
+ *  header   64 bytes: magic, byte order mark and format version
+ *  arrays   every array starts at a multiple of 64 bytes, so that
+ *           uncompressed arrays can be read directly into shared memory;
+ *           arrays are cut into chunks of 4 MB which are byte shuffled
+ *           and deflated independently
+ *  index    one record per object: type, name, sizes, attributes,
+ *           arrays and children (as object indices)
+ *  trailer  offset and size of the index and a second magic
+ *
+ * Objects are added children first, the last object added is the root.
+ * As every object can be located through the index, single elements of
+ * a set (e.g. timesteps) can be read without touching the others.
+ */
+class CoviseFile2
+{
+public:
+    enum
+    {
+        Alignment = 64,
+        ChunkSize = 1 << 22
+    };
+
+    enum Codec
+    {
+        CODEC_NONE = 0,
+        CODEC_SHUFFLE_DEFLATE = 1
+    };
+
+    struct Array
+    {
+        int64_t offset;
+        int64_t rawSize;
+        int elemSize;
+        int codec;
+        // stored size of each chunk, a chunk of ChunkSize bytes (or less
+        // for the last one) is stored uncompressed if it did not shrink
+        std::vector<int64_t> chunkSizes;
+    };
+
+    struct Object
+    {
+        std::string type;
+        std::string name;
+        std::vector<int64_t> sizes;
+        std::vector<float> values;
+        std::vector<std::string> attribNames;
+        std::vector<std::string> attribValues;
+        std::vector<Array> arrays;
+        std::vector<int> children;
+    };
+
+    CoviseFile2();
+    ~CoviseFile2();
+
+    /// true if filename is a file in format version 2
+    static bool isV2File(const char *filename);
+
+    /// start writing filename, compressionLevel 0 stores all arrays as they are
+    bool create(const char *filename, int compressionLevel);
+
+    /// write numElem elements of elemSize bytes and append them to obj's arrays
+    bool addArray(Object &obj, const void *data, int elemSize, int64_t numElem);
+
+    /// add obj to the index, returns its index
+    int addObject(const Object &obj);
+
+    /// write index and trailer and close the file
+    bool finish();
+
+    /// open filename for reading and load the index
+    bool open(const char *filename);
+
+    int numObjects() const
+    {
+        return (int)objects_.size();
+    }
+
+    int root() const
+    {
+        return root_;
+    }
+
+    const Object &object(int index) const
+    {
+        return objects_[index];
+    }
+
+    /// read arr into data, which has to hold size bytes
+    bool readArray(const Array &arr, void *data, int64_t size);
+
+    void close();
+
+    const char *error() const
+    {
+        return error_.c_str();
+    }
+
+private:
+    CoviseFile2(const CoviseFile2 &);
+    CoviseFile2 &operator=(const CoviseFile2 &);
+
+    bool write(const void *data, int64_t size);
+    bool readAt(int64_t offset, void *data, int64_t size);
+    bool parseIndex(const std::vector<char> &index);
+    void setError(const char *what);
+
+    int fd_;
+    bool writing_;
+    bool swapped_;
+    int level_;
+    int64_t pos_;
+    int root_;
+    std::vector<Object> objects_;
+    std::vector<char> buffer_;
+    std::string error_;
+};
+}
+#endif
@@ -6,6 +6,7 @@
  * License: LGPL 2+ */
 
 #include "CoviseIO.h"
+#include "CoviseFile2.h"
 
 #include <do/coDoSet.h>
 #include <do/coDoPolygons.h>
@@ -58,6 +59,25 @@ int CoviseIO::WriteFile(const char *filename, const coDistributedObject *Object)
     if (filename != NULL)
     {
         grid_Path = filename;
+        if (fileFormat >= 2)
+        {
+            if (isSupported2(Object))
+            {
+                CoviseFile2 file;
+                bool ok = file.create(grid_Path.c_str(), compressionLevel)
+                          && writeobj2(file, Object) >= 0
+                          && file.finish();
+                writtenObjects.clear();
+                if (!ok)
+                {
+                    Covise::sendError("failed to write %s: %s", filename, file.error());
+                    return 0;
+                }
+                return 1;
+            }
+            Covise::sendInfo("%s: object types not supported by COVISE file format 2, writing format 1", filename);
+        }
+
         int fd = covOpenOutFile(grid_Path.c_str());
         if (!fd)
         {
@@ -84,6 +104,22 @@ coDistributedObject *CoviseIO::ReadFile(const char *filename, const char *object
     if (filename != NULL)
     {
         grid_Path = filename;
+        if (isIndexedFile(filename))
+        {
+            CoviseFile2 file;
+            if (!file.open(filename))
+            {
+                Covise::sendError("failed to open %s for reading: %s", filename, file.error());
+                return NULL;
+            }
+            firstStepToRead = firstStep;
+            numStepsToRead = numSteps;
+            skipSteps = skipNumSteps;
+            setsRead = 0;
+            readObjects.assign(file.numObjects(), NULL);
+            return finishRead2(file, readData2(file, file.root(), objectName));
+        }
+
         int fd = this->covOpenInFile(grid_Path.c_str());
         if (!fd)
         {
@@ -1600,3 +1636,822 @@ void CoviseIO::skipattrib(int fd)
 
     lseek64(abs(fd), size, SEEK_CUR);
 }
+
+//
+// indexed format (version 2)
+//
+
+namespace
+{
+
+bool hasLayout(const CoviseFile2::Object &rec, size_t numSizes, size_t numArrays, size_t numValues = 0)
+{
+    return rec.sizes.size() >= numSizes && rec.arrays.size() >= numArrays && rec.values.size() >= numValues;
+}
+}
+
+bool CoviseIO::isIndexedFile(const char *filename)
+{
+    return filename != NULL && CoviseFile2::isV2File(filename);
+}
+
+bool CoviseIO::isSupported2(const coDistributedObject *data_obj) const
+{
+    static const char *const simpleTypes[] = {
+        "INTARR", "INTDT ", "BYTEDT", "UNSGRD", "POINTS", "SPHERE", "DOTEXT", "POLYGN",
+        "LINES", "TRITRI", "QUADS", "TRIANG", "RCTGRD", "STRGRD", "UNIGRD", "USTSDT",
+        "USTTDT", "RGBADT", "USTVDT", "IMAGE", NULL
+    };
+
+    if (data_obj == NULL)
+        return false;
+    const char *gtype = data_obj->getType();
+    if (strcmp(gtype, "SETELE") == 0)
+    {
+        int numsets;
+        const coDistributedObject *const *objs = ((const coDoSet *)data_obj)->getAllElements(&numsets);
+        for (int i = 0; i < numsets; i++)
+            if (!isSupported2(objs[i]))
+                return false;
+        return true;
+    }
+    if (strcmp(gtype, "GEOMET") == 0)
+    {
+        const coDoGeometry *geo = (const coDoGeometry *)data_obj;
+        return isSupported2(geo->getGeometry())
+               && (!geo->getColors() || isSupported2(geo->getColors()))
+               && (!geo->getNormals() || isSupported2(geo->getNormals()))
+               && (!geo->getTexture() || isSupported2(geo->getTexture()));
+    }
+    for (int i = 0; simpleTypes[i]; i++)
+        if (strcmp(gtype, simpleTypes[i]) == 0)
+            return true;
+    return false;
+}
+
+int CoviseIO::writeobj2(CoviseFile2 &file, const coDistributedObject *data_obj)
+{
+    if (data_obj->getRefCount() > 1)
+    {
+        // stored already, just reference it
+        std::map<std::string, int>::const_iterator it = writtenObjects.find(data_obj->getName());
+        if (it != writtenObjects.end())
+            return it->second;
+    }
+
+    CoviseFile2::Object rec;
+    rec.type = data_obj->getType();
+    rec.name = data_obj->getName();
+    const char **an, **at;
+    int numAttr = data_obj->getAllAttributes(&an, &at);
+    for (int i = 0; i < numAttr; i++)
+    {
+        rec.attribNames.push_back(an[i]);
+        rec.attribValues.push_back(at[i]);
+    }
+
+    const char *gtype = rec.type.c_str();
+    bool ok = true;
+    if (strcmp(gtype, "SETELE") == 0)
+    {
+        int numsets;
+        const coDistributedObject *const *objs = ((const coDoSet *)data_obj)->getAllElements(&numsets);
+        for (int i = 0; i < numsets && ok; i++)
+        {
+            rec.children.push_back(writeobj2(file, objs[i]));
+            ok = rec.children.back() >= 0;
+        }
+    }
+    else if (strcmp(gtype, "GEOMET") == 0)
+    {
+        const coDoGeometry *geo = (const coDoGeometry *)data_obj;
+        const coDistributedObject *parts[] = { geo->getGeometry(), geo->getColors(), geo->getNormals(), geo->getTexture() };
+        rec.sizes.push_back(geo->getColorAttributes());
+        rec.sizes.push_back(geo->getNormalAttributes());
+        rec.sizes.push_back(geo->getTextureAttributes());
+        for (int i = 0; i < 4 && ok; i++)
+        {
+            rec.sizes.push_back(parts[i] != NULL);
+            if (parts[i])
+            {
+                rec.children.push_back(writeobj2(file, parts[i]));
+                ok = rec.children.back() >= 0;
+            }
+        }
+    }
+    else if (strcmp(gtype, "INTARR") == 0)
+    {
+        const coDoIntArr *arr = (const coDoIntArr *)data_obj;
+        for (int i = 0; i < arr->getNumDimensions(); i++)
+            rec.sizes.push_back(arr->getDimension(i));
+        ok = file.addArray(rec, arr->getAddress(), sizeof(int), arr->getSize());
+    }
+    else if (strcmp(gtype, "INTDT ") == 0)
+    {
+        const coDoInt *arr = (const coDoInt *)data_obj;
+        rec.sizes.push_back(arr->getNumPoints());
+        ok = file.addArray(rec, arr->getAddress(), sizeof(int), arr->getNumPoints());
+    }
+    else if (strcmp(gtype, "BYTEDT") == 0)
+    {
+        const coDoByte *arr = (const coDoByte *)data_obj;
+        rec.sizes.push_back(arr->getNumPoints());
+        ok = file.addArray(rec, arr->getAddress(), 1, arr->getNumPoints());
+    }
+    else if (strcmp(gtype, "UNSGRD") == 0)
+    {
+        mesh = (coDoUnstructuredGrid *)data_obj;
+        mesh->getAddresses(&el, &vl, &x_coord, &y_coord, &z_coord);
+        mesh->getTypeList(&tl);
+        mesh->getGridSize(&n_elem, &n_conn, &n_coord);
+        rec.sizes.push_back(n_elem);
+        rec.sizes.push_back(n_conn);
+        rec.sizes.push_back(n_coord);
+        ok = file.addArray(rec, el, sizeof(int), n_elem)
+             && file.addArray(rec, tl, sizeof(int), n_elem)
+             && file.addArray(rec, vl, sizeof(int), n_conn)
+             && file.addArray(rec, x_coord, sizeof(float), n_coord)
+             && file.addArray(rec, y_coord, sizeof(float), n_coord)
+             && file.addArray(rec, z_coord, sizeof(float), n_coord);
+    }
+    else if (strcmp(gtype, "POINTS") == 0)
+    {
+        pts = (coDoPoints *)data_obj;
+        pts->getAddresses(&x_coord, &y_coord, &z_coord);
+        n_coord = pts->getNumPoints();
+        rec.sizes.push_back(n_coord);
+        ok = file.addArray(rec, x_coord, sizeof(float), n_coord)
+             && file.addArray(rec, y_coord, sizeof(float), n_coord)
+             && file.addArray(rec, z_coord, sizeof(float), n_coord);
+    }
+    else if (strcmp(gtype, "SPHERE") == 0)
+    {
+        sph = (coDoSpheres *)data_obj;
+        sph->getAddresses(&x_coord, &y_coord, &z_coord, &radius);
+        n_coord = sph->getNumSpheres();
+        rec.sizes.push_back(n_coord);
+        ok = file.addArray(rec, x_coord, sizeof(float), n_coord)
+             && file.addArray(rec, y_coord, sizeof(float), n_coord)
+             && file.addArray(rec, z_coord, sizeof(float), n_coord)
+             && file.addArray(rec, radius, sizeof(float), n_coord);
+    }
+    else if (strcmp(gtype, "DOTEXT") == 0)
+    {
+        char *data;
+        txt = (coDoText *)data_obj;
+        txt->getAddress(&data);
+        n_elem = txt->getTextLength();
+        rec.sizes.push_back(n_elem);
+        ok = file.addArray(rec, data, 1, n_elem);
+    }
+    else if (strcmp(gtype, "POLYGN") == 0 || strcmp(gtype, "LINES") == 0 || strcmp(gtype, "TRIANG") == 0)
+    {
+        if (strcmp(gtype, "POLYGN") == 0)
+        {
+            pol = (coDoPolygons *)data_obj;
+            pol->getAddresses(&x_coord, &y_coord, &z_coord, &vl, &el);
+            n_elem = pol->getNumPolygons();
+            n_conn = pol->getNumVertices();
+            n_coord = pol->getNumPoints();
+        }
+        else if (strcmp(gtype, "LINES") == 0)
+        {
+            lin = (coDoLines *)data_obj;
+            lin->getAddresses(&x_coord, &y_coord, &z_coord, &vl, &el);
+            n_elem = lin->getNumLines();
+            n_conn = lin->getNumVertices();
+            n_coord = lin->getNumPoints();
+        }
+        else
+        {
+            tri = (coDoTriangleStrips *)data_obj;
+            tri->getAddresses(&x_coord, &y_coord, &z_coord, &vl, &el);
+            n_elem = tri->getNumStrips();
+            n_conn = tri->getNumVertices();
+            n_coord = tri->getNumPoints();
+        }
+        rec.sizes.push_back(n_elem);
+        rec.sizes.push_back(n_conn);
+        rec.sizes.push_back(n_coord);
+        ok = file.addArray(rec, el, sizeof(int), n_elem)
+             && file.addArray(rec, vl, sizeof(int), n_conn)
+             && file.addArray(rec, x_coord, sizeof(float), n_coord)
+             && file.addArray(rec, y_coord, sizeof(float), n_coord)
+             && file.addArray(rec, z_coord, sizeof(float), n_coord);
+    }
+    else if (strcmp(gtype, "TRITRI") == 0 || strcmp(gtype, "QUADS") == 0)
+    {
+        if (strcmp(gtype, "TRITRI") == 0)
+        {
+            triang = (coDoTriangles *)data_obj;
+            triang->getAddresses(&x_coord, &y_coord, &z_coord, &vl);
+            n_conn = triang->getNumVertices();
+            n_coord = triang->getNumPoints();
+        }
+        else
+        {
+            quads = (coDoQuads *)data_obj;
+            quads->getAddresses(&x_coord, &y_coord, &z_coord, &vl);
+            n_conn = quads->getNumVertices();
+            n_coord = quads->getNumPoints();
+        }
+        rec.sizes.push_back(n_conn);
+        rec.sizes.push_back(n_coord);
+        ok = file.addArray(rec, vl, sizeof(int), n_conn)
+             && file.addArray(rec, x_coord, sizeof(float), n_coord)
+             && file.addArray(rec, y_coord, sizeof(float), n_coord)
+             && file.addArray(rec, z_coord, sizeof(float), n_coord);
+    }
+    else if (strcmp(gtype, "RCTGRD") == 0)
+    {
+        int xs, ys, zs;
+        rgrid = (coDoRectilinearGrid *)data_obj;
+        rgrid->getAddresses(&x_coord, &y_coord, &z_coord);
+        rgrid->getGridSize(&xs, &ys, &zs);
+        rec.sizes.push_back(xs);
+        rec.sizes.push_back(ys);
+        rec.sizes.push_back(zs);
+        ok = file.addArray(rec, x_coord, sizeof(float), xs)
+             && file.addArray(rec, y_coord, sizeof(float), ys)
+             && file.addArray(rec, z_coord, sizeof(float), zs);
+    }
+    else if (strcmp(gtype, "STRGRD") == 0)
+    {
+        int xs, ys, zs;
+        sgrid = (coDoStructuredGrid *)data_obj;
+        sgrid->getAddresses(&x_coord, &y_coord, &z_coord);
+        sgrid->getGridSize(&xs, &ys, &zs);
+        rec.sizes.push_back(xs);
+        rec.sizes.push_back(ys);
+        rec.sizes.push_back(zs);
+        int64_t num = (int64_t)xs * ys * zs;
+        ok = file.addArray(rec, x_coord, sizeof(float), num)
+             && file.addArray(rec, y_coord, sizeof(float), num)
+             && file.addArray(rec, z_coord, sizeof(float), num);
+    }
+    else if (strcmp(gtype, "UNIGRD") == 0)
+    {
+        int xs, ys, zs;
+        float x_min, y_min, z_min, x_max, y_max, z_max;
+        ugrid = (coDoUniformGrid *)data_obj;
+        ugrid->getGridSize(&xs, &ys, &zs);
+        ugrid->getMinMax(&x_min, &x_max, &y_min, &y_max, &z_min, &z_max);
+        rec.sizes.push_back(xs);
+        rec.sizes.push_back(ys);
+        rec.sizes.push_back(zs);
+        float minMax[] = { x_min, x_max, y_min, y_max, z_min, z_max };
+        rec.values.assign(minMax, minMax + 6);
+    }
+    else if (strcmp(gtype, "USTSDT") == 0)
+    {
+        us3d = (coDoFloat *)data_obj;
+        us3d->getAddress(&x_coord);
+        n_elem = us3d->getNumPoints();
+        rec.sizes.push_back(n_elem);
+        ok = file.addArray(rec, x_coord, sizeof(float), n_elem);
+    }
+    else if (strcmp(gtype, "USTTDT") == 0)
+    {
+        const coDoTensor *ut3d = (const coDoTensor *)data_obj;
+        ut3d->getAddress(&x_coord);
+        n_elem = ut3d->getNumPoints();
+        rec.sizes.push_back(n_elem);
+        rec.sizes.push_back(ut3d->getTensorType());
+        ok = file.addArray(rec, x_coord, sizeof(float), (int64_t)n_elem * ut3d->dimension());
+    }
+    else if (strcmp(gtype, "RGBADT") == 0)
+    {
+        int *colors;
+        rgba = (coDoRGBA *)data_obj;
+        rgba->getAddress(&colors);
+        n_elem = rgba->getNumPoints();
+        rec.sizes.push_back(n_elem);
+        ok = file.addArray(rec, colors, sizeof(int), n_elem);
+    }
+    else if (strcmp(gtype, "USTVDT") == 0)
+    {
+        us3dv = (coDoVec3 *)data_obj;
+        us3dv->getAddresses(&x_coord, &y_coord, &z_coord);
+        n_elem = us3dv->getNumPoints();
+        rec.sizes.push_back(n_elem);
+        ok = file.addArray(rec, x_coord, sizeof(float), n_elem)
+             && file.addArray(rec, y_coord, sizeof(float), n_elem)
+             && file.addArray(rec, z_coord, sizeof(float), n_elem);
+    }
+    else if (strcmp(gtype, "IMAGE") == 0)
+    {
+        pixelimage = (coDoPixelImage *)data_obj;
+        rec.sizes.push_back(pixelimage->getWidth());
+        rec.sizes.push_back(pixelimage->getHeight());
+        rec.sizes.push_back(pixelimage->getPixelsize());
+        rec.sizes.push_back(pixelimage->getFormat());
+        ok = file.addArray(rec, pixelimage->getPixels(), 1,
+                           (int64_t)pixelimage->getWidth() * pixelimage->getHeight() * pixelimage->getPixelsize());
+    }
+    else
+    {
+        Covise::sendError("ERROR: unsupported DataType");
+        return -1;
+    }
+    if (!ok)
+        return -1;
+
+    int index = file.addObject(rec);
+    if (data_obj->getRefCount() > 1)
+        writtenObjects[rec.name] = index;
+    return index;
+}
+
+coDistributedObject *CoviseIO::readData2(CoviseFile2 &file, int index, const char *Name)
+{
+    if (index < 0 || index >= file.numObjects())
+    {
+        Covise::sendError("ERROR: Reading file '%s': index is corrupt", grid_Path.c_str());
+        return NULL;
+    }
+    if (readObjects[index])
+    {
+        // referenced several times
+        readObjects[index]->incRefCount();
+        return readObjects[index];
+    }
+
+    const CoviseFile2::Object &rec = file.object(index);
+    const char *Data_Type = rec.type.c_str();
+    char buf[300];
+    coDistributedObject *obj = NULL;
+    bool ok = true;
+    bool layoutOk = true;
+
+    if (strcmp(Data_Type, "SETELE") == 0)
+    {
+        int numsets = (int)rec.children.size();
+        int startstep = 0, numsteps = numsets, step = 1;
+        if (setsRead == 0)
+        {
+            // only the elements requested are touched
+            if (firstStepToRead > 0 && firstStepToRead < numsets)
+                startstep = firstStepToRead;
+            if (numStepsToRead > 0)
+                numsteps = numStepsToRead;
+            if (skipSteps > 0)
+                step += skipSteps;
+        }
+        setsRead++;
+
+        std::vector<coDistributedObject *> tmp_objs;
+        if (setsRead == 1 && residentNum > 0)
+        {
+            // all elements are there, but only the resident ones are read
+            for (int i = 0; i < numsets; i++)
+            {
+                snprintf(buf, sizeof(buf), "%s_%d", Name, i);
+                coDistributedObject *elem = NULL;
+                if ((i - residentFirst % numsets + numsets) % numsets < residentNum)
+                    elem = readData2(file, rec.children[i], buf);
+                else
+                    elem = new coDoSet(coObjInfo(buf), SET_CREATE);
+                if (!elem)
+                    return NULL;
+                tmp_objs.push_back(elem);
+            }
+            numsteps = 0;
+        }
+        for (int i = startstep; i < numsets && (int)tmp_objs.size() < numsteps; i += step)
+        {
+            snprintf(buf, sizeof(buf), "%s_%d", Name, (int)tmp_objs.size());
+            coDistributedObject *elem = readData2(file, rec.children[i], buf);
+            if (!elem)
+                return NULL;
+            tmp_objs.push_back(elem);
+        }
+        tmp_objs.push_back(NULL);
+        obj = new coDoSet(coObjInfo(Name), &tmp_objs[0]);
+    }
+    else if (strcmp(Data_Type, "GEOMET") == 0)
+    {
+        static const char *const suffix[] = { "_Geo", "_Col", "_Norm", "_Texture" };
+        coDistributedObject *parts[4] = { NULL, NULL, NULL, NULL };
+        layoutOk = hasLayout(rec, 7, 0) && rec.sizes[3];
+        size_t child = 0;
+        for (int i = 0; i < 4 && layoutOk; i++)
+        {
+            if (!rec.sizes[3 + i])
+                continue;
+            layoutOk = child < rec.children.size();
+            if (layoutOk)
+            {
+                snprintf(buf, sizeof(buf), "%s%s", Name, suffix[i]);
+                parts[i] = readData2(file, rec.children[child++], buf);
+                if (!parts[i])
+                    return NULL;
+            }
+        }
+        if (layoutOk)
+        {
+            coDoGeometry *geo = new coDoGeometry(coObjInfo(Name), parts[0]);
+            if (parts[1])
+                geo->setColors((int)rec.sizes[0], parts[1]);
+            if (parts[2])
+                geo->setNormals((int)rec.sizes[1], parts[2]);
+            if (parts[3])
+                geo->setTexture((int)rec.sizes[2], parts[3]);
+            obj = geo;
+        }
+    }
+    else if (strcmp(Data_Type, "INTARR") == 0)
+    {
+        layoutOk = hasLayout(rec, 1, 1);
+        if (layoutOk)
+        {
+            std::vector<int> sizes(rec.sizes.begin(), rec.sizes.end());
+            coDoIntArr *arr = new coDoIntArr(coObjInfo(Name), (int)sizes.size(), &sizes[0]);
+            if (arr->objectOk())
+                ok = file.readArray(rec.arrays[0], arr->getAddress(), (int64_t)arr->getSize() * sizeof(int));
+            obj = arr;
+        }
+    }
+    else if (strcmp(Data_Type, "INTDT ") == 0)
+    {
+        layoutOk = hasLayout(rec, 1, 1);
+        if (layoutOk)
+        {
+            n_elem = (int)rec.sizes[0];
+            coDoInt *intobj = new coDoInt(coObjInfo(Name), n_elem);
+            if (intobj->objectOk())
+                ok = file.readArray(rec.arrays[0], intobj->getAddress(), (int64_t)n_elem * sizeof(int));
+            obj = intobj;
+        }
+    }
+    else if (strcmp(Data_Type, "BYTEDT") == 0)
+    {
+        layoutOk = hasLayout(rec, 1, 1);
+        if (layoutOk)
+        {
+            n_elem = (int)rec.sizes[0];
+            coDoByte *byteobj = new coDoByte(coObjInfo(Name), n_elem);
+            if (byteobj->objectOk())
+                ok = file.readArray(rec.arrays[0], byteobj->getAddress(), n_elem);
+            obj = byteobj;
+        }
+    }
+    else if (strcmp(Data_Type, "UNSGRD") == 0)
+    {
+        layoutOk = hasLayout(rec, 3, 6);
+        if (layoutOk)
+        {
+            n_elem = (int)rec.sizes[0];
+            n_conn = (int)rec.sizes[1];
+            n_coord = (int)rec.sizes[2];
+            mesh = new coDoUnstructuredGrid(coObjInfo(Name), n_elem, n_conn, n_coord, 1);
+            if (mesh->objectOk())
+            {
+                mesh->getAddresses(&el, &vl, &x_coord, &y_coord, &z_coord);
+                mesh->getTypeList(&tl);
+                ok = file.readArray(rec.arrays[0], el, (int64_t)n_elem * sizeof(int))
+                     && file.readArray(rec.arrays[1], tl, (int64_t)n_elem * sizeof(int))
+                     && file.readArray(rec.arrays[2], vl, (int64_t)n_conn * sizeof(int))
+                     && file.readArray(rec.arrays[3], x_coord, (int64_t)n_coord * sizeof(float))
+                     && file.readArray(rec.arrays[4], y_coord, (int64_t)n_coord * sizeof(float))
+                     && file.readArray(rec.arrays[5], z_coord, (int64_t)n_coord * sizeof(float));
+            }
+            obj = mesh;
+        }
+    }
+    else if (strcmp(Data_Type, "POINTS") == 0)
+    {
+        layoutOk = hasLayout(rec, 1, 3);
+        if (layoutOk)
+        {
+            n_coord = (int)rec.sizes[0];
+            pts = new coDoPoints(coObjInfo(Name), n_coord);
+            if (pts->objectOk())
+            {
+                pts->getAddresses(&x_coord, &y_coord, &z_coord);
+                ok = file.readArray(rec.arrays[0], x_coord, (int64_t)n_coord * sizeof(float))
+                     && file.readArray(rec.arrays[1], y_coord, (int64_t)n_coord * sizeof(float))
+                     && file.readArray(rec.arrays[2], z_coord, (int64_t)n_coord * sizeof(float));
+            }
+            obj = pts;
+        }
+    }
+    else if (strcmp(Data_Type, "SPHERE") == 0)
+    {
+        layoutOk = hasLayout(rec, 1, 4);
+        if (layoutOk)
+        {
+            n_coord = (int)rec.sizes[0];
+            sph = new coDoSpheres(coObjInfo(Name), n_coord);
+            if (sph->objectOk())
+            {
+                sph->getAddresses(&x_coord, &y_coord, &z_coord, &radius);
+                ok = file.readArray(rec.arrays[0], x_coord, (int64_t)n_coord * sizeof(float))
+                     && file.readArray(rec.arrays[1], y_coord, (int64_t)n_coord * sizeof(float))
+                     && file.readArray(rec.arrays[2], z_coord, (int64_t)n_coord * sizeof(float))
+                     && file.readArray(rec.arrays[3], radius, (int64_t)n_coord * sizeof(float));
+            }
+            obj = sph;
+        }
+    }
+    else if (strcmp(Data_Type, "DOTEXT") == 0)
+    {
+        layoutOk = hasLayout(rec, 1, 1);
+        if (layoutOk)
+        {
+            char *data;
+            n_elem = (int)rec.sizes[0];
+            txt = new coDoText(coObjInfo(Name), n_elem);
+            if (txt->objectOk())
+            {
+                txt->getAddress(&data);
+                ok = file.readArray(rec.arrays[0], data, n_elem);
+            }
+            obj = txt;
+        }
+    }
+    else if (strcmp(Data_Type, "POLYGN") == 0 || strcmp(Data_Type, "LINES") == 0 || strcmp(Data_Type, "TRIANG") == 0)
+    {
+        layoutOk = hasLayout(rec, 3, 5);
+        if (layoutOk)
+        {
+            n_elem = (int)rec.sizes[0];
+            n_conn = (int)rec.sizes[1];
+            n_coord = (int)rec.sizes[2];
+            if (strcmp(Data_Type, "POLYGN") == 0)
+            {
+                pol = new coDoPolygons(coObjInfo(Name), n_coord, n_conn, n_elem);
+                if (pol->objectOk())
+                    pol->getAddresses(&x_coord, &y_coord, &z_coord, &vl, &el);
+                obj = pol;
+            }
+            else if (strcmp(Data_Type, "LINES") == 0)
+            {
+                lin = new coDoLines(coObjInfo(Name), n_coord, n_conn, n_elem);
+                if (lin->objectOk())
+                    lin->getAddresses(&x_coord, &y_coord, &z_coord, &vl, &el);
+                obj = lin;
+            }
+            else
+            {
+                tri = new coDoTriangleStrips(coObjInfo(Name), n_coord, n_conn, n_elem);
+                if (tri->objectOk())
+                    tri->getAddresses(&x_coord, &y_coord, &z_coord, &vl, &el);
+                obj = tri;
+            }
+            if (obj->objectOk())
+                ok = file.readArray(rec.arrays[0], el, (int64_t)n_elem * sizeof(int))
+                     && file.readArray(rec.arrays[1], vl, (int64_t)n_conn * sizeof(int))
+                     && file.readArray(rec.arrays[2], x_coord, (int64_t)n_coord * sizeof(float))
+                     && file.readArray(rec.arrays[3], y_coord, (int64_t)n_coord * sizeof(float))
+                     && file.readArray(rec.arrays[4], z_coord, (int64_t)n_coord * sizeof(float));
+        }
+    }
+    else if (strcmp(Data_Type, "TRITRI") == 0 || strcmp(Data_Type, "QUADS") == 0)
+    {
+        layoutOk = hasLayout(rec, 2, 4);
+        if (layoutOk)
+        {
+            n_conn = (int)rec.sizes[0];
+            n_coord = (int)rec.sizes[1];
+            if (strcmp(Data_Type, "TRITRI") == 0)
+            {
+                triang = new coDoTriangles(coObjInfo(Name), n_coord, n_conn);
+                if (triang->objectOk())
+                    triang->getAddresses(&x_coord, &y_coord, &z_coord, &vl);
+                obj = triang;
+            }
+            else
+            {
+                quads = new coDoQuads(coObjInfo(Name), n_coord, n_conn);
+                if (quads->objectOk())
+                    quads->getAddresses(&x_coord, &y_coord, &z_coord, &vl);
+                obj = quads;
+            }
+            if (obj->objectOk())
+                ok = file.readArray(rec.arrays[0], vl, (int64_t)n_conn * sizeof(int))
+                     && file.readArray(rec.arrays[1], x_coord, (int64_t)n_coord * sizeof(float))
+                     && file.readArray(rec.arrays[2], y_coord, (int64_t)n_coord * sizeof(float))
+                     && file.readArray(rec.arrays[3], z_coord, (int64_t)n_coord * sizeof(float));
+        }
+    }
+    else if (strcmp(Data_Type, "RCTGRD") == 0)
+    {
+        layoutOk = hasLayout(rec, 3, 3);
+        if (layoutOk)
+        {
+            int xs = (int)rec.sizes[0], ys = (int)rec.sizes[1], zs = (int)rec.sizes[2];
+            rgrid = new coDoRectilinearGrid(coObjInfo(Name), xs, ys, zs);
+            if (rgrid->objectOk())
+            {
+                rgrid->getAddresses(&x_coord, &y_coord, &z_coord);
+                ok = file.readArray(rec.arrays[0], x_coord, (int64_t)xs * sizeof(float))
+                     && file.readArray(rec.arrays[1], y_coord, (int64_t)ys * sizeof(float))
+                     && file.readArray(rec.arrays[2], z_coord, (int64_t)zs * sizeof(float));
+            }
+            obj = rgrid;
+        }
+    }
+    else if (strcmp(Data_Type, "STRGRD") == 0)
+    {
+        layoutOk = hasLayout(rec, 3, 3);
+        if (layoutOk)
+        {
+            int xs = (int)rec.sizes[0], ys = (int)rec.sizes[1], zs = (int)rec.sizes[2];
+            int64_t size = (int64_t)xs * ys * zs * sizeof(float);
+            sgrid = new coDoStructuredGrid(coObjInfo(Name), xs, ys, zs);
+            if (sgrid->objectOk())
+            {
+                sgrid->getAddresses(&x_coord, &y_coord, &z_coord);
+                ok = file.readArray(rec.arrays[0], x_coord, size)
+                     && file.readArray(rec.arrays[1], y_coord, size)
+                     && file.readArray(rec.arrays[2], z_coord, size);
+            }
+            obj = sgrid;
+        }
+    }
+    else if (strcmp(Data_Type, "UNIGRD") == 0)
+    {
+        layoutOk = hasLayout(rec, 3, 0, 6);
+        if (layoutOk)
+            obj = ugrid = new coDoUniformGrid(coObjInfo(Name), (int)rec.sizes[0], (int)rec.sizes[1], (int)rec.sizes[2],
+                                              rec.values[0], rec.values[1], rec.values[2],
+                                              rec.values[3], rec.values[4], rec.values[5]);
+    }
+    else if (strcmp(Data_Type, "USTSDT") == 0)
+    {
+        layoutOk = hasLayout(rec, 1, 1);
+        if (layoutOk)
+        {
+            n_elem = (int)rec.sizes[0];
+            us3d = new coDoFloat(coObjInfo(Name), n_elem);
+            if (us3d->objectOk())
+            {
+                us3d->getAddress(&x_coord);
+                ok = file.readArray(rec.arrays[0], x_coord, (int64_t)n_elem * sizeof(float));
+            }
+            obj = us3d;
+        }
+    }
+    else if (strcmp(Data_Type, "USTTDT") == 0)
+    {
+        layoutOk = hasLayout(rec, 2, 1);
+        if (layoutOk)
+        {
+            n_elem = (int)rec.sizes[0];
+            coDoTensor *ut3d = new coDoTensor(coObjInfo(Name), n_elem, (coDoTensor::TensorType)rec.sizes[1]);
+            if (ut3d->objectOk())
+            {
+                ut3d->getAddress(&x_coord);
+                ok = file.readArray(rec.arrays[0], x_coord, (int64_t)n_elem * ut3d->dimension() * sizeof(float));
+            }
+            obj = ut3d;
+        }
+    }
+    else if (strcmp(Data_Type, "RGBADT") == 0)
+    {
+        layoutOk = hasLayout(rec, 1, 1);
+        if (layoutOk)
+        {
+            int *colors;
+            n_elem = (int)rec.sizes[0];
+            rgba = new coDoRGBA(coObjInfo(Name), n_elem);
+            if (rgba->objectOk())
+            {
+                rgba->getAddress(&colors);
+                ok = file.readArray(rec.arrays[0], colors, (int64_t)n_elem * sizeof(int));
+            }
+            obj = rgba;
+        }
+    }
+    else if (strcmp(Data_Type, "USTVDT") == 0)
+    {
+        layoutOk = hasLayout(rec, 1, 3);
+        if (layoutOk)
+        {
+            n_elem = (int)rec.sizes[0];
+            us3dv = new coDoVec3(coObjInfo(Name), n_elem);
+            if (us3dv->objectOk())
+            {
+                us3dv->getAddresses(&x_coord, &y_coord, &z_coord);
+                ok = file.readArray(rec.arrays[0], x_coord, (int64_t)n_elem * sizeof(float))
+                     && file.readArray(rec.arrays[1], y_coord, (int64_t)n_elem * sizeof(float))
+                     && file.readArray(rec.arrays[2], z_coord, (int64_t)n_elem * sizeof(float));
+            }
+            obj = us3dv;
+        }
+    }
+    else if (strcmp(Data_Type, "IMAGE") == 0)
+    {
+        layoutOk = hasLayout(rec, 4, 1);
+        if (layoutOk)
+        {
+            int width = (int)rec.sizes[0], height = (int)rec.sizes[1], pixelSize = (int)rec.sizes[2];
+            pixelimage = new coDoPixelImage(coObjInfo(Name), width, height, pixelSize, (unsigned)rec.sizes[3]);
+            if (pixelimage->objectOk())
+                ok = file.readArray(rec.arrays[0], pixelimage->getPixels(), (int64_t)width * height * pixelSize);
+            obj = pixelimage;
+        }
+    }
+    else
+    {
+        Covise::sendError("ERROR: Reading file '%s', unsupported object type %s", grid_Path.c_str(), Data_Type);
+        return NULL;
+    }
+
+    if (!layoutOk)
+    {
+        Covise::sendError("ERROR: Reading file '%s', %s object is corrupt", grid_Path.c_str(), Data_Type);
+        return NULL;
+    }
+    if (!obj->objectOk())
+    {
+        Covise::sendError("ERROR: creation of %s object failed", Data_Type);
+        delete obj;
+        return NULL;
+    }
+    if (!ok)
+    {
+        Covise::sendError("ERROR: Reading file '%s': %s", grid_Path.c_str(), file.error());
+        delete obj;
+        return NULL;
+    }
+
+    if (!rec.attribNames.empty())
+    {
+        std::vector<const char *> atNam, atVal;
+        for (size_t i = 0; i < rec.attribNames.size(); i++)
+        {
+            atNam.push_back(rec.attribNames[i].c_str());
+            atVal.push_back(rec.attribValues[i].c_str());
+        }
+        obj->addAttributes((int)atNam.size(), &atNam[0], &atVal[0]);
+    }
+    readObjects[index] = obj;
+    return obj;
+}
+
+coDistributedObject *CoviseIO::finishRead2(CoviseFile2 &file, coDistributedObject *tmp_obj)
+{
+    // the returned object is deleted later by the module
+    for (size_t i = 0; i < readObjects.size(); ++i)
+        if (readObjects[i] != tmp_obj)
+            delete readObjects[i];
+    readObjects.clear();
+    file.close();
+    return tmp_obj;
+}
+
+int CoviseIO::getNumElements(const char *filename)
+{
+    CoviseFile2 file;
+    if (!file.open(filename))
+    {
+        Covise::sendError("failed to open %s for reading: %s", filename, file.error());
+        return 0;
+    }
+    const CoviseFile2::Object &root = file.object(file.root());
+    return root.type == "SETELE" ? (int)root.children.size() : 0;
+}
+
+coDistributedObject *CoviseIO::ReadElement(const char *filename, const char *objectName, int element, bool force)
+{
+    this->force = force;
+    if (filename == NULL)
+        return NULL;
+
+    grid_Path = filename;
+    CoviseFile2 file;
+    if (!file.open(filename))
+    {
+        Covise::sendError("failed to open %s for reading: %s", filename, file.error());
+        return NULL;
+    }
+    const CoviseFile2::Object &root = file.object(file.root());
+    if (root.type != "SETELE" || element < 0 || element >= (int)root.children.size())
+    {
+        Covise::sendError("ERROR: '%s' has no element %d", filename, element);
+        return NULL;
+    }
+    // nested sets are read completely
+    setsRead = 1;
+    readObjects.assign(file.numObjects(), NULL);
+    return finishRead2(file, readData2(file, root.children[element], objectName));
+}
+
+coDistributedObject *CoviseIO::ReadWindow(const char *filename, const char *objectName, int first, int num, bool force)
+{
+    if (filename == NULL)
+        return NULL;
+    if (!isIndexedFile(filename))
+    {
+        Covise::sendWarning("%s is not in COVISE file format 2, reading all elements", filename);
+        return ReadFile(filename, objectName, force);
+    }
+
+    residentFirst = std::max(first, 0);
+    residentNum = std::max(num, 1);
+    coDistributedObject *obj = ReadFile(filename, objectName, force);
+    residentFirst = 0;
+    residentNum = 0;
+    return obj;
+}
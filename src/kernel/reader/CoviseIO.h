@@ -14,10 +14,13 @@
 #include <file/covReadFiles.h>
 #include <do/coDoData.h>
 #include <string>
+#include <map>
 
 namespace covise
 {
 
+class CoviseFile2;
+
 class coDoLines;
 class coDoPixelImage;
 class coDoPoints;
@@ -93,6 +96,18 @@ private:
     ObjectNameList objectNameList;
     ObjectList objectList;
 
+    // indexed format (version 2)
+    int fileFormat;
+    int compressionLevel;
+    int residentFirst;
+    int residentNum;
+    std::map<std::string, int> writtenObjects;
+    std::vector<coDistributedObject *> readObjects;
+    bool isSupported2(const coDistributedObject *tmp_Object) const;
+    int writeobj2(CoviseFile2 &file, const coDistributedObject *tmp_Object);
+    coDistributedObject *readData2(CoviseFile2 &file, int index, const char *Name);
+    coDistributedObject *finishRead2(CoviseFile2 &file, coDistributedObject *tmp_obj);
+
 protected:
     virtual int covOpenInFile(const char *grid_Path);
     virtual int covCloseInFile(int fd);
@@ -100,9 +115,30 @@ protected:
 public:
     coDistributedObject *ReadFile(const char *filename, const char *ObjectName, bool force = false, int firstStep = 0, int numSteps = 0, int skipSteps = 0);
     int WriteFile(const char *filename, const coDistributedObject *Object);
+
+    /// format written by WriteFile: 1 sequential records, 2 indexed with compressed arrays
+    void setFileFormat(int version, int compression = 1)
+    {
+        fileFormat = version;
+        compressionLevel = compression;
+    }
+    /// true if filename is in the indexed format, which allows random access to set elements
+    static bool isIndexedFile(const char *filename);
+    /// number of elements of the top level set of an indexed file, 0 if it is no set
+    int getNumElements(const char *filename);
+    /// read a single element of the top level set of an indexed file
+    coDistributedObject *ReadElement(const char *filename, const char *ObjectName, int element, bool force = false);
+    /// read the top level set of an indexed file with all its elements, but only num
+    /// elements starting at first (cyclically) are read, the others are empty sets
+    coDistributedObject *ReadWindow(const char *filename, const char *ObjectName, int first, int num, bool force = false);
+
     CoviseIO()
     {
         force = false;
+        fileFormat = 1;
+        compressionLevel = 1;
+        residentFirst = 0;
+        residentNum = 0;
     }
     virtual ~CoviseIO()
     {
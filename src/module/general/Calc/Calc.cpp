@@ -25,9 +25,14 @@
 \**************************************************************************/
 
 #include "Calc.h"
+#include <config/CoviseConfig.h>
 #include <do/coDoData.h>
 #include <do/coDoUnstructuredGrid.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace covise;
 
 //#define DEBUGMODE 1
@@ -586,33 +591,13 @@ int CCalc::Compute(Calc *module, char *Expression)
     }
 
     //evaluate array
-
-    for (Array_Count = 0; Array_Count < Array_Len; Array_Count++)
+    //the compiled program gives the same results as Evaluate(), but works on
+    //blocks of elements instead of one element per call
+    CCalcProgram Program;
+    if (Array_Len > 0 && !coCoviseConfig::isOn("Module.Calc.Interpreter", false)
+        && Compile(module, &Program))
     {
-        Result_Vektor = pIntermed;
-        if (u1_in != NULL) // vector-input 1 connected
-        {
-            pVektor_1[0] = u1_in[Array_Count];
-            pVektor_1[1] = v1_in[Array_Count];
-            if (Vek_Len == 3)
-                pVektor_1[2] = w1_in[Array_Count];
-        }
-
-        if (u2_in != NULL) // vector-input 2 connected
-        {
-            pVektor_2[0] = u2_in[Array_Count];
-            pVektor_2[1] = v2_in[Array_Count];
-            if (Vek_Len == 3)
-                pVektor_2[2] = w2_in[Array_Count];
-        }
-
-        if (s1_in != NULL)
-            pSkalar_1 = &s1_in[Array_Count];
-        if (s2_in != NULL)
-            pSkalar_2 = &s2_in[Array_Count];
-
-        //evaluation of expression
-        if (!Evaluate(module, &Result_Type, &Result_Vektor, &Result_Skalar))
+        if (!Program.Run(module, Array_Len, s_out, u_out, v_out, w_out))
         {
             //in case of an error free memory before return
             DeleteItemList();
@@ -630,23 +615,70 @@ int CCalc::Compute(Calc *module, char *Expression)
             delete[](dtype_v2);
             return coSimpleModule::FAIL;
         }
-
-        //write result into output object
-        switch (Result_Type)
+    }
+    else
+    {
+        for (Array_Count = 0; Array_Count < Array_Len; Array_Count++)
         {
-        case VEKTOR:
-            u_out[Array_Count] = Result_Vektor[0];
-            v_out[Array_Count] = Result_Vektor[1];
-            if (Vek_Len == 3)
-                w_out[Array_Count] = Result_Vektor[2];
-            break;
+            Result_Vektor = pIntermed;
+            if (u1_in != NULL) // vector-input 1 connected
+            {
+                pVektor_1[0] = u1_in[Array_Count];
+                pVektor_1[1] = v1_in[Array_Count];
+                if (Vek_Len == 3)
+                    pVektor_1[2] = w1_in[Array_Count];
+            }
 
-        case SKALAR:
-            s_out[Array_Count] = Result_Skalar;
-            break;
+            if (u2_in != NULL) // vector-input 2 connected
+            {
+                pVektor_2[0] = u2_in[Array_Count];
+                pVektor_2[1] = v2_in[Array_Count];
+                if (Vek_Len == 3)
+                    pVektor_2[2] = w2_in[Array_Count];
+            }
+
+            if (s1_in != NULL)
+                pSkalar_1 = &s1_in[Array_Count];
+            if (s2_in != NULL)
+                pSkalar_2 = &s2_in[Array_Count];
+
+            //evaluation of expression
+            if (!Evaluate(module, &Result_Type, &Result_Vektor, &Result_Skalar))
+            {
+                //in case of an error free memory before return
+                DeleteItemList();
+                DeletePostfixList();
+
+                delete[](pVektor_1);
+                delete[](pVektor_2);
+                delete[](pEinh_Vektor);
+                delete[](pMan_Vektor);
+                delete[](String);
+                delete[](pIntermed);
+                delete[](dtype_s1);
+                delete[](dtype_s2);
+                delete[](dtype_v1);
+                delete[](dtype_v2);
+                return coSimpleModule::FAIL;
+            }
+
+            //write result into output object
+            switch (Result_Type)
+            {
+            case VEKTOR:
+                u_out[Array_Count] = Result_Vektor[0];
+                v_out[Array_Count] = Result_Vektor[1];
+                if (Vek_Len == 3)
+                    w_out[Array_Count] = Result_Vektor[2];
+                break;
+
+            case SKALAR:
+                s_out[Array_Count] = Result_Skalar;
+                break;
+            }
+            if (Array_Count == 0)
+                minmax = 1; //in case of max/min: send message
         }
-        if (Array_Count == 0)
-            minmax = 1; //in case of max/min: send message
     }
 
     //FOR TESTING *********************************************************
@@ -1604,6 +1636,151 @@ int CCalc::GetResultType(Calc *module, int *Result_Type, int *TempVek)
     return (1);
 }
 
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Compile: translate postfix-expression into a CCalcProgram                //
+//          returns false if the expression has to be left to Evaluate()    //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+bool CCalc::Compile(Calc *module, CCalcProgram *Program)
+{
+    std::vector<int> Stack;
+    bool Skalar_Written = false; // Evaluate() adds the dot product to the last scalar result
+    int Operation = 0;
+    int Type_Res = TOKEN;
+
+    for (int CountPostfix = 0; pListPostfix[CountPostfix].Priority != EOL; CountPostfix++)
+    {
+        const LIST &Entry = pListPostfix[CountPostfix];
+        int Slot = -1;
+
+        switch (Entry.Priority)
+        {
+        case 0: // operand
+            if (Entry.Type == SKALAR)
+            {
+                const float *Data = NULL;
+                if (!strcmp(Entry.Item, SKALAR_1))
+                    Data = s1_in;
+                else if (!strcmp(Entry.Item, SKALAR_2))
+                    Data = s2_in;
+                if (Data)
+                {
+                    Slot = Program->AddSlot(SKALAR, CCalcProgram::INPUT);
+                    Program->Slots[Slot].Data[0] = Data;
+                }
+                else
+                {
+                    // unconnected inputs evaluate to 0
+                    Slot = Program->AddSlot(SKALAR, CCalcProgram::CONSTANT);
+                    if (strcmp(Entry.Item, SKALAR_1) != 0 && strcmp(Entry.Item, SKALAR_2) != 0)
+                        Program->Slots[Slot].Value[0] = (float)atof(Entry.Item);
+                }
+            }
+            else if (Entry.Type == VEKTOR)
+            {
+                if (!strcmp(Entry.Item, VEKTOR_1) || !strcmp(Entry.Item, VEKTOR_2))
+                {
+                    bool First = !strcmp(Entry.Item, VEKTOR_1);
+                    if (First ? u1_in == NULL : u2_in == NULL)
+                        return false;
+                    Slot = Program->AddSlot(VEKTOR, CCalcProgram::INPUT);
+                    Program->Slots[Slot].Data[0] = First ? u1_in : u2_in;
+                    Program->Slots[Slot].Data[1] = First ? v1_in : v2_in;
+                    Program->Slots[Slot].Data[2] = First ? w1_in : w2_in;
+                }
+                else if (strstr(Entry.Item, MANUAL_V))
+                {
+                    int Man_Vek = atoi(Entry.Item + strlen(MANUAL_V));
+                    Slot = Program->AddSlot(VEKTOR, CCalcProgram::CONSTANT);
+                    for (int x = 0; x < Vek_Len; x++)
+                        Program->Slots[Slot].Value[x] = pMan_Vektor[Man_Vek * Vek_Len + x];
+                }
+                else if (!strcmp(Entry.Item, EINHEITS_V))
+                {
+                    Slot = Program->AddSlot(VEKTOR, CCalcProgram::CONSTANT);
+                    for (int x = 0; x < Vek_Len; x++)
+                        Program->Slots[Slot].Value[x] = 1;
+                }
+                else
+                    return false;
+            }
+            else
+                return false;
+            Stack.push_back(Slot);
+            break;
+
+        case 2: // operator
+        case 3:
+        case 4:
+        case 5:
+        {
+            int Op_2 = -1;
+            int Op_Type_2 = false;
+            //no function
+            if (Entry.Priority != 5)
+            {
+                if (Stack.empty())
+                    return false;
+                Op_2 = Stack.back();
+                Stack.pop_back();
+                Op_Type_2 = Program->Slots[Op_2].Type;
+            }
+            if (Stack.empty())
+                return false;
+            int Op_1 = Stack.back();
+            Stack.pop_back();
+
+            if (!CheckOp(Program->Slots[Op_1].Type, Op_Type_2, Entry.Token, &Operation, &Type_Res))
+                return false;
+
+            if (Entry.Token == MAX || Entry.Token == MIN)
+            {
+                // max/min over the whole input array: evaluate once
+                const char *Input = pListPostfix[CountPostfix - 1].Item;
+                if (Operation == SKA ? !((!strcmp(Input, SKALAR_1) && s1_in) || (!strcmp(Input, SKALAR_2) && s2_in))
+                                     : !((!strcmp(Input, VEKTOR_1) && u1_in) || (!strcmp(Input, VEKTOR_2) && u2_in && u1_in)))
+                    return false;
+                float Skalar_Res = 0.f;
+                int Type = SKALAR;
+                if (!PerformOperation(module, 0.f, 0.f, NULL, NULL, Vek_Len, Operation, Entry.Token,
+                                      pListPostfix[CountPostfix - 1].Item, &Type, &Skalar_Res, NULL))
+                    return false;
+                Slot = Program->AddSlot(SKALAR, CCalcProgram::CONSTANT);
+                Program->Slots[Slot].Value[0] = Skalar_Res;
+            }
+            else
+            {
+                if (Operation == VEK_VEK && Entry.Token == MAL && Skalar_Written)
+                    return false;
+                Slot = Program->AddSlot(Type_Res, CCalcProgram::TEMP);
+                CCalcProgram::Instruction Instr;
+                Instr.Operation = Operation;
+                Instr.Token = Entry.Token;
+                Instr.Dst = Slot;
+                Instr.Op_1 = Op_1;
+                Instr.Op_2 = Op_2;
+                Program->Code.push_back(Instr);
+            }
+            if (Type_Res == SKALAR)
+                Skalar_Written = true;
+            Stack.push_back(Slot);
+            break;
+        }
+
+        default:
+            return false;
+        }
+    }
+
+    // expressions without any operation produce no output
+    if (Stack.size() != 1 || Program->Code.empty() || Program->Code.back().Dst != Stack.back())
+        return false;
+    Program->Result = Stack.back();
+    return true;
+}
+
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
 // Evaluate: evaluate postfix-expression                                    //
@@ -2398,4 +2575,308 @@ int CCalc::CheckInputs(Calc *module, int Code_s1, int Code_s2, int Code_v1, int
     return (1);
 }
 
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Implementation of class CCalcProgram                                     //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+int CCalcProgram::AddSlot(int Type, int Source)
+{
+    Slot NewSlot;
+    NewSlot.Type = Type;
+    NewSlot.Source = Source;
+    for (int x = 0; x < 3; x++)
+    {
+        NewSlot.Data[x] = NULL;
+        NewSlot.Value[x] = 0.f;
+    }
+    Slots.push_back(NewSlot);
+    return (int)Slots.size() - 1;
+}
+
+bool CCalcProgram::Run(Calc *module, int Array_Len, float *s_out,
+                       float *u_out, float *v_out, float *w_out) const
+{
+    const int NumSlots = (int)Slots.size();
+    const int NumBlocks = (Array_Len + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    int Error = CALC_OK;
+    int DivZero = 0;
+
+#ifdef _OPENMP
+#pragma omp parallel reduction(+ : DivZero)
+#endif
+    {
+        // per thread: BLOCK_SIZE values for each component of each slot
+        std::vector<float> Work(NumSlots * 3 * BLOCK_SIZE);
+        std::vector<float *> Comp(NumSlots * 3);
+        for (int i = 0; i < NumSlots; i++)
+        {
+            for (int x = 0; x < 3; x++)
+            {
+                Comp[3 * i + x] = &Work[(3 * i + x) * BLOCK_SIZE];
+                if (Slots[i].Source == CONSTANT)
+                {
+                    for (int k = 0; k < BLOCK_SIZE; k++)
+                        Comp[3 * i + x][k] = Slots[i].Value[x];
+                }
+            }
+        }
+
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+        for (int Block = 0; Block < NumBlocks; Block++)
+        {
+            int Start = Block * BLOCK_SIZE;
+            int Num = std::min((int)BLOCK_SIZE, Array_Len - Start);
+            for (int i = 0; i < NumSlots; i++)
+            {
+                if (Slots[i].Source == INPUT)
+                {
+                    for (int x = 0; x < 3; x++)
+                    {
+                        if (Slots[i].Data[x])
+                            Comp[3 * i + x] = const_cast<float *>(Slots[i].Data[x]) + Start;
+                    }
+                }
+            }
+            // the last operation writes directly into the output object
+            if (Slots[Result].Type == SKALAR)
+            {
+                Comp[3 * Result] = s_out + Start;
+            }
+            else
+            {
+                Comp[3 * Result] = u_out + Start;
+                Comp[3 * Result + 1] = v_out + Start;
+                Comp[3 * Result + 2] = w_out + Start;
+            }
+
+            int BlockError = RunBlock(&Comp[0], Num, &DivZero);
+            if (BlockError != CALC_OK)
+            {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                Error = BlockError;
+            }
+        }
+    }
+
+    switch (Error)
+    {
+    case CALC_DIV_ZERO:
+        module->sendError("ERROR: division by zero");
+        return false;
+    case CALC_LOG_NEGATIVE:
+        module->sendError("ERROR: log on negativ operand");
+        return false;
+    }
+    if (DivZero > 0)
+        module->sendWarning("ERROR: division by zero (%d times)", DivZero);
+    return true;
+}
+
+int CCalcProgram::RunBlock(float *const *Comp, int Num, int *DivZero) const
+{
+    int Error = CALC_OK;
+    int Count;
+
+    for (size_t Pc = 0; Pc < Code.size(); Pc++)
+    {
+        const Instruction &Instr = Code[Pc];
+        float *const *Res = &Comp[3 * Instr.Dst];
+        float *const *V_1 = &Comp[3 * Instr.Op_1];
+        float *const *V_2 = Instr.Op_2 >= 0 ? &Comp[3 * Instr.Op_2] : NULL;
+        float *S_Res = Res[0];
+        const float *Op_1 = V_1[0];
+        const float *Op_2 = V_2 ? V_2[0] : NULL;
+
+        switch (Instr.Operation)
+        {
+        case CCalc::VEK_VEK:
+            switch (Instr.Token)
+            {
+            case CCalc::PLUS:
+                for (int x = 0; x < 3; x++)
+                    for (Count = 0; Count < Num; Count++)
+                        Res[x][Count] = V_1[x][Count] + V_2[x][Count];
+                break;
+
+            case CCalc::MINUS:
+                for (int x = 0; x < 3; x++)
+                    for (Count = 0; Count < Num; Count++)
+                        Res[x][Count] = V_1[x][Count] - V_2[x][Count];
+                break;
+
+            case CCalc::MAL:
+                for (Count = 0; Count < Num; Count++)
+                {
+                    float Sum = 0.f;
+                    for (int x = 0; x < 3; x++)
+                        Sum = Sum + (V_1[x][Count] * V_2[x][Count]);
+                    S_Res[Count] = Sum;
+                }
+                break;
+
+            case CCalc::VEK_PROD:
+                for (Count = 0; Count < Num; Count++)
+                {
+                    Res[0][Count] = V_1[1][Count] * V_2[2][Count] - V_1[2][Count] * V_2[1][Count];
+                    Res[1][Count] = V_1[2][Count] * V_2[0][Count] - V_1[0][Count] * V_2[2][Count];
+                    Res[2][Count] = V_1[0][Count] * V_2[1][Count] - V_1[1][Count] * V_2[0][Count];
+                }
+                break;
+            }
+            break;
+
+        case CCalc::VEK_SKA:
+            switch (Instr.Token)
+            {
+            case CCalc::MAL:
+                for (int x = 0; x < 3; x++)
+                    for (Count = 0; Count < Num; Count++)
+                        Res[x][Count] = V_1[x][Count] * Op_2[Count];
+                break;
+
+            case CCalc::GETEILT:
+                for (Count = 0; Count < Num; Count++)
+                {
+                    if (!Op_2[Count])
+                        Error = CALC_DIV_ZERO;
+                }
+                for (int x = 0; x < 3; x++)
+                    for (Count = 0; Count < Num; Count++)
+                        Res[x][Count] = V_1[x][Count] / Op_2[Count];
+                break;
+            }
+            break;
+
+        case CCalc::SKA_VEK:
+            for (int x = 0; x < 3; x++)
+                for (Count = 0; Count < Num; Count++)
+                    Res[x][Count] = V_2[x][Count] * Op_1[Count];
+            break;
+
+        case CCalc::SKA_SKA:
+            switch (Instr.Token)
+            {
+            case CCalc::PLUS:
+                for (Count = 0; Count < Num; Count++)
+                    S_Res[Count] = Op_1[Count] + Op_2[Count];
+                break;
+
+            case CCalc::MINUS:
+                for (Count = 0; Count < Num; Count++)
+                    S_Res[Count] = Op_1[Count] - Op_2[Count];
+                break;
+
+            case CCalc::MAL:
+                for (Count = 0; Count < Num; Count++)
+                    S_Res[Count] = Op_1[Count] * Op_2[Count];
+                break;
+
+            case CCalc::GETEILT:
+                for (Count = 0; Count < Num; Count++)
+                {
+                    if (Op_2[Count])
+                        S_Res[Count] = Op_1[Count] / Op_2[Count];
+                    else
+                    {
+                        S_Res[Count] = 0.;
+                        (*DivZero)++;
+                    }
+                }
+                break;
+
+            case CCalc::HOCH:
+                for (Count = 0; Count < Num; Count++)
+                    S_Res[Count] = pow(Op_1[Count], Op_2[Count]);
+                break;
+
+            case CCalc::WURZEL:
+                for (Count = 0; Count < Num; Count++)
+                    S_Res[Count] = pow(Op_1[Count], 1 / Op_2[Count]);
+                break;
+            }
+            break;
+
+        case CCalc::VEK:
+            switch (Instr.Token)
+            {
+            case CCalc::NEG:
+                for (int x = 0; x < 3; x++)
+                    for (Count = 0; Count < Num; Count++)
+                        Res[x][Count] = (-1) * V_1[x][Count];
+                break;
+
+            case CCalc::VLEN:
+                for (Count = 0; Count < Num; Count++)
+                {
+                    float Len = 0;
+                    for (int x = 0; x < 3; x++)
+                        Len = Len + (V_1[x][Count] * V_1[x][Count]);
+                    S_Res[Count] = sqrt(Len);
+                }
+                break;
+
+            case CCalc::COMP_1:
+            case CCalc::COMP_2:
+            case CCalc::COMP_3:
+                for (Count = 0; Count < Num; Count++)
+                    S_Res[Count] = V_1[Instr.Token - CCalc::COMP_1][Count];
+                break;
+            }
+            break;
+
+        case CCalc::SKA:
+            switch (Instr.Token)
+            {
+            case CCalc::SIN:
+                for (Count = 0; Count < Num; Count++)
+                    S_Res[Count] = sin(Op_1[Count]);
+                break;
+
+            case CCalc::COS:
+                for (Count = 0; Count < Num; Count++)
+                    S_Res[Count] = cos(Op_1[Count]);
+                break;
+
+            case CCalc::TAN:
+                for (Count = 0; Count < Num; Count++)
+                    S_Res[Count] = tan(Op_1[Count]);
+                break;
+
+            case CCalc::ATAN:
+                for (Count = 0; Count < Num; Count++)
+                    S_Res[Count] = atan(Op_1[Count]);
+                break;
+
+            case CCalc::LOG:
+                for (Count = 0; Count < Num; Count++)
+                {
+                    if (Op_1[Count] >= 0)
+                        S_Res[Count] = log(Op_1[Count]);
+                    else
+                        Error = CALC_LOG_NEGATIVE;
+                }
+                break;
+
+            case CCalc::EXP:
+                for (Count = 0; Count < Num; Count++)
+                    S_Res[Count] = exp(Op_1[Count]);
+                break;
+
+            case CCalc::NEG:
+                for (Count = 0; Count < Num; Count++)
+                    S_Res[Count] = (-Op_1[Count]);
+                break;
+            }
+            break;
+        }
+    }
+    return Error;
+}
+
 MODULE_MAIN(Tools, Calc)
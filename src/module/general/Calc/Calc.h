@@ -31,6 +31,7 @@
 #include <api/coSimpleModule.h>
 using namespace covise;
 #include <util/coviseCompat.h>
+#include <vector>
 
 const unsigned MAXLEN = 80; // Max. Länge eines Ausdrucks
 const unsigned MAXITEM = 20; // Max. Länge eines Ausdrucks
@@ -124,6 +125,68 @@ private:
     virtual void copyAttributesToOutObj(coInputPort **, coOutputPort **, int);
 };
 
+//////////////////////////////////////////////////////////////////////////////
+//                                                                          //
+// Definition of Class CCalcProgram                                         //
+//                                                                          //
+// Postfix expression compiled into a flat list of operations on slots.     //
+// Every slot holds BLOCK_SIZE values (3 components for vectors), so each   //
+// operation is a simple loop over a block of array elements. Blocks are    //
+// evaluated in parallel.                                                   //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+class CCalcProgram
+{
+public:
+    enum
+    {
+        BLOCK_SIZE = 256
+    };
+
+    enum Sources
+    {
+        INPUT, // array from an input port
+        CONSTANT, // same value for all elements
+        TEMP // intermediate result
+    };
+
+    enum Errors
+    {
+        CALC_OK,
+        CALC_DIV_ZERO, // vector divided by 0
+        CALC_LOG_NEGATIVE
+    };
+
+    struct Slot
+    {
+        int Type; // VEKTOR or SKALAR
+        int Source; // INPUT, CONSTANT, TEMP
+        const float *Data[3]; // input arrays
+        float Value[3]; // constant value
+    };
+
+    struct Instruction
+    {
+        int Operation; // VEK_VEK, VEK_SKA, ...
+        int Token; // PLUS, MINUS, MAL, ...
+        int Dst, Op_1, Op_2; // slots
+    };
+
+    std::vector<Slot> Slots;
+    std::vector<Instruction> Code;
+    int Result; // slot holding the result
+
+    int AddSlot(int Type, int Source);
+
+    // evaluate for all elements, returns false on errors (already reported)
+    bool Run(Calc *module, int Array_Len, float *s_out,
+             float *u_out, float *v_out, float *w_out) const;
+
+private:
+    int RunBlock(float *const *Comp, int Num, int *DivZero) const;
+};
+
 //////////////////////////////////////////////////////////////////////////////
 //                                                                          //
 // Definition of Class CCalc                                                //
@@ -132,6 +195,8 @@ private:
 
 class CCalc
 {
+    friend class CCalcProgram;
+
 protected:
 private:
     //////////////////////////////////////////////////////////////////////////////
@@ -163,6 +228,7 @@ private:
     void Stack_Eval_Free();
 
     int InfixToPostfix(Calc *module);
+    bool Compile(Calc *module, CCalcProgram *Program);
 
     int GetResultType(Calc *module, int *Result_Type, int *TempVek);
     int Evaluate(Calc *module, int *Result_Type, float **Result_Vektor,
@@ -57,7 +57,6 @@ int CellToVert::compute(const char *)
     else
         algo_option = coCellToVert::SIMPLE;
 
-    coCellToVert fct;
     // here we go
     returnObject = fct.interpolate(grid_in->getCurrentObject(), data_in->getCurrentObject(), data_out->getObjName(), algo_option);
 
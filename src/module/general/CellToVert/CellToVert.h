@@ -30,6 +30,7 @@
 #include <api/coSimpleModule.h>
 using namespace covise;
 #include <util/coviseCompat.h>
+#include <alg/coCellToVert.h>
 
 class CellToVert;
 
@@ -41,6 +42,10 @@ private:
     coOutputPort *data_out;
     coChoiceParam *algorithm;
 
+    // kept between calls, so that the vertex-to-cell adjacency
+    // is reused for all time steps on a static grid
+    coCellToVert fct;
+
 public:
     CellToVert(int argc, char *argv[]);
 
@@ -28,6 +28,7 @@
 #include <do/coDoSet.h>
 #include <do/coDoData.h>
 #include <do/coDoIntArr.h>
+#include <alg/coColors.h>
 #include <do/coDoPixelImage.h>
 #include <do/coDoTexture.h>
 #include <api/coFeedback.h>
@@ -662,8 +663,6 @@ coDistributedObject *Colors::createColors(recObj &base, recObj &alpha, FlColor *
     {
         float *data = base.data; // where my data starts
         float *alphaData = alpha.data;
-        float delta = numSteps / (max - min); // cmap steps
-        int maxIdx = numSteps - 1;
 
         // packed RGBA data
         if (outStyle == RGBA)
@@ -671,31 +670,9 @@ coDistributedObject *Colors::createColors(recObj &base, recObj &alpha, FlColor *
             coDoRGBA *res = new coDoRGBA(name, base.numElem);
             int *dPtr;
             res->getAddress(&dPtr);
-            unsigned int *packed = (unsigned int *)dPtr;
-            unsigned char r, g, b, a;
-            for (i = 0; i < base.numElem; i++)
-            {
-                if (data[i] >= NoDataColorPercent * FLT_MAX)
-                {
-                    packed[i] = d_noDataColor;
-                }
-                else
-                {
-                    int idx = (int)((data[i] - min) * delta);
-                    if (idx < 0)
-                        idx = 0;
-                    if (idx > maxIdx)
-                        idx = maxIdx;
-                    r = (int)(actMap[idx][0] * 255);
-                    g = (int)(actMap[idx][1] * 255);
-                    b = (int)(actMap[idx][2] * 255);
-                    if (alphaData)
-                        a = (int)(alphaData[i] * 255);
-                    else
-                        a = (int)(actMap[idx][3] * 255);
-                    packed[i] = (r << 24) | (g << 16) | (b << 8) | a;
-                }
-            }
+            // min and max are fixed for the whole object: map through a lookup table
+            coColorLut lut(actMap, numSteps, min, max, (unsigned int)d_noDataColor);
+            lut.map(data, base.numElem, (unsigned int *)dPtr, alphaData);
             res->copyAllAttributes(base.obj);
             return res;
         }
@@ -30,6 +30,14 @@
 #include <do/coDoStructuredGrid.h>
 #include <do/coDoUniformGrid.h>
 #include <do/coDoRectilinearGrid.h>
+#include <config/CoviseConfig.h>
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 SDomainsurface::SDomainsurface(int argc, char *argv[])
     : coSimpleModule(argc, argv, "Domain surfaces of grids")
@@ -62,6 +70,9 @@ SDomainsurface::SDomainsurface(int argc, char *argv[])
     param_double = addBooleanParam("double", "check for duplicated vertices");
     param_double->setValue(true);
 
+    param_sorted = addBooleanParam("sorted_faces", "find the surface of unstructured grids by sorting face keys");
+    param_sorted->setValue(true);
+
     //    param_optimize = addChoiceParam("optimize", "optimize for memory or speed");
     //    char *choices[] = {(char *)"speed", (char *)"memory"};
     //    param_optimize->setValue(2, choices, Speed);
@@ -1114,17 +1125,30 @@ void SDomainsurface::doModule(const coDistributedObject *meshIn,
     {
         Covise::sendWarning("WARNING: Data object 'meshIn' is empty");
     }
-    //      If computation is for the first time or the grid has changed
-    //      create adjacency information
-    //	get cells_use_coord list from shared memory
-    int cuc_count;
-    int *cuc, *cuc_pos;
-    tmp_grid->getNeighborList(&cuc_count, &cuc, &cuc_pos);
     numelem_o = numelem;
     u_out = v_out = w_out = 0;
     lu_out = lv_out = lw_out = 0;
     // Surface polygons
-    surface();
+    if (coCoviseConfig::isOn("Module.DomainSurface.Benchmark", false))
+    {
+        // compare the neighbor search with the sorted face keys
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        surface();
+        std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+        int polygons = num_elem, corners = num_conn;
+        freeSurface();
+        std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+        bool sorted = surfaceSorted();
+        std::chrono::steady_clock::time_point t3 = std::chrono::steady_clock::now();
+        if (sorted)
+            Covise::sendInfo("%d elements: neighbor search %.3f s (%d polygons, %d corners), sorted faces %.3f s (%d polygons, %d corners)",
+                             numelem, std::chrono::duration<double>(t1 - t0).count(), polygons, corners,
+                             std::chrono::duration<double>(t3 - t2).count(), num_elem, num_conn);
+        else
+            surface();
+    }
+    else if (!param_sorted->getValue() || !surfaceSorted())
+        surface();
     Polygons = new coDoPolygons(meshOutName, num_vert, x_out, y_out, z_out,
                                 num_conn, conn_list, num_elem, elem_list);
     if (!meshIn->getAttribute("COLOR")) // sonst koennten wir COLOR
@@ -2051,7 +2075,6 @@ void SDomainsurface::surface()
     // int i, a, c;
 	int i, j, a;
 	size_t c;
-    int nb; // ne deleted
 
     bool start_vertex_set;
     bool vertices_found;
@@ -2088,6 +2111,12 @@ void SDomainsurface::surface()
 
     int ct_alloc;
 
+    //	get cells_use_coord list from shared memory,
+    //	it is freed after lines()
+    int cuc_count;
+    int *cuc, *cuc_pos;
+    tmp_grid->getNeighborList(&cuc_count, &cuc, &cuc_pos);
+
     ct_alloc = numcoord;
     conn_tag = new int[ct_alloc];
 
@@ -3190,6 +3219,397 @@ void SDomainsurface::surface()
             //  break; Everything is either specific or default...
         }
     }
+    surfaceOutput();
+    return;
+}
+
+//=====================================================================
+// surface extraction by sorted face keys
+//=====================================================================
+
+// faces of the standard cells with the same node order, visibility
+// test and orientation as the element-wise search in surface()
+struct CellFace
+{
+    int num; // 3 or 4 nodes
+    int key[4]; // nodes of the face
+    int test[4]; // visibility test: (0,1,2) or (0,3,2) for quads
+    int norm[3]; // orientation check
+    int ok[4]; // emitted if the orientation check succeeds
+    int flipped[4]; // emitted otherwise
+};
+
+static const CellFace hexFaces[] = {
+    { 4, { 0, 1, 5, 4 }, { 0, 1, 5, 4 }, { 0, 1, 5 }, { 1, 5, 4, 0 }, { 4, 5, 1, 0 } },
+    { 4, { 2, 3, 7, 6 }, { 2, 3, 7, 6 }, { 2, 3, 7 }, { 3, 7, 6, 2 }, { 6, 7, 3, 2 } },
+    { 4, { 4, 5, 6, 7 }, { 4, 5, 6, 7 }, { 4, 5, 6 }, { 5, 6, 7, 4 }, { 7, 6, 5, 4 } },
+    { 4, { 0, 4, 7, 3 }, { 0, 4, 7, 3 }, { 0, 4, 7 }, { 0, 4, 7, 3 }, { 3, 7, 4, 0 } },
+    { 4, { 1, 2, 6, 5 }, { 1, 2, 6, 5 }, { 1, 2, 6 }, { 1, 2, 6, 5 }, { 5, 6, 2, 1 } },
+    { 4, { 0, 3, 2, 1 }, { 0, 3, 2, 1 }, { 0, 3, 2 }, { 0, 3, 2, 1 }, { 1, 2, 3, 0 } }
+};
+
+static const CellFace tetraFaces[] = {
+    { 3, { 0, 2, 1 }, { 0, 2, 1 }, { 0, 2, 1 }, { 0, 1, 2 }, { 1, 2, 0 } },
+    { 3, { 0, 1, 3 }, { 0, 1, 3 }, { 0, 1, 3 }, { 0, 3, 1 }, { 3, 1, 0 } },
+    { 3, { 3, 1, 2 }, { 3, 1, 2 }, { 3, 1, 2 }, { 3, 2, 1 }, { 2, 1, 3 } },
+    { 3, { 0, 3, 2 }, { 0, 3, 2 }, { 0, 3, 2 }, { 0, 2, 3 }, { 2, 3, 0 } }
+};
+
+static const CellFace prismFaces[] = {
+    { 4, { 0, 2, 5, 3 }, { 0, 2, 5, 3 }, { 0, 2, 5 }, { 0, 2, 5, 3 }, { 3, 5, 2, 0 } },
+    { 3, { 5, 4, 3 }, { 5, 4, 3 }, { 5, 4, 3 }, { 5, 4, 3 }, { 3, 4, 5 } },
+    { 4, { 0, 3, 4, 1 }, { 0, 3, 4, 1 }, { 0, 3, 4 }, { 0, 3, 4, 1 }, { 1, 4, 3, 0 } },
+    { 3, { 0, 1, 2 }, { 0, 1, 2 }, { 0, 1, 2 }, { 0, 1, 2 }, { 2, 1, 0 } },
+    { 4, { 2, 5, 4, 1 }, { 2, 5, 4, 1 }, { 2, 5, 4 }, { 2, 1, 4, 5 }, { 1, 4, 5, 2 } }
+};
+
+static const CellFace pyramidFaces[] = {
+    { 3, { 0, 1, 4 }, { 0, 1, 4 }, { 0, 1, 4 }, { 0, 4, 1 }, { 4, 1, 0 } },
+    { 3, { 0, 4, 3 }, { 0, 4, 3 }, { 0, 4, 3 }, { 0, 3, 4 }, { 3, 4, 0 } },
+    { 3, { 2, 3, 4 }, { 4, 2, 3 }, { 2, 3, 4 }, { 2, 4, 3 }, { 4, 3, 2 } },
+    { 3, { 1, 2, 4 }, { 1, 2, 4 }, { 1, 2, 4 }, { 1, 4, 2 }, { 4, 2, 1 } },
+    { 4, { 0, 3, 2, 1 }, { 0, 3, 2, 1 }, { 0, 3, 2 }, { 0, 1, 2, 3 }, { 1, 2, 3, 0 } }
+};
+
+// 2D elements take part in the matching with their only face, they are not emitted
+static const CellFace quadFace = { 4, { 0, 1, 2, 3 }, { 0 }, { 0 }, { 0 }, { 0 } };
+static const CellFace triangleFace = { 3, { 0, 1, 2 }, { 0 }, { 0 }, { 0 }, { 0 } };
+
+static int cellFaces(int type, const CellFace *&faces)
+{
+    switch (type)
+    {
+    case TYPE_HEXAGON:
+        faces = hexFaces;
+        return 6;
+    case TYPE_TETRAHEDER:
+        faces = tetraFaces;
+        return 4;
+    case TYPE_PRISM:
+        faces = prismFaces;
+        return 5;
+    case TYPE_PYRAMID:
+        faces = pyramidFaces;
+        return 5;
+    case TYPE_QUAD:
+        faces = &quadFace;
+        return 1;
+    case TYPE_TRIANGLE:
+        faces = &triangleFace;
+        return 1;
+    }
+    return 0;
+}
+
+// a face is identified by its three smallest distinct nodes,
+// just as getNeighbor accepts three common nodes of a quad
+struct FaceKey
+{
+    int v[3];
+    int face;
+    bool sameFace(const FaceKey &o) const
+    {
+        return v[0] == o.v[0] && v[1] == o.v[1] && v[2] == o.v[2];
+    }
+    bool operator<(const FaceKey &o) const
+    {
+        if (v[1] != o.v[1])
+            return v[1] < o.v[1];
+        if (v[2] != o.v[2])
+            return v[2] < o.v[2];
+        return face < o.face;
+    }
+};
+
+// returns false for faces with less than three distinct nodes
+static bool faceKey(const int *cell, const CellFace &face, int v[3])
+{
+    int n[4];
+    for (int i = 0; i < face.num; i++)
+    {
+        int node = cell[face.key[i]];
+        int j = i;
+        while (j > 0 && n[j - 1] > node)
+        {
+            n[j] = n[j - 1];
+            j--;
+        }
+        n[j] = node;
+    }
+    int num = 1;
+    for (int i = 1; i < face.num; i++)
+    {
+        if (n[i] != n[num - 1])
+            n[num++] = n[i];
+    }
+    if (num < 3)
+        return false;
+    v[0] = n[0];
+    v[1] = n[1];
+    v[2] = n[2];
+    return true;
+}
+
+// For conforming grids without polyhedral cells, the result is the same
+// as that of surface(), but instead of a neighbor search for every face, the keys of all faces
+// are sorted and the faces whose key occurs only once form the surface.
+// The keys are distributed to a few buckets per thread by the range of
+// their smallest node, each bucket is then sorted by counting its
+// smallest nodes and by comparing the remaining nodes in the tiny groups
+// of faces sharing a node. Besides the 16 bytes per key there is no
+// memory depending on the mesh connectivity, and the result does not
+// depend on the number of threads.
+// Returns false if the grid contains polyhedral cells.
+bool SDomainsurface::surfaceSorted()
+{
+    const CellFace *faces;
+    int i;
+    for (i = 0; i < numelem; i++)
+    {
+        if (tl[i] == TYPE_POLYHEDRON)
+            return false;
+    }
+    if (numelem > INT_MAX / 6)
+        return false;
+
+    // faces of element i are numbered from faceStart[i]
+    vector<int> faceStart(numelem + 1);
+    faceStart[0] = 0;
+    for (i = 0; i < numelem; i++)
+        faceStart[i + 1] = faceStart[i] + cellFaces(tl[i], faces);
+    int numFaces = faceStart[numelem];
+
+    int numThreads = 1;
+#ifdef _OPENMP
+    numThreads = omp_get_max_threads();
+#endif
+    int bucketWidth = (numcoord + 4 * numThreads - 1) / (4 * numThreads);
+    if (bucketWidth < 1)
+        bucketWidth = 1;
+    int numBuckets = (numcoord + bucketWidth - 1) / bucketWidth;
+    if (numBuckets < 1)
+        numBuckets = 1;
+
+    // every thread handles a contiguous range of elements and writes
+    // its keys behind those of the preceding threads in each bucket
+    vector<int> count(numThreads * numBuckets, 0);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int t = 0; t < numThreads; t++)
+    {
+        int *myCount = &count[t * numBuckets];
+        int elemEnd = (int)((size_t)numelem * (t + 1) / numThreads);
+        for (int elem = (int)((size_t)numelem * t / numThreads); elem < elemEnd; elem++)
+        {
+            const CellFace *cellFace;
+            int nf = cellFaces(tl[elem], cellFace);
+            for (int f = 0; f < nf; f++)
+            {
+                int v[3];
+                if (faceKey(cl + el[elem], cellFace[f], v))
+                    myCount[v[0] / bucketWidth]++;
+            }
+        }
+    }
+    vector<int> bucketStart(numBuckets + 1);
+    int numKeys = 0;
+    for (int b = 0; b < numBuckets; b++)
+    {
+        bucketStart[b] = numKeys;
+        for (int t = 0; t < numThreads; t++)
+        {
+            int n = count[t * numBuckets + b];
+            count[t * numBuckets + b] = numKeys;
+            numKeys += n;
+        }
+    }
+    bucketStart[numBuckets] = numKeys;
+
+    vector<FaceKey> keys(numKeys);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int t = 0; t < numThreads; t++)
+    {
+        int *myPos = &count[t * numBuckets];
+        int elemEnd = (int)((size_t)numelem * (t + 1) / numThreads);
+        for (int elem = (int)((size_t)numelem * t / numThreads); elem < elemEnd; elem++)
+        {
+            const CellFace *cellFace;
+            int nf = cellFaces(tl[elem], cellFace);
+            for (int f = 0; f < nf; f++)
+            {
+                FaceKey key;
+                if (faceKey(cl + el[elem], cellFace[f], key.v))
+                {
+                    key.face = faceStart[elem] + f;
+                    keys[myPos[key.v[0] / bucketWidth]++] = key;
+                }
+            }
+        }
+    }
+
+    // faces whose key is unique, degenerated faces are never part of the surface
+    vector<unsigned char> boundary(numFaces, 0);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+    for (int b = 0; b < numBuckets; b++)
+    {
+        if (bucketStart[b + 1] == bucketStart[b])
+            continue;
+        int first = b * bucketWidth;
+        int width = std::min(bucketWidth, numcoord - first);
+        vector<int> nodeStart(width + 1, 0);
+        for (int k = bucketStart[b]; k < bucketStart[b + 1]; k++)
+            nodeStart[keys[k].v[0] - first + 1]++;
+        for (int n = 0; n < width; n++)
+            nodeStart[n + 1] += nodeStart[n];
+        vector<FaceKey> sorted(bucketStart[b + 1] - bucketStart[b]);
+        vector<int> pos(nodeStart.begin(), nodeStart.end() - 1);
+        for (int k = bucketStart[b]; k < bucketStart[b + 1]; k++)
+            sorted[pos[keys[k].v[0] - first]++] = keys[k];
+
+        for (int n = 0; n < width; n++)
+        {
+            FaceKey *begin = &sorted[0] + nodeStart[n];
+            FaceKey *end = &sorted[0] + nodeStart[n + 1];
+            std::sort(begin, end);
+            for (FaceKey *k = begin; k < end;)
+            {
+                FaceKey *same = k + 1;
+                while (same < end && same->sameFace(*k))
+                    same++;
+                if (same == k + 1)
+                    boundary[k->face] = 1;
+                k = same;
+            }
+        }
+    }
+    keys.clear();
+
+    // collect the polygons in element order like surface()
+    conn_tag = new int[numcoord];
+    memset(conn_tag, -1, numcoord * sizeof(int));
+    num_vert = 0;
+    num_conn = 0;
+    num_elem = 0;
+    num_bar = 0;
+    int firstError = 1;
+    for (i = 0; i < numelem; i++)
+    {
+        const int *cell = cl + el[i];
+        int nf = cellFaces(tl[i], faces);
+        if (tl[i] == TYPE_QUAD || tl[i] == TYPE_TRIANGLE)
+        {
+            if (test(cell[0], cell[1], cell[2]))
+            {
+                if (DataType == DATA_S_E)
+                {
+                    temp_u_out.push_back(u_in[i]);
+                }
+                else if (DataType == DATA_V_E)
+                {
+                    temp_u_out.push_back(u_in[i]);
+                    temp_v_out.push_back(v_in[i]);
+                    temp_w_out.push_back(w_in[i]);
+                }
+                temp_elem_list.push_back(num_conn);
+                num_elem++;
+                for (int n = 0; n < faces[0].num; n++)
+                {
+                    temp_conn_list.push_back(add_vertex(cell[n]));
+                    num_conn++;
+                }
+            }
+        }
+        else if (nf > 0)
+        {
+            int c = UnstructuredGrid_Num_Nodes[tl[i]];
+            x_center = 0;
+            y_center = 0;
+            z_center = 0;
+            for (int a = 0; a < c; a++)
+            {
+                x_center += x_in[cell[a]];
+                y_center += y_in[cell[a]];
+                z_center += z_in[cell[a]];
+            }
+            x_center /= (float)c;
+            y_center /= (float)c;
+            z_center /= (float)c;
+
+            for (int f = 0; f < nf; f++)
+            {
+                if (!boundary[faceStart[i] + f])
+                    continue;
+                const CellFace &face = faces[f];
+                const int *t = face.test;
+                if (!test(cell[t[0]], cell[t[1]], cell[t[2]])
+                    && (face.num == 3 || !test(cell[t[0]], cell[t[3]], cell[t[2]])))
+                    continue;
+
+                if (DataType == DATA_S_E)
+                {
+                    temp_u_out.push_back(u_in[i]);
+                }
+                else if (DataType == DATA_V_E)
+                {
+                    temp_u_out.push_back(u_in[i]);
+                    temp_v_out.push_back(v_in[i]);
+                    temp_w_out.push_back(w_in[i]);
+                }
+                temp_elem_list.push_back(num_conn);
+                num_elem++;
+                const int *order = norm_check(cell[face.norm[0]], cell[face.norm[1]], cell[face.norm[2]])
+                                       ? face.ok
+                                       : face.flipped;
+                for (int n = 0; n < face.num; n++)
+                {
+                    temp_conn_list.push_back(add_vertex(cell[order[n]]));
+                    num_conn++;
+                }
+            }
+        }
+        else if (tl[i] == TYPE_BAR)
+        {
+            num_bar++;
+        }
+        else if (tl[i] != TYPE_POINT)
+        {
+            if (firstError)
+                Covise::sendError("ERROR: unsupported grid type detected");
+            firstError = 0;
+        }
+    }
+
+    surfaceOutput();
+    return true;
+}
+
+// releases what surface() or surfaceSorted() allocated
+void SDomainsurface::freeSurface()
+{
+    delete[] x_out;
+    delete[] y_out;
+    delete[] z_out;
+    delete[] u_out;
+    delete[] v_out;
+    delete[] w_out;
+    delete[] conn_list;
+    delete[] conn_tag;
+    delete[] elem_list;
+    delete[] elemMap;
+    x_out = y_out = z_out = u_out = v_out = w_out = NULL;
+    conn_list = conn_tag = elem_list = elemMap = NULL;
+}
+
+// copies the polygons collected by surface() or surfaceSorted()
+// into the output arrays and lists the bar elements for lines()
+void SDomainsurface::surfaceOutput()
+{
+    int i, nb;
     elemMap = new int[num_bar];
     nb = 0;
     for (i = 0; i < numelem; i++)
@@ -3267,9 +3687,6 @@ void SDomainsurface::surface()
         }
     }
 
-    temp_elem_in.clear();
-    temp_conn_in.clear();
-    temp_vertex_list.clear();
     temp_conn_list.clear();
     temp_elem_list.clear();
     temp_x_out.clear();
@@ -3279,7 +3696,6 @@ void SDomainsurface::surface()
     temp_v_out.clear();
     temp_w_out.clear();
 
-    return;
 }
 
 int SDomainsurface::add_vertex(int v)
@@ -33,6 +33,7 @@ private:
     coFloatVectorParam *param_vertex;
     coFloatParam *param_scalar;
     coBooleanParam *param_double;
+    coBooleanParam *param_sorted;
     //       coChoiceParam *param_optimize;
 
     //       enum OptimizeParam
@@ -119,6 +120,9 @@ private:
                   coDistributedObject **ldataOut);
 
     void surface();
+    bool surfaceSorted();
+    void surfaceOutput();
+    void freeSurface();
     void lines();
     int test(int, int, int);
     int add_vertex(int v);
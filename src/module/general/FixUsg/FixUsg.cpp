@@ -9,6 +9,7 @@
 #include <api/coFeedback.h>
 #include <util/coviseCompat.h>
 #include <alg/coFixUsg.h>
+#include <util/coWristWatch.h>
 
 FixUSG::FixUSG(int argc, char *argv[])
     : coSimpleModule(argc, argv, "Filter for unnecessary coordinates")
@@ -35,8 +36,8 @@ FixUSG::FixUSG(int argc, char *argv[])
     paramDelta->setValue(0.0);
 
     paramAlgorithm = addChoiceParam("algorithm", "choose your favorite algorithm");
-    const char *alg_choice[] = { "BoundingBox", "None" };
-    paramAlgorithm->setValue(2, alg_choice, 0);
+    const char *alg_choice[] = { "BoundingBox", "None", "SpatialHash" };
+    paramAlgorithm->setValue(3, alg_choice, 0);
 
     paramOptimize = addChoiceParam("optimize", "should we care 'bout RAM or not");
     const char *opt_choice[] = { "speed", "memory" };
@@ -65,7 +66,8 @@ int FixUSG::compute(const char *)
 {
 
     coFixUsg fct(paramMaxvertices->getValue(), paramDelta->getValue(),
-                 paramOptimize->getValue() != 0 /* false means optimize for speed */);
+                 paramOptimize->getValue() != 0 /* false means optimize for speed */,
+                 paramAlgorithm->getValue() == 2 ? coFixUsg::SPATIAL_HASH : coFixUsg::BOUNDING_BOX);
 
     const coDistributedObject **in_data = new const coDistributedObject *[num_ports];
     const char **outNames = new const char *[num_ports];
@@ -88,6 +90,7 @@ int FixUSG::compute(const char *)
     coDistributedObject *geo_out;
     bool fail = false;
     int num_red;
+    coWristWatch ww;
     if ((num_red = fct.fixUsg(inMeshPort->getCurrentObject(), &geo_out, outGridName, num_used, in_data, returnObject, outNames)) != coFixUsg::FIX_ERROR)
     {
         for (i = 0; i < num_used; i++)
@@ -95,7 +98,7 @@ int FixUSG::compute(const char *)
             ptrDataOutPort[tgt2src[i]]->setCurrentObject(returnObject[i]);
         }
         outMeshPort->setCurrentObject(geo_out);
-        Covise::sendInfo("removed %d points", num_red);
+        Covise::sendInfo("removed %d points in %.3f s", num_red, ww.elapsed());
     }
     else
     {
@@ -9,6 +9,7 @@
 #include <do/coDoOctTree.h>
 #include <do/coDoOctTreeP.h>
 #include <do/coDoUnstructuredGrid.h>
+#include <util/coWristWatch.h>
 
 MakeOctTree::MakeOctTree(int argc, char *argv[])
     : coSimpleModule(argc, argv, "Create Octrees for UNSGRDs")
@@ -85,6 +86,7 @@ MakeOctTree::compute(const char *)
         float *x_l, *y_l, *z_l;
         unsgrd->getAddresses(&e_l, &c_l, &x_l, &y_l, &z_l);
 
+        coWristWatch ww;
         coDoOctTree *tree = new coDoOctTree(p_octtrees_->getObjName(),
                                             nume, numc, nump, e_l, c_l,
                                             x_l, y_l, z_l
@@ -97,6 +99,7 @@ MakeOctTree::compute(const char *)
                p_limit_fY_->getValue(),
                   p_limit_fZ_->getValue()*/
                                             );
+        reportTree(tree, ww.elapsed());
         p_octtrees_->setCurrentObject(tree);
     }
     else if (grid->isType("POLYGN"))
@@ -110,6 +113,7 @@ MakeOctTree::compute(const char *)
         float *x_l, *y_l, *z_l;
         polgrd->getAddresses(&x_l, &y_l, &z_l, &c_l, &e_l);
 
+        coWristWatch ww;
         coDoOctTreeP *tree = new coDoOctTreeP(p_octtrees_->getObjName(),
                                               nume, numc, nump, e_l, c_l,
                                               x_l, y_l, z_l,
@@ -120,6 +124,7 @@ MakeOctTree::compute(const char *)
                                               p_limit_fX_->getValue(),
                                               p_limit_fY_->getValue(),
                                               p_limit_fZ_->getValue());
+        reportTree(tree, ww.elapsed());
 
         p_octtrees_->setCurrentObject(tree);
     }
@@ -131,4 +136,16 @@ MakeOctTree::compute(const char *)
     return SUCCESS;
 }
 
+void
+MakeOctTree::reportTree(const coDoBasisTree *tree, float seconds)
+{
+    int numTrees, numNodes, numLeaves, maxDepth, maxPopulation;
+    float meanPopulation;
+    tree->getStatistics(&numTrees, &numNodes, &numLeaves, &maxDepth,
+                        &maxPopulation, &meanPopulation);
+    sendInfo("%s: built in %.3f s, %d trees, %d macrocells, %d leaves, depth %d, cells per leaf: mean %.1f, max %d",
+             tree->getName(), seconds, numTrees, numNodes, numLeaves, maxDepth,
+             meanPopulation, maxPopulation);
+}
+
 MODULE_MAIN(Tools, MakeOctTree)
@@ -23,6 +23,11 @@
 #include <api/coSimpleModule.h>
 using namespace covise;
 
+namespace covise
+{
+class coDoBasisTree;
+}
+
 class MakeOctTree : public coSimpleModule
 {
 public:
@@ -33,6 +38,9 @@ protected:
     virtual int compute(const char *port);
 
 private:
+    // send build time and tree statistics to the map editor
+    void reportTree(const coDoBasisTree *tree, float seconds);
+
     coInputPort *p_grids_;
     coOutputPort *p_octtrees_;
     coIntScalarParam *p_normal_size_;
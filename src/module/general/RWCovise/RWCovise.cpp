@@ -26,6 +26,8 @@
  **     working with datatype coDoTexture                                   **
 \**************************************************************************/
 #include <config/CoviseConfig.h>
+#include <api/coFeedback.h>
+#include <do/coDoSet.h>
 #include "RWCovise.h"
 
 RWCovise::RWCovise(int argc, char *argv[])
@@ -77,6 +79,25 @@ RWCovise::RWCovise(int argc, char *argv[])
     _p_increment_suffix = addBooleanParam("increment_filename", "use this to add a suffix to the filename which is incremented every time the module is executed");
     _p_increment_suffix->setValue(0);
 
+    // format 2 is indexed and compressed, single timesteps can be read without scanning the file
+    const char *formats[] = { "COVISE_1", "COVISE_2_indexed" };
+    _p_format = addChoiceParam("file_format", "Format of written files");
+    _p_format->setValue(2, formats, coCoviseConfig::getInt("Module.RWCovise.FileFormat", 1) >= 2 ? 1 : 0);
+
+    // timesteps of format 2 files outside of the resident window are read when
+    // the OpenCOVER plugin RWCovise moves the window along with the animation
+    _p_lazy = addBooleanParam("lazy_timesteps", "Only read a window of timesteps, the renderer requests the others");
+    _p_lazy->setValue(coCoviseConfig::isOn("Module.RWCovise.LazyTimesteps", false));
+
+    _p_window = addInt32Param("resident_window", "Number of timesteps kept in memory");
+    _p_window->setValue(coCoviseConfig::getInt("Module.RWCovise.ResidentWindow", 10));
+
+    _p_prefetch = addInt32Param("prefetch", "Number of remaining timesteps when the next window is requested");
+    _p_prefetch->setValue(coCoviseConfig::getInt("Module.RWCovise.Prefetch", 2));
+
+    _p_windowStart = addInt32Param("window_start", "First timestep of the resident window");
+    _p_windowStart->setValue(0);
+
     suffix_number = 0;
 }
 
@@ -142,6 +163,7 @@ int RWCovise::compute(const char *)
     if (p_mesh_in->getCurrentObject() != NULL)
     {
         _trueOpen = true;
+        setFileFormat(_p_format->getValue() + 1, coCoviseConfig::getInt("Module.RWCovise.CompressionLevel", 1));
         if (_p_increment_suffix->getValue())
         {
             const char *suffix = strrchr(grid_Path.c_str(), '.');
@@ -172,6 +194,9 @@ int RWCovise::compute(const char *)
     }
     else
     {
+        // indexed files are not kept open, every step is read directly
+        const bool indexed = isIndexedFile(grid_Path.c_str());
+
         if (_p_step->getValue() < 0)
         {
             _p_step->setValue(0);
@@ -183,6 +208,14 @@ int RWCovise::compute(const char *)
             _trueOpen = true;
         }
 
+        else if (_p_step->getValue() > 0 && indexed)
+        {
+            _number_of_elements = getNumElements(grid_Path.c_str());
+            if (_p_step->getValue() > _number_of_elements)
+            {
+                _p_step->setValue(_number_of_elements);
+            }
+        }
         else if (_p_step->getValue() > 0 && _trueOpen)
         {
             // check if we have to do with a set or not
@@ -222,9 +255,32 @@ int RWCovise::compute(const char *)
             _trueOpen = true;
         }
 
-        coDistributedObject *obj = ReadFile(grid_Path.c_str(), p_mesh->getObjName(), _p_force->getValue(), _p_firstStep->getValue(), _p_numSteps->getValue(), _p_skipStep->getValue());
+        coDistributedObject *obj = NULL;
+        if (indexed && _p_step->getValue() > 0 && _number_of_elements > 0)
+            obj = ReadElement(grid_Path.c_str(), p_mesh->getObjName(), _p_step->getValue() - 1, _p_force->getValue());
+        else if (indexed && _p_lazy->getValue() && _p_step->getValue() == 0)
+        {
+            if (_p_window->getValue() < 1)
+                _p_window->setValue(1);
+            if (_p_windowStart->getValue() < 0)
+                _p_windowStart->setValue(0);
+            obj = ReadWindow(grid_Path.c_str(), p_mesh->getObjName(), _p_windowStart->getValue(), _p_window->getValue(), _p_force->getValue());
+            if (obj && strcmp(obj->getType(), "SETELE") == 0)
+            {
+                char numSteps[32];
+                sprintf(numSteps, "%d", ((coDoSet *)obj)->getNumElements());
+                coFeedback feedback("RWCovise");
+                feedback.addPara(_p_windowStart);
+                feedback.addPara(_p_window);
+                feedback.addPara(_p_prefetch);
+                feedback.addString(numSteps);
+                feedback.apply(obj);
+            }
+        }
+        else
+            obj = ReadFile(grid_Path.c_str(), p_mesh->getObjName(), _p_force->getValue(), _p_firstStep->getValue(), _p_numSteps->getValue(), _p_skipStep->getValue());
 
-        if (_p_step->getValue() > 0 && _number_of_elements > 0)
+        if (_p_step->getValue() > 0 && _number_of_elements > 0 && obj)
         {
             // add in this case pertinent attributes for pipelinecollect
             string module_id("!"); // just for compatibility
@@ -252,7 +308,8 @@ int RWCovise::compute(const char *)
                 }
                 // if this is the last step for pipelinecollect reset _trueOpen and close
                 _trueOpen = true;
-                this->covCloseInFile(_fd);
+                if (!indexed)
+                    this->covCloseInFile(_fd);
             }
         }
 
@@ -52,6 +52,11 @@ private:
     coBooleanParam *_p_force;
     coChoiceParam *_p_RotAxis;
     coBooleanParam *_p_increment_suffix;
+    coChoiceParam *_p_format;
+    coBooleanParam *_p_lazy;
+    coIntScalarParam *_p_window;
+    coIntScalarParam *_p_prefetch;
+    coIntScalarParam *_p_windowStart;
 
     char *s_RotAxis[3];
     coFloatParam *_p_rot_speed;
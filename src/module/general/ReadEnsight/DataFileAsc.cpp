@@ -95,16 +95,12 @@ DataFileAsc::read(dimType dim, coDistributedObject **outObjects, const string &b
     int entries(0), numGot(0);
     float val[6];
 
-    while (!feof(in_))
+    EnAsciiCursor cur(asciiCursor());
+    while (!cur.atEnd())
     {
-        if (!fgets(buf, lineLen, in_))
-        {
-            cerr << "DataFileAsc: premature EOF 2" << endl;
-            break;
-        }
         ++lineCnt_;
-
-        entries = sscanf(buf, "%e%e%e%e%e%e", &val[0], &val[1], &val[2], &val[3], &val[4], &val[5]);
+        // Ensight 6 writes up to 6 values of 12 figures per line
+        entries = cur.getFloats(val, 6);
 
         // TBD: insert error handler
         int i;
@@ -259,15 +255,16 @@ DataFileAsc::readCells(dimType dim, coDistributedObject **outObjects, const stri
                     // 		    cerr << "DataFileAsc::readCells(..) read "
                     // 			 << elementType
                     // 			 << " number of values " << valuesToRead << endl;
+                    EnAsciiCursor cur(asciiCursor());
                     while (valuesToRead > 0)
                     {
-                        if (!fgets(buf, lineLen, in_))
+                        if (cur.atEnd())
                         {
                             cerr << "DataFileAsc: premature EOF 5" << endl;
                             break;
                         }
                         ++lineCnt_;
-                        entries = sscanf(buf, "%e%e%e%e%e%e", &val[0], &val[1], &val[2], &val[3], &val[4], &val[5]);
+                        entries = cur.getFloats(val, 6);
 
                         valuesToRead -= entries;
                         if (actPart->isActive())
@@ -313,6 +310,7 @@ DataFileAsc::readCells(dimType dim, coDistributedObject **outObjects, const stri
                         } // isActive
 
                     } // while
+                    syncFile(cur);
                 } // if ( numberOfElements > 0 )
             } //if ( elem.valid() )
         }
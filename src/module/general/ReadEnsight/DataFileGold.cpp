@@ -66,7 +66,6 @@ DataFileGold::readCells(dimType dim, coDistributedObject **outObjects, const str
         // 1 lines decription - ignore it
         fgets(buf, lineLen, in_);
         ++lineCnt_;
-        int entries(0);
         float val;
         size_t id(0);
         int actPartNr;
@@ -186,6 +185,7 @@ DataFileGold::readCells(dimType dim, coDistributedObject **outObjects, const str
                             cerr << "DataFileGold::readCells( ) blacklist size problem " << bl.size() << endl;
                         }
 
+                        EnAsciiCursor cur(asciiCursor());
                         int i;
                         switch (dim_)
                         {
@@ -195,9 +195,8 @@ DataFileGold::readCells(dimType dim, coDistributedObject **outObjects, const str
                             {
                                 for (i = 0; i < anzEle; ++i)
                                 {
-                                    fgets(buf, lineLen, in_);
                                     ++lineCnt_;
-                                    entries = sscanf(buf, "%e", &val);
+                                    cur.getFloat(val);
                                     if (bl[i] > 0)
                                     {
                                         actPart->d2dx_[eleCnt2d] = val;
@@ -209,9 +208,8 @@ DataFileGold::readCells(dimType dim, coDistributedObject **outObjects, const str
                             {
                                 for (i = 0; i < anzEle; ++i)
                                 {
-                                    fgets(buf, lineLen, in_);
                                     ++lineCnt_;
-                                    entries = sscanf(buf, "%e", &val);
+                                    cur.getFloat(val);
                                     if (bl[i] > 0)
                                     {
                                         actPart->d3dx_[eleCnt3d] = val;
@@ -227,9 +225,8 @@ DataFileGold::readCells(dimType dim, coDistributedObject **outObjects, const str
                                 tArr[j] = new float[anzEle];
                                 for (i = 0; i < anzEle; ++i)
                                 {
-                                    fgets(buf, lineLen, in_);
                                     ++lineCnt_;
-                                    entries = sscanf(buf, "%e", &(tArr[j][i]));
+                                    cur.getFloat(tArr[j][i]);
                                 }
                             }
                             if (thisEle.getDim() == EnElement::D2)
@@ -265,6 +262,7 @@ DataFileGold::readCells(dimType dim, coDistributedObject **outObjects, const str
                             delete[] tArr;
                             break;
                         }
+                        syncFile(cur);
                     } // if( elem.valid()
 
                 } // if ( actPart->isActive()
@@ -322,9 +320,7 @@ DataFileGold::read(dimType dim, coDistributedObject **outObjects, const string &
         fgets(buf, lineLen, in_);
         ++lineCnt_;
 
-        int entries(0);
         float val;
-        int numGot(0);
         size_t id(0);
         int actPartNr;
         uint64_t numVal = 0;
@@ -349,7 +345,6 @@ DataFileGold::read(dimType dim, coDistributedObject **outObjects, const string &
                 actPartNr = atoi(buf);
                 //cerr << "DataFileGold::read( ) part " <<  actPartNr << endl;
                 actPart = findPart(actPartNr);
-                numGot = 0;
 
                 // allocate memory for whole parts
                 if (actPart != NULL)
@@ -392,66 +387,29 @@ DataFileGold::read(dimType dim, coDistributedObject **outObjects, const string &
             id = tmp.find("coordinates");
             if (id != string::npos)
             {
+                EnAsciiCursor cur(asciiCursor());
                 int i(0);
                 if ((actPart != NULL) && (actPart->isActive()))
                 {
-                    numGot = 0;
-                    switch (dim_)
+                    float *arr[3] = { arr1, arr2, arr3 };
+                    for (int j = 0; j < dim_; ++j)
                     {
-                    case 1:
                         for (i = 0; i < numVal; ++i)
                         {
                             // we have data
-                            fgets(buf, lineLen, in_);
-                            ++lineCnt_;
-                            entries = sscanf(buf, "%e", &val);
-                            arr1[numGot] = val;
-                            numGot++;
-                        }
-                        break;
-                    case 3:
-                        for (i = 0; i < numVal; ++i)
-                        {
-                            // we have data
-                            fgets(buf, lineLen, in_);
                             ++lineCnt_;
-                            entries = sscanf(buf, "%e", &val);
-                            arr1[numGot] = val;
-                            numGot++;
+                            cur.getFloat(val);
+                            arr[j][i] = val;
                         }
-                        numGot = 0;
-                        for (i = 0; i < numVal; ++i)
-                        {
-                            // we have data
-                            fgets(buf, lineLen, in_);
-                            ++lineCnt_;
-                            entries = sscanf(buf, "%e", &val);
-                            arr2[numGot] = val;
-                            numGot++;
-                        }
-                        numGot = 0;
-                        numGot = 0;
-                        for (i = 0; i < numVal; ++i)
-                        {
-                            // we have data
-                            fgets(buf, lineLen, in_);
-                            ++lineCnt_;
-                            entries = sscanf(buf, "%e", &val);
-                            arr3[numGot] = val;
-                            numGot++;
-                        }
-                        break;
                     }
                 }
                 else
                 {
                     numVal *= dim_;
-                    for (i = 0; i < numVal; ++i)
-                    {
-                        fgets(buf, lineLen, in_);
-                        ++lineCnt_;
-                    }
+                    cur.skipLines(numVal);
+                    lineCnt_ += numVal;
                 }
+                syncFile(cur);
             }
         }
     }
@@ -0,0 +1,374 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+// +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ++ Description:                                                        ++
+// ++             Implementation of class EnMappedFile                    ++
+// ++                                     EnAsciiCursor                   ++
+// ++                                                                     ++
+// +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include "EnAsciiReader.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace
+{
+
+inline bool isBlank(const char &c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline bool isDigit(const char &c)
+{
+    return c >= '0' && c <= '9';
+}
+
+// exactly representable powers of ten
+const double powersOf10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// everything the fast path does not handle (nan, inf, many digits, huge exponents)
+bool parseFloatSlow(const char *&p, const char *end, float &val)
+{
+    char buf[64];
+    int len(0);
+    while (p + len < end && len < 63 && !isBlank(p[len]) && p[len] != '\n')
+    {
+        buf[len] = p[len];
+        ++len;
+    }
+    buf[len] = '\0';
+    char *stop(NULL);
+    double d = strtod(buf, &stop);
+    if (stop == buf)
+        return false;
+    val = (float)d;
+    p += stop - buf;
+    return true;
+}
+}
+
+//
+// Constructor
+//
+EnMappedFile::EnMappedFile()
+    : data_(NULL)
+    , size_(0)
+    , isCopy_(false)
+#ifdef _WIN32
+    , mapping_(NULL)
+#endif
+{
+}
+
+EnMappedFile::~EnMappedFile()
+{
+    unmap();
+}
+
+bool
+EnMappedFile::map(FILE *in)
+{
+    unmap();
+    if (in == NULL)
+        return false;
+
+#ifdef _WIN32
+    HANDLE file = (HANDLE)_get_osfhandle(_fileno(in));
+    LARGE_INTEGER size;
+    if (file != INVALID_HANDLE_VALUE && GetFileSizeEx(file, &size) && size.QuadPart > 0)
+    {
+        mapping_ = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping_ != NULL)
+        {
+            data_ = (char *)MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0);
+            if (data_ == NULL)
+            {
+                CloseHandle(mapping_);
+                mapping_ = NULL;
+            }
+            else
+                size_ = size.QuadPart;
+        }
+    }
+#else
+    struct stat st;
+    if (fstat(fileno(in), &st) == 0 && st.st_size > 0)
+    {
+        void *addr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fileno(in), 0);
+        if (addr != MAP_FAILED)
+        {
+            madvise(addr, st.st_size, MADV_SEQUENTIAL);
+            data_ = (char *)addr;
+            size_ = st.st_size;
+        }
+    }
+#endif
+    if (data_ != NULL)
+        return true;
+
+    // no mapping possible - read the whole file
+#ifdef _WIN32
+    __int64 pos = _ftelli64(in);
+    _fseeki64(in, 0, SEEK_END);
+    __int64 size = _ftelli64(in);
+    _fseeki64(in, 0, SEEK_SET);
+#else
+    long pos = ftell(in);
+    fseek(in, 0, SEEK_END);
+    long size = ftell(in);
+    fseek(in, 0, SEEK_SET);
+#endif
+    if (size > 0)
+    {
+        data_ = new char[size];
+        size_ = fread(data_, 1, size, in);
+        isCopy_ = true;
+    }
+#ifdef _WIN32
+    _fseeki64(in, pos, SEEK_SET);
+#else
+    fseek(in, pos, SEEK_SET);
+#endif
+    return data_ != NULL;
+}
+
+void
+EnMappedFile::unmap()
+{
+    if (data_ == NULL)
+        return;
+
+    if (isCopy_)
+        delete[] data_;
+    else
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(data_);
+        CloseHandle(mapping_);
+        mapping_ = NULL;
+#else
+        munmap(data_, size_);
+#endif
+    }
+    data_ = NULL;
+    size_ = 0;
+    isCopy_ = false;
+}
+
+//
+// Constructor
+//
+EnAsciiCursor::EnAsciiCursor(const char *begin, const char *end)
+    : pos_(begin)
+    , end_(end)
+{
+}
+
+void
+EnAsciiCursor::getLine(const char *&lineBegin, const char *&lineEnd)
+{
+    lineBegin = pos_;
+    if (pos_ >= end_)
+    {
+        lineEnd = pos_;
+        return;
+    }
+    const char *nl = (const char *)memchr(pos_, '\n', end_ - pos_);
+    if (nl == NULL)
+    {
+        lineEnd = end_;
+        pos_ = end_;
+    }
+    else
+    {
+        lineEnd = nl;
+        pos_ = nl + 1;
+    }
+}
+
+string
+EnAsciiCursor::getLine()
+{
+    const char *lb, *le;
+    getLine(lb, le);
+    return string(lb, le);
+}
+
+void
+EnAsciiCursor::skipLines(uint64_t n)
+{
+    while (n > 0 && pos_ < end_)
+    {
+        const char *nl = (const char *)memchr(pos_, '\n', end_ - pos_);
+        pos_ = (nl == NULL) ? end_ : nl + 1;
+        --n;
+    }
+}
+
+int
+EnAsciiCursor::getInt()
+{
+    const char *lb, *le;
+    getLine(lb, le);
+    int val(0);
+    if (!parseInt(lb, le, INT_MAX, val))
+        return 0;
+    return val;
+}
+
+int
+EnAsciiCursor::getFloats(float *val, const int &maxVals)
+{
+    const char *lb, *le;
+    getLine(lb, le);
+    int cnt(0);
+    while (cnt < maxVals && parseFloat(lb, le, val[cnt]))
+        ++cnt;
+    return cnt;
+}
+
+bool
+EnAsciiCursor::getFloat(float &val)
+{
+    return getFloats(&val, 1) == 1;
+}
+
+int
+EnAsciiCursor::getInts(const int &width, int *arr, const int &num)
+{
+    const char *lb, *le;
+    getLine(lb, le);
+    int cnt(0);
+    while (cnt < num && parseInt(lb, le, width, arr[cnt]))
+        ++cnt;
+    return cnt;
+}
+
+bool
+EnAsciiCursor::parseFloat(const char *&p, const char *end, float &val)
+{
+    const char *s(p);
+    while (s < end && isBlank(*s))
+        ++s;
+    const char *start(s);
+
+    bool neg(false);
+    if (s < end && (*s == '-' || *s == '+'))
+    {
+        neg = (*s == '-');
+        ++s;
+    }
+
+    // collect up to 15 significant digits, an uint64_t and a double hold them exactly
+    uint64_t mant(0);
+    int numDigits(0), exp10(0);
+    bool haveDigits(false);
+    for (; s < end && isDigit(*s); ++s)
+    {
+        haveDigits = true;
+        if (numDigits < 15)
+        {
+            mant = 10 * mant + (*s - '0');
+            if (mant != 0)
+                ++numDigits;
+        }
+        else
+            ++exp10;
+    }
+    if (s < end && *s == '.')
+    {
+        for (++s; s < end && isDigit(*s); ++s)
+        {
+            haveDigits = true;
+            if (numDigits < 15)
+            {
+                mant = 10 * mant + (*s - '0');
+                if (mant != 0)
+                    ++numDigits;
+                --exp10;
+            }
+        }
+    }
+    if (!haveDigits)
+    {
+        p = start;
+        return parseFloatSlow(p, end, val);
+    }
+
+    if (s < end && (*s == 'e' || *s == 'E'))
+    {
+        const char *e(s + 1);
+        bool negExp(false);
+        if (e < end && (*e == '-' || *e == '+'))
+        {
+            negExp = (*e == '-');
+            ++e;
+        }
+        if (e < end && isDigit(*e))
+        {
+            int ex(0);
+            for (; e < end && isDigit(*e); ++e)
+            {
+                if (ex < 10000)
+                    ex = 10 * ex + (*e - '0');
+            }
+            exp10 += negExp ? -ex : ex;
+            s = e;
+        }
+    }
+
+    if (exp10 < -22 || exp10 > 22)
+    {
+        p = start;
+        return parseFloatSlow(p, end, val);
+    }
+
+    double d = (double)mant;
+    if (exp10 < 0)
+        d /= powersOf10[-exp10];
+    else
+        d *= powersOf10[exp10];
+    val = (float)(neg ? -d : d);
+    p = s;
+    return true;
+}
+
+bool
+EnAsciiCursor::parseInt(const char *&p, const char *end, const int &width, int &val)
+{
+    const char *fieldBegin(p);
+    const char *s(p);
+    while (s < end && isBlank(*s))
+        ++s;
+
+    bool neg(false);
+    if (s < end && (*s == '-' || *s == '+'))
+    {
+        neg = (*s == '-');
+        ++s;
+    }
+    if (s >= end || !isDigit(*s))
+        return false;
+
+    int v(0);
+    for (; s < end && isDigit(*s) && s - fieldBegin < width; ++s)
+        v = 10 * v + (*s - '0');
+    val = neg ? -v : v;
+    p = s;
+    return true;
+}
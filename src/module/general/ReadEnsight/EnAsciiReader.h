@@ -0,0 +1,119 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+//-*-Mode: C++;-*-
+// +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// CLASS  EnMappedFile
+// CLASS  EnAsciiCursor
+//
+// Description: fast access to ASCII Ensight files
+//              The file is memory mapped and parsed in place with a hand
+//              written number parser instead of fgets/sscanf line by line.
+//              Ensight writes floats in fields of 12 characters (%12.5e)
+//              and integers in fields of 8 (Ensight 6) or 10 (Gold)
+//              characters which need not be separated by blanks.
+//
+// +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#ifndef ENASCIIREADER_H
+#define ENASCIIREADER_H
+
+#include <util/coviseCompat.h>
+
+//
+// read only view of a whole file, mapped or (if that fails) read to memory
+//
+class EnMappedFile
+{
+public:
+    EnMappedFile();
+
+    ~EnMappedFile();
+
+    // map the file opened as in
+    bool map(FILE *in);
+
+    void unmap();
+
+    bool isMapped() const
+    {
+        return data_ != NULL;
+    };
+
+    const char *begin() const
+    {
+        return data_;
+    };
+
+    const char *end() const
+    {
+        return data_ + size_;
+    };
+
+private:
+    EnMappedFile(const EnMappedFile &);
+    EnMappedFile &operator=(const EnMappedFile &);
+
+    char *data_;
+    uint64_t size_;
+    bool isCopy_;
+#ifdef _WIN32
+    void *mapping_;
+#endif
+};
+
+//
+// line oriented parser for a range of a mapped file
+// several cursors may work on the same file concurrently
+//
+class EnAsciiCursor
+{
+public:
+    EnAsciiCursor(const char *begin = NULL, const char *end = NULL);
+
+    bool atEnd() const
+    {
+        return pos_ >= end_;
+    };
+
+    const char *pos() const
+    {
+        return pos_;
+    };
+
+    // next line without line end
+    string getLine();
+    void getLine(const char *&lineBegin, const char *&lineEnd);
+
+    void skipLines(uint64_t n);
+
+    // first integer of the next line (atoi)
+    int getInt();
+
+    // up to maxVals floats of the next line (sscanf "%e%e..")
+    // returns the number of values found
+    int getFloats(float *val, const int &maxVals);
+
+    // one float in the next line
+    bool getFloat(float &val);
+
+    // num integers of width figures in the next line (En6GeoASC::atoiArr)
+    // returns the number of values found
+    int getInts(const int &width, int *arr, const int &num);
+
+    // parse a float starting at p, p is advanced behind it
+    static bool parseFloat(const char *&p, const char *end, float &val);
+
+    // parse an integer starting at p, the field ends after width characters
+    // or at the first character not belonging to the number
+    static bool parseInt(const char *&p, const char *end, const int &width, int &val);
+
+private:
+    const char *pos_;
+    const char *end_;
+};
+#endif
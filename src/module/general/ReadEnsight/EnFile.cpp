@@ -33,8 +33,21 @@
 
 #include <util/coviseCompat.h>
 #include <api/coModule.h>
+#include <config/CoviseConfig.h>
+
+#include <thread>
 
 using namespace covise;
+
+namespace
+{
+// parts decoded concurrently, Module.ReadEnsight.Threads overrides the number of cores
+int numReadThreads()
+{
+    int num = coCoviseConfig::getInt("Module.ReadEnsight.Threads", std::thread::hardware_concurrency());
+    return num < 1 ? 1 : num;
+}
+}
 InvalidWordException::InvalidWordException(const string &type)
     : type_(type)
 {
@@ -177,6 +190,7 @@ EnFile::EnFile(ReadEnsight *mod, const BinType &binType)
     , activeAlloc_(true)
     , dataByteSwap_(false)
     , ens(mod)
+    , numReadThreads_(numReadThreads())
 {
 }
 
@@ -191,6 +205,7 @@ EnFile::EnFile(ReadEnsight *mod, const string &name, const int &dim, const BinTy
     , activeAlloc_(true)
     , dataByteSwap_(false)
     , ens(mod)
+    , numReadThreads_(numReadThreads())
     , name_(name)
 {
     if (binType != FBIN && binType != CBIN)
@@ -226,6 +241,7 @@ EnFile::EnFile(ReadEnsight *mod, const string &name, const BinType &binType)
     , dim_(1)
     , activeAlloc_(true)
     , ens(mod)
+    , numReadThreads_(numReadThreads())
     , name_(name)
 {
 
@@ -909,6 +925,244 @@ EnFile::sendPartsToInfo()
     ens->sendInfo("...Finished: List of Ensight Parts");
 }
 
+EnAsciiCursor
+EnFile::asciiCursor()
+{
+    if (!mapped_.isMapped())
+        mapped_.map(in_);
+    if (!mapped_.isMapped())
+        return EnAsciiCursor();
+
+#ifdef WIN32
+    uint64_t pos(_ftelli64(in_));
+#else
+    uint64_t pos(ftell(in_));
+#endif
+    return EnAsciiCursor(mapped_.begin() + pos, mapped_.end());
+}
+
+void
+EnFile::syncFile(const EnAsciiCursor &cursor)
+{
+    if (!mapped_.isMapped() || cursor.pos() == NULL)
+        return;
+#ifdef WIN32
+    _fseeki64(in_, cursor.pos() - mapped_.begin(), SEEK_SET);
+#else
+    fseek(in_, cursor.pos() - mapped_.begin(), SEEK_SET);
+#endif
+}
+
+void
+EnFile::decodePart(EnRawPart *raw) const
+{
+    EnPart &actPart(raw->part);
+    int currElePtr2d = 0, currElePtr3d = 0;
+    int cornIn[20], cornOut[20];
+    vector<int> eleLst2d, eleLst3d, cornLst2d, cornLst3d, typeLst2d, typeLst3d;
+
+    vector<EnRawPart::Block>::iterator b(raw->blocks.begin());
+    for (; b != raw->blocks.end(); ++b)
+    {
+        EnElement elem(b->elem);
+        vector<int> blacklist;
+        const int numElements(b->numElements);
+        const int covType(elem.getCovType());
+
+        if (elem.getEnTypeStr() == "nfaced")
+        {
+            if (includePolyeder_)
+            {
+                size_t face(0), corn(0);
+                for (int i = 0; i < numElements; ++i)
+                {
+                    typeLst3d.push_back(covType);
+                    eleLst3d.push_back(currElePtr3d);
+                    for (int j = 0; j < b->numFaces[i]; ++j)
+                    {
+                        int nc = b->numPoints[face++];
+                        const int *locArr = b->conn.data() + corn;
+                        corn += nc;
+                        if (nc <= 0)
+                            continue;
+                        for (int k = 0; k < nc; ++k)
+                        {
+                            cornLst3d.push_back(locArr[k] - 1);
+                            currElePtr3d++;
+                            if ((k != 0) && (locArr[k] == locArr[0]))
+                            {
+                                // The first point appears twice in the face and would destroy
+                                // our "first-point-again-ends-face"-definition. We explicitly
+                                // start a new face here by adding the point again.
+                                cornLst3d.push_back(locArr[k] - 1);
+                                currElePtr3d++;
+                            }
+                        }
+                        cornLst3d.push_back(locArr[0] - 1);
+                        currElePtr3d++; // add first point again to mark the end of the face
+                    }
+                    blacklist.push_back(1);
+                }
+            }
+            else
+            {
+                blacklist.resize(numElements, -1); // dont read data
+            }
+        }
+        else if (elem.getEnTypeStr() == "nsided")
+        {
+            size_t corn(0);
+            for (int i = 0; i < numElements; ++i)
+            {
+                typeLst2d.push_back(covType);
+                eleLst2d.push_back(currElePtr2d);
+                int nc = b->numPoints[i];
+                for (int k = 0; k < nc; ++k)
+                    cornLst2d.push_back(b->conn[corn + k] - 1);
+                corn += nc;
+                currElePtr2d += nc;
+                blacklist.push_back(1);
+            }
+        }
+        else
+        {
+            const int nc(elem.getNumberOfCorners());
+            const int *locArr = b->conn.data();
+            for (int i = 0; i < numElements; ++i, locArr += nc)
+            {
+                // remap indicees (Ensight elements may have a different numbering scheme
+                //                 as COVISE elements)
+                //  prepare arrays
+                int j;
+                for (j = 0; j < nc; ++j)
+                    cornIn[j] = locArr[j] - 1;
+                // we add the element to the list of points if it has more than one
+                // distinct point
+                int numDistCorn = elem.distinctCorners(cornIn, cornOut);
+                if (numDistCorn > 1)
+                {
+                    if (numDistCorn != nc)
+                    {
+                        raw->statistic[nc]++;
+                        raw->rstatistic[nc][numDistCorn]++;
+                    }
+                    // do the remapping
+                    elem.remap(cornIn, cornOut);
+                    if (elem.getDim() == EnElement::D2)
+                    {
+                        eleLst2d.push_back(currElePtr2d);
+                        for (j = 0; j < nc; ++j)
+                            cornLst2d.push_back(cornOut[j]);
+                        typeLst2d.push_back(covType);
+                        currElePtr2d += nc;
+                    }
+                    else if (elem.getDim() == EnElement::D3)
+                    {
+                        eleLst3d.push_back(currElePtr3d);
+                        for (j = 0; j < nc; ++j)
+                            cornLst3d.push_back(cornOut[j]);
+                        typeLst3d.push_back(covType);
+                        currElePtr3d += nc;
+                    }
+                    blacklist.push_back(1);
+                }
+                else
+                {
+                    blacklist.push_back(-1);
+                    raw->degCells++;
+                }
+            }
+        }
+        // the raw connectivity is not needed any more
+        vector<int>().swap(b->conn);
+
+        elem.setBlacklist(blacklist);
+        actPart.addElement(elem, numElements);
+    }
+
+    // create arrys explicitly
+    int *elePtr2d(NULL), *typePtr2d(NULL), *connPtr2d(NULL);
+    int *elePtr3d(NULL), *typePtr3d(NULL), *connPtr3d(NULL);
+
+    elePtr2d = new int[eleLst2d.size()];
+    elePtr3d = new int[eleLst3d.size()];
+    typePtr2d = new int[typeLst2d.size()];
+    typePtr3d = new int[typeLst3d.size()];
+    connPtr2d = new int[cornLst2d.size()];
+    connPtr3d = new int[cornLst3d.size()];
+
+    std::copy(eleLst2d.begin(), eleLst2d.end(), elePtr2d);
+    std::copy(eleLst3d.begin(), eleLst3d.end(), elePtr3d);
+    std::copy(typeLst2d.begin(), typeLst2d.end(), typePtr2d);
+    std::copy(typeLst3d.begin(), typeLst3d.end(), typePtr3d);
+    std::copy(cornLst2d.begin(), cornLst2d.end(), connPtr2d);
+    std::copy(cornLst3d.begin(), cornLst3d.end(), connPtr3d);
+    actPart.setNumEleRead2d(eleLst2d.size());
+    actPart.setNumEleRead3d(eleLst3d.size());
+    actPart.setNumConnRead2d(cornLst2d.size());
+    actPart.setNumConnRead3d(cornLst3d.size());
+    actPart.el2d_ = elePtr2d;
+    actPart.tl2d_ = typePtr2d;
+    actPart.cl2d_ = connPtr2d;
+    actPart.el3d_ = elePtr3d;
+    actPart.tl3d_ = typePtr3d;
+    actPart.cl3d_ = connPtr3d;
+}
+
+void
+EnFile::submitPart(EnRawPart *raw)
+{
+    // a single thread decodes each part as soon as it is read
+    std::launch policy(numReadThreads_ > 1 ? std::launch::async : std::launch::deferred);
+    pendingParts_.push_back(std::async(policy, [this, raw]() {
+        decodePart(raw);
+        return raw;
+    }));
+    // keep the memory for raw parts bounded
+    finishParts(numReadThreads_ > 1 ? numReadThreads_ : 0);
+}
+
+void
+EnFile::finishParts(const size_t &maxPending)
+{
+    while (pendingParts_.size() > maxPending)
+    {
+        EnRawPart *raw = pendingParts_.front().get();
+        pendingParts_.pop_front();
+
+        if (partList_ != NULL)
+            partList_->push_back(raw->part);
+
+        if (raw->degCells > 0)
+        {
+            cerr << " WRONG ELEMENT STATISTICS" << endl;
+            cerr << "-------------------------------------------" << endl;
+            for (int ii = 2; ii < 9; ++ii)
+            {
+                cerr << ii << " | " << raw->statistic[ii];
+                for (int jj = 1; jj < 9; ++jj)
+                    cerr << " || " << raw->rstatistic[ii][jj];
+                cerr << endl;
+            }
+
+            char buf[256];
+            sprintf(buf, " -> found %d fully degenerated cells in part %d", raw->degCells, raw->part.getPartNum());
+            ens->sendInfo("%s", buf);
+        }
+        delete raw;
+    }
+}
+
+/////////////////////////// class EnRawPart /////////////////////////////////
+EnRawPart::EnRawPart()
+    : text(NULL)
+    , textEnd(NULL)
+    , degCells(0)
+{
+    memset(statistic, 0, sizeof(statistic));
+    memset(rstatistic, 0, sizeof(rstatistic));
+}
+
 /////////////////////////// class DataCont /////////////////////////////////
 DataCont::DataCont()
     : x(NULL)
@@ -28,7 +28,12 @@
 
 #include "EnElement.h"
 #include "EnPart.h"
+#include "EnAsciiReader.h"
 #include "CaseFile.h"
+
+#include <deque>
+#include <future>
+
 class ReadEnsight;
 
 namespace covise
@@ -98,6 +103,38 @@ private:
     string type_;
 };
 
+//
+// a part of a Gold geometry file as it is read from the file
+// decodePart() checks the elements for degenerated cells and
+// remaps them to COVISE conventions
+//
+class EnRawPart
+{
+public:
+    EnRawPart();
+
+    struct Block
+    {
+        EnElement elem;
+        int numElements;
+        vector<int> numFaces; // nfaced: faces per element
+        vector<int> numPoints; // nsided: points per element, nfaced: points per face
+        vector<int> conn; // corner indices as in the file (starting with 1)
+    };
+
+    EnPart part;
+    vector<Block> blocks;
+
+    // ASCII only: the unparsed part in the mapped file
+    const char *text;
+    const char *textEnd;
+
+    // element statistics
+    int degCells;
+    int statistic[30];
+    int rstatistic[30][30];
+};
+
 //
 // base class for Ensight geometry files
 // provide general methods for reading geometry files
@@ -214,6 +251,25 @@ protected:
     // send a list of all parts to covise info
     void sendPartsToInfo();
 
+    // functions used for memory mapped ASCII input
+    // cursor reading from the current position of in_ to the end of the file
+    EnAsciiCursor asciiCursor();
+
+    // continue reading in_ where cursor stopped
+    void syncFile(const EnAsciiCursor &cursor);
+
+    // functions used to decode parts concurrently
+    // build the connectivity of raw->part from raw->blocks
+    // must not change *this as it runs in a worker thread
+    virtual void decodePart(EnRawPart *raw) const;
+
+    // decode raw in a worker thread (or at once), takes ownership of raw
+    void submitPart(EnRawPart *raw);
+
+    // append decoded parts to partList_ in file order until
+    // not more than maxPending parts are left
+    void finishParts(const size_t &maxPending = 0);
+
     string className_;
 
     bool isOpen_;
@@ -242,9 +298,16 @@ protected:
     // pointer to module for sending ui messages
     ReadEnsight *ens;
 
+    // number of parts decoded concurrently
+    int numReadThreads_;
+
 private:
     string name_;
 
+    EnMappedFile mapped_;
+
+    std::deque<std::future<EnRawPart *> > pendingParts_;
+
     void getIntArrHelper(const uint64_t &n, int *iarr = NULL);
 };
 #endif
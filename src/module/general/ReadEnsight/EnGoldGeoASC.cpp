@@ -24,7 +24,9 @@
 #include "GeoFileAsc.h"
 #include "api/coModule.h"
 #include "ReadEnsight.h"
+#include <util/coWristWatch.h>
 
+#include <algorithm>
 #include <vector>
 
 //
@@ -36,9 +38,7 @@ EnGoldGeoASC::EnGoldGeoASC(ReadEnsight *mod)
     , numCoords_(0)
     , indexMap_(NULL)
     , maxIndex_(0)
-    , lastNc_(0)
     , globalCoordIndexOffset_(0)
-    , currElementIdx_(0)
     , currCornerIdx_(0)
 
 {
@@ -51,9 +51,7 @@ EnGoldGeoASC::EnGoldGeoASC(ReadEnsight *mod, const string &name)
     , numCoords_(0)
     , indexMap_(NULL)
     , maxIndex_(0)
-    , lastNc_(0)
     , globalCoordIndexOffset_(0)
-    , currElementIdx_(0)
     , currCornerIdx_(0)
 {
     className_ = string("EnGoldGeoASC");
@@ -67,6 +65,7 @@ EnGoldGeoASC::read(dimType dim, coDistributedObject **outObjects2d, coDistribute
 {
     cerr << className_ << "::read() called" << endl;
     ens->sendInfo("%s", "start reading parts  -  please be patient..");
+    coWristWatch watch;
     // read header
     readHeader();
 
@@ -94,19 +93,26 @@ EnGoldGeoASC::read(dimType dim, coDistributedObject **outObjects2d, coDistribute
     {
         if (it->isActive())
         {
-            EnPart part;
-            readPart(part);
-            readPartConn(part);
+            // the parts are parsed concurrently
+            EnRawPart *raw = new EnRawPart;
+            readPart(*raw);
+            submitPart(raw);
             sprintf(buf, "read part#%d :  %d of %d", it->getPartNum(), cnt, allPartsToRead);
             ens->sendInfo("%s", buf);
             cnt++;
         }
         else
         {
+            // skipPart() appends to partList_ at once
+            finishParts();
             skipPart();
         }
         globalCoordIndexOffset_ = numCoords_;
     }
+    finishParts();
+
+    sprintf(buf, "done reading parts  %d parts read in %.2f s", cnt - 1, watch.elapsed());
+    ens->sendInfo("%s", buf);
 
     createGeoOutObj(dim, outObjects2d, outObjects3d, actObjNm2d, actObjNm3d, timeStep);
     return;
@@ -235,386 +241,176 @@ EnGoldGeoASC::readHeader()
     return ret;
 }
 
+// find the text of the next part in the mapped file
+// parsing is left to decodePart()
 int
-EnGoldGeoASC::readPart(EnPart &actPart)
-{
-    int ret(0);
-    int partNo;
-
-    if (isOpen_)
-    {
-        char buf[lineLen];
-        int noRead(0);
-        // 2 lines decription - ignore it
-        fgets(buf, lineLen, in_);
-        ++lineCnt_;
-        string line(buf);
-        cerr << lineCnt_ << " : " << line << endl;
-        if (line.find("part") != string::npos)
-        {
-            // part No
-            fgets(buf, lineLen, in_);
-            ++lineCnt_;
-            noRead = sscanf(buf, "%d", &partNo);
-            actPartNumber_ = partNo;
-            actPart.setPartNum(partNo);
-            //cerr << className_ << "::readPart() got part No: " << partNo << endl;
-            if (noRead != 1)
-            {
-                cerr << className_ << "::readPart() Error reading part No" << endl;
-                return -1;
-            }
-
-            // description line
-            fgets(buf, lineLen, in_);
-            ++lineCnt_;
-            actPart.setComment(buf);
-            // coordinates token
-            fgets(buf, lineLen, in_);
-            ++lineCnt_;
-            line = string(buf);
-            if (line.find("coordinates") == string::npos)
-            {
-                cerr << className_ << "::readPart() coordinates key not found" << endl;
-                return -1;
-            }
-            // number of coordinates
-            fgets(buf, lineLen, in_);
-            ++lineCnt_;
-            int nc(0);
-            noRead = sscanf(buf, "%d", &nc);
-            //cerr << className_ << "::readPart() got No. of coordinates (per part): " << nc << endl;
-            if (noRead != 1)
-            {
-                cerr << className_ << "::readPart() Error reading no of coordinates" << endl;
-                return -1;
-            }
-            numCoords_ += nc;
-            int numCoords = nc;
-
-            // allocate memory for the coordinate list per part
-            float *x = new float[nc];
-            float *y = new float[nc];
-            float *z = new float[nc];
-
-            // id's or coordinates
-            float val;
-            int i;
-            switch (nodeId_)
-            {
-            case OFF:
-            case ASSIGN:
-            case EN_IGNORE:
-                // read x-values
-                for (i = 0; i < nc; ++i)
-                {
-                    fgets(buf, lineLen, in_);
-                    ++lineCnt_;
-                    noRead = sscanf(buf, "%e", &val);
-                    if (noRead != 1)
-                    {
-                        cerr << className_ << "::readPart() Error reading coordinates" << endl;
-                        return -1;
-                    }
-                    x[i] = val;
-                }
-                // read y-values
-                for (i = 0; i < nc; ++i)
-                {
-                    fgets(buf, lineLen, in_);
-                    ++lineCnt_;
-                    noRead = sscanf(buf, "%e", &val);
-                    if (noRead != 1)
-                    {
-                        cerr << className_ << "::readPart() Error reading coordinates" << endl;
-                        return -1;
-                    }
-                    y[i] = val;
-                }
-                // read z-values
-                for (i = 0; i < nc; ++i)
-                {
-                    fgets(buf, lineLen, in_);
-                    ++lineCnt_;
-                    noRead = sscanf(buf, "%e", &val);
-                    if (noRead != 1)
-                    {
-                        cerr << className_ << "::readPart() Error reading coordinates" << endl;
-                        return -1;
-                    }
-                    z[i] = val;
-                }
-                break;
-            case GIVEN:
-                // index array
-                // the index array is currently ignored
-                int iVal;
-                for (i = 0; i < nc; ++i)
-                {
-                    fgets(buf, lineLen, in_);
-                    ++lineCnt_;
-                    noRead = sscanf(buf, "%d", &iVal);
-                    if (noRead != 1)
-                    {
-                        cerr << className_ << "::readPart() Error reading index arry" << endl;
-                        return -1;
-                    }
-                    //fillIndexMap(iVal,i);
-                }
-                // read x-values
-                for (i = 0; i < nc; ++i)
-                {
-                    fgets(buf, lineLen, in_);
-                    ++lineCnt_;
-                    noRead = sscanf(buf, "%e", &val);
-                    if (noRead != 1)
-                    {
-                        cerr << className_ << "::readPart() Error reading coordinates" << endl;
-                        return -1;
-                    }
-                    x[i] = val;
-                }
-                // read y-values
-                for (i = 0; i < nc; ++i)
-                {
-                    fgets(buf, lineLen, in_);
-                    ++lineCnt_;
-                    noRead = sscanf(buf, "%e", &val);
-                    if (noRead != 1)
-                    {
-                        cerr << className_ << "::readPart() Error reading coordinates" << endl;
-                        return -1;
-                    }
-                    y[i] = val;
-                }
-                // read z-values
-                for (i = 0; i < nc; ++i)
-                {
-                    fgets(buf, lineLen, in_);
-                    ++lineCnt_;
-                    noRead = sscanf(buf, "%e", &val);
-                    if (noRead != 1)
-                    {
-                        cerr << className_ << "::readPart() Error reading coordinates" << endl;
-                        return -1;
-                    }
-                    z[i] = val;
-                }
-                break;
-            }
-            actPart.x3d_ = x;
-            actPart.y3d_ = y;
-            actPart.z3d_ = z;
-            actPart.setNumCoords(numCoords);
-        }
-        else
-            cerr << className_ << "::readPart() " << lineCnt_ << " NO part header found" << endl;
-        //cerr << className_ << "::readPart()  got " << numCoords_ << " coordinates"   << endl;
-    }
-    return ret;
-}
-
-int
-EnGoldGeoASC::readPartConn(EnPart &actPart)
+EnGoldGeoASC::readPart(EnRawPart &raw)
 {
-
-    int &partNo(actPartNumber_);
-    int ret(0);
-
     if (!isOpen_)
         return -1;
 
-    char buf[lineLen];
-    int currElePtr3d = 0, currElePtr2d = 0;
-
-    int *locArr = new int[21]; // an ENSIGHT element has max. 20 corners + 1 index
-    int cornIn[20], cornOut[20];
-
-    int numElements;
-    int nc;
-    int covType;
-    int numDistCorn(0);
-
-    bool partFound(false);
+    EnAsciiCursor cur(asciiCursor());
+    raw.text = cur.pos();
 
-    int statistic[30];
-    int rstatistic[30][30];
-    int ii, jj;
-    for (ii = 0; ii < 30; ++ii)
+    string line(cur.getLine());
+    if (line.find("part") == string::npos)
     {
-        statistic[ii] = 0;
-        for (jj = 0; jj < 9; ++jj)
-            rstatistic[ii][jj] = 0;
+        cerr << className_ << "::readPart() NO part header found" << endl;
+        raw.textEnd = raw.text;
+        return -1;
     }
-    int degCells(0);
-
-    vector<int> eleLst2d, eleLst3d, cornLst2d, cornLst3d, typeLst2d, typeLst3d;
+    // part No, description line, coordinates token
+    cur.skipLines(3);
+    // number of coordinates
+    numCoords_ += cur.getInt();
 
     // we don't know a priori how many Ensight elements we can expect here therefore we have to read
     // until we find a new 'part'
-    while ((!feof(in_)) && (!partFound))
+    raw.textEnd = cur.pos();
+    while (!cur.atEnd())
     {
-        fgets(buf, lineLen, in_);
-        ++lineCnt_;
-        string tmp(buf);
+        const char *lb, *le;
+        cur.getLine(lb, le);
+        const char tok[] = "part";
+        if (std::search(lb, le, tok, tok + 4) != le)
+            break;
+        raw.textEnd = cur.pos();
+    }
+    cur = EnAsciiCursor(raw.textEnd, raw.textEnd);
+    syncFile(cur);
+    return 0;
+}
 
-        if (tmp.find("part") != string::npos)
+// parse the part found by readPart(), runs in a worker thread
+void
+EnGoldGeoASC::decodePart(EnRawPart *raw) const
+{
+    EnPart &actPart(raw->part);
+    EnAsciiCursor cur(raw->text, raw->textEnd);
+
+    if (cur.atEnd())
+        return;
+    // part token
+    cur.skipLines(1);
+    // part No
+    actPart.setPartNum(cur.getInt());
+    // description line
+    actPart.setComment(cur.getLine() + "\n");
+    // coordinates token
+    string line(cur.getLine());
+    if (line.find("coordinates") == string::npos)
+    {
+        cerr << className_ << "::decodePart() coordinates key not found" << endl;
+        return;
+    }
+    // number of coordinates
+    int nc(cur.getInt());
+
+    // allocate memory for the coordinate list per part
+    float *x = new float[nc]();
+    float *y = new float[nc]();
+    float *z = new float[nc]();
+    actPart.x3d_ = x;
+    actPart.y3d_ = y;
+    actPart.z3d_ = z;
+    actPart.setNumCoords(nc);
+
+    // the index array is currently ignored
+    if (nodeId_ == GIVEN)
+        cur.skipLines(nc);
+    float *coords[3] = { x, y, z };
+    for (int k = 0; k < 3; ++k)
+    {
+        for (int i = 0; i < nc; ++i)
         {
-            partFound = true;
-            break;
+            if (!cur.getFloat(coords[k][i]))
+            {
+                cerr << className_ << "::decodePart() Error reading coordinates" << endl;
+                return;
+            }
         }
+    }
+
+    while (!cur.atEnd())
+    {
         // scan for element type
-        string elementType(strip(tmp));
+        string elementType(strip(cur.getLine()));
         EnElement elem(elementType);
         // we have a valid ENSIGHT element
-        if (elem.valid())
+        if (!elem.valid())
+            continue;
+
+        raw->blocks.push_back(EnRawPart::Block());
+        EnRawPart::Block &block(raw->blocks.back());
+        block.elem = elem;
+        // get number of elements
+        int numElements(cur.getInt());
+        block.numElements = numElements;
+        if (numElements <= 0)
+            continue;
+
+        // skip elements id's
+        if (elementId_ == GIVEN)
+            cur.skipLines(numElements);
+
+        // an integer always has 10 figures (see ENSIGHT docu EnGold)
+        if (elem.getEnTypeStr() == "nfaced")
         {
-            vector<int> blacklist;
-            // get number of elements
-            fgets(buf, lineLen, in_);
-            ++lineCnt_;
-            numElements = atoi(buf);
-            //cerr << className_ << "::readPartConn() " << elementType << "  " <<  numElements <<  endl;
-            nc = elem.getNumberOfCorners();
-            covType = elem.getCovType();
-
-            int i;
-            // read elements id's
-            switch (elementId_)
+            block.numFaces.resize(numElements);
+            size_t numFaces(0);
+            for (int i = 0; i < numElements; ++i)
             {
-            case OFF:
-            case EN_IGNORE:
-            case ASSIGN:
-                break;
-            case GIVEN:
-                for (i = 0; i < numElements; ++i)
-                {
-                    fgets(buf, lineLen, in_);
-                    ++lineCnt_;
-                }
-                break;
+                block.numFaces[i] = cur.getInt();
+                numFaces += block.numFaces[i];
             }
-            //if (currElementIdx_ == 0) currElePtr = 0;
-            //else currElePtr = dc_.el[ currElementIdx_ - 1 ] + lastNc_;
-            for (i = 0; i < numElements; ++i)
+            block.numPoints.resize(numFaces);
+            size_t numCorners(0);
+            for (size_t face = 0; face < numFaces; ++face)
             {
-                fgets(buf, lineLen, in_);
-                ++lineCnt_;
-                // an integer always has 10 figures (see ENSIGHT docu EnGold)
-                En6GeoASC::atoiArr(10, buf, locArr, nc);
-                // remap indicees (Ensight elements may have a different numbering scheme
-                //                 as COVISE elements)
-                //  prepare arrays
-                int j;
-                for (j = 0; j < nc; ++j)
-                    cornIn[j] = locArr[j] - 1;
-                // we add the element to the list of points if it has more than one
-                // distinct point
-                numDistCorn = elem.distinctCorners(cornIn, cornOut);
-                if (numDistCorn > 1)
-                {
-                    if (numDistCorn != elem.getNumberOfCorners())
-                    {
-                        int iii = elem.getNumberOfCorners();
-                        statistic[iii]++;
-                        rstatistic[iii][numDistCorn]++;
-                    }
-                    // do the remapping
-                    elem.remap(cornIn, cornOut);
-                    // assign element list
-                    if (elem.getDim() == EnElement::D2)
-                    {
-                        eleLst2d.push_back(currElePtr2d);
-                        for (j = 0; j < nc; ++j)
-                            cornLst2d.push_back(cornOut[j]);
-                        typeLst2d.push_back(covType);
-                        currElePtr2d += nc;
-                    }
-                    else if (elem.getDim() == EnElement::D3)
-                    {
-                        eleLst3d.push_back(currElePtr3d);
-                        for (j = 0; j < nc; ++j)
-                            cornLst3d.push_back(cornOut[j]);
-                        typeLst3d.push_back(covType);
-                        currElePtr3d += nc;
-                    }
-                    currElementIdx_++;
-                    blacklist.push_back(1);
-                }
-                else
+                block.numPoints[face] = cur.getInt();
+                numCorners += block.numPoints[face];
+            }
+            if (includePolyeder_)
+            {
+                block.conn.resize(numCorners);
+                size_t corn(0);
+                for (size_t face = 0; face < numFaces; ++face)
                 {
-                    blacklist.push_back(-1);
-                    degCells++;
+                    cur.getInts(10, block.conn.data() + corn, block.numPoints[face]);
+                    corn += block.numPoints[face];
                 }
             }
-            lastNc_ = nc;
-            elem.setBlacklist(blacklist);
-            actPart.addElement(elem, numElements);
+            else
+                cur.skipLines(numFaces);
         }
-    }
-    // we have read one line more than needed
-    if (partFound)
-    {
-#ifdef WIN32
-        _fseeki64(in_, -5L, SEEK_CUR);
-#else
-        fseek(in_, -5L, SEEK_CUR);
-#endif
-    }
-
-    if (partList_ != NULL)
-    {
-        // create arrys explicitly
-        int *elePtr2d(NULL), *typePtr2d(NULL), *connPtr2d(NULL);
-        int *elePtr3d(NULL), *typePtr3d(NULL), *connPtr3d(NULL);
-
-        elePtr2d = new int[eleLst2d.size()];
-        elePtr3d = new int[eleLst3d.size()];
-        typePtr2d = new int[typeLst2d.size()];
-        typePtr3d = new int[typeLst3d.size()];
-        connPtr2d = new int[cornLst2d.size()];
-        connPtr3d = new int[cornLst3d.size()];
-
-        std::copy(eleLst2d.begin(), eleLst2d.end(), elePtr2d);
-        std::copy(eleLst3d.begin(), eleLst3d.end(), elePtr3d);
-        std::copy(typeLst2d.begin(), typeLst2d.end(), typePtr2d);
-        std::copy(typeLst3d.begin(), typeLst3d.end(), typePtr3d);
-        std::copy(cornLst2d.begin(), cornLst2d.end(), connPtr2d);
-        std::copy(cornLst3d.begin(), cornLst3d.end(), connPtr3d);
-        actPart.setNumEleRead2d(eleLst2d.size());
-        actPart.setNumEleRead3d(eleLst3d.size());
-        actPart.setNumConnRead2d(cornLst2d.size());
-        actPart.setNumConnRead3d(cornLst3d.size());
-        actPart.el2d_ = elePtr2d;
-        actPart.tl2d_ = typePtr2d;
-        actPart.cl2d_ = connPtr2d;
-        actPart.el3d_ = elePtr3d;
-        actPart.tl3d_ = typePtr3d;
-        actPart.cl3d_ = connPtr3d;
-
-        partList_->push_back(actPart);
-    }
-
-    delete[] locArr;
-
-    //cerr << className_ << "::readPartConn() " << degCells << " degenerated cells found" << endl;
-
-    if (degCells > 0)
-    {
-        cerr << " WRONG ELEMENT STATISTICS" << endl;
-        cerr << "-------------------------------------------" << endl;
-        for (ii = 2; ii < 9; ++ii)
+        else if (elem.getEnTypeStr() == "nsided")
+        {
+            block.numPoints.resize(numElements);
+            size_t numCorners(0);
+            for (int i = 0; i < numElements; ++i)
+            {
+                block.numPoints[i] = cur.getInt();
+                numCorners += block.numPoints[i];
+            }
+            block.conn.resize(numCorners);
+            size_t corn(0);
+            for (int i = 0; i < numElements; ++i)
+            {
+                cur.getInts(10, block.conn.data() + corn, block.numPoints[i]);
+                corn += block.numPoints[i];
+            }
+        }
+        else
         {
-            cerr << ii << " | " << statistic[ii];
-            for (jj = 1; jj < 9; ++jj)
-                cerr << " || " << rstatistic[ii][jj];
-            cerr << endl;
+            int nc(elem.getNumberOfCorners());
+            block.conn.resize((size_t)numElements * nc);
+            int *locArr(block.conn.data());
+            for (int i = 0; i < numElements; ++i, locArr += nc)
+                cur.getInts(10, locArr, nc);
         }
-
-        sprintf(buf, " -> found %d fully degenerated cells in part %d", degCells, partNo);
-        ens->sendInfo("%s", buf);
     }
-    return ret;
+
+    EnFile::decodePart(raw);
 }
 
 //
@@ -49,11 +49,11 @@ private:
     // read header
     int readHeader();
 
-    // read Ensight part information
-    int readPart(EnPart &actPart);
+    // find the next part in the file
+    int readPart(EnRawPart &raw);
 
-    // read part connectivities (ENSIGHT Gold only)
-    int readPartConn(EnPart &actPart);
+    // parse coordinates and connectivities of a part found by readPart
+    void decodePart(EnRawPart *raw) const;
 
     // read bounding box (ENSIGHT Gold)
     int readBB();
@@ -65,10 +65,8 @@ private:
     int numCoords_; // number of coordinates
     int *indexMap_; // index map array if node id: GIVEN
     int maxIndex_; // max possible  index of indexmap
-    int lastNc_;
     int globalCoordIndexOffset_;
     int actPartNumber_;
-    int currElementIdx_;
     int currCornerIdx_;
 
     vector<EnPart> parts_; // contains all parts of the current geometry
@@ -25,6 +25,7 @@
 #include "ReadEnsight.h"
 #include <api/coModule.h>
 #include <util/byteswap.h>
+#include <util/coWristWatch.h>
 
 #include <vector>
 
@@ -39,9 +40,7 @@ EnGoldGeoBIN::EnGoldGeoBIN(ReadEnsight *mod)
     , numCoords_(0)
     , indexMap_(NULL)
     , maxIndex_(0)
-    , lastNc_(0)
     , globalCoordIndexOffset_(0)
-    , currElementIdx_(0)
     , currCornerIdx_(0)
 
 {
@@ -54,9 +53,7 @@ EnGoldGeoBIN::EnGoldGeoBIN(ReadEnsight *mod, const string &name, EnFile::BinType
     , numCoords_(0)
     , indexMap_(NULL)
     , maxIndex_(0)
-    , lastNc_(0)
     , globalCoordIndexOffset_(0)
-    , currElementIdx_(0)
     , currCornerIdx_(0)
 {
     className_ = string("EnGoldGeoBIN");
@@ -89,6 +86,7 @@ EnGoldGeoBIN::read(dimType dim, coDistributedObject **outObjects2d, coDistribute
 {
     //cerr << className_ << "::read() called" << endl;
     ens->sendInfo("%s", "start reading parts  -  please be patient..");
+    coWristWatch watch;
     // read header
     readHeader();
 
@@ -120,21 +118,26 @@ EnGoldGeoBIN::read(dimType dim, coDistributedObject **outObjects2d, coDistribute
     {
         if (it->isActive())
         {
-            EnPart part;
-            readPart(part);
-            readPartConn(part);
+            // the file is read here, the parts are decoded concurrently
+            EnRawPart *raw = new EnRawPart;
+            readPart(raw->part);
+            readPartConn(*raw);
+            submitPart(raw);
             sprintf(buf, "read part#%d :  %d of %d", it->getPartNum(), cnt, allPartsToRead);
             ens->sendInfo("%s", buf);
             cnt++;
         }
         else
         {
+            // skipPart() appends to partList_ at once
+            finishParts();
             skipPart();
         }
         globalCoordIndexOffset_ = numCoords_;
     }
+    finishParts();
 
-    sprintf(buf, "done reading parts  %d parts read", cnt);
+    sprintf(buf, "done reading parts  %d parts read in %.2f s", cnt, watch.elapsed());
     ens->sendInfo("%s", buf);
 
     createGeoOutObj(dim, outObjects2d, outObjects3d, actObjNm2d, actObjNm3d, timeStep);
@@ -361,42 +364,23 @@ EnGoldGeoBIN::readPart(EnPart &actPart)
 }
 
 int
-EnGoldGeoBIN::readPartConn(EnPart &actPart)
+EnGoldGeoBIN::readPartConn(EnRawPart &raw)
 {
 #ifdef DEBUG
     cerr << "readPartConn()" << endl;
 #endif
 
-    int &partNo(actPartNumber_);
     int ret(0);
     if (!isOpen_)
         return -1;
 
-    char buf[lineLen];
-
-    int currElePtr2d = 0, currElePtr3d = 0;
-    int *locArr(NULL);
-    int cornIn[20], cornOut[20];
-    int numElements, nc, covType;
+    int numElements;
 
     partFound = false;
-    int numDistCorn;
-    int statistic[30];
-    int rstatistic[30][30];
-    int ii, jj;
-    for (ii = 0; ii < 30; ++ii)
-    {
-        statistic[ii] = 0;
-        for (jj = 0; jj < 9; ++jj)
-            rstatistic[ii][jj] = 0;
-    }
-    int degCells(0);
-
-    vector<int> eleLst2d, eleLst3d, cornLst2d, cornLst3d, typeLst2d, typeLst3d;
 
     // we don't know a priori how many Ensight elements we can expect here therefore we have to read
     // until we find a new 'part'
-    lastNc_ = 0;
+    // the elements are only read here, decodePart() remaps them
     while ((!feof(in_)) && (!partFound))
     {
         string tmp(getStr());
@@ -410,9 +394,12 @@ EnGoldGeoBIN::readPartConn(EnPart &actPart)
         // we have a valid ENSIGHT element
         if (elem.valid() && !partFound)
         {
-            vector<int> blacklist;
+            raw.blocks.push_back(EnRawPart::Block());
+            EnRawPart::Block &block(raw.blocks.back());
+            block.elem = elem;
             // get number of elements
             numElements = getInt();
+            block.numElements = numElements;
 #ifdef DEBUG
             cerr << " read " << numElements << " elements" << endl;
 #endif
@@ -427,82 +414,36 @@ EnGoldGeoBIN::readPartConn(EnPart &actPart)
                 if (elem.getEnTypeStr() == "nfaced")
                 {
                     // Read number of faces/points
-                    int *numFaces = new int[numElements];
-                    int **numPoints = new int *[numElements];
-                    getIntArr(numElements, numFaces);
+                    block.numFaces.resize(numElements);
+                    getIntArr(numElements, block.numFaces.data());
+                    size_t numFaces(0);
+                    for (int i = 0; i < numElements; ++i)
+                        numFaces += block.numFaces[i];
+                    block.numPoints.resize(numFaces);
+                    size_t face(0);
                     for (int i = 0; i < numElements; ++i)
                     {
-                        numPoints[i] = new int[numFaces[i]];
-                        getIntArr(numFaces[i], numPoints[i]);
+                        getIntArr(block.numFaces[i], block.numPoints.data() + face);
+                        face += block.numFaces[i];
                     }
                     if (includePolyeder_)
                     {
-                        // Read elements (VARIANT 1)
-                        for (int i = 0; i < numElements; ++i)
+                        size_t numCorners(0);
+                        for (face = 0; face < numFaces; ++face)
+                            numCorners += block.numPoints[face];
+                        block.conn.resize(numCorners);
+                        size_t corn(0);
+                        for (face = 0; face < numFaces; ++face)
                         {
-                            typeLst3d.push_back(elem.getCovType());
-                            eleLst3d.push_back(currElePtr3d);
-                            for (int j = 0; j < numFaces[i]; ++j)
-                            {
-                                nc = numPoints[i][j];
-                                locArr = new int[nc];
-                                getIntArr(nc, locArr);
-                                for (int k = 0; k < nc; ++k)
-                                {
-                                    cornLst3d.push_back(locArr[k] - 1);
-                                    currElePtr3d++;
-                                    if ((k != 0) && (locArr[k] == locArr[0]))
-                                    {
-                                        // The first point appears twice in the face and would destroy
-                                        // our "first-point-again-ends-face"-definition. We explicitly
-                                        // start a new face here by adding the point again.
-                                        cornLst3d.push_back(locArr[k] - 1);
-                                        currElePtr3d++;
-                                    }
-                                }
-                                cornLst3d.push_back(locArr[0] - 1);
-                                currElePtr3d++; // add first point again to mark the end of the face
-                                delete[] locArr;
-                            }
-                            currElementIdx_++;
-                            blacklist.push_back(1);
+                            getIntArr(block.numPoints[face], block.conn.data() + corn);
+                            corn += block.numPoints[face];
                         }
-                        //                     // Read elements (VARIANT 2) (WARNING: data doesnt match grid for element-based data)
-                        //                     for (int i=0; i<numElements; ++i)
-                        //                     {
-                        //                         for (int j=0; j<numFaces[i]; ++j)
-                        //                         {
-                        //                             if (j==0)
-                        //                                 typeLst3d.push_back(TYPE_POLYEDER);
-                        //                             else
-                        //                                 typeLst3d.push_back(TYPE_POLYEDERFACE);
-                        //                             eleLst3d.push_back(currElePtr3d);
-                        //                             nc = numPoints[i][j];
-                        //                             locArr = new int[nc];
-                        //                             getIntArr(nc, locArr);
-                        //                             for (int k=0; k<nc; ++k) cornLst3d.push_back(locArr[k] - 1);
-                        //                             delete [] locArr;
-                        //                             currElePtr3d += nc;
-                        //                         }
-                        //                         currElementIdx_++;
-                        //                         blacklist.push_back(1);
-                        //                     }
                     }
                     else
                     {
-                        for (int i = 0; i < numElements; ++i)
-                        {
-                            for (int j = 0; j < numFaces[i]; ++j)
-                            {
-                                skipInt(numPoints[i][j]);
-                            }
-                            blacklist.push_back(-1); // dont read data
-                        }
+                        for (face = 0; face < numFaces; ++face)
+                            skipInt(block.numPoints[face]);
                     }
-                    delete[] numFaces;
-                    for (int i = 0; i < numElements; ++i)
-                        delete[] numPoints[i];
-                    delete[] numPoints;
                 }
                 // ------------------- NFACED ----------------------
 
@@ -510,153 +451,32 @@ EnGoldGeoBIN::readPartConn(EnPart &actPart)
                 else if (elem.getEnTypeStr() == "nsided")
                 {
                     // Read number of points
-                    int *numPoints = new int[numElements];
-                    getIntArr(numElements, numPoints);
+                    block.numPoints.resize(numElements);
+                    getIntArr(numElements, block.numPoints.data());
+                    size_t numCorners(0);
+                    for (int i = 0; i < numElements; ++i)
+                        numCorners += block.numPoints[i];
                     // Read elements
+                    block.conn.resize(numCorners);
+                    size_t corn(0);
                     for (int i = 0; i < numElements; ++i)
                     {
-                        typeLst2d.push_back(elem.getCovType());
-                        eleLst2d.push_back(currElePtr2d);
-                        nc = numPoints[i];
-                        locArr = new int[nc];
-                        getIntArr(nc, locArr);
-                        for (int k = 0; k < nc; ++k)
-                        {
-                            cornLst2d.push_back(locArr[k] - 1);
-                        }
-                        delete[] locArr;
-                        currElePtr2d += nc;
-                        currElementIdx_++;
-                        blacklist.push_back(1);
+                        getIntArr(block.numPoints[i], block.conn.data() + corn);
+                        corn += block.numPoints[i];
                     }
-                    delete[] numPoints;
                 }
                 // ------------------- NSIDED ----------------------
 
                 // ---------------- DEFAULT ELEMENT-----------------
                 else
                 {
-                    nc = elem.getNumberOfCorners();
-                    covType = elem.getCovType();
-                    locArr = new int[numElements * nc];
-                    getIntArr(numElements * nc, locArr);
-                    int eleCnt(0), idx;
-                    for (int i = 0; i < numElements; ++i)
-                    {
-                        // remap indicees (Ensight elements may have a different numbering scheme
-                        //                 as COVISE elements)
-                        //  prepare arrays
-                        int j;
-                        for (j = 0; j < nc; ++j)
-                        {
-                            idx = eleCnt + j;
-                            cornIn[j] = locArr[idx] - 1;
-                        }
-                        eleCnt += nc;
-                        // we add the element to the list of points if it has more than one
-                        // distinct point
-                        numDistCorn = elem.distinctCorners(cornIn, cornOut);
-                        if (numDistCorn > 1)
-                        {
-                            if (numDistCorn != elem.getNumberOfCorners())
-                            {
-                                int iii = elem.getNumberOfCorners();
-                                statistic[iii]++;
-                                rstatistic[iii][numDistCorn]++;
-                            }
-                            // do the remapping
-                            elem.remap(cornIn, cornOut);
-                            if (elem.getDim() == EnElement::D2)
-                            {
-                                eleLst2d.push_back(currElePtr2d);
-                                for (j = 0; j < nc; ++j)
-                                    cornLst2d.push_back(cornOut[j]);
-                                typeLst2d.push_back(covType);
-                                currElePtr2d += nc;
-                            }
-                            else if (elem.getDim() == EnElement::D3)
-                            {
-                                eleLst3d.push_back(currElePtr3d);
-                                for (j = 0; j < nc; ++j)
-                                    cornLst3d.push_back(cornOut[j]);
-                                typeLst3d.push_back(covType);
-                                currElePtr3d += nc;
-                            }
-                            currElementIdx_++;
-                            blacklist.push_back(1);
-                        }
-                        else
-                        {
-                            blacklist.push_back(-1);
-                            degCells++;
-                        }
-                    }
-                    delete[] locArr;
-                    lastNc_ = nc;
+                    uint64_t numCorners((uint64_t)numElements * elem.getNumberOfCorners());
+                    block.conn.resize(numCorners);
+                    getIntArr(numCorners, block.conn.data());
                 }
                 // ---------------- DEFAULT ELEMENT-----------------
             }
-
-            elem.setBlacklist(blacklist);
-            actPart.addElement(elem, numElements);
-        }
-    }
-    // we have read one line more than needed
-    if (partFound)
-    {
-        //	in_.sync();
-        //	if ( binType_ == EnFile::FBIN) in_.seekg(-88L, ios::cur);
-        //	else in_.seekg(-80L, ios::cur);
-        //	in_.sync();
-    }
-
-    if (partList_ != NULL)
-    {
-        // create arrys explicitly
-        int *elePtr2d(NULL), *typePtr2d(NULL), *connPtr2d(NULL);
-        int *elePtr3d(NULL), *typePtr3d(NULL), *connPtr3d(NULL);
-
-        elePtr2d = new int[eleLst2d.size()];
-        elePtr3d = new int[eleLst3d.size()];
-        typePtr2d = new int[typeLst2d.size()];
-        typePtr3d = new int[typeLst3d.size()];
-        connPtr2d = new int[cornLst2d.size()];
-        connPtr3d = new int[cornLst3d.size()];
-
-        std::copy(eleLst2d.begin(), eleLst2d.end(), elePtr2d);
-        std::copy(eleLst3d.begin(), eleLst3d.end(), elePtr3d);
-        std::copy(typeLst2d.begin(), typeLst2d.end(), typePtr2d);
-        std::copy(typeLst3d.begin(), typeLst3d.end(), typePtr3d);
-        std::copy(cornLst2d.begin(), cornLst2d.end(), connPtr2d);
-        std::copy(cornLst3d.begin(), cornLst3d.end(), connPtr3d);
-        actPart.setNumEleRead2d(eleLst2d.size());
-        actPart.setNumEleRead3d(eleLst3d.size());
-        actPart.setNumConnRead2d(cornLst2d.size());
-        actPart.setNumConnRead3d(cornLst3d.size());
-        actPart.el2d_ = elePtr2d;
-        actPart.tl2d_ = typePtr2d;
-        actPart.cl2d_ = connPtr2d;
-        actPart.el3d_ = elePtr3d;
-        actPart.tl3d_ = typePtr3d;
-        actPart.cl3d_ = connPtr3d;
-
-        partList_->push_back(actPart);
-    }
-
-    if (degCells > 0)
-    {
-        cerr << " WRONG ELEMENT STATISTICS" << endl;
-        cerr << "-------------------------------------------" << endl;
-        for (ii = 2; ii < 9; ++ii)
-        {
-            cerr << ii << " | " << statistic[ii];
-            for (jj = 1; jj < 9; ++jj)
-                cerr << " || " << rstatistic[ii][jj];
-            cerr << endl;
         }
-
-        sprintf(buf, " -> found %d fully degenerated cells in part %d", degCells, partNo);
-        ens->sendInfo("%s", buf);
     }
 
     return ret;
@@ -53,7 +53,7 @@ private:
     int readPart(EnPart &actPart);
 
     // read part connectivities (ENSIGHT Gold only)
-    int readPartConn(EnPart &actPart);
+    int readPartConn(EnRawPart &raw);
 
     // read bounding box (ENSIGHT Gold)
     int readBB();
@@ -68,10 +68,8 @@ private:
     int numCoords_; // number of coordinates
     int *indexMap_; // index map array if node id: GIVEN
     int maxIndex_; // max possible  index of indexmap
-    int lastNc_;
     int globalCoordIndexOffset_;
     int actPartNumber_;
-    int currElementIdx_;
     int currCornerIdx_;
 
     bool allocated_;
@@ -207,9 +207,6 @@ En6GeoASC::readCoords()
     // we read only if we have a valid file and coordinates
     if ((isOpen_) && (numCoords_ > 0))
     {
-
-        char buf[lineLen];
-
         // allocate arrays
         dc_.setNumCoord(numCoords_);
         dc_.x = new float[numCoords_];
@@ -219,18 +216,20 @@ En6GeoASC::readCoords()
         maxIndex_ = numCoords_ - 1;
 
         // read all coordinates
+        EnAsciiCursor cur(asciiCursor());
         int i;
         for (i = 0; i < numCoords_; ++i)
         {
-            fgets(buf, lineLen, in_);
             ++lineCnt_;
-            //	    string tmp(buf);
-            float x, y, z;
-            int idx, entries;
+            const char *lb, *le;
+            cur.getLine(lb, le);
+            float val[3];
+            int idx, entries(0);
             switch (nodeId_)
             {
             case ASSIGN:
-                entries = sscanf(buf, "%e%e%e", &x, &y, &z);
+                while (entries < 3 && EnAsciiCursor::parseFloat(lb, le, val[entries]))
+                    ++entries;
                 if (entries != 3)
                 {
                     cerr << className_ << "::readCoords()  ERROR reading coordinates " << endl;
@@ -238,12 +237,19 @@ En6GeoASC::readCoords()
                     // TBD: insert error handler
                 }
                 // fill container
-                dc_.x[i] = x;
-                dc_.y[i] = y;
-                dc_.z[i] = z;
+                dc_.x[i] = val[0];
+                dc_.y[i] = val[1];
+                dc_.z[i] = val[2];
                 break;
             case GIVEN:
-                entries = sscanf(buf, "%d%e%e%e", &idx, &x, &y, &z);
+                // an index has 8 figures followed by the coordinates
+                idx = 0;
+                if (EnAsciiCursor::parseInt(lb, le, 8, idx))
+                {
+                    ++entries;
+                    while (entries < 4 && EnAsciiCursor::parseFloat(lb, le, val[entries - 1]))
+                        ++entries;
+                }
                 if (entries != 4)
                 {
                     cerr << className_ << "::readCoords()  ERROR reading coordinates " << endl;
@@ -251,9 +257,9 @@ En6GeoASC::readCoords()
                 }
                 fillIndexMap(idx, i);
                 // fill container
-                dc_.x[i] = x;
-                dc_.y[i] = y;
-                dc_.z[i] = z;
+                dc_.x[i] = val[0];
+                dc_.y[i] = val[1];
+                dc_.z[i] = val[2];
                 break;
             default:
                 return -1;
@@ -261,6 +267,7 @@ En6GeoASC::readCoords()
                 break;
             }
         }
+        syncFile(cur);
     }
     return ret;
 }
@@ -539,10 +546,10 @@ En6GeoASC::readConn()
             nc = elem.getNumberOfCorners();
             covType = elem.getCovType();
             // read the connectivity
+            EnAsciiCursor cur(asciiCursor());
             int i;
             for (i = 0; i < numElements; ++i)
             {
-                fgets(buf, lineLen, in_);
                 ++lineCnt_;
                 // an integer always has 8 figures (see ENSIGHT docu)
                 switch (elementId_)
@@ -550,21 +557,21 @@ En6GeoASC::readConn()
                 case ASSIGN:
                     tNc = nc;
                     begNc = 0;
-                    atoiArr(8, buf, locArr, nc);
+                    cur.getInts(8, locArr, nc);
                     break;
                 case GIVEN:
                     // in this case locArr[0] contains the element id
                     tNc = nc + 1;
                     begNc = 1;
-                    atoiArr(8, buf, locArr, tNc);
+                    cur.getInts(8, locArr, tNc);
                     break;
                 case OFF:
                     // !!!!! find out what to do here
-                    atoiArr(8, buf, locArr, nc);
+                    cur.getInts(8, locArr, nc);
                     break;
                 case EN_IGNORE:
                     // !!!! check this !!
-                    atoiArr(8, buf, locArr, nc);
+                    cur.getInts(8, locArr, nc);
                     break;
                 }
 
@@ -617,6 +624,7 @@ En6GeoASC::readConn()
                     }
                 }
             }
+            syncFile(cur);
         }
     }
 
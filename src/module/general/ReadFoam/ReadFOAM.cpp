@@ -25,6 +25,7 @@
 #include <do/coDoSet.h>
 #include <util/coFileUtil.h>
 #include <util/coRestraint.h>
+#include <config/CoviseConfig.h>
 
 #include <sstream>
 #include <fstream>
@@ -39,6 +40,9 @@
 #include <cstdio>
 #include <cstdlib>
 #include <memory>
+#include <future>
+#include <thread>
+#include <algorithm>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
@@ -417,277 +421,311 @@ void ReadFOAM::param(const char *paramName, bool inMapLoading)
     }
 }
 
-coDoUnstructuredGrid *ReadFOAM::loadMesh(const std::string &meshdir,
-                                         const std::string &pointsdir,
-                                         const std::string &meshObjName,
-                                         const index_t Processor)
+bool ReadFOAM::readMesh(const std::string &meshdir,
+                        const std::string &pointsdir,
+                        bool topology,
+                        MeshData &mesh)
 {
-    coDoUnstructuredGrid *meshObj;
-    index_t *el, *cl, *tl; // element list, connectivity list, type list
-    float *x_coord, *y_coord, *z_coord; // coordinate lists
+    std::shared_ptr<std::istream> pointsIn = m_case.getStreamForFile(pointsdir, "points");
+    if (!pointsIn)
+        return false;
+    HeaderInfo pointsH = readFoamHeader(*pointsIn);
 
-    if (Processor == -1)
+    if (topology)
     {
-        std::shared_ptr<std::istream> pointsIn = m_case.getStreamForFile(pointsdir, "points");
-        if (!pointsIn)
-            return NULL;
-        HeaderInfo pointsH = readFoamHeader(*pointsIn);
-        std::cerr << std::time(0) << " Reading mesh from:                 " << meshdir.c_str() << std::endl;
+        //std::cerr << std::time(0) << " reading Faces" << std::endl;
+        std::shared_ptr<std::istream> facesIn = m_case.getStreamForFile(meshdir, "faces");
+        if (!facesIn)
+            return false;
+        HeaderInfo facesH = readFoamHeader(*facesIn);
+        std::vector<std::vector<index_t> > faces(facesH.lines);
+        readIndexListArray(facesH, *facesIn, faces.data(), faces.size());
+
+        //std::cerr << std::time(0) << " reading Owners" << std::endl;
+        std::shared_ptr<std::istream> ownersIn = m_case.getStreamForFile(meshdir, "owner");
+        if (!ownersIn)
+            return false;
+        HeaderInfo ownerH = readFoamHeader(*ownersIn);
+        DimensionInfo dim = parseDimensions(ownerH.note);
+        std::vector<index_t> owners(ownerH.lines);
+        readIndexArray(ownerH, *ownersIn, owners.data(), owners.size());
+
+        //std::cerr << std::time(0) << " reading neighbours" << std::endl;
+        std::shared_ptr<std::istream> neighborsIn = m_case.getStreamForFile(meshdir, "neighbour");
+        if (!neighborsIn)
+            return false;
+        HeaderInfo neighbourH = readFoamHeader(*neighborsIn);
+        if (neighbourH.lines != dim.internalFaces)
+        {
+            std::cerr << "inconsistency: #internalFaces != #neighbours" << std::endl;
+            std::cerr << " #internalFaces = " << dim.internalFaces << std::endl;
+            std::cerr << " #neighbours = " << neighbourH.lines << std::endl;
+        }
+        std::vector<index_t> neighbours(neighbourH.lines);
+        readIndexArray(neighbourH, *neighborsIn, neighbours.data(), neighbours.size());
+
+        //mesh
+        //std::cerr << std::time(0) << " creating cellToFace Mapping" << std::endl;
+        std::vector<std::vector<index_t> > cellfacemap(dim.cells);
+        for (index_t face = 0; face < owners.size(); ++face)
+        {
+            cellfacemap[owners[face]].push_back(face);
+        }
+
+        for (index_t face = 0; face < neighbours.size(); ++face)
+        {
+            cellfacemap[neighbours[face]].push_back(face);
+        }
+
+        //std::cerr << std::time(0) << " Adding up connectivities" << std::endl;
+        index_t num_elem = dim.cells;
+        std::vector<index_t> types(num_elem, 0);
+        index_t num_conn = 0;
+        index_t num_hex = 0, num_tet = 0, num_prism = 0, num_pyr = 0, num_poly = 0;
+        //Check Shape of Cells and add fill Type_List
+        for (index_t i = 0; i < num_elem; i++)
         {
-            int num_points = pointsH.lines;
-            //std::cerr << std::time(0) << " reading Faces" << std::endl;
-            std::shared_ptr<std::istream> facesIn = m_case.getStreamForFile(meshdir, "faces");
-            if (!facesIn)
-                return NULL;
-            HeaderInfo facesH = readFoamHeader(*facesIn);
-            std::vector<std::vector<index_t> > faces(facesH.lines);
-            readIndexListArray(facesH, *facesIn, faces.data(), faces.size());
-
-            //std::cerr << std::time(0) << " reading Owners" << std::endl;
-            std::shared_ptr<std::istream> ownersIn = m_case.getStreamForFile(meshdir, "owner");
-            if (!ownersIn)
-                return NULL;
-            HeaderInfo ownerH = readFoamHeader(*ownersIn);
-            DimensionInfo dim = parseDimensions(ownerH.note);
-            std::vector<index_t> owners(ownerH.lines);
-            readIndexArray(ownerH, *ownersIn, owners.data(), owners.size());
-
-            //std::cerr << std::time(0) << " reading neighbours" << std::endl;
-            std::shared_ptr<std::istream> neighborsIn = m_case.getStreamForFile(meshdir, "neighbour");
-            if (!neighborsIn)
-                return NULL;
-            HeaderInfo neighbourH = readFoamHeader(*neighborsIn);
-            if (neighbourH.lines != dim.internalFaces)
+            const std::vector<index_t> &cellfaces = cellfacemap[i];
+            const vertex_set cellvertices = getVerticesForCell(cellfaces, faces);
+            bool onlySimpleFaces = true; //Simple Face = Triangle or Square
+            for (index_t j = 0; j < cellfaces.size(); ++j)
+            { //check if Cell has only Triangular and/or Square Faces
+                if (faces[cellfaces[j]].size() < 3 || faces[cellfaces[j]].size() > 4)
+                {
+                    onlySimpleFaces = false;
+                    break;
+                }
+            }
+            const index_t num_faces = index_t(cellfaces.size());
+            index_t num_verts = index_t(cellvertices.size());
+            if (num_faces == 6 && num_verts == 8 && onlySimpleFaces)
             {
-                std::cerr << "inconsistency: #internalFaces != #neighbours" << std::endl;
-                std::cerr << " #internalFaces = " << dim.internalFaces << std::endl;
-                std::cerr << " #neighbours = " << neighbourH.lines << std::endl;
+                types[i] = TYPE_HEXAEDER;
+                ++num_hex;
             }
-            std::vector<index_t> neighbours(neighbourH.lines);
-            readIndexArray(neighbourH, *neighborsIn, neighbours.data(), neighbours.size());
-
-            //mesh
-            //std::cerr << std::time(0) << " creating cellToFace Mapping" << std::endl;
-            std::vector<std::vector<index_t> > cellfacemap(dim.cells);
-            for (index_t face = 0; face < owners.size(); ++face)
+            else if (num_faces == 5 && num_verts == 6 && onlySimpleFaces)
             {
-                cellfacemap[owners[face]].push_back(face);
+                types[i] = TYPE_PRISM;
+                ++num_prism;
             }
-
-            for (index_t face = 0; face < neighbours.size(); ++face)
+            else if (num_faces == 5 && num_verts == 5 && onlySimpleFaces)
             {
-                cellfacemap[neighbours[face]].push_back(face);
+                types[i] = TYPE_PYRAMID;
+                ++num_pyr;
             }
-
-            //std::cerr << std::time(0) << " Adding up connectivities" << std::endl;
-            index_t num_elem = dim.cells;
-            std::vector<index_t> types(num_elem, 0);
-            index_t num_conn = 0;
-            index_t num_hex = 0, num_tet = 0, num_prism = 0, num_pyr = 0, num_poly = 0;
-            //Check Shape of Cells and add fill Type_List
-            for (index_t i = 0; i < num_elem; i++)
+            else if (num_faces == 4 && num_verts == 4 && onlySimpleFaces)
             {
-                const std::vector<index_t> &cellfaces = cellfacemap[i];
-                const vertex_set cellvertices = getVerticesForCell(cellfaces, faces);
-                bool onlySimpleFaces = true; //Simple Face = Triangle or Square
+                types[i] = TYPE_TETRAHEDER;
+                ++num_tet;
+            }
+            else
+            {
+                ++num_poly;
+                types[i] = TYPE_POLYHEDRON;
+                num_verts = 0;
                 for (index_t j = 0; j < cellfaces.size(); ++j)
-                { //check if Cell has only Triangular and/or Square Faces
-                    if (faces[cellfaces[j]].size() < 3 || faces[cellfaces[j]].size() > 4)
-                    {
-                        onlySimpleFaces = false;
-                        break;
-                    }
-                }
-                const index_t num_faces = index_t(cellfaces.size());
-                index_t num_verts = index_t(cellvertices.size());
-                if (num_faces == 6 && num_verts == 8 && onlySimpleFaces)
-                {
-                    types[i] = TYPE_HEXAEDER;
-                    ++num_hex;
-                }
-                else if (num_faces == 5 && num_verts == 6 && onlySimpleFaces)
                 {
-                    types[i] = TYPE_PRISM;
-                    ++num_prism;
+                    num_verts += index_t(faces[cellfaces[j]].size() + 1);
                 }
-                else if (num_faces == 5 && num_verts == 5 && onlySimpleFaces)
-                {
-                    types[i] = TYPE_PYRAMID;
-                    ++num_pyr;
-                }
-                else if (num_faces == 4 && num_verts == 4 && onlySimpleFaces)
-                {
-                    types[i] = TYPE_TETRAHEDER;
-                    ++num_tet;
-                }
-                else
-                {
-                    ++num_poly;
-                    types[i] = TYPE_POLYHEDRON;
-                    num_verts = 0;
-                    for (index_t j = 0; j < cellfaces.size(); ++j)
-                    {
-                        num_verts += index_t(faces[cellfaces[j]].size() + 1);
-                    }
-                }
-                num_conn += num_verts;
             }
+            num_conn += num_verts;
+        }
 
-            //Create the unstructured grid
-            meshObj = new coDoUnstructuredGrid(meshObjName.c_str(), num_elem, num_conn, num_points, 1);
-
-            // get pointers to the first element of the element, vertex and coordinate lists
-            meshObj->getAddresses(&el, &cl, &x_coord, &y_coord, &z_coord);
-            // get a pointer to the type list
-            meshObj->getTypeList(&tl);
-
-            //std::cerr << std::time(0) << " Setting element list and connectivity list" << std::endl;
-            // save data cell by cell to element, connectivity and type list
-            index_t conncount = 0;
-            std::vector<index_t> connectivities;
-            //go cell by cell (element by element)
-            for (index_t i = 0; i < dim.cells; i++)
+        mesh.el.resize(num_elem);
+        mesh.cl.resize(num_conn);
+        mesh.tl.resize(num_elem);
+        index_t *el = mesh.el.data();
+        index_t *cl = mesh.cl.data();
+        index_t *tl = mesh.tl.data();
+
+        //std::cerr << std::time(0) << " Setting element list and connectivity list" << std::endl;
+        // save data cell by cell to element, connectivity and type list
+        index_t conncount = 0;
+        std::vector<index_t> connectivities;
+        //go cell by cell (element by element)
+        for (index_t i = 0; i < dim.cells; i++)
+        {
+            //element list
+            *el = conncount;
+            ++el;
+            //connectivity list
+            const std::vector<index_t> &cellfaces = cellfacemap[i]; //get all faces of current cell
+            //IF cell is Hexahedron
+            if (types[i] == TYPE_HEXAEDER)
             {
-                //element list
-                *el = conncount;
-                ++el;
-                //connectivity list
-                const std::vector<index_t> &cellfaces = cellfacemap[i]; //get all faces of current cell
-                //IF cell is Hexahedron
-                if (types[i] == TYPE_HEXAEDER)
-                {
-                    index_t ia = cellfaces[0]; //Pick the first face in the Vector as Starting Face (all faces are squares)
-                    std::vector<index_t> a = faces[ia]; //find face that corresponds to index ia
+                index_t ia = cellfaces[0]; //Pick the first face in the Vector as Starting Face (all faces are squares)
+                std::vector<index_t> a = faces[ia]; //find face that corresponds to index ia
 
-                    bool na = isPointingInwards(ia, i, dim.internalFaces, owners, neighbours);
-                    if (na == false)
-                    { //if normal vector is not pointing inwards
-                        std::reverse(a.begin(), a.end()); //reverse the ordering of the Vertices
-                    }
+                bool na = isPointingInwards(ia, i, dim.internalFaces, owners, neighbours);
+                if (na == false)
+                { //if normal vector is not pointing inwards
+                    std::reverse(a.begin(), a.end()); //reverse the ordering of the Vertices
+                }
+
+                connectivities = a;
+                connectivities.push_back(findVertexAlongEdge(a[0], ia, cellfaces, faces));
+                connectivities.push_back(findVertexAlongEdge(a[1], ia, cellfaces, faces));
+                connectivities.push_back(findVertexAlongEdge(a[2], ia, cellfaces, faces));
+                connectivities.push_back(findVertexAlongEdge(a[3], ia, cellfaces, faces));
 
-                    connectivities = a;
-                    connectivities.push_back(findVertexAlongEdge(a[0], ia, cellfaces, faces));
-                    connectivities.push_back(findVertexAlongEdge(a[1], ia, cellfaces, faces));
-                    connectivities.push_back(findVertexAlongEdge(a[2], ia, cellfaces, faces));
-                    connectivities.push_back(findVertexAlongEdge(a[3], ia, cellfaces, faces));
+                conncount += 8;
+            }
 
-                    conncount += 8;
+            if (types[i] == TYPE_PRISM)
+            {
+                index_t it = 1;
+                index_t ia = cellfaces[0];
+                while (faces[ia].size() > 3)
+                { //find triangular face and use it as starting face
+                    ia = cellfaces[it++];
                 }
 
-                if (types[i] == TYPE_PRISM)
+                std::vector<index_t> a = faces[ia];
+
+                bool na = isPointingInwards(ia, i, dim.internalFaces, owners, neighbours);
+                if (na == false)
                 {
-                    index_t it = 1;
-                    index_t ia = cellfaces[0];
-                    while (faces[ia].size() > 3)
-                    { //find triangular face and use it as starting face
-                        ia = cellfaces[it++];
-                    }
+                    std::reverse(a.begin(), a.end());
+                }
 
-                    std::vector<index_t> a = faces[ia];
+                connectivities = a;
+                connectivities.push_back(findVertexAlongEdge(a[0], ia, cellfaces, faces));
+                connectivities.push_back(findVertexAlongEdge(a[1], ia, cellfaces, faces));
+                connectivities.push_back(findVertexAlongEdge(a[2], ia, cellfaces, faces));
 
-                    bool na = isPointingInwards(ia, i, dim.internalFaces, owners, neighbours);
-                    if (na == false)
-                    {
-                        std::reverse(a.begin(), a.end());
-                    }
-
-                    connectivities = a;
-                    connectivities.push_back(findVertexAlongEdge(a[0], ia, cellfaces, faces));
-                    connectivities.push_back(findVertexAlongEdge(a[1], ia, cellfaces, faces));
-                    connectivities.push_back(findVertexAlongEdge(a[2], ia, cellfaces, faces));
+                conncount += 6;
+            }
 
-                    conncount += 6;
+            if (types[i] == TYPE_PYRAMID)
+            {
+                index_t it = 1;
+                index_t ia = cellfaces[0];
+                while (faces[ia].size() < 4)
+                { //find the square and use it as starting face
+                    ia = cellfaces[it++];
                 }
 
-                if (types[i] == TYPE_PYRAMID)
+                std::vector<index_t> a = faces[ia];
+
+                bool na = isPointingInwards(ia, i, dim.internalFaces, owners, neighbours);
+                if (na == false)
                 {
-                    index_t it = 1;
-                    index_t ia = cellfaces[0];
-                    while (faces[ia].size() < 4)
-                    { //find the square and use it as starting face
-                        ia = cellfaces[it++];
-                    }
+                    std::reverse(a.begin(), a.end());
+                }
 
-                    std::vector<index_t> a = faces[ia];
+                connectivities = a;
+                connectivities.push_back(findVertexAlongEdge(a[0], ia, cellfaces, faces));
 
-                    bool na = isPointingInwards(ia, i, dim.internalFaces, owners, neighbours);
-                    if (na == false)
-                    {
-                        std::reverse(a.begin(), a.end());
-                    }
+                conncount += 5;
+            }
 
-                    connectivities = a;
-                    connectivities.push_back(findVertexAlongEdge(a[0], ia, cellfaces, faces));
+            if (types[i] == TYPE_TETRAHEDER)
+            {
+                index_t ia = cellfaces[0]; //use first face in vector as starting face (all faces are triangles)
+                std::vector<index_t> a = faces[ia];
 
-                    conncount += 5;
+                bool na = isPointingInwards(ia, i, dim.internalFaces, owners, neighbours);
+                if (na == false)
+                {
+                    std::reverse(a.begin(), a.end());
                 }
 
-                if (types[i] == TYPE_TETRAHEDER)
-                {
-                    index_t ia = cellfaces[0]; //use first face in vector as starting face (all faces are triangles)
+                connectivities = a;
+                connectivities.push_back(findVertexAlongEdge(a[0], ia, cellfaces, faces));
+
+                conncount += 4;
+            }
+
+            if (types[i] == TYPE_POLYHEDRON)
+            {
+                index_t kk;
+                for (index_t j = 0; j < cellfaces.size(); j++)
+                { //go through all faces in order
+                    index_t ia = cellfaces[j];
                     std::vector<index_t> a = faces[ia];
 
                     bool na = isPointingInwards(ia, i, dim.internalFaces, owners, neighbours);
+
                     if (na == false)
                     {
                         std::reverse(a.begin(), a.end());
                     }
-
-                    connectivities = a;
-                    connectivities.push_back(findVertexAlongEdge(a[0], ia, cellfaces, faces));
-
-                    conncount += 4;
-                }
-
-                if (types[i] == TYPE_POLYHEDRON)
-                {
-                    index_t kk;
-                    for (index_t j = 0; j < cellfaces.size(); j++)
-                    { //go through all faces in order
-                        index_t ia = cellfaces[j];
-                        std::vector<index_t> a = faces[ia];
-
-                        bool na = isPointingInwards(ia, i, dim.internalFaces, owners, neighbours);
-
-                        if (na == false)
+                    for (index_t k = 0; k < a.size() + 1; k++)
+                    { //go through the vertices of the current face in order
+                        if (k == a.size())
                         {
-                            std::reverse(a.begin(), a.end());
-                        }
-                        for (index_t k = 0; k < a.size() + 1; k++)
-                        { //go through the vertices of the current face in order
-                            if (k == a.size())
-                            {
-                                kk = 0;
-                            }
-                            else
-                            {
-                                kk = k;
-                            } //the first point has to appear again at the end
-                            connectivities.push_back(a[kk]);
-                            conncount++;
+                            kk = 0;
                         }
+                        else
+                        {
+                            kk = k;
+                        } //the first point has to appear again at the end
+                        connectivities.push_back(a[kk]);
+                        conncount++;
                     }
                 }
+            }
 
-                for (index_t j = 0; j < connectivities.size(); j++)
-                { //add connectivities of the current element to the connectivity List
-                    *cl = connectivities[j];
-                    ++cl;
-                }
-                // add the type of the current element the type lists
-                *tl++ = types[i];
-
-                connectivities.clear();
+            for (index_t j = 0; j < connectivities.size(); j++)
+            { //add connectivities of the current element to the connectivity List
+                *cl = connectivities[j];
+                ++cl;
             }
+            // add the type of the current element the type lists
+            *tl++ = types[i];
+
+            connectivities.clear();
         }
+    }
 
-        // save coordinates to coordinate lists
-        //      if (pointsH.lines != dim.points) {
-        //         std::cerr << std::time(0) << " inconsistency: #Number of points in points-file != #points declared in owner header" << std::endl;
-        //      }
-        std::cerr << std::time(0) << " Reading points from:               " << pointsdir.c_str() << std::endl;
-        //std::cerr << std::time(0) << " reading Points" << std::endl;
-        readFloatVectorArray(pointsH, *pointsIn, x_coord, y_coord, z_coord, pointsH.lines);
+    mesh.x.resize(pointsH.lines);
+    mesh.y.resize(pointsH.lines);
+    mesh.z.resize(pointsH.lines);
+    readFloatVectorArray(pointsH, *pointsIn, mesh.x.data(), mesh.y.data(), mesh.z.data(), pointsH.lines);
+    mesh.topology = topology;
+    mesh.valid = true;
+    return true;
+}
+
+coDoUnstructuredGrid *ReadFOAM::loadMesh(const std::string &meshdir,
+                                         const std::string &pointsdir,
+                                         const std::string &meshObjName,
+                                         const index_t Processor,
+                                         MeshData *prefetched)
+{
+    coDoUnstructuredGrid *meshObj;
+    index_t *el, *cl, *tl; // element list, connectivity list, type list
+    float *x_coord, *y_coord, *z_coord; // coordinate lists
+
+    const bool topology = (Processor == -1);
+    MeshData read;
+    MeshData *mesh = prefetched;
+    if (!mesh || !mesh->valid || mesh->topology != topology)
+    {
+        mesh = &read;
+        if (!readMesh(meshdir, pointsdir, topology, read))
+            return NULL;
+    }
+    if (topology)
+        std::cerr << std::time(0) << " Reading mesh from:                 " << meshdir.c_str() << std::endl;
+    int num_points = int(mesh->x.size());
+
+    if (topology)
+    {
+        index_t num_elem = index_t(mesh->el.size());
+        index_t num_conn = index_t(mesh->cl.size());
+
+        //Create the unstructured grid
+        meshObj = new coDoUnstructuredGrid(meshObjName.c_str(), num_elem, num_conn, num_points, 1);
+
+        // get pointers to the first element of the element, vertex and coordinate lists
+        meshObj->getAddresses(&el, &cl, &x_coord, &y_coord, &z_coord);
+        // get a pointer to the type list
+        meshObj->getTypeList(&tl);
+
+        std::copy(mesh->el.begin(), mesh->el.end(), el);
+        std::copy(mesh->cl.begin(), mesh->cl.end(), cl);
+        std::copy(mesh->tl.begin(), mesh->tl.end(), tl);
     }
     else
     { //if Processor >= 0  ->  Copy everything but the Coordinates from basemeshs[processor]
@@ -700,13 +738,6 @@ coDoUnstructuredGrid *ReadFOAM::loadMesh(const std::string &meshdir,
         oldMesh->getAddresses(&oldel, &oldcl, &oldx_coord, &oldy_coord, &oldz_coord);
         oldMesh->getTypeList(&oldtl);
 
-        //std::cerr << std::time(0) << " Reading points from: " << pointsdir.c_str() << std::endl;
-        std::shared_ptr<std::istream> pointsIn = m_case.getStreamForFile(pointsdir, "points");
-        if (!pointsIn)
-            return NULL;
-        HeaderInfo pointsH = readFoamHeader(*pointsIn);
-        int num_points = pointsH.lines;
-
         meshObj = new coDoUnstructuredGrid(meshObjName.c_str(), num_elem, num_conn, num_points, 1);
         // get pointers to the first element of the element, vertex and coordinate lists
         meshObj->getAddresses(&el, &cl, &x_coord, &y_coord, &z_coord);
@@ -722,15 +753,14 @@ coDoUnstructuredGrid *ReadFOAM::loadMesh(const std::string &meshdir,
         {
             cl[i] = oldcl[i];
         }
-
-        // save coordinates to coordinate lists
-        std::cerr << std::time(0) << " Reading points from:               " << pointsdir.c_str() << std::endl;
-        //if (pointsH.lines != dim.points) {
-        //   std::cerr << std::time(0) << " inconsistency: #Number of points in points-file != #points declared in owner header" << std::endl;
-        //}
-        readFloatVectorArray(pointsH, *pointsIn, x_coord, y_coord, z_coord, pointsH.lines);
     }
 
+    // save coordinates to coordinate lists
+    std::cerr << std::time(0) << " Reading points from:               " << pointsdir.c_str() << std::endl;
+    std::copy(mesh->x.begin(), mesh->x.end(), x_coord);
+    std::copy(mesh->y.begin(), mesh->y.end(), y_coord);
+    std::copy(mesh->z.begin(), mesh->z.end(), z_coord);
+
     //std::cerr << std::time(0) << " done!" << std::endl;
 
     return meshObj;
@@ -930,83 +960,106 @@ coDoPoints *ReadFOAM::loadParticles(const std::string &datadir, const std::strin
 }
 
 
-coDistributedObject *ReadFOAM::loadField(const std::string &timedir,
-                                     const std::string &file,
-                                     const std::string &vecObjName,
-                                     const std::string &meshdir)
+bool ReadFOAM::readField(const std::string &timedir,
+                         const std::string &file,
+                         const std::string &meshdir,
+                         FieldData &field)
 {
     std::shared_ptr<std::istream> vecIn = m_case.getStreamForFile(timedir, file);
     if (!vecIn)
-        return NULL;
-    HeaderInfo header = readFoamHeader(*vecIn);
+        return false;
+    HeaderInfo &header = field.header;
+    header = readFoamHeader(*vecIn);
     size_t numberCells = header.lines;
     if (numberCells == 0)
     {
         std::shared_ptr<std::istream> ownersIn = m_case.getStreamForFile(meshdir, "owner");
+        if (!ownersIn)
+            return false;
         HeaderInfo ownerH = readFoamHeader(*ownersIn);
         DimensionInfo dim = parseDimensions(ownerH.note);
         numberCells = dim.cells;
     }
-    coDistributedObject *fieldObj;
-    std::cerr << std::time(0) << "Field with name " << header.object.c_str() << " has dimensions " << header.dimensions.c_str() << std::endl;
     if (header.fieldclass == "volVectorField" || header.fieldclass == "vectorField")
     {
-        std::cerr << std::time(0) << " Reading VectorField from:          " << timedir.c_str() << "/" << file.c_str() << std::endl;
-        coDoVec3 *vecObj = new coDoVec3(vecObjName.c_str(), int(numberCells));
-        float *x, *y, *z;
-        vecObj->getAddresses(&x, &y, &z);
-        if (header.lines==0)
+        field.x.resize(numberCells, 0.0f);
+        field.y.resize(numberCells, 0.0f);
+        field.z.resize(numberCells, 0.0f);
+        if (header.lines != 0)
+            readFloatVectorArray(header, *vecIn, field.x.data(), field.y.data(), field.z.data(), header.lines);
+    }
+    else if (header.fieldclass == "volScalarField" || header.fieldclass == "scalarField")
+    {
+        if (header.lines == 0)
         {
-            for (int i=0; i<numberCells; ++i)
-            {
-                x[i] = 0.0;
-                y[i] = 0.0;
-                z[i] = 0.0;
-            }
+            float uniformFieldValue = float(std::atof(header.internalField.c_str()));
+            field.x.resize(numberCells, uniformFieldValue);
         }
         else
         {
-            readFloatVectorArray(header, *vecIn, x, y, z, header.lines);
+            field.x.resize(numberCells);
+            readFloatArray(header, *vecIn, field.x.data(), header.lines);
         }
-        fieldObj= vecObj;
     }
-    else if (header.fieldclass == "volScalarField" || header.fieldclass == "scalarField")
+    else if (header.fieldclass == "labelField")
     {
-        std::cerr << std::time(0) << " Reading ScalarField from:          " << timedir.c_str() << "/" << file.c_str() << std::endl;
-        coDoFloat *vecObj = new coDoFloat(vecObjName.c_str(), int(numberCells));
-            float *x=vecObj->getAddress();
-        if (header.lines==0)
+        if (header.lines == 0)
         {
-            float uniformFieldValue=float(std::atof(header.internalField.c_str()));
-            for (int i=0; i<numberCells; ++i)
-            {
-                x[i] = uniformFieldValue;
-            }
+            int uniformFieldValue = std::atoi(header.internalField.c_str());
+            field.labels.resize(numberCells, uniformFieldValue);
         }
         else
-        { 
-            vecObj->getAddress(&x);
-            readFloatArray(header, *vecIn, x, header.lines);
+        {
+            field.labels.resize(numberCells);
+            readIndexArray(header, *vecIn, field.labels.data(), header.lines);
         }
+    }
+    field.numberCells = numberCells;
+    field.valid = true;
+    return true;
+}
+
+coDistributedObject *ReadFOAM::loadField(const std::string &timedir,
+                                     const std::string &file,
+                                     const std::string &vecObjName,
+                                     const std::string &meshdir,
+                                     FieldData *prefetched)
+{
+    FieldData read;
+    FieldData *field = prefetched;
+    if (!field || !field->valid)
+    {
+        field = &read;
+        if (!readField(timedir, file, meshdir, read))
+            return NULL;
+    }
+    const HeaderInfo &header = field->header;
+    int numberCells = int(field->numberCells);
+    coDistributedObject *fieldObj;
+    std::cerr << std::time(0) << "Field with name " << header.object.c_str() << " has dimensions " << header.dimensions.c_str() << std::endl;
+    if (header.fieldclass == "volVectorField" || header.fieldclass == "vectorField")
+    {
+        std::cerr << std::time(0) << " Reading VectorField from:          " << timedir.c_str() << "/" << file.c_str() << std::endl;
+        coDoVec3 *vecObj = new coDoVec3(vecObjName.c_str(), numberCells);
+        float *x, *y, *z;
+        vecObj->getAddresses(&x, &y, &z);
+        std::copy(field->x.begin(), field->x.end(), x);
+        std::copy(field->y.begin(), field->y.end(), y);
+        std::copy(field->z.begin(), field->z.end(), z);
+        fieldObj= vecObj;
+    }
+    else if (header.fieldclass == "volScalarField" || header.fieldclass == "scalarField")
+    {
+        std::cerr << std::time(0) << " Reading ScalarField from:          " << timedir.c_str() << "/" << file.c_str() << std::endl;
+        coDoFloat *vecObj = new coDoFloat(vecObjName.c_str(), numberCells);
+        std::copy(field->x.begin(), field->x.end(), vecObj->getAddress());
         fieldObj= vecObj;
     }
     else if (header.fieldclass == "labelField")
     {
         std::cerr << std::time(0) << " Reading labelField from:" << timedir.c_str() << "//" << file.c_str() << std::endl;
-        coDoInt *vecObj = new coDoInt(vecObjName.c_str(), int(numberCells));
-        int *d=vecObj->getAddress();
-        if (header.lines==0)
-        {
-            int uniformFieldValue=std::atoi(header.internalField.c_str());
-            for (int i=0; i<numberCells; ++i)
-            {
-                d[i] = uniformFieldValue;
-            }
-        }
-        else
-        {
-            readIndexArray(header, *vecIn, d, header.lines);
-        }
+        coDoInt *vecObj = new coDoInt(vecObjName.c_str(), numberCells);
+        std::copy(field->labels.begin(), field->labels.end(), vecObj->getAddress());
         fieldObj= vecObj;
     }
     else
@@ -1132,6 +1185,33 @@ coDistributedObject *ReadFOAM::loadBoundaryField(const std::string &timedir,
 }
 
 
+void ReadFOAM::blockDirs(index_t block, double t, const std::string &timedir,
+                         std::string &meshdir, std::string &pointsdir, std::string &datadir)
+{
+    std::stringstream sMeshDir;
+    std::stringstream sPointsDir;
+    std::stringstream sDataDir;
+    if (m_case.numblocks > 0)
+    {
+        sMeshDir << "processor" << block << "/" << m_case.completeMeshDirs[t] << "/polyMesh";
+        sPointsDir << "processor" << block << "/" << timedir << "/polyMesh";
+        sDataDir << "processor" << block << "/" << timedir;
+    }
+    else
+    {
+        sMeshDir << m_case.completeMeshDirs[t] << "/polyMesh";
+        sPointsDir << timedir << "/polyMesh";
+        sDataDir << timedir;
+    }
+
+    meshdir = sMeshDir.str();
+    if (m_case.varyingCoords)
+        pointsdir = sPointsDir.str();
+    else
+        pointsdir = meshdir;
+    datadir = sDataDir.str();
+}
+
 int ReadFOAM::compute(const char *port) //Compute is called when Module is executed
 {
     (void)port;
@@ -1159,6 +1239,7 @@ int ReadFOAM::compute(const char *port) //Compute is called when Module is execu
     }
     float starttime = starttimeParam->getValue();
     float stoptime = stoptimeParam->getValue(); 
+    int numReadThreads = coCoviseConfig::getInt("Module.ReadFoam.Threads", int(std::thread::hardware_concurrency()));
     basemeshs.clear();
     basebounds.clear();
     pointmaps.clear();
@@ -1218,32 +1299,59 @@ int ReadFOAM::compute(const char *port) //Compute is called when Module is execu
                     std::vector<std::vector<coDistributedObject *> > tempSetPort(num_ports);
                     std::vector<std::vector<coDistributedObject *> > tempSetBoundPort(num_boundary_data_ports);
                     std::vector<std::vector<coDistributedObject *> > tempSetParticlesPort(num_ports);
+                    // with several processor directories, the meshes and fields of the next blocks
+                    // are read concurrently into process memory, while the COVISE objects
+                    // are created here in the order of the blocks
+                    const bool loadGeometry = (!m_case.varyingCoords && counter == 0) || m_case.varyingCoords;
+                    const index_t numBlocks = std::max(1, m_case.numblocks);
+                    std::vector<BlockData> prefetched(numBlocks);
+                    std::vector<std::future<void> > pending(numBlocks);
+                    auto prefetch = [&](index_t b)
+                    {
+                        std::string meshdir, pointsdir, datadir;
+                        blockDirs(b, t, timedir, meshdir, pointsdir, datadir);
+                        const bool readGeometry = loadGeometry && meshParam->getValue();
+                        const bool topology = lastmeshdir[b] != meshdir;
+                        std::vector<std::string> files(num_ports);
+                        for (int nPort = 0; nPort < num_ports; ++nPort)
+                        {
+                            index_t portchoice = portChoice[nPort]->getValue();
+                            if (portchoice > 1 && portchoice <= m_case.varyingFields.size() + 1)
+                                files[nPort] = portChoice[nPort]->getLabel(portchoice);
+                        }
+                        BlockData *data = &prefetched[b];
+                        pending[b] = std::async(std::launch::async, [this, data, meshdir, pointsdir, datadir, readGeometry, topology, files]()
+                        {
+                            if (readGeometry)
+                                readMesh(meshdir, pointsdir, topology, data->mesh);
+                            data->fields.resize(files.size());
+                            for (size_t p = 0; p < files.size(); ++p)
+                            {
+                                if (!files[p].empty())
+                                    readField(datadir, files[p], meshdir, data->fields[p]);
+                            }
+                        });
+                    };
+                    index_t ahead = 0;
+                    if (numBlocks > 1 && !m_case.archived && numReadThreads > 1)
+                    {
+                        for (; ahead < numBlocks && ahead < numReadThreads; ++ahead)
+                            prefetch(ahead);
+                    }
+
                     for (index_t j = 0;( j < m_case.numblocks || j==0); j++)
                     { //fill vector:tempSet with all the mesh parts of all processors even if its just one
                         //std::cerr << " processor" << j;
-                        std::stringstream sMeshDir;
-                        std::stringstream sPointsDir;
-                        std::stringstream sDataDir;
-                        if (m_case.numblocks > 0)
+                        std::string meshdir, pointsdir, datadir;
+                        blockDirs(j, t, timedir, meshdir, pointsdir, datadir);
+                        BlockData *blockData = NULL;
+                        if (pending[j].valid())
                         {
-                            sMeshDir << "processor" << j  << "/" << m_case.completeMeshDirs[t] << "/polyMesh";
-                            sPointsDir << "processor" << j  << "/" << timedir << "/polyMesh";
-                            sDataDir << "processor" << j  << "/" << timedir;
+                            pending[j].get();
+                            blockData = &prefetched[j];
+                            if (ahead < numBlocks)
+                                prefetch(ahead++);
                         }
-                        else
-                        {
-                            sMeshDir << m_case.completeMeshDirs[t] << "/polyMesh";
-                            sPointsDir << timedir << "/polyMesh";
-                            sDataDir << timedir;
-                        }
-
-                        std::string meshdir = sMeshDir.str();
-                        std::string pointsdir;
-                        if (m_case.varyingCoords)
-                            pointsdir = sPointsDir.str();
-                        else
-                            pointsdir = meshdir;
-                        std::string datadir = sDataDir.str();
                         std::stringstream sm;
                         std::stringstream sb;
                         std::stringstream sd;
@@ -1270,13 +1378,14 @@ int ReadFOAM::compute(const char *port) //Compute is called when Module is execu
                                 std::string meshObjName = meshOutPort->getObjName();
                                 meshObjName += sm.str();
                                 coDoUnstructuredGrid *m = NULL;
+                                MeshData *mesh = blockData ? &blockData->mesh : NULL;
                                 if (lastmeshdir[j]==meshdir)
                                 {
-                                    m = loadMesh(meshdir, pointsdir, meshObjName, j);
+                                    m = loadMesh(meshdir, pointsdir, meshObjName, j, mesh);
                                 }
                                 else
                                 {
-                                    m = loadMesh(meshdir, pointsdir, meshObjName);
+                                    m = loadMesh(meshdir, pointsdir, meshObjName, -1, mesh);
                                     basemeshs[j] = m;
                                     lastmeshdir[j]=meshdir;
                                 }
@@ -1335,7 +1444,8 @@ int ReadFOAM::compute(const char *port) //Compute is called when Module is execu
                                     std::string portObjName = outPorts[nPort]->getObjName();
                                     portObjName += sd.str();
 
-                                    coDistributedObject *v = loadField(datadir, dataFilename, portObjName, meshdir);
+                                    FieldData *field = blockData ? &blockData->fields[nPort] : NULL;
+                                    coDistributedObject *v = loadField(datadir, dataFilename, portObjName, meshdir, field);
                                     if (v)
                                         v->addAttribute("REALTIME", realtime.c_str());
                                     tempSetPort[nPort].push_back(v);
@@ -1437,6 +1547,8 @@ int ReadFOAM::compute(const char *port) //Compute is called when Module is execu
                                 }
                             }
                         }
+                        if (blockData)
+                            *blockData = BlockData();
                     }
                     std::stringstream s;
                     s << "_set_timestep" << timestep;
@@ -37,6 +37,32 @@
 using namespace covise;
 typedef int index_t;
 
+// mesh of one block, read into process memory (may be done concurrently)
+struct MeshData
+{
+    bool valid = false;
+    bool topology = false; // el, cl and tl have been read
+    std::vector<index_t> el, cl, tl;
+    std::vector<float> x, y, z;
+};
+
+// field of one block, read into process memory (may be done concurrently)
+struct FieldData
+{
+    bool valid = false;
+    HeaderInfo header;
+    size_t numberCells = 0;
+    std::vector<float> x, y, z; // only x for scalar fields
+    std::vector<index_t> labels;
+};
+
+// everything read ahead for one block of a time step
+struct BlockData
+{
+    MeshData mesh;
+    std::vector<FieldData> fields; // indexed by data port
+};
+
 class ReadFOAM : public coModule
 {
 
@@ -70,6 +96,9 @@ private:
     //  member functions
     virtual int compute(const char *port);
     bool vectorsAreFilled();
+    // directories of a block (processor) for time t
+    void blockDirs(index_t block, double t, const std::string &timedir,
+                   std::string &meshdir, std::string &pointsdir, std::string &datadir);
 
 public:
     ReadFOAM(int argc, char *argv[]); //Constructor
@@ -78,10 +107,15 @@ public:
     std::vector<const char *> getParticleFieldList();
     virtual void param(const char *, bool);
 
+    bool readMesh(const std::string &meshdir,
+                  const std::string &pointsdir,
+                  bool topology,
+                  MeshData &mesh);
     coDoUnstructuredGrid *loadMesh(const std::string &meshdir,
                                    const std::string &pointsdir,
                                    const std::string &meshObjName,
-                                   const index_t Processor = -1);
+                                   const index_t Processor = -1,
+                                   MeshData *prefetched = NULL);
     coDoPolygons *loadPatches(const std::string &meshdir,
                               const std::string &pointsdir,
                               const std::string &boundObjName,
@@ -92,10 +126,15 @@ public:
                               const std::string &objName,
                               const std::string &cellIdobjName,
                               coDistributedObject **cellIds);
+    bool readField(const std::string &timedir,
+                   const std::string &file,
+                   const std::string &meshdir,
+                   FieldData &field);
     coDistributedObject *loadField(const std::string &timedir,
                                const std::string &file,
                                const std::string &vecObjName,
-                               const std::string &meshdir);
+                               const std::string &meshdir,
+                               FieldData *prefetched = NULL);
     coDistributedObject *loadBoundaryField(const std::string &timedir,
                                       const std::string &meshdir,
                                       const std::string &file,
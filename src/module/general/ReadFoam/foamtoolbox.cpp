@@ -37,6 +37,9 @@
 #include <boost/iostreams/char_traits.hpp>
 #include <boost/iostreams/operations.hpp>
 #include <boost/iostreams/pipeline.hpp>
+#include <boost/iostreams/stream.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
 #include <boost/iostreams/detail/config/disable_warnings.hpp> // VC7.1 C4244.
 
 #include <boost/spirit/include/qi.hpp>
@@ -190,6 +193,23 @@ public:
     archive_streambuf *buf = nullptr;
 };
 
+class MappedStreamDeleter
+{
+public:
+    MappedStreamDeleter(bi::mapped_file_source *m)
+        : mapped(m)
+    {
+    }
+
+    void operator()(std::istream *s)
+    {
+        delete s;
+        delete mapped;
+    }
+
+    bi::mapped_file_source *mapped = nullptr;
+};
+
 bool isTimeDir(const std::string &dir)
 {
 
@@ -1140,22 +1160,98 @@ struct on_disk<unsigned long long>
     while(false)
 
 
-template <typename T>
-std::istream &operator>>(std::istream &stream, std::vector<T> &vec)
+namespace {
+//! parse ASCII numbers directly from the stream buffer, bypassing the formatted input of std::istream
+class AsciiScanner
 {
+public:
+    explicit AsciiScanner(std::istream &stream)
+        : m_stream(stream)
+        , m_buf(stream.rdbuf())
+    {
+    }
 
-    size_t n;
-    stream >> n;
-    stream.ignore(std::numeric_limits<std::streamsize>::max(), '(');
-    vec.reserve(n);
-    for (size_t i = 0; i < n; ++i)
+    //! consume everything up to and including c
+    bool skipTo(char c)
     {
-        T val;
-        stream >> val;
-        vec.push_back(val);
+        int ch;
+        while ((ch = m_buf->sbumpc()) != EOF)
+        {
+            if (ch == c)
+                return true;
+        }
+        m_stream.setstate(std::ios_base::eofbit | std::ios_base::failbit);
+        return false;
     }
-    stream.ignore(std::numeric_limits<std::streamsize>::max(), ')');
-    return stream;
+
+    bool next(double &val)
+    {
+        char token[64];
+        size_t len = 0;
+        int ch = skipSpace();
+        while (ch != EOF && len < sizeof(token) - 1
+               && (isdigit(ch) || ch == '-' || ch == '+' || ch == '.' || ch == 'e' || ch == 'E' || isalpha(ch)))
+        {
+            token[len++] = char(ch);
+            ch = m_buf->snextc();
+        }
+        token[len] = '\0';
+        char *end = nullptr;
+        val = strtod(token, &end);
+        if (len == 0 || end != token + len)
+            return fail();
+        return true;
+    }
+
+    bool next(float &val)
+    {
+        double d;
+        if (!next(d))
+            return false;
+        val = float(d);
+        return true;
+    }
+
+    template <typename I>
+    bool next(I &val)
+    {
+        int ch = skipSpace();
+        bool negative = false;
+        if (ch == '-' || ch == '+')
+        {
+            negative = ch == '-';
+            ch = m_buf->snextc();
+        }
+        if (ch == EOF || !isdigit(ch))
+            return fail();
+        I v = 0;
+        while (ch != EOF && isdigit(ch))
+        {
+            v = v * 10 + I(ch - '0');
+            ch = m_buf->snextc();
+        }
+        val = negative ? I(0) - v : v;
+        return true;
+    }
+
+private:
+    int skipSpace()
+    {
+        int ch = m_buf->sgetc();
+        while (ch != EOF && isspace(ch))
+            ch = m_buf->snextc();
+        return ch;
+    }
+
+    bool fail()
+    {
+        m_stream.setstate(std::ios_base::failbit);
+        return false;
+    }
+
+    std::istream &m_stream;
+    std::streambuf *m_buf;
+};
 }
 
 
@@ -1200,30 +1296,12 @@ template <typename T>
 bool readVectorArrayAscii(std::istream &stream, T *x, T *y, T *z, const size_t lines)
 {
     expect('\n');
+    AsciiScanner scanner(stream);
     for (size_t i = 0; i < lines; ++i)
     {
-        stream.ignore(std::numeric_limits<std::streamsize>::max(), '(');
-        stream >> x[i] >> y[i] >> z[i];
-        stream.ignore(std::numeric_limits<std::streamsize>::max(), ')');
-    }
-    expect('\n');
-
-    return stream.good();
-}
-
-template <>
-bool readVectorArrayAscii(std::istream &stream, float *x, float *y, float *z, const size_t lines)
-{
-    expect('\n');
-    for (size_t i = 0; i < lines; ++i)
-    {
-        stream.ignore(std::numeric_limits<std::streamsize>::max(), '(');
-        double vx, vy, vz;
-        stream >> vx >> vy >> vz;
-        x[i] = float(vx);
-        y[i] = float(vy);
-        z[i] = float(vz);
-        stream.ignore(std::numeric_limits<std::streamsize>::max(), ')');
+        if (!scanner.skipTo('(') || !scanner.next(x[i]) || !scanner.next(y[i]) || !scanner.next(z[i])
+            || !scanner.skipTo(')'))
+            return false;
     }
     expect('\n');
 
@@ -1288,22 +1366,33 @@ bool readListBinary(std::istream &stream, std::vector<T> &vec)
 template <typename T>
 bool readArrayAscii(std::istream &stream, T *p, const size_t lines)
 {
+    AsciiScanner scanner(stream);
     for (size_t i = 0; i < lines; ++i)
     {
-        stream >> p[i];
+        if (!scanner.next(p[i]))
+            return false;
     }
     expect('\n');
     return stream.good();
 }
 
-template <>
-bool readArrayAscii(std::istream &stream, float *p, const size_t lines)
+template <typename T>
+bool readArrayAscii(std::istream &stream, std::vector<T> *p, const size_t lines)
 {
+    AsciiScanner scanner(stream);
     for (size_t i = 0; i < lines; ++i)
     {
-        double val;
-        stream >> val;
-        p[i] = float(val);
+        size_t n = 0;
+        if (!scanner.next(n) || !scanner.skipTo('('))
+            return false;
+        p[i].resize(n);
+        for (size_t j = 0; j < n; ++j)
+        {
+            if (!scanner.next(p[i][j]))
+                return false;
+        }
+        if (!scanner.skipTo(')'))
+            return false;
     }
     expect('\n');
     return stream.good();
@@ -1434,7 +1523,7 @@ bool readIndexListArray(const HeaderInfo &info, std::istream &stream, std::vecto
    else
    {
       expect('(');
-      if(!readArrayAscii<std::vector<index_t> >(stream, p, lines))
+      if(!readArrayAscii(stream, p, lines))
          return false;
       expect(')');
    }
@@ -1551,14 +1640,14 @@ template <typename F, typename I>
 bool readParticleArrayAscii(std::istream &stream, F *x, F *y, F *z, I *cell, const size_t lines)
 {
     expect('\n');
+    AsciiScanner scanner(stream);
     for (size_t i = 0; i < lines; ++i)
     {
         F vx, vy, vz;
         I vc;
-        stream.ignore(std::numeric_limits<std::streamsize>::max(), '(');
-        stream >> vx >> vy >> vz;
-        stream.ignore(std::numeric_limits<std::streamsize>::max(), ')');
-        stream >> vc;
+        if (!scanner.skipTo('(') || !scanner.next(vx) || !scanner.next(vy) || !scanner.next(vz)
+            || !scanner.skipTo(')') || !scanner.next(vc))
+            return false;
         if (x) x[i] = vx;
         if (y) y[i] = vy;
         if (z) z[i] = vz;
@@ -1727,6 +1816,19 @@ std::shared_ptr<std::istream> CaseInfo::getStreamForFile(const std::string &base
     if (buf) {
         s = new std::istream(buf);
     } else {
+        if (extension.empty() && !intar) {
+            // plain files are mapped into memory instead of being copied through a stream buffer
+            bi::mapped_file_source *mapped = nullptr;
+            try {
+                mapped = new bi::mapped_file_source(container);
+            } catch (std::exception &) {
+            }
+            if (mapped && mapped->is_open() && mapped->size() > 0) {
+                std::istream *ms = new bi::stream<bi::array_source>(mapped->data(), mapped->size());
+                return std::shared_ptr<std::istream>(ms, MappedStreamDeleter(mapped));
+            }
+            delete mapped;
+        }
         std::ifstream *sf = new std::ifstream(container.c_str(), std::ios_base::in | std::ios_base::binary);
         if (!sf->is_open())
         {
@@ -33,7 +33,8 @@ Sample::Sample(int argc, char *argv[])
         "possible holes",
         "no holes and no expansion",
         "no holes and expansion",
-        "accurate and slow"
+        "accurate and slow",
+        "accurate and parallel"
         /*, "number weights" */
     };
     const char *bounding_boxChoices[] = { "automatic per timestep", "automatic global", "manual" };
@@ -49,7 +50,7 @@ Sample::Sample(int argc, char *argv[])
 
     // choose algorithm
     p_algorithm = addChoiceParam("algorithm", "choose algorithm");
-    p_algorithm->setValue(4, algorithmChoices, 2);
+    p_algorithm->setValue(5, algorithmChoices, 2);
 
     // choose mapping for point sampling
     p_pointSampling = addChoiceParam("point_sampling", "choose mapping for point sampling");
@@ -195,7 +196,8 @@ Sample::param(const char *name, bool inMapLoading)
     }
     else if (strcmp(name, p_algorithm->getName()) == 0)
     {
-        if (p_algorithm->getValue() == SAMPLE_ACCURATE)
+        if (p_algorithm->getValue() == SAMPLE_ACCURATE
+            || p_algorithm->getValue() == SAMPLE_ACCURATE_PARALLEL)
             epsParam->show();
         else
             epsParam->hide();
@@ -882,6 +884,13 @@ Sample::compute(const char *)
                                        time_grid_name, &usg[time],
                                        time_data_name, &str[time], x_value, y_value, z_value, eps);
                 break;
+            case SAMPLE_ACCURATE_PARALLEL:
+                // cell driven rasterization without the index
+                // approximation of SAMPLE_ACCURATE, runs with OpenMP
+                calc_grid->sample_raster(ndata,
+                                         time_grid_name, &usg[time],
+                                         time_data_name, &str[time], x_value, y_value, z_value, eps);
+                break;
             case SAMPLE_HOLES:
                 calc_grid->sample_holes(ndata,
                                         time_grid_name, &usg[time], time_data_name, &str[time], x_value, y_value, z_value);
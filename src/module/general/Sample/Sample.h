@@ -75,7 +75,8 @@ private:
         SAMPLE_ACCURATE = 3,
         SAMPLE_HOLES = 0,
         SAMPLE_NO_HOLES = 2,
-        SAMPLE_NO_HOLES_BETTER = 1
+        SAMPLE_NO_HOLES_BETTER = 1,
+        SAMPLE_ACCURATE_PARALLEL = 4
     };
     enum
     {
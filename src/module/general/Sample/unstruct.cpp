@@ -8,6 +8,12 @@
 #include "unstruct.h"
 #include "Sample.h"
 
+#include <algorithm>
+#include <math.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 int unstruct_grid::is_in(int el)
 {
     int i;
@@ -824,6 +830,318 @@ void unstruct_grid::sample_accu(const coDistributedObject **in_data,
     }
 }
 
+int unstruct_grid::cellTetras(int type, int **&tetra) const
+{
+    switch (type)
+    {
+    case TYPE_HEXAEDER:
+        tetra = (int **)h_tetras;
+        return 5;
+    case TYPE_PYRAMID:
+        tetra = (int **)py_tetras;
+        return 2;
+    case TYPE_TETRAHEDER:
+        tetra = (int **)&t_tetras;
+        return 1;
+    case TYPE_PRISM:
+        tetra = (int **)p_tetras;
+        return 3;
+    }
+    return 0;
+}
+
+bool unstruct_grid::cellIndexRange(int elem, int lo[3], int hi[3]) const
+{
+    const float *coord[3] = { x_c[cur_block], y_c[cur_block], z_c[cur_block] };
+    const int size[3] = { x_size, y_size, z_size };
+    const int *conn = cl[cur_block];
+    int j_start = el[cur_block][elem];
+    int j_end = (elem != nelem[cur_block] - 1) ? el[cur_block][elem + 1] : nconn[cur_block];
+    if (j_end <= j_start)
+        return false;
+
+    for (int d = 0; d < 3; d++)
+    {
+        float min = coord[d][conn[j_start]], max = min;
+        for (int j = j_start + 1; j < j_end; j++)
+        {
+            float c = coord[d][conn[j]];
+            if (c < min)
+                min = c;
+            if (c > max)
+                max = c;
+        }
+        // points may be up to eps outside in barycentric coordinates
+        float border = eps * (max - min);
+        min -= border;
+        max += border;
+
+        if (size[d] <= 1 || reg_max[d] <= reg_min[d])
+        {
+            if (reg_min[d] < min || reg_min[d] > max)
+                return false;
+            lo[d] = hi[d] = 0;
+            continue;
+        }
+        // grid points are at reg_min + i * (reg_max - reg_min) / (size - 1),
+        // a small tolerance keeps points on the cell faces
+        float scale = (float)(size[d] - 1) / (reg_max[d] - reg_min[d]);
+        float first = ceilf((min - reg_min[d]) * scale - 1e-3f);
+        float last = floorf((max - reg_min[d]) * scale + 1e-3f);
+        if (first > (float)(size[d] - 1) || last < 0.0f)
+            return false;
+        lo[d] = first < 0.0f ? 0 : (int)first;
+        hi[d] = last > (float)(size[d] - 1) ? size[d] - 1 : (int)last;
+        if (lo[d] > hi[d])
+            return false;
+    }
+    return true;
+}
+
+void unstruct_grid::rasterCell(int elem, int i_first, int i_last,
+                               const float *const *in, int no_comp, float *const *out) const
+{
+    int **tetra;
+    int no_tetras = cellTetras(tl[cur_block][elem], tetra);
+    int lo[3], hi[3];
+    if (no_tetras == 0 || !cellIndexRange(elem, lo, hi))
+        return;
+    if (lo[0] < i_first)
+        lo[0] = i_first;
+    if (hi[0] > i_last)
+        hi[0] = i_last;
+    if (lo[0] > hi[0])
+        return;
+
+    const float *x_cl = x_c[cur_block];
+    const float *y_cl = y_c[cur_block];
+    const float *z_cl = z_c[cur_block];
+    const int *conn = cl[cur_block] + el[cur_block][elem];
+
+    // for every tetrahedron the inverse of its edge matrix,
+    // so that lambda[1..3] = inv * (point - origin)
+    // and lambda[0] = 1 - lambda[1] - lambda[2] - lambda[3]
+    float origin[5][3], inv[5][9];
+    int node[5][4];
+    bool valid[5];
+    for (int t = 0; t < no_tetras; t++)
+    {
+        float e[3][3];
+        for (int n = 0; n < 4; n++)
+            node[t][n] = conn[tetra[t][n]];
+        origin[t][0] = x_cl[node[t][0]];
+        origin[t][1] = y_cl[node[t][0]];
+        origin[t][2] = z_cl[node[t][0]];
+        for (int n = 0; n < 3; n++)
+        {
+            e[n][0] = x_cl[node[t][n + 1]] - origin[t][0];
+            e[n][1] = y_cl[node[t][n + 1]] - origin[t][1];
+            e[n][2] = z_cl[node[t][n + 1]] - origin[t][2];
+        }
+        // rows of the inverse are the cross products of the other edges
+        for (int n = 0; n < 3; n++)
+        {
+            const float *a = e[(n + 1) % 3], *b = e[(n + 2) % 3];
+            inv[t][3 * n + 0] = a[1] * b[2] - a[2] * b[1];
+            inv[t][3 * n + 1] = a[2] * b[0] - a[0] * b[2];
+            inv[t][3 * n + 2] = a[0] * b[1] - a[1] * b[0];
+        }
+        float det = e[0][0] * inv[t][0] + e[0][1] * inv[t][1] + e[0][2] * inv[t][2];
+        valid[t] = (det != 0.0f);
+        if (valid[t])
+            for (int n = 0; n < 9; n++)
+                inv[t][n] /= det;
+    }
+
+    const float step[3] = {
+        x_size > 1 ? (reg_max[0] - reg_min[0]) / (float)(x_size - 1) : 0.0f,
+        y_size > 1 ? (reg_max[1] - reg_min[1]) / (float)(y_size - 1) : 0.0f,
+        z_size > 1 ? (reg_max[2] - reg_min[2]) / (float)(z_size - 1) : 0.0f
+    };
+    for (int c_i = lo[0]; c_i <= hi[0]; c_i++)
+        for (int c_j = lo[1]; c_j <= hi[1]; c_j++)
+            for (int c_k = lo[2]; c_k <= hi[2]; c_k++)
+            {
+                float p[3] = {
+                    reg_min[0] + (float)c_i * step[0],
+                    reg_min[1] + (float)c_j * step[1],
+                    reg_min[2] + (float)c_k * step[2]
+                };
+                for (int t = 0; t < no_tetras; t++)
+                {
+                    if (!valid[t])
+                        continue;
+                    float d[3] = { p[0] - origin[t][0], p[1] - origin[t][1], p[2] - origin[t][2] };
+                    float l[4];
+                    l[1] = inv[t][0] * d[0] + inv[t][1] * d[1] + inv[t][2] * d[2];
+                    l[2] = inv[t][3] * d[0] + inv[t][4] * d[1] + inv[t][5] * d[2];
+                    l[3] = inv[t][6] * d[0] + inv[t][7] * d[1] + inv[t][8] * d[2];
+                    l[0] = 1.0f - l[1] - l[2] - l[3];
+                    int n;
+                    for (n = 0; n < 4; n++)
+                        if (l[n] < (0.0 - eps) || l[n] > (1.0 + eps))
+                            break;
+                    if (n < 4)
+                        continue;
+
+                    int idx = c_i * y_size * z_size + c_j * z_size + c_k;
+                    for (int c = 0; c < no_comp; c++)
+                        out[c][idx] = l[0] * in[c][node[t][0]] + l[1] * in[c][node[t][1]]
+                                      + l[2] * in[c][node[t][2]] + l[3] * in[c][node[t][3]];
+                    break;
+                }
+            }
+}
+
+// cell driven version of sample_accu:
+// the grid is split into slabs of i-planes, every element is sorted
+// into the slabs its bounding box overlaps, and the slabs are filled
+// concurrently, so no two threads ever write to the same grid point.
+// Within a slab the elements are handled in their original order,
+// so the result does not depend on the number of threads.
+void unstruct_grid::sample_raster(const coDistributedObject **in_data,
+                                  const char *grid_name, coDistributedObject **uni_grid_o,
+                                  const char *data_name, coDistributedObject **out_data_o,
+                                  int x_s, int y_s, int z_s, float e)
+{
+    x_size = x_s;
+    y_size = y_s;
+    z_size = z_s;
+    eps = e;
+
+    coDoUniformGrid *uni_grid = new coDoUniformGrid(grid_name, x_size, y_size, z_size, reg_min[0], reg_max[0], reg_min[1], reg_max[1],
+                                                    reg_min[2], reg_max[2]);
+    *uni_grid_o = uni_grid;
+
+    int no_comp = (flagVector == VECTOR) ? 3 : 1;
+    float *out[3] = { NULL, NULL, NULL };
+    if (flagVector == VECTOR)
+    {
+        coDoVec3 *out_data_v = new coDoVec3(data_name, noDummy * x_size * noDummy * y_size * noDummy * z_size);
+        *out_data_o = out_data_v;
+        out_data_v->getAddresses(&out[0], &out[1], &out[2]);
+    }
+    else
+    {
+        coDoFloat *out_data = new coDoFloat(data_name, noDummy * x_size * noDummy * y_size * noDummy * z_size);
+        *out_data_o = out_data;
+        out_data->getAddress(&out[0]);
+    }
+
+    if (!noDummy)
+        return;
+
+    int num_points = x_size * y_size * z_size;
+    float value = nan_flag ? FLT_MAX : fill_value;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int i = 0; i < num_points; i++)
+        for (int c = 0; c < no_comp; c++)
+            out[c][i] = value;
+
+    int num_threads = 1;
+#ifdef _OPENMP
+    num_threads = omp_get_max_threads();
+#endif
+    // a few slabs per thread for load balancing
+    int slab_width = (x_size + 4 * num_threads - 1) / (4 * num_threads);
+    int num_slabs = (x_size + slab_width - 1) / slab_width;
+
+    std::vector<int> count(num_threads * num_slabs);
+    std::vector<int> cells;
+    for (int block = 0; block < (int)num_blocks; block++)
+    {
+        cur_block = block;
+        if (!in_data[block] || nelem[block] <= 0)
+            continue;
+
+        const float *in[3] = { NULL, NULL, NULL };
+        int num_values;
+        if (flagVector == VECTOR)
+        {
+            const coDoVec3 *data = (const coDoVec3 *)in_data[block];
+            float *u, *v, *w;
+            data->getAddresses(&u, &v, &w);
+            in[0] = u;
+            in[1] = v;
+            in[2] = w;
+            num_values = data->getNumPoints();
+        }
+        else
+        {
+            const coDoFloat *data = (const coDoFloat *)in_data[block];
+            float *s;
+            data->getAddress(&s);
+            in[0] = s;
+            num_values = data->getNumPoints();
+        }
+        if (num_values < ncoord[block])
+        {
+            fprintf(stderr, "unstruct_grid::sample_raster: block %d: %d data values for %d vertices, skipped\n",
+                    block, num_values, ncoord[block]);
+            continue;
+        }
+
+        // counting sort of the elements into the slabs: every thread
+        // counts a contiguous range of elements, the offsets are ordered
+        // by slab and thread, so that each slab lists its elements in order
+        int num_elem = nelem[block];
+        std::fill(count.begin(), count.end(), 0);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int t = 0; t < num_threads; t++)
+        {
+            int *my_count = &count[t * num_slabs];
+            int lo[3], hi[3];
+            int **tetra;
+            for (int elem = (int)((size_t)num_elem * t / num_threads); elem < (int)((size_t)num_elem * (t + 1) / num_threads); elem++)
+                if (cellTetras(tl[block][elem], tetra) && cellIndexRange(elem, lo, hi))
+                    for (int s = lo[0] / slab_width; s <= hi[0] / slab_width; s++)
+                        my_count[s]++;
+        }
+        std::vector<int> slab_start(num_slabs + 1);
+        int total = 0;
+        for (int s = 0; s < num_slabs; s++)
+        {
+            slab_start[s] = total;
+            for (int t = 0; t < num_threads; t++)
+            {
+                int n = count[t * num_slabs + s];
+                count[t * num_slabs + s] = total;
+                total += n;
+            }
+        }
+        slab_start[num_slabs] = total;
+        cells.resize(total);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int t = 0; t < num_threads; t++)
+        {
+            int *my_pos = &count[t * num_slabs];
+            int lo[3], hi[3];
+            int **tetra;
+            for (int elem = (int)((size_t)num_elem * t / num_threads); elem < (int)((size_t)num_elem * (t + 1) / num_threads); elem++)
+                if (cellTetras(tl[block][elem], tetra) && cellIndexRange(elem, lo, hi))
+                    for (int s = lo[0] / slab_width; s <= hi[0] / slab_width; s++)
+                        cells[my_pos[s]++] = elem;
+        }
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+        for (int s = 0; s < num_slabs; s++)
+        {
+            int i_first = s * slab_width;
+            int i_last = std::min(i_first + slab_width, x_size) - 1;
+            for (int n = slab_start[s]; n < slab_start[s + 1]; n++)
+                rasterCell(cells[n], i_first, i_last, in, no_comp, out);
+        }
+    }
+}
+
 // the fastest method
 void unstruct_grid::sample_holes(const coDistributedObject **in_data,
                                  const char *grid_name, coDistributedObject **uni_grid_o,
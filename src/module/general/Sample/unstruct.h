@@ -123,6 +123,20 @@ private:
     // mult 3-vector with 4x4-matrix
     void mat_mult(float *x, float *y, float *z, const float *mat);
 
+    // tetrahedra of the decomposition of an element type,
+    // returns their number, 0 if the type is not supported
+    int cellTetras(int type, int **&tetra) const;
+
+    // range of uniform grid indices within the (eps-enlarged) bounding box
+    // of element elem of the current block, false if it is empty
+    bool cellIndexRange(int elem, int lo[3], int hi[3]) const;
+
+    // interpolates element elem of the current block at all grid points
+    // with first index in [i_first, i_last], no_comp data components;
+    // reentrant, as it does not use the search state of is_in
+    void rasterCell(int elem, int i_first, int i_last,
+                    const float *const *in, int no_comp, float *const *out) const;
+
 public:
     //	unstruct_grid(std::vector<coDistributedObject *>& grid,int flag);
     enum vecFlag
@@ -154,6 +168,14 @@ public:
                      const char *data_name, coDistributedObject **out_data,
                      int x_size, int y_size, int z_size, float eps);
 
+    // like sample_accu, but each element is interpolated
+    // exactly at the grid points within its bounding box and the
+    // grid is split into slabs which are filled concurrently
+    void sample_raster(const coDistributedObject **in_data,
+                       const char *grid_name, coDistributedObject **grid,
+                       const char *data_name, coDistributedObject **out_data,
+                       int x_size, int y_size, int z_size, float eps);
+
     void sample_holes(const coDistributedObject **in_data,
                       const char *grid_name, coDistributedObject **grid,
                       const char *data_name, coDistributedObject **out_data,
@@ -129,6 +129,14 @@ EdgeCollapseBasis::EdgeCollapseBasis(const vector<float> &x_c,
     _vertexList->MakeBoundary();
 }
 
+EdgeCollapseBasis::EdgeCollapseBasis()
+    : _vertexList(NULL)
+    , _triangleList(NULL)
+    , _edgeSet(NULL)
+    , _pq(NULL)
+{
+}
+
 EdgeCollapseBasis::~EdgeCollapseBasis()
 {
     delete _vertexList;
@@ -51,7 +51,7 @@ public:
     /// destructor
     virtual ~EdgeCollapseBasis();
     /// This function is called to get the output
-    void LeftEntities(vector<int> &leftTriangles,
+    virtual void LeftEntities(vector<int> &leftTriangles,
                       vector<float> &leftVertexX,
                       vector<float> &leftVertexY,
                       vector<float> &leftVertexZ,
@@ -61,6 +61,8 @@ public:
     bool PQ_OK() const;
 
 protected:
+    /// for implementations which do not use the containers
+    EdgeCollapseBasis();
     int CheckDirection(const Vertex *, const Vertex *, const Edge *) const;
     VertexContainer *_vertexList;
     TriangleContainer *_triangleList;
@@ -0,0 +1,1149 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#include "EdgeCollapseFlat.h"
+#include "Point.h"
+
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace std;
+
+extern float normaldeviation_cos;
+extern float domaindeviation_cos;
+extern float boundary_factor;
+extern bool ignoreData;
+extern bool TooUgly(const float *e0, const float *e1);
+
+EdgeCollapseFlat::EdgeCollapseFlat(const vector<float> &x_c,
+                                   const vector<float> &y_c,
+                                   const vector<float> &z_c,
+                                   const vector<int> &conn_list,
+                                   const vector<float> &data_c,
+                                   const vector<float> &normals_c,
+                                   bool parallel)
+    : _dataDim(0)
+    , _parallel(parallel)
+    , _goal(0)
+    , _numTriangles(int(conn_list.size() / 3))
+    , _stamp(0)
+    , _heap(int(conn_list.size() / 3) * 3)
+{
+    int no_vertex = (int)x_c.size();
+    if (no_vertex > 0)
+    {
+        _dataDim = int(data_c.size() / no_vertex);
+    }
+    _dim = 3 + _dataDim;
+    _qDim = ignoreData ? 3 : _dim;
+    _qStride = (_qDim * (_qDim + 1)) / 2 + _qDim + 1;
+
+    _point.resize(size_t(no_vertex) * _dim);
+    for (int vertex = 0; vertex < no_vertex; ++vertex)
+    {
+        float *p = &_point[size_t(vertex) * _dim];
+        p[0] = x_c[vertex];
+        p[1] = y_c[vertex];
+        p[2] = z_c[vertex];
+        for (int i = 0; i < _dataDim; ++i)
+        {
+            p[3 + i] = data_c[size_t(vertex) * _dataDim + i];
+        }
+    }
+    if (normals_c.size() >= size_t(3 * no_vertex))
+    {
+        _normal.assign(normals_c.begin(), normals_c.begin() + 3 * no_vertex);
+    }
+    _quadric.resize(size_t(no_vertex) * _qStride, 0.0);
+    _flags.resize(no_vertex, 0);
+    _vertexHalfEdge.resize(no_vertex, -1);
+    _mark.resize(no_vertex, 0);
+    _corner.assign(conn_list.begin(), conn_list.begin() + 3 * _numTriangles);
+    _opposite.resize(_corner.size(), -1);
+
+    // triangle quadrics, boundary quadrics are added when the
+    // boundary is found
+    for (int tri = 0; tri < _numTriangles; ++tri)
+    {
+        AddTriangleQuadric(tri);
+    }
+    BuildTopology(no_vertex);
+
+    // initial edge costs, every edge is represented by the smaller
+    // one of its half-edges
+    int no_he = int(_corner.size());
+    vector<float> cost(no_he, -1.0f);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 4096) if (_parallel)
+#endif
+    for (int he = 0; he < no_he; ++he)
+    {
+        int opp = _opposite[he];
+        if (opp >= 0 && opp < he)
+        {
+            continue;
+        }
+        int a = _corner[he];
+        int b = _corner[Next(he)];
+        if (a == b || locked(a) || locked(b))
+        {
+            continue;
+        }
+        float popt[MAX_DIM];
+        Optimum(a, b, popt, cost[he]);
+        if (cost[he] < 0.0f)
+        {
+            // only rounding errors may make the cost negative
+            cost[he] = 0.0f;
+        }
+    }
+    for (int he = 0; he < no_he; ++he)
+    {
+        if (cost[he] >= 0.0f)
+        {
+            _heap.update(he, cost[he]);
+        }
+    }
+}
+
+EdgeCollapseFlat::~EdgeCollapseFlat()
+{
+}
+
+void
+EdgeCollapseFlat::SetGoal(int num_triangles)
+{
+    _goal = num_triangles;
+}
+
+// link the half-edges of every edge shared by exactly two consistently
+// oriented triangles, find the boundary and lock all vertices
+// the half-edge structure cannot represent
+void
+EdgeCollapseFlat::BuildTopology(int no_vertex)
+{
+    int no_he = int(_corner.size());
+
+    // outgoing half-edges per vertex
+    vector<int> offset(no_vertex + 1, 0);
+    for (int he = 0; he < no_he; ++he)
+    {
+        ++offset[_corner[he] + 1];
+    }
+    for (int vertex = 0; vertex < no_vertex; ++vertex)
+    {
+        offset[vertex + 1] += offset[vertex];
+    }
+    vector<int> outgoing(no_he);
+    vector<int> fill(offset.begin(), offset.end() - 1);
+    for (int he = 0; he < no_he; ++he)
+    {
+        outgoing[fill[_corner[he]]++] = he;
+    }
+
+    for (int tri = 0; tri < _numTriangles; ++tri)
+    {
+        int v0 = _corner[3 * tri];
+        int v1 = _corner[3 * tri + 1];
+        int v2 = _corner[3 * tri + 2];
+        if (v0 == v1 || v1 == v2 || v2 == v0)
+        {
+            _flags[v0] |= LOCKED;
+            _flags[v1] |= LOCKED;
+            _flags[v2] |= LOCKED;
+        }
+    }
+
+    for (int he = 0; he < no_he; ++he)
+    {
+        int a = _corner[he];
+        int b = _corner[Next(he)];
+        if (a == b)
+        {
+            continue;
+        }
+        int same = 0;
+        for (int i = offset[a]; i < offset[a + 1]; ++i)
+        {
+            if (_corner[Next(outgoing[i])] == b)
+            {
+                ++same;
+            }
+        }
+        int reverse = -1, num_reverse = 0;
+        for (int i = offset[b]; i < offset[b + 1]; ++i)
+        {
+            if (_corner[Next(outgoing[i])] == a)
+            {
+                reverse = outgoing[i];
+                ++num_reverse;
+            }
+        }
+        if (same == 1 && num_reverse == 1)
+        {
+            _opposite[he] = reverse;
+        }
+        else if (same == 1 && num_reverse == 0)
+        {
+            AddBoundaryQuadric(he);
+        }
+        else
+        {
+            // non-manifold or inconsistently oriented
+            _flags[a] |= LOCKED;
+            _flags[b] |= LOCKED;
+        }
+    }
+
+    // a vertex has to be surrounded by one fan of triangles
+    vector<int> fan;
+    for (int vertex = 0; vertex < no_vertex; ++vertex)
+    {
+        int num = offset[vertex + 1] - offset[vertex];
+        if (num == 0)
+        {
+            continue;
+        }
+        _vertexHalfEdge[vertex] = outgoing[offset[vertex]];
+        if (!locked(vertex))
+        {
+            Fan(vertex, fan);
+            if (int(fan.size()) != num)
+            {
+                _flags[vertex] |= LOCKED;
+            }
+        }
+    }
+}
+
+// the quadric of the triangle is added to its vertices, as in Qs,
+// but weighted with the area of the triangle
+void
+EdgeCollapseFlat::AddTriangleQuadric(int tri)
+{
+    double p[3][MAX_DIM];
+    for (int corner = 0; corner < 3; ++corner)
+    {
+        const float *data = point(_corner[3 * tri + corner]);
+        for (int coord = 0; coord < _qDim; ++coord)
+        {
+            p[corner][coord] = data[coord];
+        }
+    }
+    double e1[MAX_DIM], e2[MAX_DIM];
+    if (!Base2(_qDim, e1, e2, p[0], p[1], p[2]))
+    {
+        return;
+    }
+    double side1[MAX_DIM], side2[MAX_DIM];
+    for (int coord = 0; coord < _qDim; ++coord)
+    {
+        side1[coord] = p[1][coord] - p[0][coord];
+        side2[coord] = p[2][coord] - p[0][coord];
+    }
+    double scal12 = ScalarProd(_qDim, side1, side2);
+    double area2 = ScalarProd(_qDim, side1, side1) * ScalarProd(_qDim, side2, side2) - scal12 * scal12;
+    if (area2 <= 0.0)
+    {
+        return;
+    }
+    double factor = sqrt(area2);
+
+    double q[MAX_Q];
+    double *A = q;
+    double *B = q + (_qDim * (_qDim + 1)) / 2;
+    double scl1 = ScalarProd(_qDim, p[0], e1);
+    double scl2 = ScalarProd(_qDim, p[0], e2);
+    for (int i = 0; i < _qDim; ++i)
+    {
+        for (int j = 0; j <= i; ++j)
+        {
+            A[j + (i * (i + 1)) / 2] = factor * ((i == j ? 1.0 : 0.0) - e1[i] * e1[j] - e2[i] * e2[j]);
+        }
+        B[i] = factor * (scl1 * e1[i] + scl2 * e2[i] - p[0][i]);
+    }
+    B[_qDim] = factor * (ScalarProd(_qDim, p[0], p[0]) - scl1 * scl1 - scl2 * scl2);
+
+    for (int corner = 0; corner < 3; ++corner)
+    {
+        double *vq = &_quadric[size_t(_corner[3 * tri + corner]) * _qStride];
+        for (int i = 0; i < _qStride; ++i)
+        {
+            vq[i] += q[i];
+        }
+    }
+}
+
+// geometric quadric of the plane through the boundary half-edge he
+// orthogonal to its triangle (see Triangle::QBound)
+void
+EdgeCollapseFlat::AddBoundaryQuadric(int he)
+{
+    int a = _corner[he];
+    int b = _corner[Next(he)];
+    const float *data0 = point(a);
+    const float *data1 = point(b);
+    const float *interior = point(_corner[Prev(he)]);
+
+    double side0[3], side1[3], edge[3], normal[3], m[3];
+    for (int coord = 0; coord < 3; ++coord)
+    {
+        side0[coord] = data0[coord] - interior[coord];
+        side1[coord] = data1[coord] - interior[coord];
+        edge[coord] = data1[coord] - data0[coord];
+    }
+
+    Direction dir;
+    dir.d[0] = float(edge[0]);
+    dir.d[1] = float(edge[1]);
+    dir.d[2] = float(edge[2]);
+    if (!Normalise(dir.d))
+    {
+        dir.d[0] = dir.d[1] = dir.d[2] = 0.0f;
+    }
+    _boundaryDirection[he] = dir;
+    _flags[a] |= BOUNDARY;
+    _flags[b] |= BOUNDARY;
+
+    vect_prod(normal, side0, side1);
+    double surf = sqrt(ScalarProd(3, normal, normal));
+    vect_prod(m, edge, normal);
+    double mlen = sqrt(ScalarProd(3, m, m));
+    if (surf == 0.0 || mlen == 0.0)
+    {
+        return;
+    }
+    m[0] /= mlen;
+    m[1] /= mlen;
+    m[2] /= mlen;
+    double d = -(m[0] * data0[0] + m[1] * data0[1] + m[2] * data0[2]);
+    double weight = boundary_factor * surf;
+
+    for (int vertex = 0; vertex < 2; ++vertex)
+    {
+        double *vq = &_quadric[size_t(vertex == 0 ? a : b) * _qStride];
+        double *B = vq + (_qDim * (_qDim + 1)) / 2;
+        for (int i = 0; i < 3; ++i)
+        {
+            for (int j = 0; j <= i; ++j)
+            {
+                vq[j + (i * (i + 1)) / 2] += weight * m[i] * m[j];
+            }
+            B[i] += weight * d * m[i];
+        }
+        B[_qDim] += weight * d * d;
+    }
+}
+
+// outgoing half-edges of v around its fan of triangles
+void
+EdgeCollapseFlat::Fan(int v, vector<int> &fan) const
+{
+    fan.clear();
+    int start = _vertexHalfEdge[v];
+    if (start < 0)
+    {
+        return;
+    }
+    int he = start;
+    do
+    {
+        fan.push_back(he);
+        he = _opposite[Prev(he)];
+    } while (he >= 0 && he != start);
+    if (he == start)
+    {
+        return;
+    }
+    // a boundary was reached, turn the other way round
+    int opp = _opposite[start];
+    while (opp >= 0)
+    {
+        he = Next(opp);
+        fan.push_back(he);
+        opp = _opposite[he];
+    }
+}
+
+// sorted neighbours of the vertex with the given fan,
+// returns if the vertex lies on the boundary
+bool
+EdgeCollapseFlat::Ring(const vector<int> &fan, vector<int> &ring) const
+{
+    bool boundary = false;
+    ring.clear();
+    for (size_t i = 0; i < fan.size(); ++i)
+    {
+        int he = fan[i];
+        ring.push_back(_corner[Next(he)]);
+        ring.push_back(_corner[Prev(he)]);
+        if (_opposite[he] < 0 || _opposite[Prev(he)] < 0)
+        {
+            boundary = true;
+        }
+    }
+    sort(ring.begin(), ring.end());
+    ring.erase(unique(ring.begin(), ring.end()), ring.end());
+    return boundary;
+}
+
+double
+EdgeCollapseFlat::Eval(const double *q, const float *point) const
+{
+    const double *B = q + (_qDim * (_qDim + 1)) / 2;
+    double ret = B[_qDim];
+    for (int i = 0; i < _qDim; ++i)
+    {
+        for (int j = 0; j < i; ++j)
+        {
+            ret += 2.0 * q[j + (i * (i + 1)) / 2] * point[i] * point[j];
+        }
+        ret += q[(i * (i + 3)) / 2] * point[i] * point[i];
+        ret += 2.0 * B[i] * point[i];
+    }
+    return ret;
+}
+
+// optimal position and cost for collapsing the edge between a and b,
+// the same rules as in Edge::new_cost apply
+bool
+EdgeCollapseFlat::Optimum(int a, int b, float *popt, float &cost) const
+{
+    double q[MAX_Q];
+    const double *qa = &_quadric[size_t(a) * _qStride];
+    const double *qb = &_quadric[size_t(b) * _qStride];
+    for (int i = 0; i < _qStride; ++i)
+    {
+        q[i] = qa[i] + qb[i];
+    }
+    const double *B = q + (_qDim * (_qDim + 1)) / 2;
+    const float *pa = point(a);
+    const float *pb = point(b);
+
+    double m[MAX_DIM][MAX_DIM];
+    double *mwrap[MAX_DIM];
+    double p[MAX_DIM];
+    for (int i = 0; i < _qDim; ++i)
+    {
+        mwrap[i] = m[i];
+        for (int j = i; j < _qDim; ++j)
+        {
+            m[i][j] = q[i + (j * (j + 1)) / 2];
+        }
+    }
+    bool solved = choldc(mwrap, _qDim, p);
+    if (solved)
+    {
+        double p_max = *max_element(p, p + _qDim);
+        double p_min = *min_element(p, p + _qDim);
+        solved = (p_min >= 0.0 && p_min * ILL_DEFINED >= p_max);
+    }
+    if (solved)
+    {
+        double result[MAX_DIM];
+        cholsl(mwrap, _qDim, p, B, result);
+        double costd = B[_qDim];
+        for (int coord = 0; coord < _qDim; ++coord)
+        {
+            popt[coord] = float(-result[coord]);
+            costd -= B[coord] * result[coord];
+        }
+        cost = float(costd);
+        if (_qDim < _dim)
+        {
+            // data are ignored: interpolate them along the edge
+            double len2 = 0.0, tau = 0.0;
+            for (int coord = 0; coord < 3; ++coord)
+            {
+                len2 += (pb[coord] - pa[coord]) * (pb[coord] - pa[coord]);
+                tau += (popt[coord] - pa[coord]) * (pb[coord] - pa[coord]);
+            }
+            tau = (len2 > 0.0) ? tau / len2 : 0.5;
+            tau = std::min(1.0, std::max(0.0, tau));
+            for (int coord = 3; coord < _dim; ++coord)
+            {
+                popt[coord] = float((1.0 - tau) * pa[coord] + tau * pb[coord]);
+            }
+        }
+    }
+    else // the matrix is degenerate
+    {
+        double cost0 = Eval(q, pa);
+        double cost1 = Eval(q, pb);
+        bool bound0 = (_flags[a] & BOUNDARY) != 0;
+        bool bound1 = (_flags[b] & BOUNDARY) != 0;
+        if (!bound0 && bound1)
+        {
+            // in this case, we move a to the boundary
+            copy(pb, pb + _dim, popt);
+            cost = float(cost1);
+        }
+        else if (bound0 && !bound1)
+        {
+            copy(pa, pa + _dim, popt);
+            cost = float(cost0);
+        }
+        else
+        {
+            float mid[MAX_DIM];
+            for (int coord = 0; coord < _dim; ++coord)
+            {
+                mid[coord] = 0.5f * (pa[coord] + pb[coord]);
+            }
+            double cost_int = Eval(q, mid);
+            if (cost0 <= cost1 && cost0 <= cost_int)
+            {
+                copy(pa, pa + _dim, popt);
+                cost = float(cost0);
+            }
+            else if (cost1 <= cost0 && cost1 <= cost_int)
+            {
+                copy(pb, pb + _dim, popt);
+                cost = float(cost1);
+            }
+            else
+            {
+                copy(mid, mid + _dim, popt);
+                cost = float(cost_int);
+            }
+        }
+    }
+    if (ignoreData)
+    {
+        // in case we ignore the data, cost is calculated using the edges length in order to avoid large triangles
+        cost = fabs(pa[0] - pb[0]) + fabs(pa[1] - pb[1]) + fabs(pa[2] - pb[2]);
+    }
+    return solved;
+}
+
+// same test as Triangle::CheckSide for the triangle (v, side0, side1)
+// when v is moved to moved
+bool
+EdgeCollapseFlat::CheckSide(int v, int side0, int side1, const float *moved) const
+{
+    const float *data0 = point(side0);
+    const float *data1 = point(side1);
+    const float *prev_data = point(v);
+    float e0[MAX_DIM], e1[MAX_DIM], normal[3];
+    float moved_e0[MAX_DIM], moved_e1[MAX_DIM], moved_normal[3];
+    int coord;
+    for (coord = 0; coord < _dim; ++coord)
+    {
+        if (!ignoreData || (coord < 3))
+        {
+            e0[coord] = data0[coord] - prev_data[coord];
+            e1[coord] = data1[coord] - prev_data[coord];
+            moved_e0[coord] = data0[coord] - moved[coord];
+            moved_e1[coord] = data1[coord] - moved[coord];
+        }
+        else
+        {
+            e0[coord] = 0.0f;
+            e1[coord] = 0.0f;
+            moved_e0[coord] = 0.0f;
+            moved_e1[coord] = 0.0f;
+        }
+    }
+    if (TooUgly(moved_e0, moved_e1))
+    {
+        return false;
+    }
+
+    vect_prod(normal, e0, e1);
+    vect_prod(moved_normal, moved_e0, moved_e1);
+    if (!Normalise(normal) || !Normalise(moved_normal))
+    {
+        return false;
+    }
+    if ((float)ScalarProd(3, normal, moved_normal) <= normaldeviation_cos)
+    {
+        return false;
+    }
+    if (_dataDim > 0)
+    {
+        Normalise(e0, _dim);
+        Normalise(moved_e0, _dim);
+        float res = (float)ScalarProd(_dim, e0, e1);
+        float moved_res = (float)ScalarProd(_dim, moved_e0, moved_e1);
+        for (coord = 0; coord < _dim; ++coord)
+        {
+            e1[coord] -= res * e0[coord];
+            moved_e1[coord] -= moved_res * moved_e0[coord];
+        }
+        if (!Normalise(e1, _dim) || !Normalise(moved_e1, _dim))
+        {
+            return false;
+        }
+        float a11 = (float)ScalarProd(_dim, e0, moved_e0);
+        float a12 = (float)ScalarProd(_dim, e1, moved_e0);
+        float a21 = (float)ScalarProd(_dim, e0, moved_e1);
+        float a22 = (float)ScalarProd(_dim, e1, moved_e1);
+        float A11 = a11 * a11 + a21 * a21;
+        float A22 = a12 * a12 + a22 * a22;
+        float A12 = a11 * a12 + a21 * a22;
+        float minmu = 0.5f * (A11 + A22 - (float)sqrt((A11 - A22) * (A11 - A22) + 4.0f * A12 * A12));
+        if (minmu <= normaldeviation_cos * normaldeviation_cos)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// boundary edges must not turn too much, see Edge::CheckDirection
+bool
+EdgeCollapseFlat::CheckDirection(const Candidate &cand) const
+{
+    if (_boundaryDirection.empty())
+    {
+        return true;
+    }
+    for (int side = 0; side < 2; ++side)
+    {
+        const vector<int> &fan = (side == 0) ? cand.fanA : cand.fanB;
+        for (size_t i = 0; i < fan.size(); ++i)
+        {
+            int candidates[2] = { fan[i], Prev(fan[i]) };
+            for (int c = 0; c < 2; ++c)
+            {
+                int he = candidates[c];
+                if (_opposite[he] >= 0 || he == cand.he)
+                {
+                    continue;
+                }
+                map<int, Direction>::const_iterator it = _boundaryDirection.find(he);
+                if (it == _boundaryDirection.end())
+                {
+                    continue;
+                }
+                int v0 = _corner[he];
+                int v1 = _corner[Next(he)];
+                const float *data0 = (v0 == cand.a || v0 == cand.b) ? cand.point : point(v0);
+                const float *data1 = (v1 == cand.a || v1 == cand.b) ? cand.point : point(v1);
+                float direction[3];
+                direction[0] = data1[0] - data0[0];
+                direction[1] = data1[1] - data0[1];
+                direction[2] = data1[2] - data0[2];
+                if (!Normalise(direction))
+                {
+                    return false;
+                }
+                const float *orig = it->second.d;
+                if (orig[0] == 0.0 && orig[1] == 0.0 && orig[2] == 0.0)
+                {
+                    return false;
+                }
+                if (ScalarProd(3, orig, direction) < domaindeviation_cos)
+                {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// topological part of the tests: valence and link condition
+bool
+EdgeCollapseFlat::Gather(int he, int num_max, Candidate &cand) const
+{
+    cand.he = he;
+    cand.a = _corner[he];
+    cand.b = _corner[Next(he)];
+    if (cand.a < 0 || locked(cand.a) || locked(cand.b))
+    {
+        return false;
+    }
+    Fan(cand.a, cand.fanA);
+    Fan(cand.b, cand.fanB);
+    bool boundaryA = Ring(cand.fanA, cand.ringA);
+    bool boundaryB = Ring(cand.fanB, cand.ringB);
+    if (int(cand.ringA.size()) >= num_max || int(cand.ringB.size()) >= num_max)
+    {
+        return false;
+    }
+    bool interior = (_opposite[he] >= 0);
+    // an inner edge between two boundary vertices would pinch the surface
+    if (interior && boundaryA && boundaryB)
+    {
+        return false;
+    }
+    // a and b may only share the vertices opposite to the edge
+    size_t common = 0;
+    vector<int>::const_iterator ia = cand.ringA.begin(), ib = cand.ringB.begin();
+    while (ia != cand.ringA.end() && ib != cand.ringB.end())
+    {
+        if (*ia < *ib)
+        {
+            ++ia;
+        }
+        else if (*ib < *ia)
+        {
+            ++ib;
+        }
+        else
+        {
+            ++common;
+            ++ia;
+            ++ib;
+        }
+    }
+    if (common != (interior ? 2u : 1u))
+    {
+        return false;
+    }
+    // do not collapse a tetrahedron
+    if (interior && cand.ringA.size() == 3 && cand.ringB.size() == 3)
+    {
+        return false;
+    }
+    return true;
+}
+
+// geometric part of the tests, the same as in EdgeCollapseSimple
+bool
+EdgeCollapseFlat::Check(Candidate &cand) const
+{
+    Optimum(cand.a, cand.b, cand.point, cand.cost);
+    int tri0 = cand.he / 3;
+    int tri1 = (_opposite[cand.he] >= 0) ? _opposite[cand.he] / 3 : -1;
+    for (int side = 0; side < 2; ++side)
+    {
+        const vector<int> &fan = (side == 0) ? cand.fanA : cand.fanB;
+        int v = (side == 0) ? cand.a : cand.b;
+        for (size_t i = 0; i < fan.size(); ++i)
+        {
+            int he = fan[i];
+            if (he / 3 == tri0 || he / 3 == tri1)
+            {
+                continue;
+            }
+            if (!CheckSide(v, _corner[Next(he)], _corner[Prev(he)], cand.point))
+            {
+                return false;
+            }
+        }
+    }
+    return CheckDirection(cand);
+}
+
+// dead0 and dead1 are the half-edges of a removed triangle meeting at
+// a vertex which is kept: their opposite half-edges are linked
+void
+EdgeCollapseFlat::Join(int dead0, int dead1)
+{
+    int x = _opposite[dead0];
+    int y = _opposite[dead1];
+    if (x >= 0)
+    {
+        _opposite[x] = y;
+    }
+    if (y >= 0)
+    {
+        _opposite[y] = x;
+    }
+    // a half-edge becoming part of the boundary
+    // inherits the direction of the original one
+    int dead = (x < 0) ? dead0 : dead1;
+    int kept = (x < 0) ? y : x;
+    if (kept >= 0 && (x < 0 || y < 0))
+    {
+        map<int, Direction>::iterator it = _boundaryDirection.find(dead);
+        if (it != _boundaryDirection.end())
+        {
+            _boundaryDirection[kept] = it->second;
+        }
+    }
+}
+
+void
+EdgeCollapseFlat::Kill(int tri)
+{
+    for (int he = 3 * tri; he < 3 * tri + 3; ++he)
+    {
+        _heap.remove(he);
+        if (_opposite[he] < 0)
+        {
+            _boundaryDirection.erase(he);
+        }
+        _corner[he] = -1;
+        _opposite[he] = -1;
+    }
+}
+
+int
+EdgeCollapseFlat::Collapse(const Candidate &cand)
+{
+    int a = cand.a;
+    int b = cand.b;
+    int he = cand.he;
+    int h1 = _opposite[he];
+
+    // normal of the new vertex, see Vertex::UpdatePoint
+    if (!_normal.empty())
+    {
+        const float *pa = point(a);
+        const float *pb = point(b);
+        float disp[3], dispnew[3];
+        for (int coord = 0; coord < 3; ++coord)
+        {
+            disp[coord] = pb[coord] - pa[coord];
+            dispnew[coord] = cand.point[coord] - pa[coord];
+        }
+        float len2 = (float)ScalarProd(3, disp, disp);
+        if (Normalise(disp) && len2 > 0.0)
+        {
+            float tau = (float)ScalarProd(3, dispnew, disp) / sqrt(len2);
+            float tau_comp = 1.0f - tau;
+            float *na = &_normal[3 * a];
+            const float *nb = &_normal[3 * b];
+            na[0] = tau_comp * na[0] + tau * nb[0];
+            na[1] = tau_comp * na[1] + tau * nb[1];
+            na[2] = tau_comp * na[2] + tau * nb[2];
+            Normalise(na);
+        }
+    }
+    copy(cand.point, cand.point + _dim, &_point[size_t(a) * _dim]);
+    double *qa = &_quadric[size_t(a) * _qStride];
+    const double *qb = &_quadric[size_t(b) * _qStride];
+    for (int i = 0; i < _qStride; ++i)
+    {
+        qa[i] += qb[i];
+    }
+    _flags[a] |= (_flags[b] & BOUNDARY);
+    _flags[b] |= DEAD;
+
+    for (size_t i = 0; i < cand.fanB.size(); ++i)
+    {
+        _corner[cand.fanB[i]] = a;
+    }
+
+    // keep valid outgoing half-edges for the vertices opposite to the edge
+    int tri0 = he / 3;
+    int tri1 = (h1 >= 0) ? h1 / 3 : -1;
+    for (int side = 0; side < 2; ++side)
+    {
+        int h = (side == 0) ? he : h1;
+        if (h < 0)
+        {
+            continue;
+        }
+        int c = _corner[Prev(h)];
+        int start = _vertexHalfEdge[c];
+        if (start >= 0 && start / 3 != tri0 && start / 3 != tri1)
+        {
+            continue;
+        }
+        int x = _opposite[Next(h)];
+        int y = _opposite[Prev(h)];
+        _vertexHalfEdge[c] = (x >= 0) ? x : ((y >= 0) ? Next(y) : -1);
+    }
+
+    Join(Next(he), Prev(he));
+    int removed = 1;
+    if (h1 >= 0)
+    {
+        Join(Next(h1), Prev(h1));
+        removed = 2;
+    }
+    Kill(tri0);
+    if (tri1 >= 0)
+    {
+        Kill(tri1);
+    }
+
+    _vertexHalfEdge[b] = -1;
+    _vertexHalfEdge[a] = -1;
+    for (int side = 0; side < 2 && _vertexHalfEdge[a] < 0; ++side)
+    {
+        const vector<int> &fan = (side == 0) ? cand.fanA : cand.fanB;
+        for (size_t i = 0; i < fan.size(); ++i)
+        {
+            if (_corner[fan[i]] >= 0)
+            {
+                _vertexHalfEdge[a] = fan[i];
+                break;
+            }
+        }
+    }
+    _numTriangles -= removed;
+    return removed;
+}
+
+// new costs of all edges around the vertex kept by a collapse
+void
+EdgeCollapseFlat::ComputeCosts(Candidate &cand) const
+{
+    cand.updates.clear();
+    cand.stale.clear();
+    Fan(cand.a, cand.fanA);
+    float popt[MAX_DIM];
+    for (size_t i = 0; i < cand.fanA.size(); ++i)
+    {
+        int he = cand.fanA[i];
+        int edges[2] = { he, Prev(he) };
+        for (int e = 0; e < 2; ++e)
+        {
+            // incoming half-edges are only visited at the boundary
+            if (e == 1 && _opposite[edges[e]] >= 0)
+            {
+                continue;
+            }
+            int opp = _opposite[edges[e]];
+            int rep = (opp < 0 || edges[e] < opp) ? edges[e] : opp;
+            int other = (rep == edges[e]) ? opp : edges[e];
+            if (other >= 0)
+            {
+                cand.stale.push_back(other);
+            }
+            int v0 = _corner[rep];
+            int v1 = _corner[Next(rep)];
+            if (locked(v0) || locked(v1))
+            {
+                cand.stale.push_back(rep);
+                continue;
+            }
+            float cost;
+            Optimum(v0, v1, popt, cost);
+            cand.updates.push_back(pair<int, float>(rep, std::max(cost, 0.0f)));
+        }
+    }
+}
+
+void
+EdgeCollapseFlat::ApplyCosts(const Candidate &cand)
+{
+    for (size_t i = 0; i < cand.stale.size(); ++i)
+    {
+        _heap.remove(cand.stale[i]);
+    }
+    for (size_t i = 0; i < cand.updates.size(); ++i)
+    {
+        _heap.update(cand.updates[i].first, cand.updates[i].second);
+    }
+}
+
+bool
+EdgeCollapseFlat::Touched(const Candidate &cand) const
+{
+    if (_mark[cand.a] == _stamp || _mark[cand.b] == _stamp)
+    {
+        return true;
+    }
+    for (size_t i = 0; i < cand.ringA.size(); ++i)
+    {
+        if (_mark[cand.ringA[i]] == _stamp)
+        {
+            return true;
+        }
+    }
+    for (size_t i = 0; i < cand.ringB.size(); ++i)
+    {
+        if (_mark[cand.ringB[i]] == _stamp)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+EdgeCollapseFlat::Mark(const Candidate &cand)
+{
+    _mark[cand.a] = _stamp;
+    _mark[cand.b] = _stamp;
+    for (size_t i = 0; i < cand.ringA.size(); ++i)
+    {
+        _mark[cand.ringA[i]] = _stamp;
+    }
+    for (size_t i = 0; i < cand.ringB.size(); ++i)
+    {
+        _mark[cand.ringB[i]] = _stamp;
+    }
+}
+
+int
+EdgeCollapseFlat::EdgeContraction(int num_max)
+{
+    if (_heap.empty())
+    {
+        return -1;
+    }
+    if (_batch.empty())
+    {
+        _batch.resize(1);
+    }
+
+    int batch = 1;
+    if (_parallel)
+    {
+        batch = std::min((_numTriangles - _goal) / 2, _heap.size() / 64);
+        batch = std::max(batch, 1);
+    }
+    if (batch == 1)
+    {
+        Candidate &cand = _batch[0];
+        int he = _heap.top();
+        _heap.pop();
+        if (!Gather(he, num_max, cand) || !Check(cand))
+        {
+            return 0;
+        }
+        int removed = Collapse(cand);
+        ComputeCosts(cand);
+        ApplyCosts(cand);
+        return removed;
+    }
+
+    // select cheap edges with disjoint 1-rings from the upper levels
+    // of the heap, which hold no key greater than those below them
+    if (int(_batch.size()) < batch)
+    {
+        _batch.resize(batch);
+    }
+    ++_stamp;
+    int scan = std::min(_heap.size(), 2 * batch);
+    vector<int> scanned(scan);
+    for (int pos = 0; pos < scan; ++pos)
+    {
+        scanned[pos] = _heap.at(pos);
+    }
+    int num = 0;
+    for (int pos = 0; pos < scan && num < batch; ++pos)
+    {
+        int he = scanned[pos];
+        if (_mark[_corner[he]] == _stamp || _mark[_corner[Next(he)]] == _stamp)
+        {
+            continue;
+        }
+        Candidate &cand = _batch[num];
+        if (!Gather(he, num_max, cand))
+        {
+            _heap.remove(he);
+            continue;
+        }
+        if (Touched(cand))
+        {
+            continue;
+        }
+        _heap.remove(he);
+        Mark(cand);
+        ++num;
+    }
+
+    vector<char> ok(num);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for (int i = 0; i < num; ++i)
+    {
+        ok[i] = Check(_batch[i]);
+    }
+
+    int removed = 0;
+    for (int i = 0; i < num; ++i)
+    {
+        if (ok[i])
+        {
+            removed += Collapse(_batch[i]);
+        }
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for (int i = 0; i < num; ++i)
+    {
+        if (ok[i])
+        {
+            ComputeCosts(_batch[i]);
+        }
+    }
+    for (int i = 0; i < num; ++i)
+    {
+        if (ok[i])
+        {
+            ApplyCosts(_batch[i]);
+        }
+    }
+    return removed;
+}
+
+void
+EdgeCollapseFlat::LeftEntities(vector<int> &leftTriangles,
+                               vector<float> &leftVertexX,
+                               vector<float> &leftVertexY,
+                               vector<float> &leftVertexZ,
+                               vector<float> &leftData,
+                               vector<float> &leftNormals) const
+{
+    leftTriangles.clear();
+    leftVertexX.clear();
+    leftVertexY.clear();
+    leftVertexZ.clear();
+    leftData.clear();
+    leftNormals.clear();
+
+    int no_vertex = int(_vertexHalfEdge.size());
+    vector<int> mark(no_vertex, -1);
+    for (size_t corner = 0; corner < _corner.size(); ++corner)
+    {
+        if (_corner[corner] >= 0)
+        {
+            mark[_corner[corner]] = 0;
+        }
+    }
+    int count = 0;
+    for (int vertex = 0; vertex < no_vertex; ++vertex)
+    {
+        if (mark[vertex] == 0)
+        {
+            mark[vertex] = count;
+            ++count;
+        }
+    }
+
+    leftTriangles.reserve(3 * _numTriangles);
+    for (size_t corner = 0; corner < _corner.size(); ++corner)
+    {
+        if (_corner[corner] >= 0)
+        {
+            leftTriangles.push_back(mark[_corner[corner]]);
+        }
+    }
+    leftVertexX.reserve(count);
+    leftVertexY.reserve(count);
+    leftVertexZ.reserve(count);
+    leftData.reserve(size_t(count) * _dataDim);
+    if (!_normal.empty())
+    {
+        leftNormals.reserve(3 * count);
+    }
+    for (int vertex = 0; vertex < no_vertex; ++vertex)
+    {
+        if (mark[vertex] < 0)
+        {
+            continue;
+        }
+        const float *p = point(vertex);
+        leftVertexX.push_back(p[0]);
+        leftVertexY.push_back(p[1]);
+        leftVertexZ.push_back(p[2]);
+        for (int i = 0; i < _dataDim; ++i)
+        {
+            leftData.push_back(p[3 + i]);
+        }
+        if (!_normal.empty())
+        {
+            leftNormals.push_back(_normal[3 * vertex]);
+            leftNormals.push_back(_normal[3 * vertex + 1]);
+            leftNormals.push_back(_normal[3 * vertex + 2]);
+        }
+    }
+}
@@ -0,0 +1,148 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//  CLASS EdgeCollapseFlat
+//
+//  Quadric edge collapse on a half-edge structure kept in flat arrays.
+//  It applies the same criteria as EdgeCollapseSimple (valence,
+//  normal deviation, triangle shape, boundary direction, boundary
+//  quadrics), but needs neither per-vertex sets nor per-edge objects:
+//  a vertex carries its position, data, normal and one accumulated
+//  quadric, a triangle its three corners and the opposite half-edges.
+//  Edges are ordered by an indexed heap whose keys are updated in place.
+//
+//  Vertices at non-manifold edges or with more than one triangle fan
+//  are never moved.
+//
+//  If parallel is set, every call to EdgeContraction collapses a batch
+//  of cheap edges whose 1-rings do not overlap; the geometric checks and
+//  the cost updates of a batch are computed concurrently.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#ifndef _EDGE_COLLAPSE_FLAT_H_
+#define _EDGE_COLLAPSE_FLAT_H_
+
+#include "EdgeCollapseBasis.h"
+#include "IndexedPQ.h"
+
+#include <map>
+#include <vector>
+
+class EdgeCollapseFlat : public EdgeCollapseBasis
+{
+public:
+    /// data_c may have 0, 1 or 3 values per vertex,
+    /// normals_c is either empty or holds a normal per vertex
+    EdgeCollapseFlat(const vector<float> &x_c,
+                     const vector<float> &y_c,
+                     const vector<float> &z_c,
+                     const vector<int> &conn_list,
+                     const vector<float> &data_c,
+                     const vector<float> &normals_c,
+                     bool parallel);
+    virtual ~EdgeCollapseFlat();
+    /// returns the number of removed triangles, -1 if no edge is left
+    virtual int EdgeContraction(int num_max);
+    /// number of triangles the calculation aims at,
+    /// a parallel batch does not remove more than required to reach it
+    void SetGoal(int num_triangles);
+    virtual void LeftEntities(vector<int> &leftTriangles,
+                              vector<float> &leftVertexX,
+                              vector<float> &leftVertexY,
+                              vector<float> &leftVertexZ,
+                              vector<float> &leftData,
+                              vector<float> &leftNormals) const;
+
+private:
+    enum
+    {
+        MAX_DIM = 6, // 3 coordinates and up to 3 data values
+        MAX_Q = (MAX_DIM * (MAX_DIM + 1)) / 2 + MAX_DIM + 1
+    };
+    enum
+    {
+        LOCKED = 1,
+        BOUNDARY = 2,
+        DEAD = 4
+    };
+    struct Direction
+    {
+        float d[3];
+    };
+    // an edge being collapsed: its half-edge he goes from a to b,
+    // b is removed and a is moved to point
+    struct Candidate
+    {
+        int he, a, b;
+        float cost;
+        float point[MAX_DIM];
+        vector<int> fanA, fanB; // outgoing half-edges
+        vector<int> ringA, ringB; // sorted neighbours
+        vector<std::pair<int, float> > updates; // new edge costs
+        vector<int> stale; // half-edges to be removed from the heap
+    };
+
+    static int Next(int he)
+    {
+        return (he % 3 == 2) ? he - 2 : he + 1;
+    }
+    static int Prev(int he)
+    {
+        return (he % 3 == 0) ? he + 2 : he - 1;
+    }
+    const float *point(int v) const
+    {
+        return &_point[v * _dim];
+    }
+    bool locked(int v) const
+    {
+        return (_flags[v] & LOCKED) != 0;
+    }
+
+    void BuildTopology(int no_vertex);
+    void AddTriangleQuadric(int tri);
+    void AddBoundaryQuadric(int he);
+    void Fan(int v, vector<int> &fan) const;
+    bool Ring(const vector<int> &fan, vector<int> &ring) const;
+    bool Optimum(int a, int b, float *point, float &cost) const;
+    double Eval(const double *q, const float *point) const;
+    bool CheckSide(int v, int side0, int side1, const float *moved) const;
+    bool CheckDirection(const Candidate &cand) const;
+    bool Gather(int he, int num_max, Candidate &cand) const;
+    bool Check(Candidate &cand) const;
+    int Collapse(const Candidate &cand);
+    void Join(int dead0, int dead1);
+    void Kill(int tri);
+    void ComputeCosts(Candidate &cand) const;
+    void ApplyCosts(const Candidate &cand);
+    bool Touched(const Candidate &cand) const;
+    void Mark(const Candidate &cand);
+
+    int _dataDim; // data values per vertex
+    int _dim; // point size: 3 + _dataDim
+    int _qDim; // dimension of the quadrics: 3 if data are ignored
+    int _qStride; // symmetric matrix, vector and constant
+    bool _parallel;
+    int _goal;
+    int _numTriangles; // triangles left
+    int _stamp;
+
+    vector<float> _point;
+    vector<float> _normal;
+    vector<double> _quadric;
+    vector<unsigned char> _flags;
+    vector<int> _vertexHalfEdge; // an outgoing half-edge, -1 if none
+    vector<int> _mark;
+    vector<int> _corner; // vertex at the origin of each half-edge, -1 if dead
+    vector<int> _opposite; // -1 at the boundary
+    // original direction of the boundary half-edges
+    std::map<int, Direction> _boundaryDirection;
+    IndexedPQ _heap;
+    vector<Candidate> _batch;
+};
+#endif
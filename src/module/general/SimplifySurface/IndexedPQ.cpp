@@ -0,0 +1,135 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#include "IndexedPQ.h"
+
+IndexedPQ::IndexedPQ(int size)
+    : _pos(size, -1)
+    , _key(size, 0.0f)
+{
+}
+
+void
+IndexedPQ::pop()
+{
+    if (!_heap.empty())
+    {
+        remove(_heap[0]);
+    }
+}
+
+void
+IndexedPQ::update(int id, float key)
+{
+    int pos = _pos[id];
+    if (pos < 0)
+    {
+        _key[id] = key;
+        _pos[id] = (int)_heap.size();
+        _heap.push_back(id);
+        SiftUp(_pos[id]);
+        return;
+    }
+    float old = _key[id];
+    _key[id] = key;
+    if (key < old)
+    {
+        SiftUp(pos);
+    }
+    else if (key > old)
+    {
+        SiftDown(pos);
+    }
+}
+
+void
+IndexedPQ::remove(int id)
+{
+    int pos = _pos[id];
+    if (pos < 0)
+    {
+        return;
+    }
+    _pos[id] = -1;
+    int last = _heap.back();
+    _heap.pop_back();
+    if (pos == (int)_heap.size())
+    {
+        return;
+    }
+    _heap[pos] = last;
+    _pos[last] = pos;
+    // the moved element may have to go either way
+    SiftUp(pos);
+    SiftDown(_pos[last]);
+}
+
+void
+IndexedPQ::SiftUp(int pos)
+{
+    int id = _heap[pos];
+    float key = _key[id];
+    while (pos > 0)
+    {
+        int parent = (pos - 1) / 2;
+        if (_key[_heap[parent]] <= key)
+        {
+            break;
+        }
+        _heap[pos] = _heap[parent];
+        _pos[_heap[pos]] = pos;
+        pos = parent;
+    }
+    _heap[pos] = id;
+    _pos[id] = pos;
+}
+
+void
+IndexedPQ::SiftDown(int pos)
+{
+    int n = (int)_heap.size();
+    int id = _heap[pos];
+    float key = _key[id];
+    for (;;)
+    {
+        int child = 2 * pos + 1;
+        if (child >= n)
+        {
+            break;
+        }
+        if (child + 1 < n && _key[_heap[child + 1]] < _key[_heap[child]])
+        {
+            ++child;
+        }
+        if (key <= _key[_heap[child]])
+        {
+            break;
+        }
+        _heap[pos] = _heap[child];
+        _pos[_heap[pos]] = pos;
+        pos = child;
+    }
+    _heap[pos] = id;
+    _pos[id] = pos;
+}
+
+bool
+IndexedPQ::OK() const
+{
+    for (int pos = 0; pos < (int)_heap.size(); ++pos)
+    {
+        if (_pos[_heap[pos]] != pos)
+        {
+            return false;
+        }
+        if (pos > 0 && _key[_heap[(pos - 1) / 2]] > _key[_heap[pos]])
+        {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,68 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#ifndef _SS_INDEXED_PQ_H_
+#define _SS_INDEXED_PQ_H_
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//  CLASS IndexedPQ
+//
+//  Binary min-heap of integer ids in [0, size) with float keys.
+//  The heap position of every id is kept in a flat array, so that
+//  keys may be changed (in both directions) and arbitrary ids removed
+//  in O(log n) without any per-element allocation.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include <vector>
+
+class IndexedPQ
+{
+public:
+    IndexedPQ(int size);
+
+    bool empty() const
+    {
+        return _heap.empty();
+    }
+    int size() const
+    {
+        return (int)_heap.size();
+    }
+    bool contains(int id) const
+    {
+        return _pos[id] >= 0;
+    }
+    float key(int id) const
+    {
+        return _key[id];
+    }
+    // id with the smallest key, -1 if empty
+    int top() const
+    {
+        return _heap.empty() ? -1 : _heap[0];
+    }
+    // id at heap position pos
+    int at(int pos) const
+    {
+        return _heap[pos];
+    }
+    void pop();
+    // insert id or change its key if already present
+    void update(int id, float key);
+    // remove id if present
+    void remove(int id);
+
+    bool OK() const; // just for debugging purposes
+
+private:
+    void SiftUp(int pos);
+    void SiftDown(int pos);
+    std::vector<int> _heap;
+    std::vector<int> _pos;
+    std::vector<float> _key;
+};
+#endif
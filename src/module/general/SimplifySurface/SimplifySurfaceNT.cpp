@@ -9,6 +9,7 @@
 #include "Point.h"
 #include "EdgeCollapse.h"
 #include "EdgeCollapseSimple.h"
+#include "EdgeCollapseFlat.h"
 #include <do/coDoTriangleStrips.h>
 #include <do/coDoData.h>
 #include <alg/coFeatureLines.h>
@@ -145,6 +146,8 @@ SimplifySurface::SimplifySurface(int argc, char *argv[])
     cf_MaxValence = coCoviseConfig::getInt("Module.SimplifySurface.MaxValence", 200);
 
     cf_Algorithm = coCoviseConfig::getInt("Module.SimplifySurface.Algorithm", 2);
+
+    cf_Parallel = coCoviseConfig::isOn("Module.SimplifySurface.Parallel", false);
 }
 
 float max_cos_2;
@@ -584,6 +587,13 @@ SimplifySurface::compute(const char *)
                                                 TriangleContainer::VECTOR,
                                                 EdgeContainer::HASHED_SET);
 			}
+			else if (cf_Algorithm == 3)
+			{
+				EdgeCollapseFlat *flat = new EdgeCollapseFlat(x_c, y_c, z_c,
+					tri_conn_list, data_c, normals_c, cf_Parallel);
+				flat->SetGoal(int(stage_num_ini_triangles * stage_ratio));
+				edgeCollapse = flat;
+			}
 			else
 			{
 				edgeCollapse = new EdgeCollapseSimple(x_c, y_c, z_c,
@@ -101,5 +101,6 @@ private:
     float cf_BoundaryFactor;
     int cf_MaxValence;
     int cf_Algorithm;
+    bool cf_Parallel;
 };
 #endif
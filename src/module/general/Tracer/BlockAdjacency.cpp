@@ -0,0 +1,233 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#include "BlockAdjacency.h"
+#include <do/coDoUniformGrid.h>
+#include <do/coDoRectilinearGrid.h>
+#include <do/coDoStructuredGrid.h>
+#include <do/coDoUnstructuredGrid.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <map>
+#include <mutex>
+
+extern float grid_tolerance;
+
+// the boxes are enlarged by this fraction of their diagonal
+static const float BOX_MARGIN = 1.0e-3f;
+
+static std::mutex adjacencyMutex;
+static std::multimap<const coDistributedObject *, BlockAdjacency *> adjacencies;
+
+static void
+enlarge(float *box, int n, const float *x, const float *y, const float *z)
+{
+    for (int i = 0; i < n; ++i)
+    {
+        box[0] = std::min(box[0], x[i]);
+        box[1] = std::min(box[1], y[i]);
+        box[2] = std::min(box[2], z[i]);
+        box[3] = std::max(box[3], x[i]);
+        box[4] = std::max(box[4], y[i]);
+        box[5] = std::max(box[5], z[i]);
+    }
+}
+
+bool
+BlockAdjacency::getBBox(const coDistributedObject *grid, float *box)
+{
+    box[0] = box[1] = box[2] = FLT_MAX;
+    box[3] = box[4] = box[5] = -FLT_MAX;
+    if (!grid)
+        return false;
+
+    if (grid->isType("UNSGRD"))
+    {
+        const coDoUnstructuredGrid *uns = (const coDoUnstructuredGrid *)grid;
+        int nelem, nconn, ncoord;
+        int *el, *conn;
+        float *x, *y, *z;
+        uns->getGridSize(&nelem, &nconn, &ncoord);
+        uns->getAddresses(&el, &conn, &x, &y, &z);
+        enlarge(box, ncoord, x, y, z);
+    }
+    else if (grid->isType("STRGRD"))
+    {
+        const coDoStructuredGrid *str = (const coDoStructuredGrid *)grid;
+        int nx, ny, nz;
+        float *x, *y, *z;
+        str->getGridSize(&nx, &ny, &nz);
+        str->getAddresses(&x, &y, &z);
+        enlarge(box, nx * ny * nz, x, y, z);
+    }
+    else if (grid->isType("RCTGRD"))
+    {
+        const coDoRectilinearGrid *rct = (const coDoRectilinearGrid *)grid;
+        int n[3];
+        float *c[3];
+        rct->getGridSize(&n[0], &n[1], &n[2]);
+        rct->getAddresses(&c[0], &c[1], &c[2]);
+        for (int k = 0; k < 3; ++k)
+        {
+            for (int i = 0; i < n[k]; ++i)
+            {
+                box[k] = std::min(box[k], c[k][i]);
+                box[k + 3] = std::max(box[k + 3], c[k][i]);
+            }
+        }
+    }
+    else if (grid->isType("UNIGRD"))
+    {
+        const coDoUniformGrid *uni = (const coDoUniformGrid *)grid;
+        float min[3], max[3];
+        uni->getMinMax(&min[0], &max[0], &min[1], &max[1], &min[2], &max[2]);
+        for (int k = 0; k < 3; ++k)
+        {
+            box[k] = std::min(min[k], max[k]);
+            box[k + 3] = std::max(min[k], max[k]);
+        }
+    }
+    else
+    {
+        // polygons are searched with a tolerance, others are dummies
+        return false;
+    }
+
+    if (box[0] > box[3])
+        return false;
+    float dx = box[3] - box[0];
+    float dy = box[4] - box[1];
+    float dz = box[5] - box[2];
+    float margin = BOX_MARGIN * sqrtf(dx * dx + dy * dy + dz * dz) + grid_tolerance;
+    for (int k = 0; k < 3; ++k)
+    {
+        box[k] -= margin;
+        box[k + 3] += margin;
+    }
+    return true;
+}
+
+BlockAdjacency::BlockAdjacency(const std::vector<const coDistributedObject *> &grids)
+    : grids_(grids)
+{
+    int numBlocks = (int)grids_.size();
+    boxes_.resize(6 * numBlocks);
+    bounded_.resize(numBlocks);
+    neighbours_.resize(numBlocks);
+    for (int i = 0; i < numBlocks; ++i)
+    {
+        bounded_[i] = getBBox(grids_[i], &boxes_[6 * i]);
+    }
+
+    // sweep along x over the blocks sorted by their lower x bound
+    std::vector<std::pair<float, int> > sorted;
+    for (int i = 0; i < numBlocks; ++i)
+    {
+        if (bounded_[i])
+            sorted.push_back(std::make_pair(boxes_[6 * i], i));
+    }
+    std::sort(sorted.begin(), sorted.end());
+    for (size_t a = 0; a < sorted.size(); ++a)
+    {
+        int i = sorted[a].second;
+        const float *bi = &boxes_[6 * i];
+        for (size_t b = a + 1; b < sorted.size() && sorted[b].first <= bi[3]; ++b)
+        {
+            int j = sorted[b].second;
+            const float *bj = &boxes_[6 * j];
+            if (bi[1] <= bj[4] && bj[1] <= bi[4] && bi[2] <= bj[5] && bj[2] <= bi[5])
+            {
+                neighbours_[i].push_back(j);
+                neighbours_[j].push_back(i);
+            }
+        }
+    }
+    // blocks without extent are neighbours of all others
+    for (int i = 0; i < numBlocks; ++i)
+    {
+        if (bounded_[i])
+            continue;
+        for (int j = 0; j < numBlocks; ++j)
+        {
+            if (j == i)
+                continue;
+            neighbours_[i].push_back(j);
+            if (bounded_[j])
+                neighbours_[j].push_back(i);
+        }
+    }
+    for (int i = 0; i < numBlocks; ++i)
+    {
+        std::sort(neighbours_[i].begin(), neighbours_[i].end());
+    }
+}
+
+BlockAdjacency::~BlockAdjacency()
+{
+}
+
+bool
+BlockAdjacency::mayContain(int block, const float *point) const
+{
+    if (!bounded_[block])
+        return true;
+    const float *box = &boxes_[6 * block];
+    return point[0] >= box[0] && point[0] <= box[3]
+           && point[1] >= box[1] && point[1] <= box[4]
+           && point[2] >= box[2] && point[2] <= box[5];
+}
+
+const std::vector<int> &
+BlockAdjacency::neighbours(int block) const
+{
+    return neighbours_[block];
+}
+
+bool
+BlockAdjacency::isNeighbour(int block, int other) const
+{
+    return std::binary_search(neighbours_[block].begin(), neighbours_[block].end(), other);
+}
+
+const std::vector<const coDistributedObject *> &
+BlockAdjacency::grids() const
+{
+    return grids_;
+}
+
+const BlockAdjacency *
+BlockAdjacency::get(const std::vector<const coDistributedObject *> &grids)
+{
+    if (grids.empty())
+        return NULL;
+
+    std::lock_guard<std::mutex> lock(adjacencyMutex);
+    typedef std::multimap<const coDistributedObject *, BlockAdjacency *>::iterator Iterator;
+    std::pair<Iterator, Iterator> range = adjacencies.equal_range(grids[0]);
+    for (Iterator it = range.first; it != range.second; ++it)
+    {
+        if (it->second->grids() == grids)
+            return it->second;
+    }
+    BlockAdjacency *adjacency = new BlockAdjacency(grids);
+    adjacencies.insert(std::make_pair(grids[0], adjacency));
+    return adjacency;
+}
+
+void
+BlockAdjacency::clear()
+{
+    std::lock_guard<std::mutex> lock(adjacencyMutex);
+    for (std::multimap<const coDistributedObject *, BlockAdjacency *>::iterator it = adjacencies.begin();
+         it != adjacencies.end(); ++it)
+    {
+        delete it->second;
+    }
+    adjacencies.clear();
+}
@@ -0,0 +1,66 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//  CLASS BlockAdjacency
+//
+//  Bounding boxes and neighbourhood of the blocks of a multi-block grid
+//
+//  Two blocks are neighbours if their (slightly enlarged) bounding boxes
+//  overlap. When a trace leaves a block, the neighbours of this block are
+//  probed first, and blocks whose bounding box does not contain the
+//  point are not probed at all.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Changes:
+
+#ifndef _BLOCK_ADJACENCY_H_
+#define _BLOCK_ADJACENCY_H_
+
+#include <do/coDistributedObject.h>
+#include <vector>
+using namespace covise;
+
+class BlockAdjacency
+{
+public:
+    /** Constructor
+       * @param grids list of blocks
+       */
+    BlockAdjacency(const std::vector<const coDistributedObject *> &grids);
+    /// Destructor
+    ~BlockAdjacency();
+    /** Return false if point certainly lies outside of a block
+       * @param block block index
+       * @param point point coordinates
+       */
+    bool mayContain(int block, const float *point) const;
+    /** Neighbours of a block, sorted by index
+       * @param block block index
+       */
+    const std::vector<int> &neighbours(int block) const;
+    /// Return true if other is a neighbour of block
+    bool isNeighbour(int block, int other) const;
+    /// the list of blocks used for the construction
+    const std::vector<const coDistributedObject *> &grids() const;
+    /** Get the adjacency for a list of blocks, which is computed
+       * when it is asked for the first time (thread safe)
+       * @param grids list of blocks
+       */
+    static const BlockAdjacency *get(const std::vector<const coDistributedObject *> &grids);
+    /// Forget all adjacencies (only call when no trace is integrated)
+    static void clear();
+
+private:
+    // false for object types without known extent
+    static bool getBBox(const coDistributedObject *grid, float *box);
+
+    std::vector<const coDistributedObject *> grids_;
+    std::vector<float> boxes_; // 6 floats per block: xmin, ymin, zmin, xmax, ymax, zmax
+    std::vector<char> bounded_; // the box of a block is known
+    std::vector<std::vector<int> > neighbours_;
+};
+#endif
@@ -12,6 +12,9 @@
 #include <do/coDoRectilinearGrid.h>
 #include <do/coDoUniformGrid.h>
 #include "HTask.h"
+#include "PTaskPool.h"
+#include "PTraceline.h"
+#include "BlockAdjacency.h"
 
 // expand a set into a list (out_array)
 int
@@ -228,31 +231,14 @@ HTask::HTask(const coModule *mod,
     ptasks_ = 0;
     no_ptasks_ = 0;
     no_finished_ = serviced_ = 0;
+    blockSearches_ = 0;
+    solvedTasks_ = 0;
 
     // Create arrays of std::vector's to optimise ExpandObjects.
     MakeIAsForExpand();
     fillRealTime();
 }
 
-// maqke the assignation of a PTask for a worker thread
-void
-HTask::assignTask(PTask **pp_task,
-                  int label)
-{
-    // shortly it is serviced
-    ptasks_[serviced_]->set_status(PTask::SERVICED);
-    ptasks_[serviced_]->set_label(label);
-    *pp_task = ptasks_[serviced_++]; // assign and increase serviced_ counter
-}
-
-// Gather results from a PTask
-void
-HTask::gatherPTask(PTask **pp_task)
-{ // a thread has finished a PTask
-    ++no_finished_;
-    *pp_task = 0;
-}
-
 // Solve sequentially all PTasks (used without pthreads)
 void
 HTask::Solve(float epsilon,
@@ -265,6 +251,51 @@ HTask::Solve(float epsilon,
         ++no_finished_;
         ++serviced_;
     }
+    countBlockSearches(0, no_ptasks_);
+}
+
+// Solve all PTasks not yet serviced with the worker threads of pool
+void
+HTask::Solve(PTaskPool &pool,
+             float epsilon,
+             float epsilon_abs)
+{
+    pool.Solve(ptasks_ + serviced_, no_ptasks_ - serviced_, epsilon, epsilon_abs);
+    countBlockSearches(serviced_, no_ptasks_);
+    no_finished_ = serviced_ = no_ptasks_;
+}
+
+// collect the block search counters of solved PTasks
+void
+HTask::countBlockSearches(int begin, int end)
+{
+    for (int i = begin; i < end; ++i)
+    {
+        PTraceline *line = dynamic_cast<PTraceline *>(ptasks_[i]);
+        if (line)
+        {
+            blockSearches_ += line->fetchBlockSearches();
+        }
+    }
+    solvedTasks_ += end - begin;
+}
+
+long
+HTask::getBlockSearches() const
+{
+    return blockSearches_;
+}
+
+long
+HTask::getSolvedTasks() const
+{
+    return solvedTasks_;
+}
+
+float
+HTask::getBlockSearchesPerTask() const
+{
+    return solvedTasks_ > 0 ? (float)blockSearches_ / solvedTasks_ : 0.0f;
 }
 
 void
@@ -572,16 +603,10 @@ HTask::allPFinished()
     return (no_finished_ == no_ptasks_);
 }
 
-// returns whether there are still unserviced ptasks
-int
-HTask::unserviced()
-{
-    return serviced_ != no_ptasks_;
-}
-
 HTask::~HTask()
 {
     cleanPTasks();
+    BlockAdjacency::clear();
     delete[] velo_tstep_opt_;
     delete[] inip_tstep_opt_;
 }
@@ -25,6 +25,7 @@ using namespace covise;
 #include <float.h>
 
 class BBoxAdmin;
+class PTaskPool;
 
 int ExpandSetList(const coDistributedObject *const *objects, int h_many,
                   std::vector<const coDistributedObject *> &out_array);
@@ -53,23 +54,30 @@ public:
        * @param    eps_abs  absolute error per time step for step control.
        */
     void Solve(float epsilon, float epsilon_abs);
-    /** Return 1 if all PTasks have been finished, 0 otherwise.
-       * @return            all PTasks have been finished or not.
+    /** Solve the PTasks with a crew of worker threads.
+       * @param    pool     worker threads.
+       * @param    eps      relative error per time step for step control.
+       * @param    eps_abs  absolute error per time step for step control.
        */
-    virtual int allPFinished();
-    /** Return 1 if there are still PTasks to be assigned to a thread.
-       * @return            all PTasks have been assigned to a thread.
+    void Solve(PTaskPool &pool, float epsilon, float epsilon_abs);
+    /** Number of blocks probed when traces left their block
+       * (see PTraceline::searchBlocks), summed over all solved PTasks.
+       * @return            block searches of all PTasks.
        */
-    int unserviced();
-    /** Assign a task to a thread reading tasks from "port" *pp_task
-       * @retval   pp_task address of pointer to the assigned PTask.
-       * @param    label   thread identification.
+    long getBlockSearches() const;
+    /** Number of solved PTasks of all time steps.
+       * @return            solved PTasks.
        */
-    void assignTask(PTask **pp_task, int label);
-    /** Do whatever is necessary when a PTask is done.
-       * @retval   pp_task set the pointer to assigned task to zero.
+    long getSolvedTasks() const;
+    /** Average number of blocks probed per PTask when a trace
+       * left its block (see PTraceline::searchBlocks).
+       * @return            block searches per PTask.
        */
-    void gatherPTask(PTask **pp_task);
+    float getBlockSearchesPerTask() const;
+    /** Return 1 if all PTasks have been finished, 0 otherwise.
+       * @return            all PTasks have been finished or not.
+       */
+    virtual int allPFinished();
     /** Return 1 if all time steps are done.
        * @return            all time steps are done.
        */
@@ -124,6 +132,9 @@ protected:
     // it is always true that serviced_>=no_finished_
     int no_finished_; // start with 0 for every time step
     int serviced_; // start with 0 for every time step
+    long blockSearches_; // probed blocks of all solved PTasks
+    long solvedTasks_; // solved PTasks of all time steps
+    void countBlockSearches(int begin, int end);
     const coDistributedObject *grid_; // pointer to grid input object
     const coDistributedObject *velo_; // pointer to velocity input object
     const coDistributedObject *ini_p_; // pointer to initial point object
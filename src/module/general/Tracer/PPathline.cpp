@@ -53,17 +53,17 @@ PPathline::derivs(float x, // time
             && emergency_ == GOT_OUT_OF_DOMAIN
             && allGrids))
     {
-        for (i = 0; i < grids0_->size(); ++i)
+        i = searchBlocks(y, int_ydot_0, *grids0_, *vels0_,
+                         iniGrid_0, false, previousCell_0_.cell_, false, search_level);
+        if (i >= 0)
         {
-            ret_0 = derivsForAGrid(y, int_ydot_0, grids0_->operator[](i),
-                                   vels0_->operator[](i),
-                                   previousCell_0_.cell_, search_level);
-            if (ret_0 == SERVICED)
-            {
-                previousCell_0_.setGrid(i);
-                flag_grid_0_ = 0;
-                break;
-            }
+            previousCell_0_.setGrid(i);
+            flag_grid_0_ = 0;
+            ret_0 = SERVICED;
+        }
+        else
+        {
+            ret_0 = FINISHED_DOMAIN;
         }
     }
 
@@ -97,17 +97,17 @@ PPathline::derivs(float x, // time
             && allGrids))
     {
         // find interpolation for grids1_ and vels1_
-        for (i = 0; i < grids1_->size(); ++i)
+        i = searchBlocks(y, int_ydot_1, *grids1_, *vels1_,
+                         iniGrid_1, false, previousCell_1_.cell_, false, search_level);
+        if (i >= 0)
         {
-            ret_1 = derivsForAGrid(y, int_ydot_1, grids1_->operator[](i),
-                                   vels1_->operator[](i),
-                                   previousCell_1_.cell_, search_level);
-            if (ret_1 == SERVICED)
-            {
-                previousCell_1_.setGrid(i);
-                flag_grid_1_ = 0;
-                break;
-            }
+            previousCell_1_.setGrid(i);
+            flag_grid_1_ = 0;
+            ret_1 = SERVICED;
+        }
+        else
+        {
+            ret_1 = FINISHED_DOMAIN;
         }
     }
 
@@ -6,6 +6,7 @@
  * License: LGPL 2+ */
 
 
+#include <do/coDistributedObject.h>
 #include "PStreamline.h"
 #include <math.h>
 
@@ -48,35 +49,55 @@ PStreamline::derivs(float x, // time
     float int_ydot[3];
     if (previousCell_0_.grid_ < 0 || (ret == FINISHED_DOMAIN && emergency_ == GOT_OUT_OF_DOMAIN && allGrids))
     {
-        // fprintf(stderr,"derivs: x: %f, y: %f %f %f\n",x,*y,*(y+1),*(y+2));
-        for (i = 0; i < grids0_->size(); ++i)
+        int hadGrid = (previousCell_0_.grid_ >= 0);
+        i = searchBlocks(y, hadGrid ? int_ydot : ydot, *grids0_, *vels0_,
+                         iniGrid, true, previousCell_0_.cell_, true, search_level);
+        if (i >= 0)
         {
-            if (i == iniGrid)
-                continue;
-            // fprintf(stderr,"   derivs: Checking %d, (%d)\n",i,previousCell_0_.grid_);
-            previousCell_0_.cell_[0] = -1;
-            previousCell_0_.cell_[1] = -1;
-            previousCell_0_.cell_[2] = -1;
-            ret = derivsForAGrid(y, (previousCell_0_.grid_ < 0) ? ydot : int_ydot,
-                                 grids0_->operator[](i),
-                                 vels0_->operator[](i),
-                                 previousCell_0_.cell_, search_level);
-            if (ret == SERVICED)
+            if (hadGrid)
             {
-                if (previousCell_0_.grid_ >= 0)
-                {
-                    ydot[0] = int_ydot[0];
-                    ydot[1] = int_ydot[1];
-                    ydot[2] = int_ydot[2];
-                }
-                previousCell_0_.setGrid(i);
-                break;
+                ydot[0] = int_ydot[0];
+                ydot[1] = int_ydot[1];
+                ydot[2] = int_ydot[2];
             }
+            previousCell_0_.setGrid(i);
+            ret = SERVICED;
+        }
+        else
+        {
+            ret = FINISHED_DOMAIN;
         }
     }
     return ret;
 }
 
+void
+PStreamline::setCellHint(const int *cell)
+{
+    if (previousCell_0_.grid_ >= 0 || grids0_->size() != 1
+        || !grids0_->operator[](0)->isType("UNSGRD"))
+    {
+        return;
+    }
+    previousCell_0_.setGrid(0);
+    previousCell_0_.cell_[0] = cell[0];
+    previousCell_0_.cell_[1] = cell[1];
+    previousCell_0_.cell_[2] = cell[2];
+}
+
+bool
+PStreamline::getCellHint(int *cell) const
+{
+    if (hintRegister_.empty() || hintRegister_[0].grid_ != 0)
+    {
+        return false;
+    }
+    cell[0] = hintRegister_[0].cell_[0];
+    cell[1] = hintRegister_[0].cell_[1];
+    cell[2] = hintRegister_[0].cell_[2];
+    return true;
+}
+
 extern float divide_cell;
 extern float max_out_of_cell;
 extern int search_level_polygons;
@@ -54,6 +54,16 @@ public:
                           vector<float> &interpolation);
     virtual float *m_c_interpolate(vector<const coDistributedObject *> &sfield,
                                    vector<const coDistributedObject *> &);
+    /** Start the cell search for the initial point in a given cell
+       * (only used for a single unstructured grid without other hint)
+       * @param cell cell of a nearby seed point
+       */
+    void setCellHint(const int *cell);
+    /** Cell of the initial point after Solve
+       * @retval cell cell of the initial point
+       * @return false if the initial point was not found in the first grid
+       */
+    bool getCellHint(int *cell) const;
 
 protected:
     // derivs: evaluate velocity
@@ -0,0 +1,179 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+#include "PTaskPool.h"
+#include "PStreamline.h"
+
+#include <algorithm>
+
+// a batch is small enough for a fair distribution of the
+// remaining work and large enough to keep queue accesses rare
+static const int MAX_BATCH_SIZE = 32;
+static const int BATCHES_PER_THREAD = 16;
+
+PTaskPool::PTaskPool(int numThreads)
+    : workers_(std::max(numThreads, 1))
+    , generation_(0)
+    , quit_(false)
+    , remaining_(0)
+    , steals_(0)
+    , tasks_(NULL)
+    , eps_(0.0)
+    , eps_abs_(0.0)
+{
+    for (size_t i = 0; i < workers_.size(); ++i)
+    {
+        workers_[i].hasCell = false;
+        threads_.push_back(std::thread(&PTaskPool::work, this, (int)i));
+    }
+}
+
+PTaskPool::~PTaskPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        quit_ = true;
+    }
+    wake_.notify_all();
+    for (size_t i = 0; i < threads_.size(); ++i)
+    {
+        threads_[i].join();
+    }
+}
+
+int
+PTaskPool::getNumThreads() const
+{
+    return (int)workers_.size();
+}
+
+int
+PTaskPool::getNumSteals() const
+{
+    return steals_;
+}
+
+void
+PTaskPool::Solve(PTask **tasks, int numTasks, float eps, float eps_abs)
+{
+    if (numTasks <= 0)
+        return;
+
+    tasks_ = tasks;
+    eps_ = eps;
+    eps_abs_ = eps_abs;
+    remaining_ = numTasks;
+
+    // every thread gets a contiguous range of tasks: neighbouring
+    // seed points usually start in neighbouring cells
+    int numThreads = (int)workers_.size();
+    int batchSize = numTasks / (numThreads * BATCHES_PER_THREAD);
+    batchSize = std::max(1, std::min(batchSize, MAX_BATCH_SIZE));
+    for (int t = 0; t < numThreads; ++t)
+    {
+        int begin = (int)((long long)numTasks * t / numThreads);
+        int end = (int)((long long)numTasks * (t + 1) / numThreads);
+        std::lock_guard<std::mutex> lock(workers_[t].mutex);
+        for (int b = begin; b < end; b += batchSize)
+        {
+            Batch batch;
+            batch.begin = b;
+            batch.end = std::min(b + batchSize, end);
+            workers_[t].batches.push_back(batch);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++generation_;
+    }
+    wake_.notify_all();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this]() { return remaining_ == 0; });
+}
+
+bool
+PTaskPool::getBatch(int label, Batch &batch)
+{
+    {
+        Worker &own = workers_[label];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.batches.empty())
+        {
+            batch = own.batches.front();
+            own.batches.pop_front();
+            return true;
+        }
+    }
+    int numThreads = (int)workers_.size();
+    for (int i = 1; i < numThreads; ++i)
+    {
+        Worker &victim = workers_[(label + i) % numThreads];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.batches.empty())
+        {
+            batch = victim.batches.back();
+            victim.batches.pop_back();
+            ++steals_;
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+PTaskPool::solveTask(int label, PTask *task)
+{
+    task->set_status(PTask::SERVICED);
+    task->set_label(label);
+
+    // streamlines starting without a cell hint begin the search
+    // in the cell of the seed handled before by this thread
+    Worker &worker = workers_[label];
+    PStreamline *line = dynamic_cast<PStreamline *>(task);
+    if (line && worker.hasCell)
+    {
+        line->setCellHint(worker.cell);
+    }
+    task->Solve(eps_, eps_abs_);
+    if (line)
+    {
+        worker.hasCell = line->getCellHint(worker.cell);
+    }
+}
+
+void
+PTaskPool::work(int label)
+{
+    int seen = 0;
+    while (1)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this, seen]() { return quit_ || generation_ != seen; });
+            if (quit_)
+                return;
+            seen = generation_;
+        }
+
+        Batch batch;
+        while (getBatch(label, batch))
+        {
+            for (int i = batch.begin; i < batch.end; ++i)
+            {
+                solveTask(label, tasks_[i]);
+            }
+            int size = batch.end - batch.begin;
+            if (remaining_.fetch_sub(size) == size)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                done_.notify_all();
+            }
+        }
+    }
+}
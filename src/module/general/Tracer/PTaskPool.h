@@ -0,0 +1,85 @@
+/* This file is part of COVISE.
+
+   You can use it under the terms of the GNU Lesser General Public License
+   version 2.1 or later, see lgpl-2.1.txt.
+
+ * License: LGPL 2+ */
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//  CLASS PTaskPool
+//
+//  Crew of worker threads solving the PTasks of a time step
+//
+//  The PTasks are cut into batches of neighbouring tasks, which are
+//  distributed over per-thread queues. A thread works on its own queue
+//  from the front and steals from the back of other queues when it runs
+//  dry. The threads live as long as the pool, i.e. for all time steps.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Changes:
+
+#ifndef _P_TASK_POOL_H_
+#define _P_TASK_POOL_H_
+
+#include "PTask.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class PTaskPool
+{
+public:
+    /** Constructor: start the worker threads
+       * @param numThreads number of worker threads
+       */
+    PTaskPool(int numThreads);
+    /// Destructor: terminate the worker threads
+    ~PTaskPool();
+    /** Solve a list of PTasks in parallel, returns when all are done
+       * @param    tasks    list of PTasks
+       * @param    numTasks length of tasks
+       * @param    eps      relative error per time step for step control.
+       * @param    eps_abs  absolute error per time step for step control.
+       */
+    void Solve(PTask **tasks, int numTasks, float eps, float eps_abs);
+    /// number of worker threads
+    int getNumThreads() const;
+    /// number of batches taken from the queue of another thread so far
+    int getNumSteals() const;
+
+private:
+    struct Batch
+    {
+        int begin;
+        int end;
+    };
+    // queue of a worker thread and the cell of its last seed point
+    struct Worker
+    {
+        std::mutex mutex;
+        std::deque<Batch> batches;
+        bool hasCell;
+        int cell[3];
+    };
+
+    void work(int label);
+    bool getBatch(int label, Batch &batch);
+    void solveTask(int label, PTask *task);
+
+    std::vector<std::thread> threads_;
+    std::vector<Worker> workers_;
+    std::mutex mutex_; // protects generation_ and quit_
+    std::condition_variable wake_; // new tasks or termination
+    std::condition_variable done_; // all tasks finished
+    int generation_; // incremented for every call to Solve
+    bool quit_;
+    std::atomic<int> remaining_; // tasks which are not finished yet
+    std::atomic<int> steals_;
+    PTask **tasks_;
+    float eps_;
+    float eps_abs_;
+};
+#endif
@@ -12,6 +12,7 @@
 #include <do/coDoPolygons.h>
 #include <do/coDoData.h>
 #include "PTraceline.h"
+#include "BlockAdjacency.h"
 #include <math.h>
 
 extern PTask::whatout Whatout;
@@ -211,6 +212,67 @@ PTraceline::derivsForAGrid(const float *y, // point: constness violated for poly
     return ret;
 }
 
+int
+PTraceline::fetchBlockSearches()
+{
+    int ret = blockSearches_;
+    blockSearches_ = 0;
+    return ret;
+}
+
+// see header
+int
+PTraceline::searchBlocks(const float *y,
+                         float *ydot,
+                         const std::vector<const coDistributedObject *> &grids,
+                         const std::vector<const coDistributedObject *> &vels,
+                         int block, // block of the last point
+                         bool skipBlock, // block has already been probed
+                         int *cell,
+                         bool resetCell, // probe without cell hint
+                         int search_level)
+{
+    int numBlocks = (int)grids.size();
+    if (block >= numBlocks)
+        block = -1;
+    const BlockAdjacency *adjacency = (numBlocks > 1) ? BlockAdjacency::get(grids) : NULL;
+
+    // usually a trace leaving a block enters one of its neighbours
+    if (adjacency && block >= 0)
+    {
+        const std::vector<int> &next = adjacency->neighbours(block);
+        for (size_t n = 0; n < next.size(); ++n)
+        {
+            int i = next[n];
+            if (!adjacency->mayContain(i, y))
+                continue;
+            if (resetCell)
+                cell[0] = cell[1] = cell[2] = -1;
+            ++blockSearches_;
+            if (derivsForAGrid(y, ydot, grids[i], vels[i], cell, search_level) == SERVICED)
+                return i;
+        }
+    }
+    for (int i = 0; i < numBlocks; ++i)
+    {
+        if (i == block && skipBlock)
+            continue;
+        if (adjacency)
+        {
+            if (block >= 0 && adjacency->isNeighbour(block, i))
+                continue;
+            if (!adjacency->mayContain(i, y))
+                continue;
+        }
+        if (resetCell)
+            cell[0] = cell[1] = cell[2] = -1;
+        ++blockSearches_;
+        if (derivsForAGrid(y, ydot, grids[i], vels[i], cell, search_level) == SERVICED)
+            return i;
+    }
+    return -1;
+}
+
 // see header
 PTraceline::PTraceline(float x_ini,
                        float y_ini,
@@ -220,6 +282,7 @@ PTraceline::PTraceline(float x_ini,
                        int ts)
     : PTask(x_ini, y_ini, z_ini, grids0, vels0)
     , release_time_(0.0)
+    , blockSearches_(0)
 {
     ts_ = ts;
 }
@@ -106,6 +106,11 @@ public:
     ~PTraceline()
     {
     }
+    /** Get the number of blocks probed when looking for a new block
+       * since the last call, and reset the counter.
+       * @return             number of probed blocks.
+       */
+    int fetchBlockSearches();
 
 protected:
     // release time
@@ -139,6 +144,15 @@ protected:
     status derivsForAGrid(const float *y, float *ydot,
                           const coDistributedObject *grid, const coDistributedObject *velo, int *cell,
                           int search_level);
+    // Look for the block containing point y: the neighbours of block are
+    // probed first, blocks whose bounding box does not contain y are
+    // skipped. Returns the block index or -1.
+    int searchBlocks(const float *y, float *ydot,
+                     const std::vector<const coDistributedObject *> &grids,
+                     const std::vector<const coDistributedObject *> &vels,
+                     int block, bool skipBlock, int *cell, bool resetCell,
+                     int search_level);
+    int blockSearches_; // number of blocks probed by searchBlocks
     // add an integrated point to the result lists
     void addPoint(float time, float *posi, float *velo, int kount, int number);
     static const float TINY; // constant used by the integrator
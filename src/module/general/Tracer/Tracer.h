@@ -22,7 +22,6 @@
 #include <api/coModule.h>
 using namespace covise;
 #include "HTask.h"
-#include "Fifo.h"
 
 #include "BBoxAdmin.h"
 
@@ -48,9 +47,6 @@ public:
     Tracer(int argc, char **argv);
     virtual ~Tracer()
     {
-#ifndef CO_hp1020
-        delete[] read_task_;
-#endif
     }
     enum HTaskTyp
     {
@@ -136,16 +132,6 @@ private:
     ///////////////////////////////////////
     int crewSize_;
     int findCrewSize();
-#ifndef CO_hp1020
-    PTask **read_task_; // list of pointers to PTask objects.
-    // used for task assignation
-    Fifo<int> lazyThreads_;
-
-    //  virtual void quit();
-    void terminateThreads();
-    void startThreads();
-    void lockMMutex();
-#endif
     BBoxAdmin BBoxAdmin_;
     bool GoodOctTrees();
     bool GoodOctTrees(const coDistributedObject *grid, const coDistributedObject *otree);
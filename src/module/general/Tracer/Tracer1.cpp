@@ -9,6 +9,7 @@
 #include "Tracer.h"
 #include <config/CoviseConfig.h>
 #include <set>
+#include <thread>
 #include <math.h>
 #include <do/coDoPoints.h>
 #include <do/coDoTriangleStrips.h>
@@ -24,8 +25,10 @@ int
 Tracer::findCrewSize()
 {
 #ifndef CO_hp1020
-    int numNodes = coCoviseConfig::getInt("System.HostInfo.NumProcessors", 1);
-    if ((numNodes < 1) || (numNodes > 200))
+    // default: one worker per hardware thread
+    int numNodes = coCoviseConfig::getInt("System.HostInfo.NumProcessors",
+                                          (int)std::thread::hardware_concurrency());
+    if (numNodes < 1)
     {
         numNodes = 1;
     }